@@ -0,0 +1,375 @@
+#include "stdafx.h"
+#include "BatchCompiler.h"
+#include "HostPlatform.h"
+#include "../Logic/ComThreadHelper.h"
+#include "../Logic/FileSearch.h"
+#include "../Logic/GameDataWorker.h"
+#include "../Logic/ProjectBuilder.h"
+#include "../Logic/ScriptFileReader.h"
+#include "../Logic/ScriptFileWriter.h"
+#include "../Logic/ScriptParser.h"
+#include "../Logic/TaskScheduler.h"
+#include "../Logic/XFileInfo.h"
+#include "../Testing/LogicBenchmarks.h"
+#include <ShlObj.h>
+
+namespace Compiler
+{
+   // -------------------------------- CONSTRUCTION --------------------------------
+
+   /// <summary>Creates a batch compiler.</summary>
+   /// <param name="opt">Command line options</param>
+   BatchCompiler::BatchCompiler(const BatchOptions& opt) : Options(opt)
+   {
+   }
+
+   BatchCompiler::~BatchCompiler()
+   {
+   }
+
+   // ------------------------------- STATIC METHODS -------------------------------
+
+   /// <summary>Prints a diagnostic in the canonical 'file(line): error: message' format, using the path form of the host.</summary>
+   /// <param name="path">Script path</param>
+   /// <param name="line">1-based line number  [zero if not applicable]</param>
+   /// <param name="msg">Error message</param>
+   /// <param name="txt">Offending text  [optional]</param>
+   void  BatchCompiler::PrintDiagnostic(const Path& path, UINT line, const wstring& msg, const wstring& txt)
+   {
+      wstring host = HostPlatform::ToHostPath(path);
+
+      if (txt.empty())
+         wcout << host << L"(" << line << L"): error: " << msg << endl;
+      else
+         wcout << host << L"(" << line << L"): error: " << msg << L" : '" << txt << L"'" << endl;
+   }
+
+   // ------------------------------- PUBLIC METHODS -------------------------------
+
+   /// <summary>Generates the synthetic corpus, runs the logic benchmarks and saves the results.</summary>
+   /// <returns>Process exit code</returns>
+   BatchCompiler::ExitCode  BatchCompiler::Benchmark()
+   {
+      try
+      {
+         WorkerData  data(Operation::NoFeedback);
+         LogicBenchmarks  benchmarks(Options.ScriptFolder, Options.CorpusSize, Options.Iterations);
+
+         // Generate + load corpus
+         wcout << VString(L"Generating %d script corpus in %s...", Options.CorpusSize, Options.ScriptFolder.c_str()) << endl;
+         benchmarks.Generate(&data);
+
+         // Run
+         wcout << VString(L"Running benchmarks (%d iterations)...", Options.Iterations) << endl;
+         benchmarks.Run();
+
+         // Print results
+         wcout << VString(L"  %-26s %8s %12s %12s %10s %10s", L"Benchmark", L"Ops", L"ms", L"Ops/sec", L"MB/sec", L"Allocs/op") << endl;
+         for (auto& r : benchmarks.Results)
+         {
+            wstring allocs = (r.Allocations >= 0 ? VString(L"%10.1f", r.GetAllocationsPerOp()) : VString(L"%10s", L"n/a"));
+            wcout << VString(L"  %-26s %8d %12.1f %12.1f %10.2f %s", r.Name.c_str(), r.Operations, r.Milliseconds, r.GetOpsPerSecond(), r.GetMegabytesPerSecond(), allocs.c_str()) << endl;
+         }
+
+         // Allocations: Counted by the debug CRT allocation hook
+         if (any_of(benchmarks.Results.begin(), benchmarks.Results.end(), [](const BenchmarkResult& r) { return r.Allocations < 0; }))
+            wcout << L"  Allocations are counted by the debug CRT only, use a debug build to measure them" << endl;
+
+         // Save results
+         benchmarks.SaveResults(Options.ResultsPath);
+         wcout << L"Results saved to " << Options.ResultsPath.c_str() << endl;
+         return Success;
+      }
+      catch (ExceptionBase& e)
+      {
+         wcerr << L"error: " << e.Message.c_str() << L"  (" << e.Source.c_str() << L")" << endl;
+         return Fatal;
+      }
+   }
+
+   /// <summary>Loads the game data then verifies/compiles every script in the input folder.</summary>
+   /// <returns>Process exit code</returns>
+   BatchCompiler::ExitCode  BatchCompiler::Run()
+   {
+      // Project: Build incrementally
+      if (Options.IsProject())
+         return Build();
+
+      try
+      {
+         // Load game data once, shared by all workers
+         LoadGameData();
+
+         // Enumerate + process scripts
+         EnumerateScripts(Options.ScriptFolder);
+         ProcessScripts();
+      }
+      catch (ExceptionBase& e)
+      {
+         wcerr << L"error: " << e.Message.c_str() << L"  (" << e.Source.c_str() << L")" << endl;
+         return Fatal;
+      }
+
+      // Print diagnostics + timings
+      PrintResults();
+
+      // Success if no script reported errors
+      return any_of(Results.begin(), Results.end(), [](const ScriptResult& r) { return !r.Diagnostics.empty(); }) ? ScriptErrors : Success;
+   }
+
+   // ------------------------------ PROTECTED METHODS -----------------------------
+
+   /// <summary>Gets the path a compiled script is written to, mirroring its sub-folder within the input folder.</summary>
+   /// <param name="script">Script path</param>
+   /// <returns></returns>
+   /// <remarks>Recursive searches may find several scripts with the same name, these must not overwrite each other</remarks>
+   Path  BatchCompiler::GetOutputPath(const Path& script) const
+   {
+      wstring input = Options.ScriptFolder.AppendBackslash().c_str(),
+              relative = script.c_str();
+
+      // Strip input folder, if present
+      if (relative.length() > input.length() && _wcsnicmp(relative.c_str(), input.c_str(), input.length()) == 0)
+         relative.erase(0, input.length());
+      else
+         relative = script.FileName;
+
+      return Options.OutputFolder.AppendBackslash() + relative;
+   }
+
+   /// <summary>Loads the game data then builds the scripts of a project that have changed since it was last built.</summary>
+   /// <returns>Process exit code</returns>
+   BatchCompiler::ExitCode  BatchCompiler::Build()
+   {
+      try
+      {
+         WorkerData     data(Operation::NoFeedback);
+         TaskScheduler  scheduler(Options.Threads);
+         UINT           failed = 0;
+
+         // Load game data once, shared by all workers
+         LoadGameData();
+
+         // Build
+         Stopwatch timer;
+         wcout << VString(L"Building project %s...", Options.ScriptFolder.c_str()) << endl;
+
+         ProjectBuilder builder(Options.ScriptFolder, Options.CacheFolder, Options.GameFolder, Options.Version, Options.Language, Options.Compile);
+         builder.Build(scheduler, Options.OutputFolder, &data);
+
+         // Diagnostics: Rebuilt + cached
+         for (const auto& pair : builder.Results)
+         {
+            const auto& e = pair.second;
+            for (const auto& d : e.Diagnostics)
+               PrintDiagnostic(e.FullPath, d.Line, d.Message, d.Text);
+
+            if (!e.IsSuccessful())
+               ++failed;
+         }
+
+         // Summary
+         wcout << VString(L"%d scripts rebuilt (%d due to script-call changes), %d up to date, %d failed, in %.0fms", 
+                          builder.Rebuilt, builder.Invalidated, builder.Reused, failed, timer.ElapsedMilliseconds) << endl;
+
+         // Success if no script reported errors
+         return failed ? ScriptErrors : Success;
+      }
+      catch (ExceptionBase& e)
+      {
+         wcerr << L"error: " << e.Message.c_str() << L"  (" << e.Source.c_str() << L")" << endl;
+         return Fatal;
+      }
+   }
+
+   /// <summary>Finds the scripts within a folder, optionally recursing into sub-folders.</summary>
+   /// <param name="folder">The folder.</param>
+   /// <exception cref="Logic::IOException">I/O error occurred</exception>
+   void  BatchCompiler::EnumerateScripts(const Path& folder)
+   {
+      for (FileSearch fs(folder.AppendBackslash() + L"*.*"); fs.HasResult(); fs.Next())
+      {
+         // Skip self/parent
+         if (fs.FileName == L"." || fs.FileName == L"..")
+            continue;
+
+         // Recurse into folders
+         if (fs.IsDirectory())
+         {
+            if (Options.Recursive)
+               EnumerateScripts(fs.FullPath);
+         }
+         // Add scripts
+         else if (fs.FullPath.HasExtension(L".pck") || fs.FullPath.HasExtension(L".xml"))
+            Results.push_back(ScriptResult(fs.FullPath));
+      }
+   }
+
+   /// <summary>Loads the game data from the game folder.</summary>
+   /// <exception cref="Logic::ComException">COM error</exception>
+   /// <exception cref="Logic::FileFormatException">Corrupt XML / Missing elements / missing attributes</exception>
+   /// <exception cref="Logic::InvalidOperationException">Missing game data</exception>
+   /// <exception cref="Logic::IOException">An I/O error occurred</exception>
+   void  BatchCompiler::LoadGameData()
+   {
+      WorkerData  data(Operation::NoFeedback);
+      Stopwatch   timer;
+
+      wcout << L"Loading " << VersionString(Options.Version).c_str() << L" game data from " << Options.GameFolder.c_str() << L"..." << endl;
+
+      // Load directly on this thread
+      GameDataWorker::Load(Options.GameFolder, Options.Version, Options.Language, &data);
+
+      wcout << VString(L"Game data loaded in %.0fms", timer.ElapsedMilliseconds) << endl;
+   }
+
+   /// <summary>Prints the diagnostics in file order followed by a timing summary.</summary>
+   void  BatchCompiler::PrintResults()
+   {
+      const WCHAR* phases[4] = { L"Read", L"Parse", L"Compile", L"Write" };
+      LONGLONG  totals[4] = { 0LL, 0LL, 0LL, 0LL };
+      LARGE_INTEGER freq;
+      UINT  failed = 0;
+
+      // Diagnostics: Canonical 'file(line): error: message' format
+      for (const auto& r : Results)
+      {
+         for (const auto& d : r.Diagnostics)
+            PrintDiagnostic(r.FullPath, d.Line, d.Message, d.Text);
+
+         // Accumulate timings
+         for (UINT i = 0; i < 4; ++i)
+            totals[i] += r.Timings[i];
+
+         if (!r.Diagnostics.empty())
+            ++failed;
+      }
+
+      // Summary
+      QueryPerformanceFrequency(&freq);
+      wcout << VString(L"%d scripts processed, %d failed, using %d threads", Results.size(), failed, Options.Threads) << endl;
+      
+      for (UINT i = 0; i < 4; ++i)
+         wcout << VString(L"  %-8s %10.1fms", phases[i], (totals[i] * 1000.0) / freq.QuadPart) << endl;
+   }
+
+   /// <summary>Reads, parses, verifies and (optionally) compiles and writes a single script.</summary>
+   /// <param name="r">Script result to populate</param>
+   void  BatchCompiler::ProcessScript(ScriptResult& r)
+   {
+      Stopwatch timer;
+      Phase     phase = Phase::Read;
+
+      try
+      {
+         LineArray lines;
+
+         // Read
+         auto script = ScriptFileReader(XFileInfo(r.FullPath).OpenRead()).ReadFile(r.FullPath, false);
+         for (const auto& cmd : script.Commands.Input)
+            lines.push_back(cmd.Text);
+         r.Timings[(UINT)phase] = timer.ElapsedTicks;
+
+         // Parse + Verify
+         timer.Restart();
+         phase = Phase::Parse;
+         ScriptParser parser(script, lines, Options.Version);
+         r.Timings[(UINT)phase] = timer.ElapsedTicks;
+
+         // Failed: Copy errors
+         if (!parser.Successful)
+         {
+            for (const auto& err : parser.Errors)
+               r.Diagnostics.push_back(Diagnostic(err.Line, err.Message, err.Text));
+            return;
+         }
+
+         // Verify only: Done
+         if (!Options.Compile)
+            return;
+
+         // Compile: Serialized, the code generator uses shared state 
+         timer.Restart();
+         phase = Phase::Compile;
+         CompileLock.Enter();
+         try
+         {
+            parser.Compile();
+            CompileLock.Leave();
+         }
+         catch (...) {
+            CompileLock.Leave();
+            throw;
+         }
+         r.Timings[(UINT)phase] = timer.ElapsedTicks;
+
+         // Write (optional)
+         if (Options.IsWriteEnabled())
+         {
+            timer.Restart();
+            phase = Phase::Write;
+            Path target = GetOutputPath(r.FullPath);
+
+            // Ensure sub-folder exists
+            switch (auto res = SHCreateDirectory(nullptr, target.Folder.c_str()))
+            {
+            case ERROR_SUCCESS:
+            case ERROR_ALREADY_EXISTS:
+            case ERROR_FILE_EXISTS:
+               break;
+            default:
+               throw IOException(HERE, SysErrorString(res));
+            }
+
+            ScriptFileWriter w(XFileInfo(target).OpenWrite());
+            w.Write(script);
+            w.Close();
+            r.Timings[(UINT)phase] = timer.ElapsedTicks;
+         }
+      }
+      catch (ExceptionBase& e)
+      {
+         r.Timings[(UINT)phase] = timer.ElapsedTicks;
+         r.Diagnostics.push_back(Diagnostic(0, e.Message, L""));
+      }
+      catch (_com_error& e)
+      {
+         r.Timings[(UINT)phase] = timer.ElapsedTicks;
+         r.Diagnostics.push_back(Diagnostic(0, ComException(HERE, e).Message, L""));
+      }
+      catch (std::exception& e)
+      {
+         r.Timings[(UINT)phase] = timer.ElapsedTicks;
+         r.Diagnostics.push_back(Diagnostic(0, GuiString::Convert(e.what(), CP_ACP), L""));
+      }
+   }
+
+   /// <summary>Processes all enumerated scripts concurrently, one task per script.</summary>
+   /// <exception cref="Logic::ComException">Unable to initialize COM on a worker thread</exception>
+   void  BatchCompiler::ProcessScripts()
+   {
+      TaskScheduler  scheduler(Options.Threads);
+      TaskArray      tasks;
+      Stopwatch      timer;
+
+      wcout << VString(L"Processing %d scripts from %s...", Results.size(), Options.ScriptFolder.c_str()) << endl;
+
+      // Process each script on a worker.  Errors are recorded as diagnostics
+      for (auto& r : Results)
+         tasks.push_back(scheduler.Run([this,&r] (const CancellationToken&) -> DWORD 
+         {
+            ComThreadHelper COM;    // MSXML
+            ProcessScript(r);
+            return 0;
+         }));
+
+      // Wait for completion 
+      scheduler.WaitAll(tasks);
+
+      wcout << VString(L"Processing completed in %.0fms", timer.ElapsedMilliseconds) << endl;
+   }
+
+   // ------------------------------- PRIVATE METHODS ------------------------------
+
+}
+
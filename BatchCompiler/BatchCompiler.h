@@ -0,0 +1,87 @@
+#pragma once
+#include "BatchOptions.h"
+#include "../Logic/Stopwatch.h"
+#include "../Logic/CriticalSection.h"
+
+namespace Compiler
+{
+   /// <summary>Verifies and compiles a folder of scripts, or builds a project, without the user interface</summary>
+   class BatchCompiler
+   {
+      // ------------------------ TYPES --------------------------
+   public:
+      /// <summary>Process exit codes</summary>
+      enum ExitCode : int { Success = 0, ScriptErrors = 1, Fatal = 2 };
+
+      /// <summary>Processing phases timed by the compiler</summary>
+      enum class Phase : UINT { Read, Parse, Compile, Write };
+
+   protected:
+      /// <summary>Error reported against a script</summary>
+      class Diagnostic
+      {
+      public:
+         Diagnostic(UINT line, const wstring& msg, const wstring& txt) : Line(line), Message(msg), Text(txt)
+         {}
+
+         UINT     Line;      // 1-based line number  [zero if not applicable]
+         wstring  Message,   // Error message
+                  Text;      // Offending text
+      };
+
+      /// <summary>Result of processing a single script</summary>
+      class ScriptResult
+      {
+      public:
+         ScriptResult(const Path& p) : FullPath(p)
+         {
+            for (auto& t : Timings)
+               t = 0LL;
+         }
+
+         Path                FullPath;       // Script path
+         list<Diagnostic>    Diagnostics;    // Errors, if any
+         LONGLONG            Timings[4];     // Ticks spent in each phase
+      };
+
+      typedef vector<ScriptResult>  ResultArray;
+
+      // --------------------- CONSTRUCTION ----------------------
+   public:
+      BatchCompiler(const BatchOptions& opt);
+      virtual ~BatchCompiler();
+
+      NO_COPY(BatchCompiler);	// No copy semantics
+      NO_MOVE(BatchCompiler);	// No move semantics
+
+      // ------------------------ STATIC -------------------------
+   protected:
+      static void  PrintDiagnostic(const Path& path, UINT line, const wstring& msg, const wstring& txt);
+
+      // ---------------------- ACCESSORS ------------------------
+   protected:
+      Path  GetOutputPath(const Path& script) const;
+
+      // ----------------------- MUTATORS ------------------------
+   public:
+      ExitCode  Benchmark();
+      ExitCode  Run();
+
+   protected:
+      ExitCode  Build();
+      void      EnumerateScripts(const Path& folder);
+      void      LoadGameData();
+      void      PrintResults();
+      void      ProcessScript(ScriptResult& r);
+      void      ProcessScripts();
+
+      // -------------------- REPRESENTATION ---------------------
+   protected:
+      const BatchOptions&  Options;
+      ResultArray          Results;       // One result per script, in enumeration order
+      CriticalSection      CompileLock;   // Serializes the compile phase
+   };
+
+}
+
+using namespace Compiler;
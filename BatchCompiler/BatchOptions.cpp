@@ -0,0 +1,176 @@
+#include "stdafx.h"
+#include "BatchOptions.h"
+#include "HostPlatform.h"
+
+namespace Compiler
+{
+   // -------------------------------- CONSTRUCTION --------------------------------
+
+   /// <summary>Parses the command line</summary>
+   /// <param name="argc">Argument count</param>
+   /// <param name="argv">Arguments</param>
+   /// <exception cref="Logic::ArgumentException">Missing or invalid argument</exception>
+   BatchOptions::BatchOptions(int argc, wchar* argv[])
+      : Version(GameVersion::TerranConflict), 
+        Language(GameLanguage::English), 
+        Threads(0), 
+        CorpusSize(200), 
+        Iterations(3), 
+        Benchmark(false), 
+        Compile(true), 
+        Recursive(false)
+   {
+      SYSTEM_INFO info;
+
+      // Parse switches
+      for (int i = 1; i < argc; ++i)
+      {
+         GuiString arg(argv[i]);
+         
+         // Switch: Ensure value present where necessary
+         auto next = [&]() -> wstring 
+         {
+            if (i+1 >= argc)
+               throw ArgumentException(HERE, arg, L"Missing value for switch");
+            return argv[++i];
+         };
+
+         if (arg.Equals(L"-game"))
+            GameFolder = HostPlatform::ToNativePath(next());
+         else if (arg.Equals(L"-version"))
+            Version = ParseVersion(next());
+         else if (arg.Equals(L"-language"))
+            Language = ParseLanguage(next());
+         else if (arg.Equals(L"-out"))
+            OutputFolder = HostPlatform::ToNativePath(next());
+         else if (arg.Equals(L"-cache"))
+            CacheFolder = HostPlatform::ToNativePath(next());
+         else if (arg.Equals(L"-threads"))
+            Threads = GuiString(next()).ToInt();
+         else if (arg.Equals(L"-verify"))
+            Compile = false;
+         else if (arg.Equals(L"-recursive"))
+            Recursive = true;
+         else if (arg.Equals(L"-benchmark"))
+            Benchmark = true;
+         else if (arg.Equals(L"-size"))
+            CorpusSize = GuiString(next()).ToInt();
+         else if (arg.Equals(L"-iterations"))
+            Iterations = GuiString(next()).ToInt();
+         else if (arg.Equals(L"-results"))
+            ResultsPath = HostPlatform::ToNativePath(next());
+         else if (arg.Left(1) == L"-")
+            throw ArgumentException(HERE, arg, L"Unrecognised switch");
+         // Positional: Script folder
+         else if (ScriptFolder.Empty())
+            ScriptFolder = HostPlatform::ToNativePath(arg);
+         else
+            throw ArgumentException(HERE, arg, L"Only one script folder may be specified");
+      }
+
+      // Validate
+      if (ScriptFolder.Empty())
+         throw ArgumentException(HERE, L"folder", L"No script folder specified");
+      
+      // Benchmark: Corpus folder doubles as the game folder
+      if (Benchmark)
+      {
+         if (ResultsPath.Empty())
+            ResultsPath = ScriptFolder.AppendBackslash() + L"results.json";
+         if (CorpusSize == 0)
+            throw ArgumentException(HERE, L"-size", L"Corpus must contain at least one script");
+         return;
+      }
+
+      if (GameFolder.Empty())
+         throw ArgumentException(HERE, L"-game", L"No game data folder specified");
+      if (IsWriteEnabled() && !Compile)
+         throw ArgumentException(HERE, L"-out", L"Cannot write output when only verifying");
+
+      // Project: Cache beside project by default
+      if (IsProject() && CacheFolder.Empty())
+         CacheFolder = ScriptFolder.RenameExtension(L".build");
+      
+      // Default: One thread per processor
+      if (Threads == 0)
+      {
+         GetSystemInfo(&info);
+         Threads = max(1UL, info.dwNumberOfProcessors);
+      }
+   }
+
+   BatchOptions::~BatchOptions()
+   {
+   }
+
+   // ------------------------------- STATIC METHODS -------------------------------
+
+   /// <summary>Gets the command line usage.</summary>
+   /// <returns></returns>
+   const wchar*  BatchOptions::GetUsage()
+   {
+      return L"Usage: XStudio2.Compiler <folder>|<project> -game <folder> [options]\n"
+             L"\n"
+             L"  <folder>             Folder containing the .pck/.xml scripts to process\n"
+             L"  <project>            Project (.xprj) to build.  Only scripts that changed, or call scripts whose\n"
+             L"                       arguments changed, are rebuilt\n"
+             L"  -game <folder>       Game folder to load game data from\n"
+             L"  -version <ver>       Game data version: X3R, X3TC or X3AP  (default X3TC)\n"
+             L"  -language <lang>     Game data language  (default English)\n"
+             L"  -out <folder>        Write compiled scripts to this folder, mirroring sub-folders\n"
+             L"  -threads <n>         Number of worker threads  (default one per processor)\n"
+             L"  -verify              Parse and verify only, do not compile\n"
+             L"  -recursive           Include scripts in sub-folders\n"
+             L"  -cache <folder>      Project build cache  (default <project>.build)\n"
+             L"\n"
+             L"Usage: XStudio2.Compiler <folder> -benchmark [options]\n"
+             L"\n"
+             L"  <folder>             Folder to generate the synthetic benchmark corpus in\n"
+             L"  -size <n>            Number of corpus scripts  (default 200)\n"
+             L"  -iterations <n>      Number of times each benchmark is run  (default 3)\n"
+             L"  -results <file>      JSON results file  (default <folder>\\results.json)\n"
+             L"\n"
+             L"Exit codes: 0 = Success, 1 = Script errors, 2 = Invalid arguments or game data\n";
+   }
+
+   /// <summary>Parses a game language name.</summary>
+   /// <param name="str">Language name</param>
+   /// <returns></returns>
+   /// <exception cref="Logic::ArgumentException">Unrecognised language</exception>
+   GameLanguage  BatchOptions::ParseLanguage(const wstring& str)
+   {
+      // Compare against language names
+      for (UINT i = 0; i < 8; ++i)
+      {
+         GameLanguageIndex lang(i);
+         if (GuiString(GetString(lang.Language)).Equals(str))
+            return lang.Language;
+      }
+
+      throw ArgumentException(HERE, L"-language", VString(L"Unrecognised game language '%s'", str.c_str()));
+   }
+
+   /// <summary>Parses a game version acronym.</summary>
+   /// <param name="str">Version acronym</param>
+   /// <returns></returns>
+   /// <exception cref="Logic::ArgumentException">Unrecognised or unsupported version</exception>
+   GameVersion  BatchOptions::ParseVersion(const wstring& str)
+   {
+      GameVersion versions[3] = { GameVersion::Reunion, GameVersion::TerranConflict, GameVersion::AlbionPrelude };
+
+      // Compare against acronyms
+      for (auto v : versions)
+         if (GuiString(VersionString(v, true)).Equals(str))
+            return v;
+
+      throw ArgumentException(HERE, L"-version", VString(L"Unrecognised game version '%s'", str.c_str()));
+   }
+
+   // ------------------------------- PUBLIC METHODS -------------------------------
+
+   // ------------------------------ PROTECTED METHODS -----------------------------
+
+   // ------------------------------- PRIVATE METHODS ------------------------------
+
+}
+
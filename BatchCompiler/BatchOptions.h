@@ -0,0 +1,50 @@
+#pragma once
+
+namespace Compiler
+{
+   /// <summary>Command line options for the batch compiler</summary>
+   class BatchOptions
+   {
+      // ------------------------ TYPES --------------------------
+   protected:
+      // --------------------- CONSTRUCTION ----------------------
+   public:
+      BatchOptions(int argc, wchar* argv[]);
+      virtual ~BatchOptions();
+
+      DEFAULT_COPY(BatchOptions);	// Default copy semantics
+      DEFAULT_MOVE(BatchOptions);	// Default move semantics
+
+      // ------------------------ STATIC -------------------------
+   public:
+      static const wchar*  GetUsage();
+
+   protected:
+      static GameLanguage  ParseLanguage(const wstring& str);
+      static GameVersion   ParseVersion(const wstring& str);
+
+      // ---------------------- ACCESSORS ------------------------
+   public:
+      bool  IsProject() const        { return ScriptFolder.HasExtension(L".xprj"); }
+      bool  IsWriteEnabled() const   { return !OutputFolder.Empty(); }
+
+      // -------------------- REPRESENTATION ---------------------
+   public:
+      Path          ScriptFolder,     // Folder containing scripts to compile, project file to build, or benchmark corpus folder
+                    GameFolder,       // Folder containing the game data
+                    OutputFolder,     // Folder to write compiled scripts to [optional]
+                    CacheFolder,      // Folder containing the project build cache
+                    ResultsPath;      // Benchmark results file
+      GameVersion   Version;          // Game data version
+      GameLanguage  Language;         // Game data language
+      UINT          Threads,          // Number of worker threads
+                    CorpusSize,       // Number of benchmark corpus scripts
+                    Iterations;       // Number of benchmark iterations
+      bool          Benchmark,        // Whether to run the benchmarks instead of compiling
+                    Compile,          // Whether to compile after verification
+                    Recursive;        // Whether to search sub-folders
+   };
+
+}
+
+using namespace Compiler;
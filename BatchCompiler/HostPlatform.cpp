@@ -0,0 +1,79 @@
+#include "stdafx.h"
+#include "HostPlatform.h"
+#include <fcntl.h>
+#include <io.h>
+
+namespace Compiler
+{
+   /// <summary>Wine: Converts a Unix path to a DOS path, allocated from the process heap</summary>
+   typedef WCHAR* (CDECL *DosFileNameFunc)(const char* path);
+
+   /// <summary>Wine: Converts a DOS path to a Unix path, allocated from the process heap</summary>
+   typedef char* (CDECL *UnixFileNameFunc)(const WCHAR* path);
+
+   // ------------------------------- STATIC METHODS -------------------------------
+
+   /// <summary>Prepares the standard output streams for the host.</summary>
+   /// <remarks>Linux terminals and pipes expect UTF-8 rather than the console code page, so wide output is written as UTF-8 under Wine</remarks>
+   void  HostPlatform::InitConsole()
+   {
+      if (IsWine())
+      {
+         _setmode(_fileno(stdout), _O_U8TEXT);
+         _setmode(_fileno(stderr), _O_U8TEXT);
+      }
+   }
+
+   /// <summary>Determines whether the process is running under Wine.</summary>
+   /// <returns></returns>
+   bool  HostPlatform::IsWine()
+   {
+      return GetProcAddress(GetModuleHandle(L"ntdll.dll"), "wine_get_version") != nullptr;
+   }
+
+   /// <summary>Converts a native path into the form the host expects.  Under Wine this is the Unix path.</summary>
+   /// <param name="path">Native path</param>
+   /// <returns>Unix path under Wine, otherwise the path unchanged</returns>
+   wstring  HostPlatform::ToHostPath(const Path& path)
+   {
+      if (!IsWine())
+         return path.c_str();
+
+      // Lookup conversion
+      auto convert = (UnixFileNameFunc)GetProcAddress(GetModuleHandle(L"kernel32.dll"), "wine_get_unix_file_name");
+      char* str = convert ? convert(path.c_str()) : nullptr;
+
+      // Unmapped drive: Use as-is
+      if (!str)
+         return path.c_str();
+
+      // Convert + release Wine buffer
+      wstring host = GuiString::Convert(string(str), CP_UTF8);
+      HeapFree(GetProcessHeap(), 0, str);
+      return host;
+   }
+
+   /// <summary>Converts a path supplied on the command line into a native path.  Under Wine, absolute Unix paths are mapped onto their DOS drive.</summary>
+   /// <param name="path">Command line path</param>
+   /// <returns>DOS path for an absolute Unix path under Wine, otherwise the path unchanged</returns>
+   /// <remarks>Wine resolves relative paths with forward slashes itself, but treats '/home/...' as relative to the current drive</remarks>
+   Path  HostPlatform::ToNativePath(const wstring& path)
+   {
+      if (!IsWine() || path.empty() || path[0] != L'/')
+         return path;
+
+      // Lookup conversion
+      auto convert = (DosFileNameFunc)GetProcAddress(GetModuleHandle(L"kernel32.dll"), "wine_get_dos_file_name");
+      WCHAR* dos = convert ? convert(GuiString::Convert(path, CP_UTF8).c_str()) : nullptr;
+
+      // Unmapped: Use as-is
+      if (!dos)
+         return path;
+
+      // Copy + release Wine buffer
+      Path native(dos);
+      HeapFree(GetProcessHeap(), 0, dos);
+      return native;
+   }
+
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+namespace Compiler
+{
+   /// <summary>Isolates the differences between running natively on Windows and running under Wine on Linux</summary>
+   /// <remarks>Under Wine the command line carries Unix paths, and the output is read by Linux tools that expect them</remarks>
+   class HostPlatform
+   {
+      // --------------------- CONSTRUCTION ----------------------
+   private:
+      HostPlatform();   // Static class
+
+      // ------------------------ STATIC -------------------------
+   public:
+      static void     InitConsole();
+      static bool     IsWine();
+      static wstring  ToHostPath(const Path& path);
+      static Path     ToNativePath(const wstring& path);
+   };
+
+}
+
+using namespace Compiler;
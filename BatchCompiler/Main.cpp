@@ -0,0 +1,54 @@
+// Main.cpp : Entry point for the command line batch compiler
+//
+
+#include "stdafx.h"
+#include "BatchCompiler.h"
+#include "HostPlatform.h"
+
+/// <summary>Minimal application object, provides the resource library, registry key and COM initialization used by the logic library</summary>
+class BatchApp : public AppBase
+{
+public:
+   BatchApp()
+   {}
+};
+
+/// <summary>The application object</summary>
+BatchApp theApp;
+
+/// <summary>Entry point</summary>
+/// <param name="argc">Argument count</param>
+/// <param name="argv">Arguments</param>
+/// <returns>Exit code: 0 = Success, 1 = Script errors, 2 = Invalid arguments or game data</returns>
+int wmain(int argc, wchar* argv[])
+{
+   // Linux/Wine: Write UTF-8
+   HostPlatform::InitConsole();
+
+   // Init MFC + base app (resources, COM)
+   if (!AfxWinInit(GetModuleHandle(nullptr), nullptr, GetCommandLine(), SW_HIDE) || !theApp.InitInstance())
+   {
+      wcerr << L"error: Unable to initialize application" << endl;
+      return BatchCompiler::Fatal;
+   }
+
+   int result = BatchCompiler::Fatal;
+   try
+   {
+      // Parse command line
+      BatchOptions options(argc, argv);
+
+      // Verify/Compile or Benchmark
+      BatchCompiler compiler(options);
+      result = options.Benchmark ? compiler.Benchmark() : compiler.Run();
+   }
+   catch (ArgumentException& e)
+   {
+      wcerr << L"error: " << e.Message.c_str() << endl << endl << BatchOptions::GetUsage();
+   }
+
+   // Cleanup
+   theApp.ExitInstance();
+   return result;
+}
+
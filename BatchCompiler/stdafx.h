@@ -0,0 +1,58 @@
+
+// stdafx.h : include file for standard system include files,
+// or project specific include files that are used frequently,
+// but are changed infrequently
+
+#pragma once
+
+// Exclude rarely-used stuff from Windows headers
+#ifndef VC_EXTRALEAN
+#define VC_EXTRALEAN            
+#endif
+
+#include "../targetver.h"
+
+// Tweaks
+#define _ATL_CSTRING_EXPLICIT_CONSTRUCTORS        // some CString constructors will be explicit
+#define _AFX_ALL_WARNINGS     // turns off MFC's hiding of some common and often safely ignored warning messages
+
+ 
+// MFC
+#include <afxwin.h>              // MFC core and standard components
+#include <afxext.h>              // MFC extensions
+
+
+// STL
+#include <string>
+#include <vector>
+#include <deque>
+#include <list>
+#include <set>
+#include <map>
+#include <memory>    // shared/unique ptr
+#include <algorithm>
+#include <iostream>  // wcout/wcerr
+using namespace std;
+
+/// <summary>BugFix for Release version optimizing away [w]string::npos</summary>
+/// <remarks>See https://connect.microsoft.com/VisualStudio/feedback/details/586959/std  (Bug 586959) for details</remarks>
+#if _MSC_VER >= 1600 && _MSC_VER < 1900
+const wstring::size_type wstring::npos = (wstring::size_type) -1;
+#endif
+
+// COM
+#include <comdef.h>
+
+// Utilities
+#undef _UTIL_LIB
+#undef _LOGIC_DLL
+#include "../Utils/Utils.h"
+#include "../Logic/ConsoleWnd.h"
+#include "../Logic/AppBase.h"
+
+// Preferences
+#include "../Logic/PreferencesLibrary.h"
+
+// Import Resource IDs 
+#include "../Resources/Resources.h"
+
@@ -3,6 +3,7 @@
 #include "ProjectDocument.h"
 #include "afxdialogex.h"
 #include "../Logic/ZipFile.h"
+#include "../Logic/CatalogWriter.h"
 
 /// <summary>User interface</summary>
 NAMESPACE_BEGIN2(GUI,Windows)
@@ -16,6 +17,7 @@ NAMESPACE_BEGIN2(GUI,Windows)
       ON_BN_CLICKED(IDC_ZIP_RADIO, OnOptionChanged)
       ON_BN_CLICKED(IDC_SPK_RADIO, OnOptionChanged)
       ON_BN_CLICKED(IDC_FOLDER_RADIO, OnOptionChanged)
+      ON_BN_CLICKED(IDC_CATALOG_RADIO, OnOptionChanged)
    END_MESSAGE_MAP()
    
    // -------------------------------- CONSTRUCTION --------------------------------
@@ -65,12 +67,12 @@ NAMESPACE_BEGIN2(GUI,Windows)
          // Get data
          UpdateData(TRUE);
 
-         // Require folder [+ filename for zip)
-         if (Folder.Empty() || (Option == OPTION_ZIP && FileName.Empty()))
+         // Require folder [+ filename for zip/catalog)
+         if (Folder.Empty() || (Option != OPTION_FOLDER && FileName.Empty()))
             return;
 
          // Feedback
-         Console << Cons::UserAction << "Exporting project to " << (Option == OPTION_ZIP ? Folder+FileName : Folder) << ENDL;
+         Console << Cons::UserAction << "Exporting project to " << (Option != OPTION_FOLDER ? Folder+FileName : Folder) << ENDL;
 
          // Check folder exists
          if (!Folder.Exists())
@@ -160,8 +162,8 @@ NAMESPACE_BEGIN2(GUI,Windows)
          // ZIP: Add all files to archive
          if (Option == OPTION_ZIP)
          {
-            // Create zip
-            ZipFile zip(Folder+FileName);
+            // Create zip  [Compress entries concurrently]
+            ZipFile zip(Folder+FileName, CompressionOptions::Parallel());
 
             // Add files to ZIP
             for (auto& f : files)
@@ -170,9 +172,25 @@ NAMESPACE_BEGIN2(GUI,Windows)
                zip.Add(f.FullPath, f.SubPath.c_str());
             }
 
-            // Close
+            // Compress + write archive
             zip.Close();
          }
+         // CATALOG: Pack all files into a catalog
+         else if (Option == OPTION_CATALOG)
+         {
+            // Create catalog + data file
+            CatalogWriter cat(Folder+FileName);
+
+            // Add files to catalog
+            for (auto& f : files)
+            {
+               Console << "Packing " << f.FullPath << " to " << f.SubPath << ENDL;
+               cat.Add(f.FullPath, f.SubPath.c_str());
+            }
+
+            // Write catalog
+            cat.Close();
+         }
          // FILES: Copy all files to a folder
          else if (Option == OPTION_FOLDER)
          {
@@ -229,8 +247,8 @@ NAMESPACE_BEGIN2(GUI,Windows)
       // Get data
       UpdateData(TRUE);
 
-      // Only 'Filename' only for archive mode
-      GetDlgItem(IDC_FILENAME_EDIT)->EnableWindow(Option == OPTION_ZIP ? TRUE : FALSE);
+      // Only 'Filename' only for archive/catalog mode
+      GetDlgItem(IDC_FILENAME_EDIT)->EnableWindow(Option != OPTION_FOLDER ? TRUE : FALSE);
    }
    
    // ------------------------------- PRIVATE METHODS ------------------------------
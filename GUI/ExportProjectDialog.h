@@ -69,7 +69,8 @@ NAMESPACE_BEGIN2(GUI,Windows)
    protected:
       const static UINT OPTION_ZIP = 0,
                         OPTION_SPK = 1,
-                        OPTION_FOLDER = 2;
+                        OPTION_FOLDER = 2,
+                        OPTION_CATALOG = 3;
 
       Path  FileName,
             Folder;
@@ -24,7 +24,8 @@ NAMESPACE_BEGIN2(GUI,Preferences)
         GameDataFolder(nullptr), 
         GameDataLanguage(nullptr),
         GameDataVersion(nullptr), 
-        SkipBrokenFiles(nullptr)
+        SkipBrokenFiles(nullptr),
+        RetainShadowedStrings(nullptr)
    {
    }
 
@@ -65,6 +66,7 @@ NAMESPACE_BEGIN2(GUI,Preferences)
       // Game Data
       PrefsLib.GameDataFolder = GameDataFolder->GetFolder();
       PrefsLib.SkipBrokenFiles = SkipBrokenFiles->GetBool();
+      PrefsLib.RetainShadowedStrings = RetainShadowedStrings->GetBool();
       PrefsLib.GameDataLanguage = GameDataLanguage->GetLanguage();
       PrefsLib.GameDataVersion = GameDataVersion->GetVersion();
 
@@ -85,6 +87,7 @@ NAMESPACE_BEGIN2(GUI,Preferences)
       group = new PropertyBase(*this, L"Game Data");
       group->AddSubItem(GameDataFolder = new GameDataFolderProperty(*this));
       group->AddSubItem(SkipBrokenFiles = new SkipBrokenFilesProperty(*this));
+      group->AddSubItem(RetainShadowedStrings = new RetainShadowedStringsProperty(*this));
       group->AddSubItem(GameDataLanguage = new GameLanguageProperty(*this));
       group->AddSubItem(GameDataVersion = new GameVersionProperty(*this));
       Grid.AddProperty(group);
@@ -120,6 +120,18 @@ NAMESPACE_BEGIN2(GUI,Preferences)
          }
       };
       
+      /// <summary>RetainShadowedStrings property</summary>
+      class RetainShadowedStringsProperty : public BooleanProperty
+      {
+         // --------------------- CONSTRUCTION ----------------------
+      public:
+         /// <summary>Create 'retain shadowed strings' property</summary>
+         /// <param name="page">Owner page.</param>
+         RetainShadowedStringsProperty(PreferencesPage& page) 
+            : BooleanProperty(page, L"Keep Overridden Strings", PrefsLib.RetainShadowedStrings, L"Keep strings overridden by higher priority language files, so the string library editor can display them when a file is excluded. Uses more memory")
+         {}
+      };
+
       /// <summary>SkipBrokenFiles property</summary>
       class SkipBrokenFilesProperty : public PropertyBase
       {
@@ -201,6 +213,7 @@ NAMESPACE_BEGIN2(GUI,Preferences)
       // -------------------- REPRESENTATION ---------------------
    protected:
       SkipBrokenFilesProperty* SkipBrokenFiles;
+      RetainShadowedStringsProperty* RetainShadowedStrings;
       GameDataFolderProperty*  GameDataFolder;
       GameLanguageProperty*    GameDataLanguage;
       GameVersionProperty*     GameDataVersion;
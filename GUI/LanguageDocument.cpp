@@ -9,7 +9,7 @@
 #include "LanguagePageView.h"
 #include "PropertiesWnd.h"
 #include "../Logic/XFileInfo.h"
-#include "../Logic/LanguageFileReader.h"
+#include "../Logic/GZipStream.h"
 #include "../Logic/LanguageFileWriter.h"
 #include "../Logic/FileIdentifier.h"
 #include "../Logic/WorkerData.h"
@@ -340,9 +340,9 @@ NAMESPACE_BEGIN2(GUI,Documents)
          }
          else
          {  
-            // Parse input file
+            // Index input file.  Strings are parsed when each page is first displayed
             XFileInfo stream(szPathName);
-            File = LanguageFileReader(stream.OpenRead()).ReadFile(szPathName);
+            File = Index.ReadFile(stream.OpenRead(), szPathName);
          }
 
          // Feedback
@@ -380,8 +380,11 @@ NAMESPACE_BEGIN2(GUI,Documents)
          if (GuiString(L"String Library") == szPathName)
             throw InvalidOperationException(HERE, L"Cannot save string library");
       
-         // Write contents
-         LanguageFileWriter w(XFileInfo(FullPath).OpenWrite());
+         // Parse pages not yet displayed
+         Index.LoadAll(File.Pages);
+
+         // Write contents  [Compress large .pck files in parallel]
+         LanguageFileWriter w(XFileInfo(FullPath).OpenWrite(L"", CompressionOptions::Parallel()));
          w.Write(File);
          w.Close();
 
@@ -440,6 +443,9 @@ NAMESPACE_BEGIN2(GUI,Documents)
       LanguagePage newPage(page);
       newPage.ID = newID;
 
+      // Strings not yet loaded: Load under new ID
+      Index.Rename(page.ID, newID);
+
       // Remove/Re-Insert
       RemovePage(page.ID);
       InsertPage(newPage);
@@ -488,11 +494,18 @@ NAMESPACE_BEGIN2(GUI,Documents)
       // Select+Display page
       //SelectedPageIndex = Content.IndexOf(page);
 
+      // Clear selection, if removing selected page
+      if (CurrentPage && CurrentPage->ID == page)
+         SelectedPage = nullptr;
+
       // Remove from view first
       GetView<LanguagePageView>()->RemovePage(File.IndexOf(page));
 
       // Remove from languagePage
       File.Remove(page);
+
+      // Discard strings not yet loaded
+      Index.Remove(page);
    }
    
    /// <summary>Removes the string from the appropriate page</summary>
@@ -565,10 +578,16 @@ NAMESPACE_BEGIN2(GUI,Documents)
    /// <summary>Sets the selected page and raises PAGE SELECTION CHANGED.</summary>
    /// <param name="p">The page.</param>
    /// <remarks>Also clears the current button</remarks>
+   /// <exception cref="Logic::ComException">COM Error</exception>
+   /// <exception cref="Logic::FileFormatException">Corrupt XML / Missing elements / missing attributes</exception>
    void  LanguageDocument::SetSelectedPage(LanguagePage* p)
    {
       if (CurrentPage != p)
       {
+         // Parse strings upon first display
+         if (p && !Virtual)
+            Index.Load(*p);
+
          // Set page.  Clear button before updating properties
          CurrentPage = p;
          CurrentButton = nullptr;
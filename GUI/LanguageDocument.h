@@ -1,5 +1,6 @@
 #pragma once
 #include "../Logic/LanguageFile.h"
+#include "../Logic/LanguageFileIndex.h"
 #include "DocumentBase.h"
 #include "DocTemplateBase.h"
 #include "PropertySource.h"
@@ -327,11 +328,12 @@ NAMESPACE_BEGIN2(GUI,Documents)
                              StringUpdated;
 
    protected:
-      EditMode         Mode;             // Current editing mode
-      ButtonData*      CurrentButton;    // Currently selected button
-      LanguageString*  CurrentString;    // Currently selected string
-      LanguagePage*    CurrentPage;      // Currently selected page
-      set<UINT>        Components;       // [LIBRARY] IDs of currently included files
+      EditMode          Mode;             // Current editing mode
+      ButtonData*       CurrentButton;    // Currently selected button
+      LanguageString*   CurrentString;    // Currently selected string
+      LanguagePage*     CurrentPage;      // Currently selected page
+      set<UINT>         Components;       // [LIBRARY] IDs of currently included files
+      LanguageFileIndex Index;            // [FILE] Strings of pages not yet displayed
 };
 
 
@@ -18,6 +18,7 @@ NAMESPACE_BEGIN2(GUI,Views)
       ON_WM_SIZE()
       ON_NOTIFY_REFLECT(LVN_ITEMCHANGED, &LanguageStringView::OnItemStateChanged)
       ON_NOTIFY_REFLECT(NM_CUSTOMDRAW, &LanguageStringView::OnCustomDraw)
+      ON_NOTIFY_REFLECT(LVN_GETDISPINFO, &LanguageStringView::OnRetrieveItem)
       ON_COMMAND(ID_EDIT_CUT, &LanguageStringView::OnCommandEditCut)
       ON_COMMAND(ID_EDIT_COPY, &LanguageStringView::OnCommandEditCopy)
       ON_COMMAND(ID_EDIT_PASTE, &LanguageStringView::OnCommandEditPaste)
@@ -64,17 +65,21 @@ NAMESPACE_BEGIN2(GUI,Views)
    
    /// <summary>Inserts a string.</summary>
    /// <param name="index">The index.</param>
-   /// <param name="str">The string.</param>
+   /// <param name="str">The string, already inserted into the selected page</param>
    /// <param name="display">Whether to ensure visible after insert</param>
+   /// <exception cref="Logic::ArgumentNullException">No page selected</exception>
+   /// <exception cref="Logic::IndexOutOfRangeException">Invalid index</exception>
    void LanguageStringView::InsertString(UINT index, LanguageString& str, bool display)
    {
-      // First display: Identify colour tags 
-      if (str.TagType == ColourTag::Undetermined)
-         str.IdentifyColourTags();
+      REQUIRED(GetDocument()->SelectedPage);
 
-      // Add item, resolve and set Text
-      GetListCtrl().InsertItem(index, VString(L"%d", str.ID).c_str(), 2+GameVersionIndex(str.Version).Index);
-      GetListCtrl().SetItemText(index, 1, str.ResolvedText.c_str());
+      // Validate index
+      if (index > Items.size())
+         throw IndexOutOfRangeException(HERE, index, Items.size());
+
+      // Add item.  Text is supplied on demand
+      Items.insert(Items.begin()+index, &GetDocument()->SelectedPage->Strings.FindByIndex(index));
+      GetListCtrl().SetItemCountEx(Items.size(), LVSICF_NOSCROLL);
 
       // Ensure visible
       if (display)
@@ -86,10 +91,21 @@ NAMESPACE_BEGIN2(GUI,Views)
 
    /// <summary>Removes a string.</summary>
    /// <param name="index">The index.</param>
+   /// <exception cref="Logic::IndexOutOfRangeException">Invalid index</exception>
    void LanguageStringView::RemoveString(UINT index)
    {
-      GetListCtrl().EnsureVisible(index, FALSE);
-      GetListCtrl().DeleteItem(index);
+      // Validate index
+      if (index >= Items.size())
+         throw IndexOutOfRangeException(HERE, index, Items.size());
+
+      // Remove item + selection
+      Items.erase(Items.begin()+index);
+      GetListCtrl().SetItemCountEx(Items.size(), LVSICF_NOSCROLL);
+      GetListCtrl().SetItemState(-1, 0, LVIS_SELECTED);
+
+      // Display neighbouring item
+      if (!Items.empty())
+         GetListCtrl().EnsureVisible(min<UINT>(index, Items.size()-1), FALSE);
    }
 
    /// <summary>Called when activate view.</summary>
@@ -105,6 +121,15 @@ NAMESPACE_BEGIN2(GUI,Views)
       __super::OnActivateView(bActivate, pActivateView, pDeactiveView);
    }
    
+   /// <summary>Creates the list without storage, the items are supplied on demand from the selected page</summary>
+   /// <param name="cs">The create parameters.</param>
+   /// <returns></returns>
+   BOOL LanguageStringView::PreCreateWindow(CREATESTRUCT& cs)
+   {
+      cs.style |= LVS_OWNERDATA;
+      return __super::PreCreateWindow(cs);
+   }
+
    /// <summary>Translates custom accelerators for this window.</summary>
    /// <param name="pMsg">The MSG.</param>
    /// <returns></returns>
@@ -132,13 +157,32 @@ NAMESPACE_BEGIN2(GUI,Views)
       GetListCtrl().SetColumnWidth(1, wnd.Width()-GetListCtrl().GetColumnWidth(0));  //LVSCW_AUTOSIZE_USEHEADER); 
    }
    
+   /// <summary>Retrieves the language string displayed by an item.</summary>
+   /// <param name="index">Zero-based item index</param>
+   /// <returns></returns>
+   /// <exception cref="Logic::IndexOutOfRangeException">Invalid index</exception>
+   /// <remarks>Colour tags are identified when the string is first displayed</remarks>
+   LanguageString&  LanguageStringView::GetItem(UINT index) const
+   {
+      // Validate index
+      if (index >= Items.size())
+         throw IndexOutOfRangeException(HERE, index, Items.size());
+
+      // First display: Identify colour tags 
+      LanguageString& str = *Items[index];
+      if (str.TagType == ColourTag::Undetermined)
+         str.IdentifyColourTags();
+
+      return str;
+   }
+
    /// <summary>Retrieves the language string representing the current selection.</summary>
    /// <returns>Selected string if any, otherwise nullptr</returns>
    /// <exception cref="Logic::IndexOutOfRangeException">Selected item index is invalid</exception>
    LanguageString*   LanguageStringView::GetSelected() const
    {
       int item = GetListCtrl().GetNextItem(-1, LVNI_SELECTED);
-      return item != -1 ? &GetDocument()->SelectedPage->Strings.FindByIndex(item) : nullptr;
+      return item != -1 ? &GetItem(item) : nullptr;
    }
    
    /// <summary>Display context menu.</summary>
@@ -249,32 +293,58 @@ NAMESPACE_BEGIN2(GUI,Views)
    {
       try
       {
-         CWaitCursor c;
-
          // Clear items + selection
+         Items.clear();
          GetListCtrl().DeleteAllItems();
          GetDocument()->SelectedString = nullptr;
 
          // Get selection, if any
-         if (GetDocument()->SelectedPage)
+         if (auto page = GetDocument()->SelectedPage)
          {
-            int item = 0;
-
-            // Freeze
-            GetListCtrl().SetRedraw(FALSE);
+            // Re-Populate strings.  Only visible items are resolved
+            Items.reserve(page->Strings.size());
+            for (auto& pair : page->Strings)
+               Items.push_back(&pair.second);
 
-            // Re-Populate strings
-            for (auto& pair : GetDocument()->SelectedPage->Strings)
-               InsertString(item++, pair.second, false);
+            GetListCtrl().SetItemCountEx(Items.size());
          }
       }
       catch (ExceptionBase& e) {
          Console.Log(HERE, e); 
       }
+   }
+
+   /// <summary>Supplies the icon and text of an item</summary>
+   /// <param name="pNMHDR">Item data.</param>
+   /// <param name="pResult">Notify result.</param>
+   void LanguageStringView::OnRetrieveItem(NMHDR *pNMHDR, LRESULT *pResult)
+   {
+      LVITEM& item = reinterpret_cast<NMLVDISPINFO*>(pNMHDR)->item;
+
+      try
+      {
+         LanguageString& str = GetItem(item.iItem);
+
+         // Supply version icon
+         if (item.mask & LVIF_IMAGE)
+            item.iImage = 2+GameVersionIndex(str.Version).Index;
 
-      // Unfreeze
-      GetListCtrl().SetRedraw(TRUE);
-      GetListCtrl().UpdateWindow();
+         // Supply ID/resolved text
+         if (item.mask & LVIF_TEXT)
+         {
+            if (item.iSubItem == 0)
+               ItemText = VString(L"%d", str.ID);
+            else
+               ItemText = str.ResolvedText;
+
+            item.pszText = (WCHAR*)ItemText.c_str();
+         }
+      }
+      catch (ExceptionBase& e) {
+         Console.Log(HERE, e);
+      }
+
+      *pResult = 0;
    }
 
 
@@ -373,29 +443,24 @@ NAMESPACE_BEGIN2(GUI,Views)
          REQUIRED(GetDocument()->SelectedString);  
 
          // Update string
-         UpdateString(GetListCtrl().GetNextItem(-1, LVNI_SELECTED), *GetDocument()->SelectedString);
+         UpdateString(GetListCtrl().GetNextItem(-1, LVNI_SELECTED));
       }
       catch (ExceptionBase& e) { 
          Console.Log(HERE, e);
       }
    }
    
-   /// <summary>Updates a string.</summary>
+   /// <summary>Redraws a string.</summary>
    /// <param name="index">The index.</param>
-   /// <param name="str">String data.</param>
-   void LanguageStringView::UpdateString(UINT index, LanguageStringRef str)
+   /// <exception cref="Logic::IndexOutOfRangeException">Invalid index</exception>
+   void LanguageStringView::UpdateString(UINT index)
    {
       // Validate index
-      if (index >= (UINT)GetListCtrl().GetItemCount())
-         throw IndexOutOfRangeException(HERE, index, GetListCtrl().GetItemCount());
-
-      // Define 1st sub-item
-      LVItem item(index, VString(L"%d", str.ID), NULL, LVIF_TEXT|LVIF_IMAGE);
-      item.iImage = GameVersionIndex(str.Version).Index + 2;
+      if (index >= Items.size())
+         throw IndexOutOfRangeException(HERE, index, Items.size());
 
-      // Set ID/Icon/Text
-      GetListCtrl().SetItem(&item);
-      GetListCtrl().SetItemText(index, 1, str.ResolvedText.c_str());
+      // Re-query ID/Icon/Text
+      GetListCtrl().Update(index);
    }
 
    // ------------------------------- PRIVATE METHODS ------------------------------
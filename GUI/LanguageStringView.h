@@ -507,19 +507,21 @@ NAMESPACE_BEGIN2(GUI,Views)
       LanguageDocument* GetDocument() const;
 
    protected:
+      LanguageString& GetItem(UINT index) const;
       LanguageString* GetSelected() const;
 
       // ----------------------- MUTATORS ------------------------
    public:
       void InsertString(UINT index, LanguageString& str, bool display);
       void RemoveString(UINT index);
+      BOOL PreCreateWindow(CREATESTRUCT& cs) override;
       BOOL PreTranslateMessage(MSG* pMsg) override;
       
       handler void OnActivateView(BOOL bActivate, CView* pActivateView, CView* pDeactiveView) override;
 
    protected:
       void AdjustLayout();
-      void UpdateString(UINT index, LanguageStringRef str);
+      void UpdateString(UINT index);
       
       afx_msg void OnCustomDraw(NMHDR *pNMHDR, LRESULT *pResult);
       afx_msg void OnContextMenu(CWnd* pWnd, CPoint point);
@@ -532,6 +534,7 @@ NAMESPACE_BEGIN2(GUI,Views)
       handler void OnInitialUpdate() override;
       afx_msg void OnItemStateChanged(NMHDR *pNMHDR, LRESULT *pResult);
       handler void OnPageSelectionChanged();
+      afx_msg void OnRetrieveItem(NMHDR *pNMHDR, LRESULT *pResult);
       afx_msg void OnQueryCommand(CCmdUI* pCmdUI);
       afx_msg void OnQueryMode(CCmdUI* pCmdUI);
       afx_msg void OnPerformCommand(UINT nID);
@@ -547,6 +550,8 @@ NAMESPACE_BEGIN2(GUI,Views)
       ImageListEx              Images;
       StringCustomDraw         CustomDraw;
       HACCEL                   Accelerators;
+      vector<LanguageString*>  Items;         // Strings of the selected page, in display order
+      wstring                  ItemText;      // Text most recently supplied to the list
    };
    
 
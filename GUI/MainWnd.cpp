@@ -27,6 +27,9 @@ NAMESPACE_BEGIN2(GUI,Windows)
    /// <summary>Default Toolwindow size  (300 wide, 500 high)</summary>
    const CRect MainWnd::DefaultSize = CRect(0, 0, 300, 500); 
 
+   /// <summary>Deferred game data switch timer ID</summary>
+   const UINT  MainWnd::GAMEDATA_TIMER = 42;
+
    /// <summary>Status bar indicator IDs</summary>
    const UINT MainWnd::StatusBar::Indicators[INDICATORS] =
    {
@@ -61,6 +64,7 @@ NAMESPACE_BEGIN2(GUI,Windows)
       ON_WM_CLOSE()
       ON_WM_SETTINGCHANGE()
       ON_WM_SHOWWINDOW()
+      ON_WM_TIMER()
       ON_MESSAGE(WM_FEEDBACK, &MainWnd::OnWorkerFeedback)
       ON_MESSAGE(WM_INITIALUPDATE, &MainWnd::OnInitialUpdate)
       ON_REGISTERED_MESSAGE(AFX_WM_CHANGE_ACTIVE_TAB, &MainWnd::OnDocumentSwitched)
@@ -92,7 +96,8 @@ NAMESPACE_BEGIN2(GUI,Windows)
    MainWnd::MainWnd() : fnGameDataFeedback(GameDataFeedback.Register(this, &MainWnd::OnGameDataFeedback)),
                         fnCaretMoved(ScriptView::CaretMoved.Register(this, &MainWnd::OnScriptCaretMoved)),
                         fnAppStateChanged(theApp.StateChanged.Register(this, &MainWnd::OnAppStateChanged)),
-                        ActiveDocument(nullptr)
+                        ActiveDocument(nullptr),
+                        DisplayingFeedback(false)
    {
    }
 
@@ -296,9 +301,41 @@ NAMESPACE_BEGIN2(GUI,Windows)
          wnd->DragAcceptFiles(TRUE);*/
    }
    
+   /// <summary>Activates a resident game data set and refreshes the game data windows.  Deferred while workers are reading the game data</summary>
+   /// <param name="set">Data set.</param>
+   /// <returns>True if activated, false if deferred</returns>
+   bool MainWnd::ActivateGameData(GameDataSetPtr set)
+   {
+      // Workers reading game data: Retry once finished
+      if (GameDataSet::IsReading())
+      {
+         Console << Cons::UserAction << "Deferring switch to " << VersionString(set->Version) << " game data until background operations complete" << ENDL;
+         PendingGameData = set;
+         SetTimer(GAMEDATA_TIMER, 250, nullptr);
+         return false;
+      }
+
+      // Supersede any deferred switch
+      KillTimer(GAMEDATA_TIMER);
+      PendingGameData.reset();
+
+      Console << Cons::UserAction << "Switching to " << VersionString(set->Version) << " game data from " << set->Folder << ENDL;
+
+      // Switch libraries
+      GameDataSet::Activate(set);
+
+      // Refresh game data windows
+      theApp.State = AppState::GameDataPresent;
+      return true;
+   }
+
    /// <summary>Loads/Reloads the game data</summary>
    void MainWnd::LoadGameData()
    {
+      // Cancel deferred switch
+      KillTimer(GAMEDATA_TIMER);
+      PendingGameData.reset();
+
       // Clear relevant windows & menu items
       theApp.State = AppState::NoGameData;
 
@@ -383,12 +420,38 @@ NAMESPACE_BEGIN2(GUI,Windows)
 
       // Raise 'SETTINGS CHANGED'
       if (dlg.Modified)
+      {
          theApp.OnPreferencesChanged();
+
+         // Switch to resident game data matching new preferences, if any
+         auto set = GameDataSet::Find(PrefsLib.GameDataFolder, PrefsLib.GameDataVersion, PrefsLib.GameDataLanguage);
+         if (set && !set->Active && theApp.State == AppState::GameDataPresent)
+            ActivateGameData(set);
+      }
    }
    
    /// <summary>Reload the game data.</summary>
    void MainWnd::OnCommand_Reload()
    {
+      // Loading: Ignore
+      if (GameDataThread.IsRunning())
+         return;
+
+      // Workers reading game data: Cannot reload
+      if (GameDataSet::IsReading())
+      {
+         AfxMessageBox(L"Game data cannot be reloaded until background operations have completed");
+         return;
+      }
+
+      // Resident: Switch to game data for current preferences without reloading
+      auto set = GameDataSet::Find(PrefsLib.GameDataFolder, PrefsLib.GameDataVersion, PrefsLib.GameDataLanguage);
+      if (set && !set->Active)
+      {
+         ActivateGameData(set);
+         return;
+      }
+
       // Save workspace
       SaveWorkspace();
 
@@ -582,6 +645,13 @@ NAMESPACE_BEGIN2(GUI,Windows)
          else
 	         theApp.ProcessShellCommand(cmdInfo);
       }
+
+      // Failure: Restore previously active game data, if any
+      if (wp.Type == ProgressType::Failure && GameDataThread.RestorePrevious())
+      {
+         Console << Cons::UserAction << "Restored previous game data" << ENDL;
+         theApp.State = AppState::GameDataPresent;
+      }
    }
    
    /// <summary>Called on first display</summary>
@@ -749,31 +819,71 @@ NAMESPACE_BEGIN2(GUI,Windows)
 	   CMDIFrameWndEx::OnSettingChange(uFlags, lpszSection);
    }
 
+   /// <summary>Performs a deferred game data switch once workers have stopped reading the game data</summary>
+   /// <param name="nIDEvent">The timer identifier.</param>
+   void MainWnd::OnTimer(UINT_PTR nIDEvent)
+   {
+      if (nIDEvent == GAMEDATA_TIMER)
+      {
+         // Still reading: Wait
+         if (GameDataSet::IsReading())
+            return;
 
-   /// <summary>Raise appropriate events in response to worker feedback.</summary>
+         // Switch, unless game data is being reloaded
+         auto set = PendingGameData;
+         KillTimer(GAMEDATA_TIMER);
+         PendingGameData.reset();
+
+         if (set && theApp.State == AppState::GameDataPresent)
+            ActivateGameData(set);
+         return;
+      }
+
+      __super::OnTimer(nIDEvent);
+   }
+
+
+   /// <summary>Drains the worker feedback queue and raises the appropriate events for each batch.</summary>
    /// <param name="wParam">Not used.</param>
-   /// <param name="lParam">Progress data.</param>
+   /// <param name="lParam">Not used.</param>
    /// <returns></returns>
    LRESULT MainWnd::OnWorkerFeedback(WPARAM wParam, LPARAM lParam)
    {
-      WorkerProgress* p = reinterpret_cast<WorkerProgress*>(lParam);
+      // Re-entrant: Outer call drains remaining feedback
+      if (DisplayingFeedback)
+         return 0;
 
-      // Initial Feedback: Activate appropriate pane
-      if (p->Type == ProgressType::Operation)
-         ActivateOutputPane(p->Operation, false);
+      DisplayingFeedback = true;
 
-      // Raise appropriate event
-      switch (p->Operation)
+      try
       {
-      case Operation::LoadGameData:       GameDataFeedback.Raise(*p);      break;
-      case Operation::ImportProject:
-      case Operation::LoadSaveDocument:   LoadSaveFeedback.Raise(*p);      break;
-      case Operation::FindAndReplace1:
-      case Operation::FindAndReplace2:    FindReplaceFeedback.Raise(*p);   break;
+         // Drain until empty, feedback may arrive while displaying
+         for (UINT count; (count = WorkerData::Feedback.Drain(FeedbackBatch)) > 0; )
+            for (UINT i = 0; i < count; ++i)
+            {
+               const WorkerProgress& p = FeedbackBatch[i];
+
+               // Initial Feedback: Activate appropriate pane
+               if (p.Type == ProgressType::Operation)
+                  ActivateOutputPane(p.Operation, false);
+
+               // Raise appropriate event
+               switch (p.Operation)
+               {
+               case Operation::LoadGameData:       GameDataFeedback.Raise(p);      break;
+               case Operation::ImportProject:
+               case Operation::LoadSaveDocument:   LoadSaveFeedback.Raise(p);      break;
+               case Operation::FindAndReplace1:
+               case Operation::FindAndReplace2:    FindReplaceFeedback.Raise(p);   break;
+               }
+            }
+      }
+      catch (...) {
+         DisplayingFeedback = false;
+         throw;
       }
       
-      // Delete data
-      delete p;
+      DisplayingFeedback = false;
       return 0;
    }
    
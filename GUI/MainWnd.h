@@ -110,6 +110,9 @@ NAMESPACE_BEGIN2(GUI,Windows)
 
       const static CRect DefaultSize;
 
+   protected:
+      const static UINT  GAMEDATA_TIMER;
+
       // --------------------- PROPERTIES ------------------------
 	  
       // ---------------------- ACCESSORS ------------------------			
@@ -128,6 +131,7 @@ NAMESPACE_BEGIN2(GUI,Windows)
 	   BOOL         PreCreateWindow(CREATESTRUCT& cs) override;
 
    protected:
+      bool  ActivateGameData(GameDataSetPtr set);
       void  CreateToolBars();
       void  CreateToolWindows();
       void  LoadGameData();
@@ -156,6 +160,7 @@ NAMESPACE_BEGIN2(GUI,Windows)
 	   afx_msg void    OnSettingChange(UINT uFlags, LPCTSTR lpszSection);
       handler void    OnScriptCaretMoved(POINT pt);
       afx_msg void    OnShowWindow(BOOL bShow, UINT nStatus);
+      afx_msg void    OnTimer(UINT_PTR nIDEvent);
       afx_msg LRESULT OnCreateNewToolbar(WPARAM wp, LPARAM lp);
       afx_msg LRESULT OnRequestTabTooltip(WPARAM wp, LPARAM lp);
       afx_msg LRESULT OnWorkerFeedback(WPARAM wParam, LPARAM lParam);
@@ -188,7 +193,10 @@ NAMESPACE_BEGIN2(GUI,Windows)
       AppStateChangedHandler fnAppStateChanged;
    
    private:
-      DocumentBase*     ActiveDocument;
+      DocumentBase*            ActiveDocument;
+      GameDataSetPtr           PendingGameData;    // Data set to activate once workers stop reading the game data
+      vector<WorkerProgress>   FeedbackBatch;      // Feedback being displayed. Elements are reused between batches
+      bool                     DisplayingFeedback; // Guards against re-entrant draining
 };
 
 
@@ -102,7 +102,7 @@ NAMESPACE_BEGIN2(GUI,Documents)
       }
 
       // Raise 'ITEM ADDED'
-      ItemAdded.Raise(&folder.Add(item), &folder);
+      ItemAdded.Raise(&Project.Add(item, folder), &folder);
 
       // Modify project
       SetModifiedFlag(TRUE);
@@ -121,7 +121,7 @@ NAMESPACE_BEGIN2(GUI,Documents)
       ProjectItem item(name, false);
 
       // Raise 'ITEM ADDED'
-      ItemAdded.Raise(&folder.Add(item), &folder);
+      ItemAdded.Raise(&Project.Add(item, folder), &folder);
    }
    
    /// <summary>Close the document, query to save if modified</summary>
@@ -292,7 +292,7 @@ NAMESPACE_BEGIN2(GUI,Documents)
       SetModifiedFlag(TRUE);
 
       // Add to folder. Raise 'ITEM ADDED'
-      ItemAdded.Raise(&folder.Add(copy), &folder);
+      ItemAdded.Raise(&Project.Add(copy, folder), &folder);
    }
    
    /// <summary>Raises 'PROJECT CLOSED/LOADED' after loading/closing</summary>
@@ -474,13 +474,12 @@ NAMESPACE_BEGIN2(GUI,Documents)
             RenameFile(item.FullPath, newPath);
 
             // Set new name+path
-            item.Name = name;
-            item.FullPath = newPath;
+            Project.Rename(item, name, newPath);
          }
       }
       // Variable: Update name 
       else
-         item.Name = name;
+         Project.Rename(item, name);
 
       // Modify project
       SetModifiedFlag(TRUE);
@@ -527,8 +526,7 @@ NAMESPACE_BEGIN2(GUI,Documents)
          return;
       
       // Update name + path
-      item->Name = doc.GetTitle();
-      item->FullPath = doc.FullPath;
+      Project.Rename(*item, (LPCWSTR)doc.GetTitle(), doc.FullPath);
 
       // Item: Raise 'ITEM CHANGED'
       ItemChanged.Raise(item);
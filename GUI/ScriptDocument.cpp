@@ -375,7 +375,7 @@ NAMESPACE_BEGIN2(GUI,Documents)
          Console << Cons::Heading << "Loading script: " << Path(szPathName) << ENDL;
          data.SendFeedback(ProgressType::Operation, 0, VString(L"Loading script '%s'", szPathName));
 
-         // Read/Parse script
+         // Read/Parse script once, using the game data for its game
          Script = ScriptFileReader(XFileInfo(szPathName).OpenRead()).ReadFile(szPathName, false);
 
          // Feedback 
@@ -2,6 +2,7 @@
 #include "../Logic/ScriptFile.h"
 #include "../Logic/ScriptRevision.h"
 #include "../Logic/ScriptObjectLibrary.h"
+#include "../Logic/GameDataSet.h"
 #include "DocumentBase.h"
 #include "DocTemplateBase.h"
 #include "PropertySource.h"
@@ -63,6 +64,8 @@ NAMESPACE_BEGIN2(GUI,Documents)
          ArgumentProperty(ScriptDocument& doc, ScriptVariable& arg)
             : Argument(arg), ScriptProperty(doc, arg.Name, GetString(arg.ParamType).c_str(), arg.Description)
          {
+            GameDataSet::Scope game(GameDataSet::Find(Script.Game));
+
             // Populate parameter types 
             for (const ScriptObject& obj : ScriptObjectLib)
                if (obj.Group == ScriptObjectGroup::ParameterType && !obj.IsHidden())
@@ -80,6 +83,7 @@ NAMESPACE_BEGIN2(GUI,Documents)
          /// <param name="value">value text</param>
          void OnValueChanged(GuiString value) override
          {
+            GameDataSet::Scope game(GameDataSet::Find(Script.Game));
             Argument.ParamType = (ParameterType)ScriptObjectLib.Find(value).ID;
             
             ScriptProperty::OnValueChanged(value);       // Modify document
@@ -100,6 +104,8 @@ NAMESPACE_BEGIN2(GUI,Documents)
          CommandIDProperty(ScriptDocument& doc)
             : ScriptProperty(doc, L"Command", doc.Script.CommandName.c_str(), L"ID of ship/station command implemented by the script")
          {
+            GameDataSet::Scope game(GameDataSet::Find(Script.Game));
+
             // Populate command IDs 
             for (const ScriptObject& obj : ScriptObjectLib)
                if (obj.Group == ScriptObjectGroup::ObjectCommand)
@@ -115,6 +121,7 @@ NAMESPACE_BEGIN2(GUI,Documents)
          /// <returns>True to accept, false to reject</returns>
          bool OnValidateValue(GuiString& value) override
          {
+            GameDataSet::Scope  game(GameDataSet::Find(Script.Game));
             const ScriptObject* obj = nullptr;
             int index = 0;
             
@@ -13,7 +13,10 @@ NAMESPACE_BEGIN2(GUI,Controls)
    // --------------------------------- CONSTANTS ----------------------------------
 
    /// <summary>Background compiler timer ID</summary>
-   const UINT  ScriptEdit::COMPILE_TIMER = 42;
+   const UINT  ScriptEdit::COMPILE_TIMER = 42,
+               ScriptEdit::HIGHLIGHT_TIMER = 43,
+               ScriptEdit::HIGHLIGHT_BATCH = 250,
+               ScriptEdit::HIGHLIGHT_MARGIN = 20;
 
    /// <summary>Used to defer keyboard messages</summary>
    #define UN_CHAR_NOTIFY      (WM_USER+1)
@@ -41,7 +44,7 @@ NAMESPACE_BEGIN2(GUI,Controls)
    
    // -------------------------------- CONSTRUCTION --------------------------------
 
-   ScriptEdit::ScriptEdit() : Document(nullptr), Suggestions(this)
+   ScriptEdit::ScriptEdit() : Document(nullptr), Suggestions(this), PendingFirst(-1), PendingLast(-1)
    {
    }
 
@@ -198,6 +201,7 @@ NAMESPACE_BEGIN2(GUI,Controls)
 
          // Parse script into list of commands
          auto commands = ScriptParser(Document->Script, GetAllLines(), Document->Script.Game).ToList();
+         Suggestions.OnScriptParsed();
          
          // Generate new document text
          for (auto cmd = commands.begin(), end = commands.end(); cmd != end; ++cmd)
@@ -246,6 +250,7 @@ NAMESPACE_BEGIN2(GUI,Controls)
 
          // Parse script into list of commands
          auto commands = ScriptParser(Document->Script, GetAllLines(), Document->Script.Game).ToList();
+         Suggestions.OnScriptParsed();
 
          // Generate selection text
          int index = 0;
@@ -442,6 +447,27 @@ NAMESPACE_BEGIN2(GUI,Controls)
       return LineTextIterator(*this, HasSelection() ? LineFromChar(GetSelection().cpMax) : LineFromChar(-1)); 
    }
 
+   /// <summary>Colours a range of lines, using cached colour runs where the text is unchanged.</summary>
+   /// <param name="first">first zero-based line number</param>
+   /// <param name="last">last zero-based line number.</param>
+   /// <exception cref="Logic::ArgumentException">Unknown token type</exception>
+   void  ScriptEdit::FormatLines(int first, int last)
+   {
+      CharFormat cf(CFM_COLOR | CFM_UNDERLINE | CFM_UNDERLINETYPE, NULL);
+
+      for (int i = first; i <= last; i++)
+      {
+         UINT offset = LineIndex(i);
+
+         // Format each run of colour
+         for (const auto& run : Highlighter.GetRuns(Document->Script, GetLineText(i)))
+         {
+            cf.crTextColor = run.Colour;
+            FormatToken(offset, TokenBase(run.Start, run.End), cf);
+         }
+      }
+   }
+
    /// <summary>Selects and formats a token.</summary>
    /// <param name="offset">The character index of the line</param>
    /// <param name="t">The token</param>
@@ -464,6 +490,19 @@ NAMESPACE_BEGIN2(GUI,Controls)
       Suggestions.FreezeWindow(freeze, invalidate);
    }
    
+   /// <summary>Gets the lines within the viewport, plus a small margin either side.</summary>
+   /// <param name="first">On return, first zero-based line number</param>
+   /// <param name="last">On return, last zero-based line number</param>
+   void  ScriptEdit::GetVisibleLines(int& first, int& last) const
+   {
+      CRect rc;
+      GetClientRect(rc);
+
+      // Lines beneath the top and bottom of the client area
+      first = max(0, GetFirstVisibleLine() - (int)HIGHLIGHT_MARGIN);
+      last = min(GetLineCount()-1, LineFromChar(CharFromPos(rc.BottomRight())) + (int)HIGHLIGHT_MARGIN);
+   }
+
    /// <summary>Determines whether document is connected</summary>
    /// <returns></returns>
    bool  ScriptEdit::HasDocument() const
@@ -471,6 +510,81 @@ NAMESPACE_BEGIN2(GUI,Controls)
       return Document != nullptr;
    }
    
+   /// <summary>Highlights the next batch of lines deferred by UpdateHighlighting.</summary>
+   void  ScriptEdit::HighlightPending()
+   {
+      int visFirst, visLast;
+
+      // Ensure work remains
+      if (PendingFirst == -1)
+         return;
+
+      // Determine batch
+      int last = min(PendingLast, PendingFirst + (int)HIGHLIGHT_BATCH - 1);
+      last = min(last, GetLineCount()-1);
+      GetVisibleLines(visFirst, visLast);
+
+      // Freeze window
+      SuspendUndo(true);
+      FreezeWindow(true);
+
+      try 
+      {
+         FormatLines(PendingFirst, last);
+         UnderlineErrors(PendingFirst, last);
+      }
+      catch (ExceptionBase& e) { 
+         Console.Log(HERE, e); 
+      }
+
+      // Restore selection.  Only redraw if batch was visible
+      FreezeWindow(false, PendingFirst <= visLast && last >= visFirst);
+      SuspendUndo(false);
+
+      // Complete: Stop idle timer
+      PendingFirst = last+1;
+      if (PendingFirst > PendingLast)
+      {
+         KillTimer(HIGHLIGHT_TIMER);
+         PendingFirst = PendingLast = -1;
+      }
+   }
+
+   /// <summary>Highlights any deferred lines within the viewport.</summary>
+   void  ScriptEdit::HighlightVisible()
+   {
+      int first, last;
+
+      // Ensure work remains
+      if (PendingFirst == -1)
+         return;
+
+      // Intersect viewport with deferred lines
+      GetVisibleLines(first, last);
+      first = max(first, PendingFirst);
+      last = min(last, PendingLast);
+
+      if (first > last)
+         return;
+
+      // Freeze window
+      SuspendUndo(true);
+      FreezeWindow(true);
+
+      try 
+      {
+         FormatLines(first, last);
+         UnderlineErrors(first, last);
+      }
+      catch (ExceptionBase& e) { 
+         Console.Log(HERE, e); 
+      }
+
+      // Restore selection
+      FreezeWindow(false);
+      SuspendUndo(false);
+   }
+   
    /// <summary>Determines whether key is pressed</summary>
    /// <param name="vKey">Virtual key.</param>
    /// <returns></returns>
@@ -510,6 +624,8 @@ NAMESPACE_BEGIN2(GUI,Controls)
    /// <summary>Refresh entire document.</summary>
    void ScriptEdit::OnArgumentChanged()
    {
+      // Variable colours may have changed
+      Highlighter.Clear();
       UpdateHighlighting(0, GetLineCount()-1);
    }
 
@@ -520,6 +636,7 @@ NAMESPACE_BEGIN2(GUI,Controls)
 
       // Stop compiler timer
       SetCompilerTimer(false);
+      CompileErrors.clear();
         
       // Freeze window
       SuspendUndo(true);
@@ -532,6 +649,7 @@ NAMESPACE_BEGIN2(GUI,Controls)
 
          // Parse script 
          ScriptParser parser(Document->Script, GetAllLines(), Document->Script.Game);
+         Suggestions.OnScriptParsed();
          
          // Underlining Errors?
          if (PrefsLib.BackgroundCompiler)
@@ -541,18 +659,12 @@ NAMESPACE_BEGIN2(GUI,Controls)
             SetSel(0,-1);
             SetSelectionCharFormat(cf);
 
-            // Define error underline
-            cf = CharFormat(CFM_COLOR|CFM_UNDERLINE|CFM_UNDERLINETYPE, CFE_UNDERLINE);
-            cf.bUnderlineType = CFU_UNDERLINEWAVE;
-            //cf.bUnderlineColor = 0x02;     //Undocumented underline colour
-            cf.crTextColor = PrefsLib.ErrorHighlight;
+            // Underline all errors.  Retain them so deferred lines can be re-underlined once highlighted
+            CompileErrors = parser.Errors;
+            UnderlineErrors(0, GetLineCount()-1);
 
-            // Underline all errors
             for (const auto& err : parser.Errors)
-            {
-               FormatToken(LineIndex(err.Line-1), err, cf);
                Console << err << ENDL;
-            }
          }
 
          // Feedback
@@ -810,6 +922,7 @@ NAMESPACE_BEGIN2(GUI,Controls)
 
       // Update all highlighting
       SetBackgroundColor(FALSE, PrefsLib.BackgroundColour);
+      Highlighter.Reset();
       UpdateHighlighting(0, GetLineCount()-1);
 
       // Update Tooltip
@@ -817,6 +930,13 @@ NAMESPACE_BEGIN2(GUI,Controls)
       __super::OnSettingChange(uFlags, lpszSection);
    }
    
+   /// <summary>Highlights the viewport and the next batch of deferred lines</summary>
+   void ScriptEdit::OnIdleHighlight()
+   {
+      HighlightVisible();
+      HighlightPending();
+   }
+
    /// <summary>Performs syntax colouring on the current line</summary>
    void ScriptEdit::OnTextChange()
    {
@@ -824,9 +944,19 @@ NAMESPACE_BEGIN2(GUI,Controls)
       if (!ReadOnly)
          SetCompilerTimer(true);
 
+      // Error positions are now stale: Underlining is restored by the next background compile
+      CompileErrors.clear();
+
       // Update current line
       UpdateHighlighting(-1, -1);
 
+      // Deferred lines may have moved up or down: Extend from the edited line to end of document
+      if (PendingFirst != -1)
+      {
+         PendingFirst = min(PendingFirst, LineFromChar(-1));
+         PendingLast = GetLineCount()-1;
+      }
+
       // Reset tooltip  (Raises 'TEXT CHANGED')
       __super::OnTextChange();
    }
@@ -839,6 +969,10 @@ NAMESPACE_BEGIN2(GUI,Controls)
       if (nIDEvent == COMPILE_TIMER) 
          OnBackgroundCompile();
 
+      // Deferred highlighting
+      else if (nIDEvent == HIGHLIGHT_TIMER) 
+         OnIdleHighlight();
+
       // Used by RichEdit
       __super::OnTimer(nIDEvent);
    }
@@ -854,6 +988,9 @@ NAMESPACE_BEGIN2(GUI,Controls)
 
       // Reset Tooltip + Scroll
       __super::VScroll(nSBCode, nPos);
+
+      // Highlight lines scrolled into view
+      HighlightVisible();
    }
    
    /// <summary>Refreshes the line numbers after a scroll</summary>
@@ -867,6 +1004,9 @@ NAMESPACE_BEGIN2(GUI,Controls)
 
       // Reset Tooltip + Scroll
       __super::OnVScroll(nSBCode, nPos, bar);
+
+      // Highlight lines scrolled into view
+      HighlightVisible();
    }
 
    /// <summary>Pastes text from clipboard.</summary>
@@ -1012,39 +1152,60 @@ NAMESPACE_BEGIN2(GUI,Controls)
       SuspendUndo(false);
    }
 
-   /// <summary>Updates the highlighting.</summary>
+   /// <summary>Underlines errors from the last background compile within a range of lines.</summary>
    /// <param name="first">first zero-based line number</param>
    /// <param name="last">last zero-based line number.</param>
+   void ScriptEdit::UnderlineErrors(int first, int last)
+   {
+      // Define error underline
+      CharFormat cf(CFM_COLOR|CFM_UNDERLINE|CFM_UNDERLINETYPE, CFE_UNDERLINE);
+      cf.bUnderlineType = CFU_UNDERLINEWAVE;
+      //cf.bUnderlineColor = 0x02;     //Undocumented underline colour
+      cf.crTextColor = PrefsLib.ErrorHighlight;
+
+      // Underline errors within range
+      for (const auto& err : CompileErrors)
+         if ((int)err.Line-1 >= first && (int)err.Line-1 <= last)
+            FormatToken(LineIndex(err.Line-1), err, cf);
+   }
+
+   /// <summary>Updates the highlighting.  Lines outside the viewport are deferred and highlighted in idle-time batches</summary>
+   /// <param name="first">first zero-based line number, or -1 for the caret line</param>
+   /// <param name="last">last zero-based line number.</param>
    void ScriptEdit::UpdateHighlighting(int first, int last)
    {
+      // Caret:
+      if (first == -1)
+         first = last = LineFromChar(-1);
+      else
+      {
+         int visFirst, visLast;
+         GetVisibleLines(visFirst, visLast);
+
+         // Off-screen: Defer until idle  [WM_TIMER is only dispatched once the message queue is empty]
+         if (first < visFirst || last > visLast)
+         {
+            PendingFirst = (PendingFirst == -1 ? first : min(first, PendingFirst));
+            PendingLast = max(last, PendingLast);
+            SetTimer(HIGHLIGHT_TIMER, 10, nullptr);
+
+            // Highlight visible portion now
+            first = max(first, visFirst);
+            last = min(last, visLast);
+         }
+      }
+
+      // Nothing visible
+      if (first > last)
+         return;
+
       // Freeze window
       SuspendUndo(true);
       FreezeWindow(true);
 
       try 
       {
-         SyntaxHighlight  Highlights;
-         CharFormat cf(CFM_COLOR | CFM_UNDERLINE | CFM_UNDERLINETYPE, NULL);
-         
-         // Caret:
-         if (first == -1)
-            first = last = LineFromChar(-1);
-
-         // Format lines
-         for (int i = first; i <= last; i++)
-         {
-            UINT offset = LineIndex(i);
-
-            // Lex current line
-            CommandLexer lex(GetLineText(i));
-
-            // Format tokens
-            for (const auto& tok : lex.Tokens)
-            {
-               cf.crTextColor = Highlights.GetColour(Document->Script, tok);
-               FormatToken(offset, tok, cf);
-            }
-         }
+         FormatLines(first, last);
       }
       catch (ExceptionBase& e) { 
          Console.Log(HERE, e); 
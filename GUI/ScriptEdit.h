@@ -6,6 +6,7 @@
 #include "../Logic/ScriptParser.h"
 #include "../Logic/DescriptionLibrary.h"
 #include "../Logic/SyntaxLibrary.h"
+#include "../Logic/LineHighlighter.h"
 
 /// <summary>User interface controls</summary>
 NAMESPACE_BEGIN2(GUI,Controls)
@@ -568,6 +569,7 @@ NAMESPACE_BEGIN2(GUI,Controls)
          void  OnItemDoubleClick(int item);
          void  OnKeyDown(UINT nChar, UINT nRepCnt, UINT nFlags);
          void  OnKillFocus(CWnd* pNewWnd);
+         void  OnScriptParsed();
          bool  WantMessage(UINT msg, WPARAM wParam, LPARAM lParam);
 
       protected:
@@ -600,7 +602,10 @@ NAMESPACE_BEGIN2(GUI,Controls)
       static const wchar*  GetString(Suggestion& s);
 
    protected:
-      static const UINT    COMPILE_TIMER;
+      static const UINT    COMPILE_TIMER,
+                           HIGHLIGHT_TIMER,
+                           HIGHLIGHT_BATCH,
+                           HIGHLIGHT_MARGIN;
 
       // --------------------- PROPERTIES ------------------------
 	  
@@ -614,6 +619,7 @@ NAMESPACE_BEGIN2(GUI,Controls)
       bool   CanViewString() const;
 
    protected:
+      void   GetVisibleLines(int& first, int& last) const;
       bool   HasDocument() const;
       bool   IsKeyPressed(UINT vKey) const;
       
@@ -637,11 +643,15 @@ NAMESPACE_BEGIN2(GUI,Controls)
       LineTextIterator end();
       LineTextIterator send();
 
+      void   FormatLines(int first, int last);
       void   FormatToken(UINT offset, const TokenBase& t, CharFormat& cf);
       void   FreezeWindow(bool freeze, bool invalidate = true) override;
+      void   HighlightPending();
+      void   HighlightVisible();
       void   RefreshGutter();
       void   SetCompilerTimer(bool set);
       void   SetGutterWidth(UINT twips);
+      void   UnderlineErrors(int first, int last);
       virtual void UpdateHighlighting(int first, int last);
       bool   WantMessage(UINT msg, WPARAM wParam, LPARAM lParam);
       
@@ -654,6 +664,7 @@ NAMESPACE_BEGIN2(GUI,Controls)
       LRESULT      OnCharNotify(WPARAM wParam, LPARAM lParam);
       handler void OnCharNewLine();
       handler void OnCharTab(bool shift);
+      handler void OnIdleHighlight();
       afx_msg void OnHScroll(UINT nSBCode, UINT nPos, CScrollBar* bar) override;
       afx_msg void OnInputMessage(NMHDR *pNMHDR, LRESULT *pResult) override;
       handler void OnKeyDownInternal(UINT nChar, UINT nRepCnt, UINT nFlags);
@@ -674,6 +685,10 @@ NAMESPACE_BEGIN2(GUI,Controls)
       ScriptDocument*    Document;              // Document pointer
       EventHandler       fnArgumentChanged;     // Raised when a Script argument is modified/removed
       SuggestionDirector Suggestions;           // Suggestions mediator
+      LineHighlighter    Highlighter;           // Colour runs of previously highlighted lines
+      ErrorArray         CompileErrors;         // Errors underlined by the last background compile, until the text changes
+      int                PendingFirst,          // First line awaiting highlighting, or -1 if none
+                         PendingLast;           // Last line awaiting highlighting, or -1 if none
 };
    
 
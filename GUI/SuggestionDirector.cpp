@@ -157,6 +157,13 @@ namespace GUI
          }
       }
       
+      /// <summary>Updates the suggestions, if visible, once the labels/variables of the script have been rebuilt</summary>
+      void ScriptEdit::SuggestionDirector::OnScriptParsed()
+      {
+         if (State == InputState::Suggestions)
+            SuggestionsList.Refresh();
+      }
+      
       /// <summary>Query whether mouse/keyboard message should be handled by SuggestionList</summary>
       /// <param name="msg">Mouse/Keyboard message</param>
       /// <param name="wParam">parameter</param>
@@ -1,6 +1,7 @@
 #include "stdafx.h"
 #include "SuggestionList.h"
 #include "ScriptEdit.h"
+#include "../Logic/GameDataSet.h"
 #include "../Logic/GameObjectLibrary.h"
 #include "../Logic/ScriptObjectLibrary.h"
 #include "../Logic/SyntaxLibrary.h"
@@ -46,6 +47,12 @@ NAMESPACE_BEGIN2(GUI,Controls)
    {
    }
 
+   /// <summary>Creates the shared library suggestions, initially empty</summary>
+   SuggestionList::LibraryContent::LibraryContent() 
+      : fnAppStateChanged(theApp.StateChanged.Register(this, &LibraryContent::OnAppStateChanged))
+   {
+   }
+
    // ------------------------------- STATIC METHODS -------------------------------
 
    /// <summary>Gets the default list size for suggestions.</summary>
@@ -63,6 +70,14 @@ NAMESPACE_BEGIN2(GUI,Controls)
       }
    }
 
+   /// <summary>Gets the suggestions shared by all lists.</summary>
+   /// <returns></returns>
+   SuggestionList::LibraryContent&  SuggestionList::GetLibraryContent()
+   {
+      static LibraryContent  content;
+      return content;
+   }
+
    // ------------------------------- PUBLIC METHODS -------------------------------
 
    /// <summary>Creates the specified parent.</summary>
@@ -87,38 +102,51 @@ NAMESPACE_BEGIN2(GUI,Controls)
       return __super::Create(style, rc, parent, IDC_SUGGESTION_LIST);
    }
    
-   /// <summary>Finds the index of the item with the longest match</summary>
-   /// <param name="txt">text to match.</param>
-   /// <returns>Zero-based index if successful, otherwise -1</returns>
-   int SuggestionList::ContentArray::FindMatch(const wstring& txt) const
+   /// <summary>Gets the suggestions for a library, building them if necessary</summary>
+   /// <param name="type">Game object, script object or command.</param>
+   /// <param name="ver">Game version of script.</param>
+   /// <returns></returns>
+   /// <exception cref="Logic::ArgumentException">Not a library suggestion type</exception>
+   SuggestionList::ContentArrayPtr  SuggestionList::LibraryContent::Get(Suggestion type, GameVersion ver)
    {
-      int index = 0,
-          value_max = 0,
-          index_max = -1;
+      // Suggestions depend upon the game version, using its resident game data
+      auto key = ContentKey(type, ver);
 
-      // Linear search for longest match
-      for (auto& item : *this)
+      // Lookup existing
+      auto it = Content.find(key);
+      if (it != Content.end())
+         return it->second;
+
+      // Build from library
+      GameDataSet::Scope game(GameDataSet::Find(ver));
+      auto items = shared_ptr<ContentArray>(new ContentArray);
+      switch (type)
       {
-         auto m = item.Match(txt);
+      // Query GameObjectLibrary 
+      case Suggestion::GameObject:  
+         for (auto& obj : GameObjectLib.Query(L""))
+            items->push_back( SuggestionItem(obj->Name, GetString(obj->Type)) );
+         break;
 
-         // Update longest match
-         if (m > value_max)
-         {
-            value_max = m;
-            index_max = index;
-         }
-         
-         ++index;
-      }
+      // Query ScriptObjectLibrary 
+      case Suggestion::ScriptObject:
+         for (auto& obj : ScriptObjectLib.Query(L""))
+            items->push_back( SuggestionItem(obj->Text, GetString(obj->Group)) );
+         break;
 
-      // Return index of longest match
-      return index_max;
+      // Query SyntaxLibrary
+      case Suggestion::Command: 
+         for (auto& obj : SyntaxLib.Query(L"", ver))
+            items->push_back( SuggestionItem(obj->DisplayText, GetString(obj->Group), obj->Hash) );
+         break;
 
-      
-      /*list<int> matches;
-      transform(begin(), end(), matches, [&txt](const SuggestionItem& it){return it.Match(txt);} );
+      default:
+         throw ArgumentException(HERE, L"type", VString(L"Suggestion type %d is not drawn from a library", type));
+      }
 
-      return max_element(matches.begin(), matches.end()) - matches.begin();*/
+      // Sort + Store
+      items->Sort();
+      return Content[key] = items;
    }
 
    /// <summary>Gets the script edit parent</summary>
@@ -141,30 +169,14 @@ NAMESPACE_BEGIN2(GUI,Controls)
       // Get selection and format
       switch (SuggestionType)
       {
-      case Suggestion::GameObject:   return VString(L"{%s}", Content[GetNextItem(-1, LVNI_SELECTED)].Text.c_str());
-      case Suggestion::ScriptObject: return VString(L"[%s]", Content[GetNextItem(-1, LVNI_SELECTED)].Text.c_str());
-      case Suggestion::Variable:     return VString(L"$%s", Content[GetNextItem(-1, LVNI_SELECTED)].Text.c_str());
-      case Suggestion::Label:        return VString(L"%s:", Content[GetNextItem(-1, LVNI_SELECTED)].Text.c_str());
-      case Suggestion::Command:      return Content[GetNextItem(-1, LVNI_SELECTED)].Text;
+      case Suggestion::GameObject:   return VString(L"{%s}", GetSuggestionText(GetNextItem(-1, LVNI_SELECTED)).c_str());
+      case Suggestion::ScriptObject: return VString(L"[%s]", GetSuggestionText(GetNextItem(-1, LVNI_SELECTED)).c_str());
+      case Suggestion::Variable:     return VString(L"$%s", GetSuggestionText(GetNextItem(-1, LVNI_SELECTED)).c_str());
+      case Suggestion::Label:        return VString(L"%s:", GetSuggestionText(GetNextItem(-1, LVNI_SELECTED)).c_str());
+      case Suggestion::Command:      return GetSuggestionText(GetNextItem(-1, LVNI_SELECTED));
       default:  return L"Error";
       }
    }
-   
-   /// <summary>Calculates the length of a match between item and a string</summary>
-   /// <param name="txt">The text.</param>
-   /// <returns>Length of match in characters</returns>
-   int SuggestionList::SuggestionItem::Match(const wstring& txt) const
-   {
-      int len = 0;
-
-      // Compare 'n' characters of input + key
-      for (auto t = txt.begin(), k = Key.begin(); t != txt.end() && k != Key.end(); ++t, ++k)
-         if (*t == *k)
-            ++len;
-
-      // Return count
-      return len;
-   }
 
    /// <summary>Highlights the closest matching suggestion.</summary>
    /// <param name="tok">Token to match</param>
@@ -173,8 +185,8 @@ NAMESPACE_BEGIN2(GUI,Controls)
       // Exclude {,[,$,: etc.
       GuiString str(tok.ValueText); 
 
-      // Linear search for partial substring
-      int index = Content.FindMatch(str);
+      // Binary search for longest prefix
+      int index = FindMatch(str);
 
       // Search/display closest match
       if (index != -1)
@@ -190,7 +202,123 @@ NAMESPACE_BEGIN2(GUI,Controls)
          Console << L"Search for " << str << L" provided no match" << ENDL;*/
    }
    
+   /// <summary>Updates the number of items once the script has been parsed, script suggestions are read from it directly</summary>
+   void  SuggestionList::Refresh()
+   {
+      SetItemCountEx(GetSuggestionCount(), LVSICF_NOSCROLL);
+      Invalidate();
+   }
+
+   /// <summary>Sorts the items by key</summary>
+   void  SuggestionList::ContentArray::Sort()
+   {
+      sort(begin(), end(), [](const SuggestionItem& a, const SuggestionItem& b) {return a.Key < b.Key;} );
+   }
+
    // ------------------------------ PROTECTED METHODS -----------------------------
+
+   /// <summary>Finds the index of the first item sharing the longest prefix with a string</summary>
+   /// <param name="txt">text to match.</param>
+   /// <returns>Zero-based index if successful, otherwise -1</returns>
+   int SuggestionList::FindMatch(const wstring& txt) const
+   {
+      wstring key = GuiString(txt).ToLower();
+      int count = GetSuggestionCount(), len = 0;
+
+      // Gets the index of the first item whose key is not less than a string
+      auto lowerBound = [&](const wstring& str) -> int
+      {
+         int first = 0;
+         for (int n = count; n > 0; )
+            if (GetSuggestionKey(first + n/2) < str)
+            {
+               first += n/2 + 1;
+               n -= n/2 + 1;
+            }
+            else
+               n /= 2;
+         return first;
+      };
+
+      // Gets the length of the prefix shared by the key of an item and the input
+      auto match = [&](int index) -> int
+      {
+         wstring item = GetSuggestionKey(index);
+         return (int)(mismatch(key.begin(), key.begin() + min(key.length(), item.length()), item.begin()).first - key.begin());
+      };
+
+      // Binary search for insertion point. Longest prefix must be shared with an adjacent item
+      int pos = lowerBound(key);
+      if (pos < count)
+         len = match(pos);
+      if (pos > 0)
+         len = max(len, match(pos-1));
+
+      // No match
+      if (len == 0)
+         return -1;
+
+      // Binary search for first item with that prefix
+      return lowerBound(key.substr(0, len));
+   }
+
+   /// <summary>Gets the number of suggestions</summary>
+   /// <returns></returns>
+   UINT  SuggestionList::GetSuggestionCount() const
+   {
+      switch (SuggestionType)
+      {
+      case Suggestion::Variable:  return Script->Variables.Sorted.size();
+      case Suggestion::Label:     return Script->Labels.Sorted.size();
+      default:                    return Content ? Content->size() : 0;
+      }
+   }
+
+   /// <summary>Gets the sorting key of a suggestion</summary>
+   /// <param name="index">Zero-based index</param>
+   /// <returns>Suggestion text in lower case</returns>
+   wstring  SuggestionList::GetSuggestionKey(UINT index) const
+   {
+      switch (SuggestionType)
+      {
+      case Suggestion::Variable:  
+      case Suggestion::Label:     return GuiString(GetSuggestionText(index)).ToLower();
+      default:                    return (*Content)[index].Key;
+      }
+   }
+
+   /// <summary>Gets the text of a suggestion</summary>
+   /// <param name="index">Zero-based index</param>
+   /// <returns></returns>
+   const wstring&  SuggestionList::GetSuggestionText(UINT index) const
+   {
+      switch (SuggestionType)
+      {
+      case Suggestion::Variable:  return Script->Variables.Sorted[index]->Name;
+      case Suggestion::Label:     return Script->Labels.Sorted[index]->Name;
+      default:                    return (*Content)[index].Text;
+      }
+   }
+
+   /// <summary>Gets the type/group text of a suggestion</summary>
+   /// <param name="index">Zero-based index</param>
+   /// <returns></returns>
+   wstring  SuggestionList::GetSuggestionType(UINT index) const
+   {
+      switch (SuggestionType)
+      {
+      case Suggestion::Variable:  return GetString(Script->Variables.Sorted[index]->Type);
+      case Suggestion::Label:     return VString(L"Line %d", Script->Labels.Sorted[index]->LineNumber);
+      default:                    return (*Content)[index].Type;
+      }
+   }
+
+   /// <summary>Discards the library suggestions when game data is loaded or unloaded</summary>
+   /// <param name="s">The new state.</param>
+   void  SuggestionList::LibraryContent::OnAppStateChanged(AppState s)
+   {
+      Content.clear();
+   }
    
    /// <summary>Initialises control and populates</summary>
    /// <param name="lpCreateStruct">The create structure.</param>
@@ -211,11 +339,11 @@ NAMESPACE_BEGIN2(GUI,Controls)
          PopulateContent();
 
          // Ensure we have content
-         if (Content.size() == 0)
+         if (GetSuggestionCount() == 0)
             throw AlgorithmException(HERE, L"Unable to create list of zero suggestions");
 
          // Display contents
-         SetItemCountEx(Content.size());
+         SetItemCountEx(GetSuggestionCount());
          SetItemState(0, LVIS_SELECTED, LVIS_SELECTED);
 
          // Shrink to fit
@@ -246,21 +374,28 @@ NAMESPACE_BEGIN2(GUI,Controls)
    {
       try
       {
+         auto& list = reinterpret_cast<SuggestionList&>(ListView);
+
+         // Script re-parsed since list was sized: Skip
+         if (item.Index >= (int)list.GetSuggestionCount())
+            return;
+
          // Get item
-         auto data = reinterpret_cast<SuggestionList&>(ListView).Content[item.Index];
+         const wstring& text = list.GetSuggestionText(item.Index);
+         wstring        group = list.GetSuggestionType(item.Index);
 
          // Measure both items
-         CSize txt = dc->GetTextExtent(data.Text.c_str()),
-               type = dc->GetTextExtent(data.Type.c_str());
+         CSize txt = dc->GetTextExtent(text.c_str()),
+               type = dc->GetTextExtent(group.c_str());
 
          // TEXT: Truncate if necessary   [Indicates window has shrunk to maximum extent]
          if (txt.cx + type.cx > item.Rect.Width())
          {
             CRect rc(item.Rect.left, item.Rect.top, item.Rect.Width()-type.cx, item.Rect.bottom);
-            dc->DrawText(data.Text.c_str(), rc, DT_LEFT|DT_SINGLELINE|DT_END_ELLIPSIS);
+            dc->DrawText(text.c_str(), rc, DT_LEFT|DT_SINGLELINE|DT_END_ELLIPSIS);
          }
          else 
-            dc->DrawText(data.Text.c_str(), item.Rect, DT_LEFT|DT_SINGLELINE);
+            dc->DrawText(text.c_str(), item.Rect, DT_LEFT|DT_SINGLELINE);
 
 
          // Draw type in grey
@@ -268,7 +403,7 @@ NAMESPACE_BEGIN2(GUI,Controls)
             dc->SetTextColor(GetSysColor(COLOR_GRAYTEXT));
 
          // TYPE: RHS. Don't Truncate. 
-         dc->DrawText(data.Type.c_str(), item.Rect, DT_RIGHT|DT_SINGLELINE);
+         dc->DrawText(group.c_str(), item.Rect, DT_RIGHT|DT_SINGLELINE);
       }
       catch (ExceptionBase& e) {
          Console.Log(HERE, e);
@@ -336,9 +471,12 @@ NAMESPACE_BEGIN2(GUI,Controls)
       LVITEM& item = reinterpret_cast<NMLVDISPINFO*>(pNMHDR)->item;
       
       // Supply text/type
-      if (item.mask & LVIF_TEXT)
+      if ((item.mask & LVIF_TEXT) && item.iItem < (int)GetSuggestionCount())
       {
-         const wstring& txt = (item.iSubItem==0 ? Content[item.iItem].Text : Content[item.iItem].Type);
+         if (item.iSubItem != 0)
+            RetrievedType = GetSuggestionType(item.iItem);
+
+         const wstring& txt = (item.iSubItem==0 ? GetSuggestionText(item.iItem) : RetrievedType);
          item.pszText = (WCHAR*)txt.c_str();
       }
 
@@ -373,10 +511,9 @@ NAMESPACE_BEGIN2(GUI,Controls)
       int width = 0;
 
       // Measure visible items
-      for (int index = GetTopIndex(), end = min(GetTopIndex()+GetCountPerPage(), (int)Content.size()); index < end; ++index)
+      for (int index = GetTopIndex(), end = min(GetTopIndex()+GetCountPerPage(), (int)GetSuggestionCount()); index < end; ++index)
       {
-         auto& item = Content[index];
-         auto w = dc.GetTextExtent(item.Text.c_str()).cx + dc.GetTextExtent(item.Type.c_str()).cx + 10;
+         auto w = dc.GetTextExtent(GetSuggestionText(index).c_str()).cx + dc.GetTextExtent(GetSuggestionType(index).c_str()).cx + 10;
          width = max(w, width);
       }
 
@@ -386,7 +523,7 @@ NAMESPACE_BEGIN2(GUI,Controls)
       
       // Adjust for scrollBar
       auto wndWidth = width + 2*GetSystemMetrics(SM_CXEDGE);
-      if (GetCountPerPage() < (int)Content.size())
+      if (GetCountPerPage() < (int)GetSuggestionCount())
          wndWidth += GetSystemMetrics(SM_CXVSCROLL);
 
       // Resize window + column
@@ -396,49 +533,25 @@ NAMESPACE_BEGIN2(GUI,Controls)
       return 0;
    }
    
-   /// <summary>Populates the list.</summary>
+   /// <summary>Populates the list.  Library suggestions are shared, script suggestions are read from the sorted labels/variables of the script</summary>
    /// <returns></returns>
    void SuggestionList::PopulateContent() 
    {
-      // Clear previous
-      Content.clear();
-      
-      // Populate
       switch (SuggestionType)
       {
-      // Query GameObjectLibrary 
+      // Query libraries
       case Suggestion::GameObject:  
-         for (auto& obj : GameObjectLib.Query(L""))
-            Content.push_back( SuggestionItem(obj->Name, GetString(obj->Type)) );
-         break;
-
-      // Query ScriptObjectLibrary 
       case Suggestion::ScriptObject:
-         for (auto& obj : ScriptObjectLib.Query(L""))
-            Content.push_back( SuggestionItem(obj->Text, GetString(obj->Group)) );
+      case Suggestion::Command: 
+         Content = GetLibraryContent().Get(SuggestionType, Script->Game);
          break;
 
       // Query ScriptFile
       case Suggestion::Variable:    
-         for (auto& var : Script->Variables)
-            Content.push_back( SuggestionItem(var.Name, GetString(var.Type).c_str()) );
-         break;
-
-      // Query ScriptFile
       case Suggestion::Label:       
-         for (auto& lab : Script->Labels)
-            Content.push_back( SuggestionItem(lab.Name, VString(L"Line %d", lab.LineNumber)) );
-         break;
-
-      // Query SyntaxLibrary
-      case Suggestion::Command: 
-         for (auto& obj : SyntaxLib.Query(L"", Script->Game))
-            Content.push_back( SuggestionItem(obj->DisplayText, GetString(obj->Group), obj->Hash) );
+         Content.reset();
          break;
       }
-
-      // Sort keys alphabetically
-      sort(Content.begin(), Content.end(), [](SuggestionItem& a, SuggestionItem& b) {return a.Key < b.Key;} );
    }
    
    /// <summary>Shrinks to fit.</summary>
@@ -447,7 +560,7 @@ NAMESPACE_BEGIN2(GUI,Controls)
       try
       {
          // Check if less than 1 page of items
-         if (GetCountPerPage() > (int)Content.size() && !Content.empty())
+         if (GetCountPerPage() > (int)GetSuggestionCount() && GetSuggestionCount() > 0)
          {
             ClientRect wnd(this);
             CRect rc(0,0,0,0);
@@ -457,7 +570,7 @@ NAMESPACE_BEGIN2(GUI,Controls)
                throw Win32Exception(HERE, L"Unable to retrieve item height");
 
             // Resize
-            SetWindowPos(nullptr,-1,-1, wnd.Width(), rc.Height()*Content.size(), SWP_NOMOVE|SWP_NOZORDER|SWP_NOACTIVATE);
+            SetWindowPos(nullptr,-1,-1, wnd.Width(), rc.Height()*GetSuggestionCount(), SWP_NOMOVE|SWP_NOZORDER|SWP_NOACTIVATE);
          }
       }
       catch (ExceptionBase& e) { 
@@ -33,28 +33,54 @@ NAMESPACE_BEGIN2(GUI,Controls)
       {
          // --------------------- CONSTRUCTION ----------------------
       public:
-         SuggestionItem(const wstring& txt, const wstring& type, const wstring& sort) : Text(txt), Type(type), Key(sort)
+         SuggestionItem(const wstring& txt, const wstring& type, const wstring& sort) : Text(txt), Type(type), Key(GuiString(sort).ToLower())
          {}
-         SuggestionItem(const wstring& txt, const wstring& type) : Text(txt), Type(type), Key(txt)
+         SuggestionItem(const wstring& txt, const wstring& type) : Text(txt), Type(type), Key(GuiString(txt).ToLower())
          {}
 
-         // ---------------------- ACCESSORS ------------------------			
-      public:
-         int Match(const wstring& txt) const;
-
          // -------------------- REPRESENTATION ---------------------
       public:
          wstring Text,  // Item text
                  Type,  // Type/Group text
-                 Key;   // Sorting key
+                 Key;   // Sorting key (lower case)
       };
 
-      /// <summary>Vector of suggestion items</summary>
+      /// <summary>Vector of suggestion items, sorted by key</summary>
       class ContentArray : public vector<SuggestionItem>
       {
-         // ---------------------- ACCESSORS ------------------------			
+         // ----------------------- MUTATORS ------------------------
+      public:
+         void Sort();
+      };
+
+      /// <summary>Shared immutable suggestions</summary>
+      typedef shared_ptr<const ContentArray>  ContentArrayPtr;
+
+      /// <summary>Suggestions drawn from the game data libraries, shared by all lists and rebuilt once per game data load</summary>
+      class LibraryContent
+      {
+         // ------------------------ TYPES --------------------------
+      protected:
+         typedef pair<Suggestion,GameVersion>  ContentKey;
+
+         // --------------------- CONSTRUCTION ----------------------
+      public:
+         LibraryContent();
+
+         NO_COPY(LibraryContent);	// No copy semantics
+         NO_MOVE(LibraryContent);	// No move semantics
+
+         // ----------------------- MUTATORS ------------------------
       public:
-         int FindMatch(const wstring& txt) const;
+         ContentArrayPtr  Get(Suggestion type, GameVersion ver);
+
+      protected:
+         handler void OnAppStateChanged(AppState s);
+
+         // -------------------- REPRESENTATION ---------------------
+      protected:
+         map<ContentKey,ContentArrayPtr>  Content;              // Suggestions by type + game
+         AppStateChangedHandler           fnAppStateChanged;    // Discards suggestions when game data is loaded/unloaded
       };
 
       // --------------------- CONSTRUCTION ----------------------
@@ -68,6 +94,9 @@ NAMESPACE_BEGIN2(GUI,Controls)
 
    public:
       static CSize  GetDefaultSize(Suggestion type);
+
+   protected:
+      static LibraryContent&  GetLibraryContent();
 	  
       // --------------------- PROPERTIES ------------------------
 	  
@@ -75,11 +104,19 @@ NAMESPACE_BEGIN2(GUI,Controls)
    public:
       ScriptEdit* GetParent() const;
       wstring GetSelected() const;
+
+   protected:
+      int            FindMatch(const wstring& txt) const;
+      UINT           GetSuggestionCount() const;
+      wstring        GetSuggestionKey(UINT index) const;
+      const wstring& GetSuggestionText(UINT index) const;
+      wstring        GetSuggestionType(UINT index) const;
    
       // ----------------------- MUTATORS ------------------------
    public:
       BOOL Create(ScriptEdit* parent, CRect rc, Suggestion type, const ScriptFile* script);
       void MatchSuggestion(const ScriptToken& tok);
+      void Refresh();
 
    protected:
       void AdjustLayout();
@@ -101,8 +138,9 @@ NAMESPACE_BEGIN2(GUI,Controls)
       
       Suggestion            SuggestionType;
       SuggestionCustomDraw  CustomDraw;
-      ContentArray          Content;
+      ContentArrayPtr       Content;          // Current library suggestions  [Script suggestions are read from the script]
       const ScriptFile*     Script;
+      wstring               RetrievedType;    // Type text supplied by the last item retrieval
    public:
       afx_msg void OnLButtonDblClk(UINT nFlags, CPoint point);
    };
@@ -1,5 +1,6 @@
 #pragma once
 #include "WorkerData.h"
+#include "TaskScheduler.h"
 
 
 namespace Logic
@@ -7,7 +8,7 @@ namespace Logic
    namespace Threads
    {
 
-      /// <summary>Background worker pattern</summary>
+      /// <summary>Background worker pattern.  Operations execute upon the default task scheduler</summary>
       class LogicExport BackgroundWorker
       {
          // ------------------------ TYPES --------------------------
@@ -17,24 +18,22 @@ namespace Logic
       protected:
          /// <summary>Create background worker.</summary>
          /// <param name="pfn">worker function.</param>
+         /// <param name="dedicated">Whether the operation is long-running, and should execute upon its own thread rather than occupy a worker</param>
          /// <exception cref="Logic::ArgumentNullException">function is nullptr</exception>
-         BackgroundWorker(ThreadProc pfn) : Proc(pfn), Thread(nullptr)
+         BackgroundWorker(ThreadProc pfn, bool dedicated = false) : Proc(pfn), Data(nullptr), Dedicated(dedicated)
          {
             REQUIRED(pfn);
          }
       public:
-         /// <summary>Stops the background worker without throwing</summary>
+         /// <summary>Waits for the background worker without throwing</summary>
+         /// <remarks>Derived workers should call Shutdown() while their data still exists</remarks>
          virtual ~BackgroundWorker()
          {
-            // Terminate if still running
-            if (Thread)
+            // Tasks cannot be terminated: Cancel + wait if still running
+            if (IsRunning())
             {
-               // Feedback
-               Console << Cons::Error << "WARNING: " << Cons::White << "Terminating " << GetString(Data->Operation) << " Worker thread" << ENDL;
-
-               // Prematurely terminate
-               TerminateThread(Thread, -1);
-               Close();
+               Token.Cancel();
+               Current->Wait();
             }
          }
       
@@ -46,58 +45,39 @@ namespace Logic
       public:
          /// <summary>Gets the thread exit code.</summary>
          /// <returns></returns>
-         /// <exception cref="Logic::InvalidOperationException">Thread closed or still executing</exception>
-         /// <exception cref="Logic::Win32Exception">Unable to query Thread</exception>
+         /// <exception cref="Logic::InvalidOperationException">Thread closed, cancelled or still executing</exception>
          DWORD  GetExitCode() const
          {
-            DWORD code(0);
-
             // Check if closed
-            if (Thread == nullptr)
+            if (Current == nullptr)
                throw InvalidOperationException(HERE, L"Thread handle has been closed");
 
-            // Query thread 
-            if (!GetExitCodeThread(Thread, &code))
-               throw Win32Exception(HERE, L"Unable to query thread state");
-
             // Ensure exited
-            if (code == STILL_ACTIVE)
+            if (!Current->IsComplete())
                throw InvalidOperationException(HERE, L"Thread is still executing");
 
             // Success
-            return code;
+            return Current->GetResult();
          }
 
          /// <summary>Determines whether thread is running.</summary>
          /// <returns></returns>
-         /// <exception cref="Logic::Win32Exception">Unable to query Thread</exception>
          bool  IsRunning() const
          {
-            DWORD code(0);
-
-            // Check if closed
-            if (Thread == nullptr)
-               return false;
-
-            // Query thread state
-            if (!GetExitCodeThread(Thread, &code))
-               throw Win32Exception(HERE, L"Unable to query thread state");
-
             // return true if active
-            return code == STILL_ACTIVE;
+            return Current != nullptr && !Current->IsComplete();
          }
 
          // ----------------------- MUTATORS ------------------------
       public:
-         /// <summary>Closes the thread handle.</summary>
+         /// <summary>Releases the task.  A running operation continues until complete</summary>
          void  Close()
          {
-            // Close handle
-            CloseHandle(Thread);
-            Thread = nullptr;
+            // Release task
+            Current.reset();
          }
 
-         /// <summary>Sets the 'abort' flag and closes the thread handle</summary>
+         /// <summary>Sets the 'abort' flag and releases the task</summary>
          /// <exception cref="Logic::Win32Exception">Failed to stop Thread</exception>
          void  Stop()
          {
@@ -110,11 +90,25 @@ namespace Logic
          }
 
       protected:
+         /// <summary>Aborts the operation, if running, and waits for it to finish. Called by derived destructors</summary>
+         void  Shutdown()
+         {
+            if (IsRunning())
+            {
+               // Feedback
+               Console << Cons::Error << "WARNING: " << Cons::White << "Cancelling " << GetString(Data->Operation) << " Worker task" << ENDL;
+
+               // Request cancellation
+               Data->Abort();
+               Current->Wait();
+            }
+            Close();
+         }
+
          /// <summary>Starts the thread.</summary>
          /// <param name="param">operation data.</param>
          /// <exception cref="Logic::ArgumentNullException">param is nullptr -or- parent window is nullptr</exception>
          /// <exception cref="Logic::InvalidOperationException">Thread already running</exception>
-         /// <exception cref="Logic::Win32Exception">Failed to start Thread</exception>
          void  Start(WorkerData* param)
          {
             // Ensure data valid
@@ -122,21 +116,26 @@ namespace Logic
             REQUIRED(param->GetParent());
                
             // Ensure not started
-            if (Thread)
+            if (Current)
                throw InvalidOperationException(HERE, L"Thread already running");
 
-            // Launch thread
-            Thread = CreateThread(NULL, 0, (LPTHREAD_START_ROUTINE)Proc, (void*)(Data=param), NULL, NULL);
+            // Schedule operation.  Long-running operations are given their own thread
+            ThreadProc proc = Proc;
+            TaskFunction fn = [proc,param] (const CancellationToken&) { return proc(param); };
+            Data = param;
+            Token = param->Cancellation;
 
-            if (!Thread)
-               throw Win32Exception(HERE, L"Unable to start thread");
+            auto& scheduler = TaskScheduler::GetDefault();
+            Current = Dedicated ? scheduler.RunDedicated(fn, Token) : scheduler.Run(fn, Token);
          }
 
          // -------------------- REPRESENTATION ---------------------
       private:
          ThreadProc   Proc;
          WorkerData*  Data;
-         HANDLE       Thread;
+         TaskPtr      Current;      // Scheduled operation, if any
+         CancellationToken  Token;  // Cancellation token of current operation
+         const bool   Dedicated;    // Whether operation executes upon its own thread
       };
    
 
@@ -18,7 +18,7 @@ namespace Logic
          /// <summary>Adds successors nodes to the queue</summary>
          /// <param name="n">Node to visit</param>
          /// <exception cref="Logic::ArgumentNullException">Node is nullptr</exception>
-         void BreadthTraversal::AddSuccessors(CommandNodePtr& n)
+         void BreadthTraversal::AddSuccessors(CommandNode* n)
          {
             REQUIRED(n);
 
@@ -37,7 +37,7 @@ namespace Logic
          /// <summary>Pops the next node from the queue</summary>
          /// <returns></returns>
          /// <exception cref="Logic::AlgorithmException">Queue is empty</exception>
-         CommandNodePtr BreadthTraversal::GetSuccessor()
+         CommandNode* BreadthTraversal::GetSuccessor()
          {
             // Verify state
             if (Empty())
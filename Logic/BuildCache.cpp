@@ -0,0 +1,114 @@
+#include "stdafx.h"
+#include "BuildCache.h"
+#include "PreferencesLibrary.h"
+
+namespace Logic
+{
+   namespace Projects
+   {
+      // -------------------------------- CONSTRUCTION --------------------------------
+
+      /// <summary>Creates an empty cache for the current verification preferences</summary>
+      /// <param name="folder">Game data folder</param>
+      /// <param name="ver">Game data version</param>
+      /// <param name="lang">Game data language</param>
+      /// <param name="compiled">Whether scripts are compiled, or only verified</param>
+      BuildCache::BuildCache(Path folder, GameVersion ver, GameLanguage lang, bool compiled) 
+         : GameFolder(folder), Game(ver), Language(lang), Compiled(compiled), 
+           CheckArgumentNames(PrefsLib.CheckArgumentNames), 
+           CheckArgumentTypes(PrefsLib.CheckArgumentTypes), 
+           UseMacroCommands(PrefsLib.UseMacroCommands)
+      {
+      }
+
+      BuildCache::~BuildCache()
+      {
+      }
+
+      // ------------------------------- STATIC METHODS -------------------------------
+
+      /// <summary>Hashes a block of data</summary>
+      /// <param name="data">Data</param>
+      /// <param name="length">Length in bytes</param>
+      /// <param name="hash">Hash of preceding data, if any</param>
+      /// <returns></returns>
+      UINT64  BuildCache::GetHash(const BYTE* data, DWORD length, UINT64 hash)
+      {
+         // 64-bit FNV-1a
+         for (DWORD i = 0; i < length; ++i)
+            hash = (hash ^ data[i]) * 1099511628211ULL;
+
+         return hash;
+      }
+
+      /// <summary>Hashes the name, type and order of the arguments of a script, which are checked by the scripts calling it</summary>
+      /// <param name="script">Script properties</param>
+      /// <returns></returns>
+      UINT64  BuildCache::GetSignature(const ScriptFile& script)
+      {
+         UINT64 hash = GetHash(nullptr, 0);
+
+         for (const auto& arg : script.Variables.Arguments.SortByID)
+         {
+            UINT type = (UINT)arg.ParamType;
+            hash = GetHash((const BYTE*)arg.Name.c_str(), (arg.Name.length()+1) * sizeof(wchar), hash);
+            hash = GetHash((const BYTE*)&type, sizeof(type), hash);
+         }
+
+         return hash;
+      }
+
+      /// <summary>Gets the key of a path</summary>
+      /// <param name="path">Full path</param>
+      /// <returns></returns>
+      wstring  BuildCache::GetPathKey(const Path& path)
+      {
+         return GuiString(path.c_str()).ToLower();
+      }
+
+      // ------------------------------- PUBLIC METHODS -------------------------------
+
+      /// <summary>Adds or replaces the entry for a script</summary>
+      /// <param name="e">Entry</param>
+      void  BuildCache::Add(const BuildEntry& e)
+      {
+         Entries[GetPathKey(e.FullPath)] = e;
+      }
+
+      /// <summary>Removes all entries</summary>
+      void  BuildCache::Clear()
+      {
+         Entries.clear();
+      }
+
+      /// <summary>Finds the entry for a script</summary>
+      /// <param name="path">Full path</param>
+      /// <returns>Entry if found, otherwise nullptr</returns>
+      const BuildEntry*  BuildCache::Find(const Path& path) const
+      {
+         auto pos = Entries.find(GetPathKey(path));
+         return pos != Entries.end() ? &pos->second : nullptr;
+      }
+
+      /// <summary>Gets the number of entries</summary>
+      /// <returns></returns>
+      UINT  BuildCache::GetCount() const
+      {
+         return Entries.size();
+      }
+
+      /// <summary>Query whether the cache was built with the same game data, options and verification preferences as another</summary>
+      /// <param name="r">Other cache</param>
+      /// <returns></returns>
+      bool  BuildCache::Matches(const BuildCache& r) const
+      {
+         return GameFolder == r.GameFolder && Game == r.Game && Language == r.Language && Compiled == r.Compiled
+             && CheckArgumentNames == r.CheckArgumentNames && CheckArgumentTypes == r.CheckArgumentTypes && UseMacroCommands == r.UseMacroCommands;
+      }
+
+      // ------------------------------ PROTECTED METHODS -----------------------------
+
+      // ------------------------------- PRIVATE METHODS ------------------------------
+   }
+}
+
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "ScriptFile.h"
+
+namespace Logic
+{
+   namespace Projects
+   {
+      /// <summary>Error reported against a script by a project build</summary>
+      class LogicExport BuildDiagnostic
+      {
+      public:
+         BuildDiagnostic(UINT line, const wstring& msg, const wstring& txt) : Line(line), Message(msg), Text(txt)
+         {}
+
+         UINT     Line;      // 1-based line number  [zero if not applicable]
+         wstring  Message,   // Error message
+                  Text;      // Offending text
+      };
+
+      /// <summary>List of build diagnostics</summary>
+      typedef list<BuildDiagnostic>  DiagnosticList;
+
+      /// <summary>Signatures of the scripts called by a script, by script name</summary>
+      typedef map<wstring,UINT64>  ScriptCallMap;
+
+
+      /// <summary>Result of building a single script, and the inputs it was built from</summary>
+      class LogicExport BuildEntry
+      {
+         // --------------------- CONSTRUCTION ----------------------
+      public:
+         BuildEntry(Path path = Path()) : FullPath(path), SourceHash(0), Signature(0)
+         {}
+
+         DEFAULT_COPY(BuildEntry);	// Default copy semantics
+         DEFAULT_MOVE(BuildEntry);	// Default move semantics
+
+         // ---------------------- ACCESSORS ------------------------
+      public:
+         /// <summary>Query whether the script built without errors</summary>
+         /// <returns></returns>
+         bool  IsSuccessful() const
+         {
+            return Diagnostics.empty();
+         }
+
+         // -------------------- REPRESENTATION ---------------------
+      public:
+         Path            FullPath;      // Script path
+         wstring         Output;        // File name of compiled script within cache folder  [empty if not compiled]
+         UINT64          SourceHash,    // Hash of script file
+                         Signature;     // Hash of script arguments
+         ScriptCallMap   Calls;         // Signatures of scripts called, when built.  Edges of the dependency graph
+         DiagnosticList  Diagnostics;   // Errors, if any
+      };
+
+
+      /// <summary>Results of a previous project build, keyed by script path</summary>
+      /// <remarks>A script need not be rebuilt while its source hash and the signatures of the scripts it calls are unchanged.  The 
+      /// entire cache is discarded when built against different game data, or with different verification preferences</remarks>
+      class LogicExport BuildCache
+      {
+         // ------------------------ TYPES --------------------------
+      protected:
+         /// <summary>Entries by case-folded path</summary>
+         typedef map<wstring,BuildEntry>  EntryMap;
+
+         // --------------------- CONSTRUCTION ----------------------
+      public:
+         BuildCache(Path folder, GameVersion ver, GameLanguage lang, bool compiled);
+         virtual ~BuildCache();
+
+         DEFAULT_COPY(BuildCache);	// Default copy semantics
+         DEFAULT_MOVE(BuildCache);	// Default move semantics
+
+         // ------------------------ STATIC -------------------------
+      public:
+         static UINT64   GetHash(const BYTE* data, DWORD length, UINT64 hash = 14695981039346656037ULL);
+         static wstring  GetPathKey(const Path& path);
+         static UINT64   GetSignature(const ScriptFile& script);
+
+         // --------------------- PROPERTIES ------------------------
+      public:
+         PROPERTY_GET(UINT,Count,GetCount);
+
+         // ---------------------- ACCESSORS ------------------------
+      public:
+         /// <summary>Iterate thru entries</summary>
+         EntryMap::const_iterator begin() const  { return Entries.begin(); }
+         EntryMap::const_iterator end() const    { return Entries.end();   }
+
+         const BuildEntry*  Find(const Path& path) const;
+         UINT               GetCount() const;
+         bool               Matches(const BuildCache& r) const;
+
+         // ----------------------- MUTATORS ------------------------
+      public:
+         void  Add(const BuildEntry& e);
+         void  Clear();
+
+         // -------------------- REPRESENTATION ---------------------
+      public:
+         Path          GameFolder;    // Game data folder scripts were verified against
+         GameVersion   Game;          // Game data version
+         GameLanguage  Language;      // Game data language
+         bool          Compiled,              // Whether scripts were compiled, or only verified
+                       CheckArgumentNames,    // Verification preference: Script-call argument names
+                       CheckArgumentTypes,    // Verification preference: Script-call argument types
+                       UseMacroCommands;      // Verification preference: Macro commands
+
+      protected:
+         EntryMap      Entries;
+      };
+
+   }
+}
+
+using namespace Logic::Projects;
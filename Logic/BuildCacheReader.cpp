@@ -0,0 +1,138 @@
+#include "stdafx.h"
+#include "BuildCacheReader.h"
+
+namespace Logic
+{
+   namespace IO
+   {
+      // -------------------------------- CONSTRUCTION --------------------------------
+
+      /// <summary>Creates a build cache reader from an input stream</summary>
+      /// <param name="in">The input stream</param>
+      /// <exception cref="Logic::ArgumentException">Stream is not readable</exception>
+      /// <exception cref="Logic::ArgumentNullException">Stream is null</exception>
+      /// <exception cref="Logic::ComException">COM Error</exception>
+      BuildCacheReader::BuildCacheReader(StreamPtr in) : XmlReader(in)
+      {
+      }
+
+      BuildCacheReader::~BuildCacheReader()
+      {
+      }
+
+      // ------------------------------- STATIC METHODS -------------------------------
+
+      /// <summary>Parses a hexadecimal hash</summary>
+      /// <param name="str">Hash text</param>
+      /// <returns></returns>
+      /// <exception cref="Logic::FileFormatException">Invalid hash</exception>
+      UINT64  BuildCacheReader::ParseHash(const wstring& str)
+      {
+         wchar* end = nullptr;
+         UINT64 hash = _wcstoui64(str.c_str(), &end, 16);
+
+         // Ensure entire string consumed
+         if (str.empty() || *end != '\0')
+            throw FileFormatException(HERE, VString(L"Invalid hash '%s'", str.c_str()));
+
+         return hash;
+      }
+
+      // ------------------------------- PUBLIC METHODS -------------------------------
+
+      /// <summary>Reads the entire cache</summary>
+      /// <returns>New build cache</returns>
+      /// <exception cref="Logic::ComException">COM Error</exception>
+      /// <exception cref="Logic::FileFormatException">Corrupt XML / Missing elements / missing attributes</exception>
+      /// <exception cref="Logic::IOException">An I/O error occurred</exception>
+      BuildCache  BuildCacheReader::ReadFile()
+      {
+         try
+         {
+            // Read file
+            LoadDocument();
+
+            // Get root 
+            Root = Document->documentElement;
+            ReadElement(Root, L"build");
+
+            // Read game data + options
+            BuildCache cache(ReadAttribute(Root, L"folder"),
+                             (GameVersion)GuiString(ReadAttribute(Root, L"game")).ToInt(), 
+                             (GameLanguage)GuiString(ReadAttribute(Root, L"language")).ToInt(), 
+                             GuiString(ReadAttribute(Root, L"compiled")).ToInt() != 0);
+
+            // Read verification preferences
+            cache.CheckArgumentNames = GuiString(ReadAttribute(Root, L"checkArgumentNames")).ToInt() != 0;
+            cache.CheckArgumentTypes = GuiString(ReadAttribute(Root, L"checkArgumentTypes")).ToInt() != 0;
+            cache.UseMacroCommands = GuiString(ReadAttribute(Root, L"useMacroCommands")).ToInt() != 0;
+
+            // Read scripts
+            for (int i = 0, count = Root->childNodes->length; i < count; i++)
+            {
+               XmlNodePtr n = GetChild(Root, i, L"script");
+
+               if (n->nodeType == Xml::NODE_ELEMENT)
+                  cache.Add(ReadEntry(n));
+            }
+
+            return cache;
+         }
+         catch (_com_error& ex) {
+            throw ComException(HERE, ex);
+         }
+      }
+
+      // ------------------------------ PROTECTED METHODS -----------------------------
+
+      /// <summary>Reads the entry of a single script</summary>
+      /// <param name="n">script node</param>
+      /// <returns></returns>
+      /// <exception cref="Logic::ComException">COM Error</exception>
+      /// <exception cref="Logic::FileFormatException">Missing elements / missing attributes / invalid hash</exception>
+      BuildEntry  BuildCacheReader::ReadEntry(XmlNodePtr n)
+      {
+         try
+         {
+            // <script path="D:\X3 Albion Prelude\scripts\plugin.piracy.lib.logic.pck" source="..." signature="..." output="...">
+            ReadElement(n, L"script");
+            BuildEntry e(ReadAttribute(n, L"path"));
+            e.SourceHash = ParseHash(ReadAttribute(n, L"source"));
+            e.Signature = ParseHash(ReadAttribute(n, L"signature"));
+            TryReadAttribute(n, L"output", e.Output);
+
+            // Read calls + errors
+            for (int i = 0, count = n->childNodes->length; i < count; i++)
+            {
+               XmlNodePtr child = GetChild(n, i, L"script call or error");
+
+               if (child->nodeType != Xml::NODE_ELEMENT)
+                  continue;
+
+               // <call name="plugin.piracy.lib.ships" signature="..."/>
+               else if (child->nodeName == _bstr_t(L"call"))
+                  e.Calls[ReadAttribute(child, L"name")] = ParseHash(ReadAttribute(child, L"signature"));
+
+               // <error line="12" text="$ship">Unrecognised variable</error>
+               else if (child->nodeName == _bstr_t(L"error"))
+               {
+                  wstring text;
+                  TryReadAttribute(child, L"text", text);
+                  e.Diagnostics.push_back(BuildDiagnostic(GuiString(ReadAttribute(child, L"line")).ToInt(), (const wchar*)child->text, text));
+               }
+               // Unrecognised
+               else
+                  throw FileFormatException(HERE, L"Unrecognised build cache element");
+            }
+
+            return e;
+         }
+         catch (_com_error& ex) {
+            throw ComException(HERE, ex);
+         }
+      }
+
+      // ------------------------------- PRIVATE METHODS ------------------------------
+   
+   }
+}
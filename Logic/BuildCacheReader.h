@@ -0,0 +1,41 @@
+#pragma once
+
+#include "XmlReader.h"
+#include "BuildCache.h"
+
+namespace Logic
+{
+   namespace IO
+   {
+      
+      /// <summary>Reads the build cache of a project</summary>
+      class LogicExport BuildCacheReader : public XmlReader
+      {
+         // --------------------- CONSTRUCTION ----------------------
+      public:
+         BuildCacheReader(StreamPtr in);
+         virtual ~BuildCacheReader();
+
+         NO_COPY(BuildCacheReader);	// No copy semantics
+         NO_MOVE(BuildCacheReader);	// No move semantics
+
+         // ------------------------ STATIC -------------------------
+      protected:
+         static UINT64  ParseHash(const wstring& str);
+
+         // ----------------------- MUTATORS ------------------------
+      public:
+         BuildCache  ReadFile();
+
+      protected:
+         BuildEntry  ReadEntry(XmlNodePtr n);
+
+         // -------------------- REPRESENTATION ---------------------
+      private:
+         XmlNodePtr   Root;
+      };
+
+   }
+}
+
+using namespace Logic::IO;
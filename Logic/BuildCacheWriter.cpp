@@ -0,0 +1,97 @@
+#include "stdafx.h"
+#include "BuildCacheWriter.h"
+
+namespace Logic
+{
+   namespace IO
+   {
+   
+      // -------------------------------- CONSTRUCTION --------------------------------
+
+      /// <summary>Creates a build cache writer for an output stream</summary>
+      /// <exception cref="Logic::ArgumentException">Stream is not writeable</exception>
+      /// <exception cref="Logic::ArgumentNullException">Stream is null</exception>
+      /// <exception cref="Logic::ComException">COM Error</exception>
+      BuildCacheWriter::BuildCacheWriter(StreamPtr out) : XmlWriter(out)
+      {
+      }
+
+      BuildCacheWriter::~BuildCacheWriter()
+      {
+      }
+
+      // ------------------------------- STATIC METHODS -------------------------------
+
+      // ------------------------------- PUBLIC METHODS -------------------------------
+
+      /// <summary>Closes and flushes the output stream</summary>
+      void  BuildCacheWriter::Close()
+      {
+         __super::Close();
+      }
+
+      /// <summary>Writes the cache</summary>
+      /// <param name="c">The cache</param>
+      /// <exception cref="Logic::ComException">COM Error</exception>
+      /// <exception cref="Logic::IOException">An I/O error occurred</exception>
+      void  BuildCacheWriter::WriteFile(const BuildCache& c)
+      {
+         // Header
+         WriteInstruction(L"version='1.0' encoding='UTF-8'");
+         WriteComment(L"Written by X-Studio II");
+
+         // Root: Game data + options + verification preferences
+         auto root = WriteRoot(L"build");
+         WriteAttribute(root, L"folder", c.GameFolder.c_str());
+         WriteAttribute(root, L"game", (int)c.Game);
+         WriteAttribute(root, L"language", (int)c.Language);
+         WriteAttribute(root, L"compiled", c.Compiled ? 1 : 0);
+         WriteAttribute(root, L"checkArgumentNames", c.CheckArgumentNames ? 1 : 0);
+         WriteAttribute(root, L"checkArgumentTypes", c.CheckArgumentTypes ? 1 : 0);
+         WriteAttribute(root, L"useMacroCommands", c.UseMacroCommands ? 1 : 0);
+
+         // Write scripts
+         for (auto& pair : c)
+            WriteEntry(pair.second, root);
+      }
+
+      // ------------------------------ PROTECTED METHODS -----------------------------
+      
+      /// <summary>Writes the entry of a single script</summary>
+      /// <param name="e">Entry.</param>
+      /// <param name="parent">root node.</param>
+      /// <exception cref="Logic::ArgumentNullException">Parent is nullptr</exception>
+      void  BuildCacheWriter::WriteEntry(const BuildEntry& e, XmlElementPtr& parent)
+      {
+         REQUIRED(parent);
+
+         // <script path="D:\X3 Albion Prelude\scripts\plugin.piracy.lib.logic.pck" source="..." signature="..." output="...">
+         auto node = WriteElement(parent, L"script");
+         WriteAttribute(node, L"path", e.FullPath.c_str());
+         WriteAttribute(node, L"source", VString(L"%016llx", e.SourceHash));
+         WriteAttribute(node, L"signature", VString(L"%016llx", e.Signature));
+         if (!e.Output.empty())
+            WriteAttribute(node, L"output", e.Output);
+
+         // <call name="plugin.piracy.lib.ships" signature="..."/>
+         for (auto& call : e.Calls)
+         {
+            auto child = WriteElement(node, L"call");
+            WriteAttribute(child, L"name", call.first);
+            WriteAttribute(child, L"signature", VString(L"%016llx", call.second));
+         }
+
+         // <error line="12" text="$ship">Unrecognised variable</error>
+         for (auto& d : e.Diagnostics)
+         {
+            auto child = WriteElement(node, L"error", d.Message);
+            WriteAttribute(child, L"line", (int)d.Line);
+            if (!d.Text.empty())
+               WriteAttribute(child, L"text", d.Text);
+         }
+      }
+
+      // ------------------------------- PRIVATE METHODS ------------------------------
+   
+   }
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "XmlWriter.h"
+#include "BuildCache.h"
+
+namespace Logic
+{
+   namespace IO
+   {
+
+      /// <summary>Writes the build cache of a project</summary>
+      class LogicExport BuildCacheWriter : protected XmlWriter
+      {
+         // --------------------- CONSTRUCTION ----------------------
+      public:
+         BuildCacheWriter(StreamPtr out);
+         virtual ~BuildCacheWriter();
+
+         NO_COPY(BuildCacheWriter);	// No copy semantics
+         NO_MOVE(BuildCacheWriter);	// No move semantics
+
+         // ----------------------- MUTATORS ------------------------
+      public:
+         void  Close();
+         void  WriteFile(const BuildCache& c);
+
+      protected:
+         void  WriteEntry(const BuildEntry& e, XmlElementPtr& parent);
+      };
+
+   }
+}
+
+using namespace Logic::IO;
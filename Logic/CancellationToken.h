@@ -0,0 +1,50 @@
+#pragma once
+#include <atomic>
+
+namespace Logic
+{
+   namespace Threads
+   {
+
+      /// <summary>Flag used to request the cooperative cancellation of an operation and any tasks it has scheduled</summary>
+      /// <remarks>Copies share the same flag, so cancelling any copy cancels them all</remarks>
+      class LogicExport CancellationToken
+      {
+         // --------------------- CONSTRUCTION ----------------------
+      public:
+         /// <summary>Creates a new token that has not been cancelled</summary>
+         CancellationToken() : Flag(new std::atomic<bool>(false))
+         {}
+
+         DEFAULT_COPY(CancellationToken);	// Default copy semantics
+         DEFAULT_MOVE(CancellationToken);	// Default move semantics
+
+         // --------------------- PROPERTIES ------------------------
+      public:
+         PROPERTY_GET(bool,Cancelled,IsCancelled);
+
+         // ---------------------- ACCESSORS ------------------------
+      public:
+         /// <summary>Query whether cancellation has been requested</summary>
+         bool  IsCancelled() const
+         {
+            return Flag->load();
+         }
+
+         // ----------------------- MUTATORS ------------------------
+      public:
+         /// <summary>Requests cancellation</summary>
+         void  Cancel()
+         {
+            Flag->store(true);
+         }
+
+         // -------------------- REPRESENTATION ---------------------
+      protected:
+         shared_ptr<std::atomic<bool>>  Flag;    // Shared cancellation flag
+      };
+
+   }
+}
+
+using namespace Logic::Threads;
@@ -15,7 +15,7 @@ namespace Logic
       CatalogReader::CatalogReader(StreamPtr src) : StringReader(src)
       {
          // Consume header on first line
-         wstring line;
+         LineView line;
          StringReader::ReadLine(line);
       }
 
@@ -34,23 +34,25 @@ namespace Logic
       /// <exception cref="Logic::InvalidOperationException">Stream has been closed (reader has been move-copied)</exception>
       bool  CatalogReader::ReadDeclaration(wstring&  path, DWORD&  size)
       {
-         wstring  line;
+         LineView  line;
 
          // Check for EOF
          if (!StringReader::ReadLine(line))
             return false;
 
          // Parse declaration
-         wstring::size_type gap = line.find_last_of(' ');
-         /*if (gap == wstring::npos)
+         const WCHAR* gap = line.Text + line.Length;
+         while (gap > line.Text && *--gap != L' ')
+         {}
+         /*if (*gap != L' ')
             throw FileFormatException(HERE, L"Invalid file declaration");*/
          
          // Parse path: Convert '/'->'\'
          path.clear();
-         transform(line.begin(), line.begin()+gap, back_inserter(path), [](WCHAR ch)->WCHAR { return (ch == '/' ? '\\' : ch); } );
+         transform(line.Text, gap, back_inserter(path), [](WCHAR ch)->WCHAR { return (ch == '/' ? '\\' : ch); } );
 
-         // Parse size
-         size = atoi( string(line.begin()+gap+1, line.end()).c_str() );
+         // Parse size  [Line is followed by a line break or the terminating null]
+         size = wcstoul(gap+1, nullptr, 10);
          return true;
       }
 
@@ -0,0 +1,108 @@
+#include "stdafx.h"
+#include "CatalogWriter.h"
+#include "CatalogStream.h"
+#include "DataStream.h"
+
+namespace Logic
+{
+   namespace IO
+   {
+      // -------------------------------- CONSTRUCTION --------------------------------
+
+      /// <summary>Creates a catalog and its data file, overwriting any existing files</summary>
+      /// <param name="path">Full path of the catalog.  The data file is created alongside it with a .dat extension</param>
+      /// <exception cref="Logic::IOException">Unable to create data file</exception>
+      CatalogWriter::CatalogWriter(const Path& path)
+         : FullPath(path.RenameExtension(L".cat")),
+           Data(new FileStream(path.RenameExtension(L".dat"), FileMode::CreateAlways, FileAccess::Write)),
+           Buffer(new BYTE[CHUNK_SIZE])
+      {
+      }
+
+      /// <summary>Releases the data file. Catalogs that were not closed have no index</summary>
+      CatalogWriter::~CatalogWriter()
+      {
+      }
+
+      // ------------------------------- STATIC METHODS -------------------------------
+
+      // ------------------------------- PUBLIC METHODS -------------------------------
+
+      /// <summary>Gets the number of files in the catalog</summary>
+      /// <returns></returns>
+      UINT  CatalogWriter::GetCount() const
+      {
+         return Declarations.size();
+      }
+
+      /// <summary>Appends a file to the catalog</summary>
+      /// <param name="file">Full path of file</param>
+      /// <param name="subPath">Path relative to the game folder</param>
+      /// <exception cref="Logic::FileNotFoundException">File not found</exception>
+      /// <exception cref="Logic::InvalidOperationException">Catalog has been closed</exception>
+      /// <exception cref="Logic::IOException">An I/O error occurred</exception>
+      void  CatalogWriter::Add(const Path& file, const wstring& subPath)
+      {
+         Add(StreamPtr(new FileStream(file, FileMode::OpenExisting, FileAccess::Read)), subPath);
+      }
+
+      /// <summary>Appends the contents of a stream to the catalog</summary>
+      /// <param name="src">Input stream, read from the current position until the end</param>
+      /// <param name="subPath">Path relative to the game folder</param>
+      /// <exception cref="Logic::ArgumentNullException">Stream is null</exception>
+      /// <exception cref="Logic::InvalidOperationException">Catalog has been closed</exception>
+      /// <exception cref="Logic::IOException">An I/O error occurred</exception>
+      void  CatalogWriter::Add(StreamPtr src, const wstring& subPath)
+      {
+         REQUIRED(src);
+
+         // Verify state
+         if (!Data)
+            throw InvalidOperationException(HERE, L"Catalog has been closed");
+
+         DWORD size = 0;
+
+         // Encode + copy input in chunks
+         for (DWORD read; (read = src->Read(Buffer.get(), CHUNK_SIZE)) > 0; size += read)
+         {
+            DataStream::Encode(Buffer.get(), read);
+            Data->Write(Buffer.get(), read);
+         }
+
+         // Declare file  [Use backslashes within catalog]
+         wstring path(subPath);
+         replace(path.begin(), path.end(), L'/', L'\\');
+         Declarations.push_back(Declaration(path, size));
+      }
+
+      /// <summary>Closes the data file and writes the catalog</summary>
+      /// <exception cref="Logic::IOException">An I/O error occurred</exception>
+      void  CatalogWriter::Close()
+      {
+         // Verify state
+         if (!Data)
+            return;
+
+         Data->Close();
+         Data.reset();
+
+         // Header: Data file name
+         wstring index(FullPath.RenameExtension(L".dat").FileName + L"\n");
+
+         // Declarations: Path + size
+         for (auto& d : Declarations)
+            index += GuiString::Format(L"%s %u\n", d.SubPath.c_str(), d.Size);
+
+         // Encode + write
+         string text = GuiString::Convert(index, CP_ACP);
+         CatalogStream cat(FullPath, FileMode::CreateAlways, FileAccess::Write);
+         cat.Write((const BYTE*)text.c_str(), text.length());
+         cat.Close();
+      }
+
+      // ------------------------------ PROTECTED METHODS -----------------------------
+
+      // ------------------------------- PRIVATE METHODS ------------------------------
+
+   }
+}
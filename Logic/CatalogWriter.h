@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Stream.h"
+
+namespace Logic
+{
+   namespace IO
+   {
+
+      /// <summary>Builds a catalog by streaming files into an encoded data file, then writing the matching encoded index</summary>
+      /// <remarks>Each file is read once, in chunks, and written immediately.  Only the declarations are held in memory.</remarks>
+      class LogicExport CatalogWriter
+      {
+         // ------------------------ TYPES --------------------------
+      protected:
+         /// <summary>Catalog file declaration</summary>
+         class Declaration
+         {
+         public:
+            Declaration(const wstring& path, DWORD size) : SubPath(path), Size(size)
+            {}
+
+            wstring  SubPath;    // Path relative to game folder
+            DWORD    Size;       // Length within data file
+         };
+
+      private:
+         static const DWORD  CHUNK_SIZE = 64*1024;
+
+         // --------------------- CONSTRUCTION ----------------------
+      public:
+         CatalogWriter(const Path& path);
+         virtual ~CatalogWriter();
+
+         NO_COPY(CatalogWriter);	// No copy semantics
+         NO_MOVE(CatalogWriter);	// No move semantics
+
+         // --------------------- PROPERTIES ------------------------
+      public:
+         PROPERTY_GET(UINT,Count,GetCount);
+
+         // ---------------------- ACCESSORS ------------------------
+      public:
+         UINT  GetCount() const;
+
+         // ----------------------- MUTATORS ------------------------
+      public:
+         void  Add(const Path& file, const wstring& subPath);
+         void  Add(StreamPtr src, const wstring& subPath);
+         void  Close();
+
+         // -------------------- REPRESENTATION ---------------------
+      protected:
+         Path               FullPath;        // Full path of catalog
+         StreamPtr          Data;            // Data file, or nullptr once closed
+         list<Declaration>  Declarations;    // Declarations in data file order
+         ByteArrayPtr       Buffer;          // Transfer buffer
+      };
+
+   }
+}
+
+using namespace Logic::IO;
@@ -0,0 +1,785 @@
+#include "stdafx.h"
+#include "CodeArrayReader.h"
+
+namespace Logic
+{
+   namespace IO
+   {
+      /// <summary>Query whether a character is XML whitespace</summary>
+      /// <param name="ch">The character</param>
+      /// <returns></returns>
+      static bool  IsSpace(wchar ch)
+      {
+         return ch == L' ' || ch == L'\t' || ch == L'\r' || ch == L'\n';
+      }
+
+      /// <summary>Query whether a character terminates an element name</summary>
+      /// <param name="ch">The character</param>
+      /// <returns></returns>
+      static bool  IsNameEnd(wchar ch)
+      {
+         return IsSpace(ch) || ch == L'/' || ch == L'>';
+      }
+
+      /// <summary>Skips whitespace</summary>
+      /// <param name="pos">Position to search from</param>
+      /// <param name="end">End of text</param>
+      /// <returns>Position of the first non-whitespace character, or 'end' if none</returns>
+      static const wchar*  SkipSpace(const wchar* pos, const wchar* end)
+      {
+         while (pos < end && IsSpace(*pos))
+            ++pos;
+         return pos;
+      }
+
+      // -------------------------------- CONSTRUCTION --------------------------------
+
+      /// <summary>Creates a reader without any text</summary>
+      CodeArrayReader::CodeArrayReader() 
+         : Position(nullptr), End(nullptr), LineStart(nullptr), Line(1), Capacity(0), Exhausted(true)
+      {
+      }
+
+      /// <summary>Nothing</summary>
+      CodeArrayReader::~CodeArrayReader()
+      {
+      }
+
+      // ------------------------------- STATIC METHODS -------------------------------
+
+      /// <summary>Get script value type string</summary>
+      /// <param name="t">The type</param>
+      /// <returns>Value of the 'type' attribute</returns>
+      wstring  CodeArrayReader::GetString(ScriptValueType t)
+      {
+         switch (t)
+         {
+         case ScriptValueType::Int:     return L"int";
+         case ScriptValueType::String:  return L"string";
+         case ScriptValueType::Array:   return L"array";
+         default:                       return L"unknown";
+         }
+      }
+
+      /// <summary>Gets the value of an integer script value</summary>
+      /// <param name="v">The value</param>
+      /// <param name="help">Meaning of value</param>
+      /// <returns>Integer value</returns>
+      /// <exception cref="Logic::FileFormatException">Not an integer value</exception>
+      int  CodeArrayReader::ToInt(const ScriptValue& v, const wchar* help)
+      {
+         if (v.Type != ScriptValueType::Int)
+            throw FileFormatException(HERE, VString(L"Cannot read %s from %s <sval> node with value '%s'", help, GetString(v.Type).c_str(), v.String.c_str()));
+
+         return v.Int;
+      }
+
+      /// <summary>Gets the value of a string script value</summary>
+      /// <param name="v">The value</param>
+      /// <param name="help">Meaning of value</param>
+      /// <returns>String value</returns>
+      /// <exception cref="Logic::FileFormatException">Not a string value</exception>
+      wstring  CodeArrayReader::ToString(const ScriptValue& v, const wchar* help)
+      {
+         if (v.Type != ScriptValueType::String)
+            throw FileFormatException(HERE, VString(L"Cannot read %s from %s <sval> node with value '%s'", help, GetString(v.Type).c_str(), v.String.c_str()));
+
+         return v.String;
+      }
+
+      /// <summary>Gets the value of a string or integer script value</summary>
+      /// <param name="v">The value</param>
+      /// <param name="help">Meaning of value</param>
+      /// <returns>String/Int value</returns>
+      /// <exception cref="Logic::FileFormatException">Not a string/integer value</exception>
+      ParameterValue  CodeArrayReader::ToValue(const ScriptValue& v, const wchar* help)
+      {
+         switch (v.Type)
+         {
+         case ScriptValueType::String:  return ParameterValue(v.String);
+         case ScriptValueType::Int:     return ParameterValue(v.Int);
+         default:                       break;
+         }
+
+         // Unknown type
+         throw FileFormatException(HERE, VString(L"Cannot read %s from %s <sval> node with value '%s'", help, GetString(v.Type).c_str(), v.String.c_str()));
+      }
+
+      /// <summary>Parses an integer the same way as _wtoi. Leading whitespace is skipped, out of range values are clamped</summary>
+      /// <param name="str">The string</param>
+      /// <returns>Integer value, or zero if none</returns>
+      int  CodeArrayReader::ParseInt(const wstring& str)
+      {
+         const wchar* pos = str.c_str();
+         long long    value = 0;
+         bool         negative = false;
+
+         // Whitespace, sign
+         while (IsSpace(*pos))
+            ++pos;
+         if (*pos == L'-' || *pos == L'+')
+            negative = (*pos++ == L'-');
+
+         // Digits: Saturate beyond range of int
+         for (; *pos >= L'0' && *pos <= L'9'; ++pos)
+            if ((value = value * 10 + (*pos - L'0')) > 0x80000000LL)
+               value = 0x80000000LL;
+
+         if (negative)
+            return (int)-value;
+         return value > INT_MAX ? INT_MAX : (int)value;
+      }
+
+
+      // ------------------------------- PUBLIC METHODS -------------------------------
+
+      /// <summary>Query whether the current array contains another value</summary>
+      /// <returns></returns>
+      /// <exception cref="Logic::FileFormatException">Malformed XML</exception>
+      /// <exception cref="Logic::IOException">An I/O error occurred</exception>
+      bool  CodeArrayReader::HasNext()
+      {
+         // Self-closing arrays have no values
+         if (!Frames.empty() && !Frames.back().Open)
+            return false;
+
+         SkipMarkup();
+         return Ensure(2) && Position[0] == L'<' && Position[1] != L'/';
+      }
+
+      /// <summary>Locates the codearray element within text that has already been decoded</summary>
+      /// <param name="text">Decoded text of the file. Must remain valid while reading</param>
+      /// <param name="length">Length of text, in characters</param>
+      /// <exception cref="Logic::ArgumentNullException">Text is null</exception>
+      /// <exception cref="Logic::FileFormatException">Missing codearray node</exception>
+      void  CodeArrayReader::Load(const wchar* text, UINT length)
+      {
+         REQUIRED(text);
+
+         // Read text in place
+         Source.reset();
+         Decoder.reset();
+         Chunk.reset();
+         Window.reset();
+         Capacity = 0;
+         Exhausted = true;
+
+         Position = LineStart = text;
+         End = text + length;
+         Line = 1;
+
+         FindCodeArray();
+      }
+
+      /// <summary>Locates the codearray element, decoding the stream only as far as necessary</summary>
+      /// <param name="in">Input stream, positioned at the start of the file.  Must remain open while reading</param>
+      /// <exception cref="Logic::ArgumentNullException">Stream is null</exception>
+      /// <exception cref="Logic::FileFormatException">Missing codearray node</exception>
+      /// <exception cref="Logic::IOException">An I/O error occurred</exception>
+      void  CodeArrayReader::Load(StreamPtr in)
+      {
+         const BYTE  utf8[3] = { 0xEF, 0xBB, 0xBF },    // UTF-8 byte ordering header
+                     utf16[2] = { 0xFF, 0xFE };         // UTF-16 byte ordering header
+         REQUIRED(in);
+
+         // Prepare empty window
+         Source = in;
+         Chunk.reset(new BYTE[CHUNK_SIZE]);
+         Capacity = 2*CHUNK_SIZE;
+         Window.reset(new wchar[Capacity]);
+         Exhausted = false;
+
+         Position = End = LineStart = Window.get();
+         Line = 1;
+
+         // Read first chunk, identify encoding from byte ordering header: UTF-16 is copied, UTF-8 and ANSI (Windows-1250) are decoded
+         DWORD count = ReadChunk(),
+               offset = 0;
+
+         if (count >= 2 && memcmp(Chunk.get(), utf16, 2) == 0)
+         {
+            Decoder.reset();
+            offset = 2;
+         }
+         else
+         {
+            bool isUTF8 = (count >= 3 && memcmp(Chunk.get(), utf8, 3) == 0);
+            Decoder.reset(new TextDecoder(isUTF8 ? TextDecoder::Encoding::UTF8 : TextDecoder::Encoding::Windows1250));
+            offset = (isUTF8 ? 3 : 0);
+         }
+
+         // Decode, excluding header
+         End += DecodeChunk(Chunk.get() + offset, count - offset, Window.get());
+         FindCodeArray();
+      }
+
+      /// <summary>Enters an array.  Integer zero is accepted as an empty array</summary>
+      /// <param name="help">Meaning of array</param>
+      /// <returns>Declared size of the array</returns>
+      /// <exception cref="Logic::FileFormatException">Not an array sval node / Malformed XML</exception>
+      /// <exception cref="Logic::IOException">An I/O error occurred</exception>
+      UINT  CodeArrayReader::ReadArray(const wchar* help)
+      {
+         bool open;
+         Read(Current, open, help);
+
+         // Array: Read size.  Int: Permit iff zero
+         if (Current.Type != ScriptValueType::Array && !(Current.Type == ScriptValueType::Int && Current.String == L"0"))
+            throw FileFormatException(HERE, GetLineNumber(), VString(L"Cannot read %s from %s <sval> node with value '%s'", help, GetString(Current.Type).c_str(), Current.String.c_str()));
+
+         UINT size = (Current.Type == ScriptValueType::Array ? (UINT)Current.Int : 0);
+         Frames.push_back(Frame(size, open));
+         return size;
+      }
+
+      /// <summary>Leaves the current array, skipping any values not read</summary>
+      /// <exception cref="Logic::InvalidOperationException">No array has been entered</exception>
+      /// <exception cref="Logic::FileFormatException">Malformed XML</exception>
+      /// <exception cref="Logic::IOException">An I/O error occurred</exception>
+      void  CodeArrayReader::EndArray()
+      {
+         if (Frames.empty())
+            throw InvalidOperationException(HERE, L"No array has been entered");
+
+         // Skip remaining values and the closing tag
+         SkipChildren(Frames.back().Open);
+         Frames.pop_back();
+      }
+
+      /// <summary>Reads the next integer value</summary>
+      /// <param name="help">Meaning of value</param>
+      /// <returns>Integer value</returns>
+      /// <exception cref="Logic::FileFormatException">Not an integer sval node / Malformed XML</exception>
+      /// <exception cref="Logic::IOException">An I/O error occurred</exception>
+      int  CodeArrayReader::ReadInt(const wchar* help)
+      {
+         bool open;
+         Read(Current, open, help);
+         SkipChildren(open);
+
+         return ToInt(Current, help);
+      }
+
+      /// <summary>Reads the next string value</summary>
+      /// <param name="help">Meaning of value</param>
+      /// <returns>String value</returns>
+      /// <exception cref="Logic::FileFormatException">Not a string sval node / Malformed XML</exception>
+      /// <exception cref="Logic::IOException">An I/O error occurred</exception>
+      wstring  CodeArrayReader::ReadString(const wchar* help)
+      {
+         bool open;
+         Read(Current, open, help);
+         SkipChildren(open);
+
+         return ToString(Current, help);
+      }
+
+      /// <summary>Reads the next string or integer value</summary>
+      /// <param name="help">Meaning of value</param>
+      /// <returns>String/Int value</returns>
+      /// <exception cref="Logic::FileFormatException">Not a string/integer sval node / Malformed XML</exception>
+      /// <exception cref="Logic::IOException">An I/O error occurred</exception>
+      ParameterValue  CodeArrayReader::ReadValue(const wchar* help)
+      {
+         bool open;
+         Read(Current, open, help);
+         SkipChildren(open);
+
+         return ToValue(Current, help);
+      }
+
+      /// <summary>Reads every value of an array, such as a command.  The children of nested arrays are skipped</summary>
+      /// <param name="values">On return, contains the values.  Existing elements are reused</param>
+      /// <param name="help">Meaning of array</param>
+      /// <exception cref="Logic::FileFormatException">Not an array sval node / Malformed XML</exception>
+      /// <exception cref="Logic::IOException">An I/O error occurred</exception>
+      void  CodeArrayReader::ReadValues(ScriptValueArray& values, const wchar* help)
+      {
+         UINT count = 0;
+         bool open;
+
+         // Read values, overwriting previous
+         ReadArray(help);
+         for (; HasNext(); ++count)
+         {
+            if (count == values.size())
+               values.push_back(ScriptValue());
+
+            Read(values[count], open, help);
+            SkipChildren(open);
+         }
+         EndArray();
+
+         // Discard surplus
+         values.resize(count);
+      }
+
+      /// <summary>Skips the next value, and its children</summary>
+      /// <param name="help">Meaning of value</param>
+      /// <exception cref="Logic::FileFormatException">Malformed XML</exception>
+      /// <exception cref="Logic::IOException">An I/O error occurred</exception>
+      void  CodeArrayReader::Skip(const wchar* help)
+      {
+         bool open;
+         Read(Current, open, help);
+         SkipChildren(open);
+      }
+
+      // ------------------------------ PROTECTED METHODS -----------------------------
+
+      /// <summary>Gets the one-based line number of the current position</summary>
+      /// <returns></returns>
+      UINT  CodeArrayReader::GetLineNumber() const
+      {
+         return Line + (UINT)count(LineStart, Position, L'\n');
+      }
+
+      /// <summary>Reads the start tag of the next value of the current array</summary>
+      /// <param name="value">On return, contains the value</param>
+      /// <param name="open">On return, indicates whether the element has children and a closing tag</param>
+      /// <param name="help">Meaning of value</param>
+      /// <exception cref="Logic::FileFormatException">No further values / Not an sval node / Missing attribute / Malformed XML</exception>
+      /// <exception cref="Logic::IOException">An I/O error occurred</exception>
+      void  CodeArrayReader::Read(ScriptValue& value, bool& open, const wchar* help)
+      {
+         bool hasType = false, 
+              hasValue = false, 
+              hasSize = false;
+
+         // Ensure array has another value
+         if (!Frames.empty())
+         {
+            if (!HasNext())
+               throw FileFormatException(HERE, GetLineNumber(), VString(L"Cannot read %s from node %d of %d", help, Frames.back().Index+1, Frames.back().Index));
+            Frames.back().Index++;
+         }
+         else
+            SkipMarkup();
+
+         // Ensure node is script value
+         if (!Ensure(1) || *Position != L'<')
+            throw FileFormatException(HERE, GetLineNumber(), L"Unexpected text while searching for '<sval>' element");
+
+         // Ensure entire start tag has been decoded
+         UINT length = FindTagEnd();
+         const wchar *tagEnd = Position + length,
+                     *name = Position+1,
+                     *nameEnd = find_if(name, tagEnd, IsNameEnd);
+         if (nameEnd - name != 4 || wcsncmp(name, L"sval", 4) != 0)
+            throw FileFormatException(HERE, GetLineNumber(), VString(L"Unexpected '<%s>' element while searching for '<sval>' element", wstring(name, nameEnd).c_str()));
+         Position = nameEnd;
+
+         // Read attributes
+         value.Type = ScriptValueType::Unknown;
+         value.Int = 0;
+         value.String.clear();
+
+         for (Position = SkipSpace(Position, tagEnd); *Position != L'/' && *Position != L'>'; Position = SkipSpace(Position, tagEnd))
+         {
+            ReadAttribute(tagEnd, Name, Text);
+
+            if (Name == L"type")
+            {
+               hasType = true;
+               value.Type = Text == L"int" ? ScriptValueType::Int
+                          : Text == L"string" ? ScriptValueType::String
+                          : Text == L"array" ? ScriptValueType::Array : ScriptValueType::Unknown;
+            }
+            else if (Name == L"val")
+            {
+               hasValue = true;
+               value.String = Text;
+            }
+            else if (Name == L"size")
+            {
+               hasSize = true;
+               value.Int = ParseInt(Text);
+            }
+         }
+
+         // End of start tag
+         if (*Position == L'/')
+            ++Position;
+         if (Position != tagEnd)
+            throw FileFormatException(HERE, GetLineNumber(), L"Unterminated <sval> element");
+         open = (Position[-1] != L'/');
+         ++Position;
+
+         // Ensure required attributes are present : "Missing '%s' attribute on '<%s>' element"
+         if (!hasType)
+            throw FileFormatException(HERE, GetLineNumber(), L"Missing 'type' attribute on '<sval>' element");
+         else if (value.Type == ScriptValueType::Array && !hasSize)
+            throw FileFormatException(HERE, GetLineNumber(), L"Missing 'size' attribute on '<sval>' element");
+         else if (value.Type != ScriptValueType::Array && !hasValue)
+            throw FileFormatException(HERE, GetLineNumber(), L"Missing 'val' attribute on '<sval>' element");
+
+         // Int: Parse value
+         if (value.Type == ScriptValueType::Int)
+            value.Int = ParseInt(value.String);
+      }
+
+      /// <summary>Reads an attribute of the current start tag</summary>
+      /// <param name="end">Position of the '>' that ends the start tag</param>
+      /// <param name="name">On return, contains the name</param>
+      /// <param name="value">On return, contains the decoded and normalized value</param>
+      /// <exception cref="Logic::FileFormatException">Malformed attribute</exception>
+      void  CodeArrayReader::ReadAttribute(const wchar* end, wstring& name, wstring& value)
+      {
+         // Name
+         const wchar* start = Position;
+         while (Position < end && *Position != L'=' && !IsNameEnd(*Position))
+            ++Position;
+         name.assign(start, Position);
+
+         // Equals
+         Position = SkipSpace(Position, end);
+         if (*Position != L'=')
+            throw FileFormatException(HERE, GetLineNumber(), VString(L"Malformed '%s' attribute on '<sval>' element", name.c_str()));
+         Position = SkipSpace(Position+1, end);
+
+         // Quoted value
+         wchar quote = *Position;
+         const wchar* close = (quote == L'"' || quote == L'\'' ? find(Position+1, end, quote) : end);
+         if (close == end)
+            throw FileFormatException(HERE, GetLineNumber(), VString(L"Malformed '%s' attribute on '<sval>' element", name.c_str()));
+
+         ++Position;
+         ReadText(close, value);
+         Position = close + 1;
+      }
+
+      /// <summary>Consumes an sval closing tag</summary>
+      /// <exception cref="Logic::FileFormatException">Missing closing tag</exception>
+      /// <exception cref="Logic::IOException">An I/O error occurred</exception>
+      void  CodeArrayReader::ReadCloseTag()
+      {
+         SkipMarkup();
+
+         // Expect '</sval>'
+         if (!Ensure(6) || wcsncmp(Position, L"</sval", 6) != 0)
+            throw FileFormatException(HERE, GetLineNumber(), L"Missing '</sval>' closing tag");
+
+         UINT length = FindTagEnd();
+         if (SkipSpace(Position+6, Position+length) != Position+length)
+            throw FileFormatException(HERE, GetLineNumber(), L"Missing '</sval>' closing tag");
+         Position += length+1;
+      }
+
+      /// <summary>Decodes attribute text: replaces entity references and normalizes whitespace as an XML parser does</summary>
+      /// <param name="end">End of text</param>
+      /// <param name="value">On return, contains the decoded text</param>
+      /// <exception cref="Logic::FileFormatException">Unrecognised entity</exception>
+      void  CodeArrayReader::ReadText(const wchar* end, wstring& value)
+      {
+         value.clear();
+
+         for (const wchar* pos = Position; pos < end; ++pos)
+            switch (*pos)
+            {
+            // Line break: CRLF is a single space
+            case L'\r':
+               if (pos+1 < end && pos[1] == L'\n')
+                  ++pos;
+               // [Fall through]
+            case L'\n':
+            case L'\t':
+               value += L' ';
+               break;
+
+            // Entity
+            case L'&':
+               {
+                  const wchar* semi = find(pos, end, L';');
+                  wstring entity(pos+1, semi);
+                  UINT ch = 0;
+
+                  if (semi == end)
+                     throw FileFormatException(HERE, GetLineNumber(), L"Unterminated entity reference in <sval> attribute");
+
+                  if (entity == L"lt")         ch = L'<';
+                  else if (entity == L"gt")    ch = L'>';
+                  else if (entity == L"amp")   ch = L'&';
+                  else if (entity == L"quot")  ch = L'"';
+                  else if (entity == L"apos")  ch = L'\'';
+                  else if (entity.length() > 1 && entity[0] == L'#')
+                     ch = (entity[1] == L'x' ? wcstoul(entity.c_str()+2, nullptr, 16) : wcstoul(entity.c_str()+1, nullptr, 10));
+
+                  if (ch == 0 || ch > 0x10FFFF)
+                     throw FileFormatException(HERE, GetLineNumber(), VString(L"Unrecognised entity '&%s;' in <sval> attribute", entity.c_str()));
+
+                  // Supplementary: Encode as surrogate pair where necessary
+                  if (ch >= 0x10000 && sizeof(wchar) == 2)
+                  {
+                     value += static_cast<wchar>(0xD800 + ((ch - 0x10000) >> 10));
+                     value += static_cast<wchar>(0xDC00 + ((ch - 0x10000) & 0x3FF));
+                  }
+                  else
+                     value += static_cast<wchar>(ch);
+
+                  pos = semi;
+               }
+               break;
+
+            default:
+               value += *pos;
+               break;
+            }
+      }
+
+      /// <summary>Skips the children of an element, and its closing tag, without decoding them</summary>
+      /// <param name="open">Whether the element has children and a closing tag</param>
+      /// <exception cref="Logic::FileFormatException">Malformed XML</exception>
+      /// <exception cref="Logic::IOException">An I/O error occurred</exception>
+      void  CodeArrayReader::SkipChildren(bool open)
+      {
+         // Match tags by depth alone.  Attributes and text are not examined
+         for (UINT depth = (open ? 1 : 0); depth > 0; )
+         {
+            if (!FindTag())
+               throw FileFormatException(HERE, GetLineNumber(), L"Missing '</sval>' closing tag");
+
+            // Comment / Processing instruction
+            if (IsMarkup())
+            {
+               SkipMarkup();
+               continue;
+            }
+
+            // Closing / Empty / Start tag
+            bool closing = (Ensure(2) && Position[1] == L'/');
+            UINT length = FindTagEnd();
+            bool empty = (Position[length-1] == L'/');
+            Position += length+1;
+
+            if (closing)
+               --depth;
+            else if (!empty)
+               ++depth;
+         }
+      }
+
+      /// <summary>Skips whitespace, comments and processing instructions</summary>
+      /// <exception cref="Logic::FileFormatException">Unterminated comment</exception>
+      /// <exception cref="Logic::IOException">An I/O error occurred</exception>
+      void  CodeArrayReader::SkipMarkup()
+      {
+         for (SkipWhitespace(); IsMarkup(); SkipWhitespace())
+         {
+            // Comment / Processing instruction: Skip to end
+            if (Position[1] == L'!')
+            {
+               Position += 4;
+               SkipPast(L"-->");
+            }
+            else
+            {
+               Position += 2;
+               SkipPast(L"?>");
+            }
+         }
+      }
+
+      /// <summary>Skips whitespace</summary>
+      /// <exception cref="Logic::IOException">An I/O error occurred</exception>
+      void  CodeArrayReader::SkipWhitespace()
+      {
+         do 
+         {
+            Position = SkipSpace(Position, End);
+         } 
+         while (Position == End && Refill());
+      }
+
+		// ------------------------------- PRIVATE METHODS ------------------------------
+
+      /// <summary>Converts a chunk of input to text</summary>
+      /// <param name="bytes">Input bytes</param>
+      /// <param name="count">Number of bytes</param>
+      /// <param name="output">Output buffer.  Must have space for one character per byte, plus four</param>
+      /// <returns>Number of characters written</returns>
+      UINT  CodeArrayReader::DecodeChunk(const BYTE* bytes, DWORD count, wchar* output)
+      {
+         // UTF-16: Copy whole characters
+         if (!Decoder)
+         {
+            memcpy(output, bytes, count & ~1);
+            return count / 2;
+         }
+
+         // UTF-8/ANSI: Decode, replacing any incomplete sequence at the end of the stream
+         return (UINT)Decoder->Decode(bytes, count, output, Exhausted);
+      }
+
+      /// <summary>Decodes more of the stream until at least the specified number of characters are available</summary>
+      /// <param name="length">Number of characters</param>
+      /// <returns>False if the input ends first</returns>
+      /// <exception cref="Logic::IOException">An I/O error occurred</exception>
+      bool  CodeArrayReader::Ensure(UINT length)
+      {
+         while ((UINT)(End - Position) < length)
+            if (!Refill())
+               return false;
+
+         return true;
+      }
+
+      /// <summary>Searches elements until the codearray start tag has been consumed</summary>
+      /// <exception cref="Logic::FileFormatException">Missing codearray node</exception>
+      /// <exception cref="Logic::IOException">An I/O error occurred</exception>
+      void  CodeArrayReader::FindCodeArray()
+      {
+         Frames.clear();
+
+         while (FindTag())
+         {
+            // Skip comments, processing instructions, declarations, closing tags
+            if (IsMarkup())
+            {
+               SkipMarkup();
+               continue;
+            }
+            else if (!Ensure(2) || Position[1] == L'!' || Position[1] == L'/')
+            {
+               ++Position;
+               continue;
+            }
+
+            // Element: Compare name
+            UINT length = FindTagEnd();
+            const wchar *tagEnd = Position + length,
+                        *name = Position+1,
+                        *nameEnd = find_if(name, tagEnd, IsNameEnd);
+            bool match = (nameEnd - name == 9 && wcsncmp(name, L"codearray", 9) == 0),
+                 empty = (tagEnd[-1] == L'/');
+            Position = tagEnd + 1;
+
+            // Found: Position after start tag, unless empty
+            if (match && !empty)
+               return;
+         }
+
+         throw FileFormatException(HERE, L"Missing codearray node");
+      }
+
+      /// <summary>Advances to the next '&lt;', decoding more of the stream as necessary</summary>
+      /// <returns>False if the input ends first</returns>
+      /// <exception cref="Logic::IOException">An I/O error occurred</exception>
+      bool  CodeArrayReader::FindTag()
+      {
+         while ((Position = find(Position, End, L'<')) == End)
+            if (!Refill())
+               return false;
+
+         return true;
+      }
+
+      /// <summary>Locates the '>' that ends the tag at the current position, decoding more of the stream as necessary</summary>
+      /// <returns>Offset of the '>' from the current position</returns>
+      /// <exception cref="Logic::FileFormatException">Unterminated tag</exception>
+      /// <exception cref="Logic::IOException">An I/O error occurred</exception>
+      UINT  CodeArrayReader::FindTagEnd()
+      {
+         wchar quote = 0;
+
+         // Offsets remain valid when the window moves
+         for (UINT offset = 1; ; ++offset)
+         {
+            if (!Ensure(offset+1))
+               throw FileFormatException(HERE, GetLineNumber(), L"Unterminated element");
+
+            // Ignore '>' within quoted attribute values
+            wchar ch = Position[offset];
+            if (quote)
+               quote = (ch == quote ? 0 : quote);
+            else if (ch == L'"' || ch == L'\'')
+               quote = ch;
+            else if (ch == L'>')
+               return offset;
+         }
+      }
+
+      /// <summary>Query whether the current position is the start of a comment or processing instruction</summary>
+      /// <returns></returns>
+      /// <exception cref="Logic::IOException">An I/O error occurred</exception>
+      bool  CodeArrayReader::IsMarkup()
+      {
+         if (!Ensure(2) || Position[0] != L'<')
+            return false;
+
+         return Position[1] == L'?' || (Ensure(4) && wcsncmp(Position, L"<!--", 4) == 0);
+      }
+
+      /// <summary>Reads input until the buffer is full or the stream ends</summary>
+      /// <returns>Number of bytes read</returns>
+      /// <exception cref="Logic::IOException">An I/O error occurred</exception>
+      DWORD  CodeArrayReader::ReadChunk()
+      {
+         DWORD count = 0;
+         for (DWORD read; count < CHUNK_SIZE && (read = Source->Read(Chunk.get() + count, CHUNK_SIZE - count)) > 0; )
+            count += read;
+
+         Exhausted = (count < CHUNK_SIZE);
+         return count;
+      }
+
+      /// <summary>Discards the text already consumed and decodes the next chunk of the stream</summary>
+      /// <returns>False if the input has been exhausted</returns>
+      /// <exception cref="Logic::IOException">An I/O error occurred</exception>
+      bool  CodeArrayReader::Refill()
+      {
+         if (!Source || Exhausted)
+            return false;
+
+         // Count line breaks within the text being discarded
+         Line += (UINT)count(LineStart, Position, L'\n');
+         UINT remaining = (UINT)(End - Position);
+
+         // Move unconsumed text to start of window.  Enlarge window if a single element spans most of it
+         if (Capacity - remaining < CHUNK_SIZE + 4)
+         {
+            CharArrayPtr window(new wchar[Capacity *= 2]);
+            memcpy(window.get(), Position, remaining * sizeof(wchar));
+            Window = move(window);
+         }
+         else
+            memmove(Window.get(), Position, remaining * sizeof(wchar));
+
+         // Decode chunks until more text is produced
+         wchar* output = Window.get() + remaining;
+         UINT   length = 0;
+         while (!length && !Exhausted)
+            length = DecodeChunk(Chunk.get(), ReadChunk(), output);
+
+         Position = LineStart = Window.get();
+         End = output + length;
+         return length > 0;
+      }
+
+      /// <summary>Advances past the next occurrence of a terminator, decoding more of the stream as necessary</summary>
+      /// <param name="terminator">The terminator</param>
+      /// <exception cref="Logic::FileFormatException">Unterminated comment</exception>
+      /// <exception cref="Logic::IOException">An I/O error occurred</exception>
+      void  CodeArrayReader::SkipPast(const wchar* terminator)
+      {
+         size_t len = wcslen(terminator);
+
+         for (;;)
+         {
+            const wchar* pos = search(Position, End, terminator, terminator+len);
+            if (pos != End)
+            {
+               Position = pos + len;
+               return;
+            }
+
+            // Retain any partial terminator at the end of the window
+            if ((size_t)(End - Position) >= len)
+               Position = End - (len-1);
+
+            if (!Refill())
+               throw FileFormatException(HERE, GetLineNumber(), L"Unterminated comment");
+         }
+      }
+
+   }
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "ParameterValue.h"
+#include "Stream.h"
+#include "TextDecoder.h"
+
+namespace Logic
+{
+   namespace IO
+   {
+      /// <summary>Defines the type of an MSCI script value</summary>
+      enum class ScriptValueType { Int, String, Array, Unknown };
+
+      /// <summary>Script value read from an &lt;sval&gt; element</summary>
+      class ScriptValue
+      {
+      public:
+         ScriptValue() : Type(ScriptValueType::Unknown), Int(0)
+         {}
+
+         ScriptValueType  Type;      // Value type
+         int              Int;       // Integer value, or size of array
+         wstring          String;    // String value, or the unparsed integer value
+      };
+
+      /// <summary>Vector of script values, reused between commands</summary>
+      typedef vector<ScriptValue>  ScriptValueArray;
+
+      
+      /// <summary>Forward-only reader for the &lt;sval&gt; tree of the MSCI codearray</summary>
+      /// <remarks>Parses the elements straight from the decoded text without building a document, and has no dependency upon COM or MSXML.
+      /// Values are read in document order.  Arrays are entered with ReadArray() and left with EndArray(), which skips any unread values.
+      /// Streams are decoded a chunk at a time as the reader advances, so only a small window of text is held, and skipped values are scanned without being decoded.</remarks>
+      class LogicExport CodeArrayReader
+      {
+         // ------------------------ TYPES --------------------------
+      protected:
+         /// <summary>Array being read</summary>
+         class Frame
+         {
+         public:
+            Frame(UINT size, bool open) : Size(size), Index(0), Open(open)
+            {}
+
+            UINT  Size,    // Declared size
+                  Index;   // Number of values read
+            bool  Open;    // Whether a closing tag is expected
+         };
+
+      private:
+         static const UINT  CHUNK_SIZE = 64*1024;
+
+         // --------------------- CONSTRUCTION ----------------------
+      public:
+         CodeArrayReader();
+         virtual ~CodeArrayReader();
+
+         NO_COPY(CodeArrayReader);	// No copy semantics
+         NO_MOVE(CodeArrayReader);	// No move semantics
+
+         // ------------------------ STATIC -------------------------
+      public:
+         static wstring         GetString(ScriptValueType t);
+         static int             ToInt(const ScriptValue& v, const wchar* help);
+         static wstring         ToString(const ScriptValue& v, const wchar* help);
+         static ParameterValue  ToValue(const ScriptValue& v, const wchar* help);
+
+      protected:
+         static int  ParseInt(const wstring& str);
+
+         // ---------------------- ACCESSORS ------------------------
+      public:
+         bool  HasNext();
+
+      protected:
+         UINT  GetLineNumber() const;
+
+         // ----------------------- MUTATORS ------------------------
+      public:
+         void            Load(const wchar* text, UINT length);
+         void            Load(StreamPtr in);
+         UINT            ReadArray(const wchar* help);
+         void            EndArray();
+         int             ReadInt(const wchar* help);
+         wstring         ReadString(const wchar* help);
+         ParameterValue  ReadValue(const wchar* help);
+         void            ReadValues(ScriptValueArray& values, const wchar* help);
+         void            Skip(const wchar* help);
+
+      protected:
+         void  Read(ScriptValue& value, bool& open, const wchar* help);
+         void  ReadAttribute(const wchar* end, wstring& name, wstring& value);
+         void  ReadCloseTag();
+         void  ReadText(const wchar* end, wstring& value);
+         void  SkipMarkup();
+         void  SkipWhitespace();
+         void  SkipChildren(bool open);
+
+      private:
+         UINT   DecodeChunk(const BYTE* bytes, DWORD count, wchar* output);
+         bool   Ensure(UINT length);
+         void   FindCodeArray();
+         bool   FindTag();
+         UINT   FindTagEnd();
+         bool   IsMarkup();
+         DWORD  ReadChunk();
+         bool   Refill();
+         void   SkipPast(const wchar* terminator);
+
+         // -------------------- REPRESENTATION ---------------------
+      private:
+         const wchar    *Position,     // Current position
+                        *End,          // End of decoded text
+                        *LineStart;    // Position from which line breaks have not been counted
+         UINT           Line;          // Line number of 'LineStart'
+         StreamPtr      Source;        // Input stream, or nullptr when reading text supplied by the caller
+         unique_ptr<TextDecoder>  Decoder;   // UTF-8/Windows-1250 decoder, or nullptr for UTF-16
+         ByteArrayPtr   Chunk;         // Input buffer
+         CharArrayPtr   Window;        // Decoded text, starting with the earliest character not yet consumed
+         UINT           Capacity;      // Size of window, in characters
+         bool           Exhausted;     // Whether the input stream has been read completely
+         vector<Frame>  Frames;        // Arrays being read, innermost last
+         ScriptValue    Current;       // Value being read
+         wstring        Name,          // Attribute name being read
+                        Text;          // Attribute value being read
+      };
+
+   }
+}
+
+using namespace Logic::IO;
@@ -47,7 +47,7 @@ namespace Logic
 
           // Command: Provide compiled parameters in display order
           if (!n->Syntax.Is(CMD_EXPRESSION))
-            Script.Commands.AddOutput(ScriptCommand(n->LineText, n->Syntax, n->Parameters, n->CmdComment));
+            Script.Commands.AddOutput(ScriptCommand(n->LineText.c_str(), n->Syntax, n->Parameters, n->CmdComment));
           else
           {
             // Compile postfix parameters
@@ -55,7 +55,7 @@ namespace Logic
               p.Generate(Script, n->JumpAddress, n->CmdComment);
 
             // Expression: Provide compiled parameters in infix & postfix order
-            Script.Commands.AddOutput(ScriptCommand(n->LineText, n->Syntax, n->Parameters, n->Postfix, n->CmdComment));
+            Script.Commands.AddOutput(ScriptCommand(n->LineText.c_str(), n->Syntax, n->Parameters, n->Postfix, n->CmdComment));
           }
         }
         catch (ExceptionBase& e) {
@@ -15,17 +15,26 @@ namespace Logic
    {
       namespace Compiler
       {
-#ifdef VALIDATION
-         /// <summary>An invisible node that functions as a jump target with address 'script_length+1'</summary>
-         CommandNode  CommandNode::EndOfScript;
-#endif
          // -------------------------------- CONSTRUCTION --------------------------------
 
+         /// <summary>Create a handle to a node, sharing ownership of its arena</summary>
+         /// <param name="node">Node within an arena owned by a shared pointer, or nullptr</param>
+         CommandNodePtr::CommandNodePtr(CommandNode* node) 
+            : shared_ptr<CommandNode>(node ? shared_ptr<CommandNode>(node->Arena.shared_from_this(), node) : nullptr)
+         {}
+
          /// <summary>Create root node</summary>
-         CommandNode::CommandNode()
-            : Syntax(CommandSyntax::Unrecognised), 
+         /// <param name="arena">Arena containing the node</param>
+         CommandNode::CommandNode(MemoryArena& arena)
+            : Arena(arena),
+              Parameters(arena),
+              Postfix(arena),
+              LineText(ArenaString::allocator_type(arena)),
+              Syntax(CommandSyntax::Unrecognised), 
               Condition(Conditional::NONE),
               Parent(nullptr), 
+              PrevSibling(nullptr),
+              NextSibling(nullptr),
               JumpTarget(nullptr), 
               Index(EMPTY_JUMP), 
               LineNumber(0),
@@ -34,14 +43,21 @@ namespace Logic
          {}
 
          /// <summary>Create node for a hidden jump command</summary>
+         /// <param name="arena">Arena containing the node</param>
          /// <param name="parent">parent node</param>
          /// <param name="target">target node</param>
          /// <exception cref="Logic::ArgumentNullException">Parent or target is null</exception>
-         CommandNode::CommandNode(const CommandNode& parent, const CommandNode* target)
-            : Syntax(SyntaxLib.Find(CMD_HIDDEN_JUMP, GameVersion::Threat)),
+         CommandNode::CommandNode(MemoryArena& arena, const CommandNode& parent, const CommandNode* target)
+            : Arena(arena),
+              Parameters(arena),
+              Postfix(arena),
+              LineText(ArenaString::allocator_type(arena)),
+              Syntax(SyntaxLib.Find(CMD_HIDDEN_JUMP, GameVersion::Threat)),
               Condition(Conditional::NONE),
               JumpTarget(target),
               Parent(const_cast<CommandNode*>(&parent)),
+              PrevSibling(nullptr),
+              NextSibling(nullptr),
               LineNumber(parent.LineNumber),
               Extent({0,0}),
               Index(EMPTY_JUMP),
@@ -54,65 +70,82 @@ namespace Logic
          }
          
          /// <summary>Create a replacement for a macro command. The line number/text from the macro are preserved</summary>
+         /// <param name="arena">Arena containing the node</param>
          /// <param name="macro">macro command - line number, parent, line text preserved</param>
          /// <param name="expanded">expanded command - syntax, parameters, condition preserved</param>
          /// <exception cref="Logic::AlgorithmException">macro command not a macro</exception>
-         CommandNode::CommandNode(const CommandNode& macro, const CommandNode& expanded)
-            : Syntax(expanded.Syntax),
+         CommandNode::CommandNode(MemoryArena& arena, const CommandNode& macro, const CommandNode& expanded)
+            : Arena(arena),
+              Syntax(expanded.Syntax),
               Condition(expanded.Condition),
-              Parameters(expanded.Parameters),
-              Postfix(expanded.Postfix),
+              Parameters(arena),
+              Postfix(arena),
               LineNumber(macro.LineNumber), 
               Extent(expanded.Extent), 
-              LineText(expanded.LineText),
+              LineText(expanded.LineText, ArenaString::allocator_type(arena)),
               Parent(macro.Parent), 
+              PrevSibling(nullptr),
+              NextSibling(nullptr),
               JumpTarget(nullptr), 
               Index(EMPTY_JUMP),
               CmdComment(false)
          {
             if (!macro.Is(CommandType::Macro))
                throw AlgorithmException(HERE, L"Cannot expand command from a non-macro");
+
+            // Copy parameters into this arena
+            Parameters = expanded.Parameters;
+            Postfix = expanded.Postfix;
          }
          
          /// <summary>Create node for a script command</summary>
+         /// <param name="arena">Arena containing the node</param>
          /// <param name="cnd">conditional.</param>
          /// <param name="syntax">command syntax.</param>
-         /// <param name="params">parameters.</param>
+         /// <param name="params">parameters.  Moved without copying if drawn from the same arena</param>
          /// <param name="lex">lexer.</param>
          /// <param name="line">1-based line number</param>
          /// <param name="commented">Whether command comment</param>
-         CommandNode::CommandNode(Conditional cnd, CommandSyntaxRef syntax, ParameterArray& params, 
+         CommandNode::CommandNode(MemoryArena& arena, Conditional cnd, CommandSyntaxRef syntax, ParameterArray& params, 
                                   const CommandLexer& lex, UINT line, bool commented)
-            : Syntax(syntax),
+            : Arena(arena),
+              Syntax(syntax),
               Condition(cnd),
-              Parameters(move(params)),
+              Parameters(move(params), ParameterArray::allocator_type(arena)),
+              Postfix(arena),
               LineNumber(line), 
               Extent(lex.Extent), 
-              LineText(lex.Input),
+              LineText(lex.Input.c_str(), lex.Input.length(), ArenaString::allocator_type(arena)),
               Parent(nullptr), 
+              PrevSibling(nullptr),
+              NextSibling(nullptr),
               JumpTarget(nullptr), 
               Index(EMPTY_JUMP),
               CmdComment(commented)
          {}
          
          /// <summary>Create node for an expression</summary>
+         /// <param name="arena">Arena containing the node</param>
          /// <param name="cnd">conditional.</param>
          /// <param name="syntax">command syntax.</param>
-         /// <param name="params">infix parameters and retVar</param>
-         /// <param name="params">postfix parameters.</param>
+         /// <param name="params">infix parameters and retVar.  Moved without copying if drawn from the same arena</param>
+         /// <param name="params">postfix parameters.  Moved without copying if drawn from the same arena</param>
          /// <param name="lex">lexer.</param>
          /// <param name="line">1-based line number</param>
          /// <param name="commented">Whether command comment</param>
-         CommandNode::CommandNode(Conditional cnd, CommandSyntaxRef syntax, ParameterArray& infix, ParameterArray& postfix, 
+         CommandNode::CommandNode(MemoryArena& arena, Conditional cnd, CommandSyntaxRef syntax, ParameterArray& infix, ParameterArray& postfix, 
                                   const CommandLexer& lex, UINT line, bool commented)
-            : Syntax(syntax),
+            : Arena(arena),
+              Syntax(syntax),
               Condition(cnd),
-              Parameters(move(infix)),
-              Postfix(move(postfix)),
+              Parameters(move(infix), ParameterArray::allocator_type(arena)),
+              Postfix(move(postfix), ParameterArray::allocator_type(arena)),
               LineNumber(line), 
               Extent(lex.Extent), 
-              LineText(lex.Input),
+              LineText(lex.Input.c_str(), lex.Input.length(), ArenaString::allocator_type(arena)),
               Parent(nullptr), 
+              PrevSibling(nullptr),
+              NextSibling(nullptr),
               JumpTarget(nullptr), 
               Index(EMPTY_JUMP),
               CmdComment(commented)
@@ -124,19 +157,19 @@ namespace Logic
          // ------------------------------- STATIC METHODS -------------------------------
          
          /// <summary>Checks whether a command is executable from a logic perspective</summary>
-         CommandNode::NodeDelegate  CommandNode::isExecutableCommand = [](const CommandNodePtr& n) 
+         CommandNode::NodeDelegate  CommandNode::isExecutableCommand = [](const CommandNode* n) 
          { 
             return !n->CmdComment && (n->Is(CommandType::Standard) || n->Is(CMD_BREAK) || n->Is(CMD_CONTINUE)); 
          };
 
          /// <summary>Checks whether commands are standard</summary>
-         CommandNode::NodeDelegate  CommandNode::isStandardCommand = [](const CommandNodePtr& n) 
+         CommandNode::NodeDelegate  CommandNode::isStandardCommand = [](const CommandNode* n) 
          { 
             return n->Is(CommandType::Standard) && !n->CmdComment; 
          };
          
          /// <summary>Checks whether commands are compatible with 'skip-if' conditional</summary>
-         CommandNode::NodeDelegate  CommandNode::isSkipIfCompatible = [](const CommandNodePtr& n) 
+         CommandNode::NodeDelegate  CommandNode::isSkipIfCompatible = [](const CommandNode* n) 
          { 
             switch (n->Logic)
             {
@@ -149,7 +182,7 @@ namespace Logic
          };
          
          /// <summary>Finds any command or 'starting' conditional, but rejects 'middle' conditionals like else,else-if,end</summary>
-         CommandNode::NodeDelegate  CommandNode::isConditionalEnd = [](const CommandNodePtr& n) 
+         CommandNode::NodeDelegate  CommandNode::isConditionalEnd = [](const CommandNode* n) 
          { 
             switch (n->Logic)
             {
@@ -163,7 +196,7 @@ namespace Logic
          };
 
          /// <summary>Finds any executable command, ie. anything except END or NOP</summary>
-         CommandNode::NodeDelegate  CommandNode::isConditionalAlternate = [](const CommandNodePtr& n) 
+         CommandNode::NodeDelegate  CommandNode::isConditionalAlternate = [](const CommandNode* n) 
          { 
             switch (n->Logic)
             {
@@ -204,7 +237,7 @@ namespace Logic
          /// <returns></returns>
          CommandNode::NodeIterator CommandNode::FindChild(const CommandNode* child) const
          {
-            return find_if(Children.begin(), Children.end(), [child](const CommandNodePtr& n) {return child == n.get();} );
+            return find(Children.begin(), Children.end(), child);
          }
          
          /// <summary>Finds the conditional or standard command following an if/else-if statement</summary>
@@ -222,11 +255,11 @@ namespace Logic
                   node = node->FindNextCommand();
                
                // 1st child is not executable (Auxiliary): Use it's next std sibling
-               else if (!isExecutableCommand(*node->Children.begin())) 
-                  node = (*node->Children.begin())->FindNextCommand();
+               else if (!isExecutableCommand(node->Children.front())) 
+                  node = node->Children.front()->FindNextCommand();
                else
                   // Default: Use first child
-                  node = node->Children.begin()->get();
+                  node = node->Children.front();
             }
 
             return node;
@@ -240,15 +273,15 @@ namespace Logic
             // Find next Std command that isn't ELSE-IF
             return FindSibling(isConditionalEnd, L"conditional end-point");
 #else
-            // EOF: Return sentinel
+            // EOF: Return root, which functions as a jump target with address 'script_length+1'
             if (IsRoot())
-               return &EndOfScript;
+               return const_cast<CommandNode*>(this);
 
             // Find next sibling node containing a standard command
             auto node = find_if(++Parent->FindChild(this), Parent->Children.cend(), isConditionalEnd);
 
             // Return if found, else recurse into parent
-            return node != Parent->Children.cend() ? node->get() : Parent->FindConditionalEnd();
+            return node != Parent->Children.cend() ? *node : Parent->FindConditionalEnd();
 #endif
          }
 
@@ -286,9 +319,8 @@ namespace Logic
             if (IsRoot())
                throw AlgorithmException(HERE, L"Cannot retrieve next sibling of the root");
 
-            // Find 'this' and return next (if any)
-            auto node = Parent->FindChild(this);
-            return ++node != Parent->Children.end() ? node->get() : nullptr;
+            // Return next (if any)
+            return NextSibling;
          }
 
          /// <summary>Finds the prev sibling of this node</summary>
@@ -300,9 +332,8 @@ namespace Logic
             if (IsRoot())
                throw AlgorithmException(HERE, L"Cannot retrieve previous sibling of the root");
 
-            // Find 'this' and return prev (if any)
-            auto node = Parent->FindChild(this);
-            return node != Parent->Children.begin() ? (--node)->get() : nullptr;
+            // Return prev (if any)
+            return PrevSibling;
          }
 
          /// <summary>Finds the root node</summary>
@@ -332,7 +363,7 @@ namespace Logic
             auto node = find_if(++Parent->FindChild(this), Parent->Children.cend(), d);
 
             // Return if found, else recurse into parent
-            return node != Parent->Children.cend() ? node->get() : Parent->FindSibling(d, help);
+            return node != Parent->Children.cend() ? *node : Parent->FindSibling(d, help);
          }
 
          /// <summary>Query command syntax ID</summary>
@@ -425,13 +456,13 @@ namespace Logic
             if (cmd == Children.rend())
                throw AlgorithmException(HERE, L"Command doesn't have any executable children");
 
-            return cmd->get();
+            return *cmd;
          }
 
          /// <summary>Get line text without indentation</summary>
          GuiString   CommandNode::GetLineCode() const
          {
-            return LineText.TrimLeft(L" ");
+            return GuiString(LineText.c_str()).TrimLeft(L" ");
          }
          
          /// <summary>Gets the name of the script (if any) called by this command</summary>
@@ -458,7 +489,7 @@ namespace Logic
          /// <returns></returns>
          void  CommandNode::InsertJump(NodeIterator pos, const CommandNode* target)
          {
-            Children.insert(pos, new CommandNode(*this, target));
+            Children.insert(pos, Arena.New<CommandNode>(Arena, *this, target));
          }
          
          /// <summary>Query whether node is root</summary>
@@ -472,7 +503,7 @@ namespace Logic
          /// <returns></returns>
          ErrorToken  CommandNode::MakeError(const GuiString& msg) const
          {
-            return ErrorToken(msg, LineNumber, LineText.substr(Extent.cpMin, Extent.cpMax-Extent.cpMin), Extent);
+            return ErrorToken(msg, LineNumber, wstring(LineText.c_str()+Extent.cpMin, Extent.cpMax-Extent.cpMin), Extent);
          }
 
          /// <summary>Create error for a token on this line</summary>
@@ -493,10 +524,13 @@ namespace Logic
                throw AlgorithmException(HERE, L"Cannot transfer children to itself");
 
             // Move children 
-            for (auto& c = Children.begin(); c != Children.end(); )
+            while (!Children.empty())
             {
-               n += *c;
-               Children.erase(c++);
+               CommandNode* c = Children.front();
+               Children.erase(Children.begin());
+
+               c->Parent = &n;
+               n.Children.push_back(c);
             }
          }
          
@@ -513,14 +547,14 @@ namespace Logic
                throw InvalidOperationException(HERE, L"Cannot find child");
 
             // Re-lex line text as a comment
-            CommandLexer lex(L"*" + child->LineText);
+            CommandLexer lex(L"*" + wstring(child->LineText.c_str()));
 
             // Extract as comment parameter
             CommandSyntaxRef newSyntax = SyntaxLib.Find(CMD_COMMENT, GameVersion::Threat);
             ParameterArray params(ScriptParameter(newSyntax.Parameters[0], lex.Tokens[1]));
 
             // Generate new command + perform in-place replacement
-            ReplaceChild(child, new CommandNode(Conditional::NONE, newSyntax, params, lex, child->LineNumber, false));
+            ReplaceChild(child, Arena.New<CommandNode>(Arena, Conditional::NONE, newSyntax, params, lex, child->LineNumber, false));
          }
          
          /// <summary>Append node as a child</summary>
@@ -532,7 +566,7 @@ namespace Logic
             n->Parent = this;
 
             // Append child
-            Children.push_back(n);
+            Children.push_back(n.get());
             return *this;
          }
          
@@ -557,7 +591,7 @@ namespace Logic
 
          // ------------------------------ PROTECTED METHODS -----------------------------
          
-         /// <summary>Replaces one child node with another.</summary>
+         /// <summary>Replaces one child node with another.  The existing child remains in the arena until it is reset</summary>
          /// <param name="oldChild">existing child.</param>
          /// <param name="newChild">new replacement child.</param>
          /// <exception cref="Logic::ArgumentNullException">child is null</exception>
@@ -567,16 +601,14 @@ namespace Logic
             REQUIRED(oldChild);
             REQUIRED(newChild);
 
-            // Linear find/replace existing child
-            for (auto& c : Children)
-               if (c.get() == oldChild)
-               {
-                  newChild->Parent = this;
-                  return c.reset(newChild);
-               }
+            // Linear find existing child
+            NodeIterator pos = FindChild(oldChild);
+            if (pos == Children.end())
+               throw InvalidOperationException(HERE, L"Cannot find existing child");
 
-            // Error: Not found
-            throw InvalidOperationException(HERE, L"Cannot find existing child");
+            // Link replacement in its place
+            newChild->Parent = this;
+            Children.insert(Children.erase(pos), newChild);
          }
 
          // ------------------------------- PRIVATE METHODS ------------------------------
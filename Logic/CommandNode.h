@@ -7,6 +7,7 @@
 #include "ScriptToken.h"
 #include "ErrorToken.h"
 #include "Symbol.h"
+#include "MemoryArena.h"
 #include <algorithm>
 
 namespace Testing
@@ -22,14 +23,15 @@ namespace Logic
       {
          class CommandNode;
          
-         /// <summary>Shared pointer to a parse tree node</summary>
+         /// <summary>Shared pointer to a parse tree node, which keeps the arena containing the node alive</summary>
          class LogicExport CommandNodePtr : public shared_ptr<CommandNode> 
          {
             // --------------------- CONSTRUCTION ----------------------
          public:
             CommandNodePtr() : shared_ptr<CommandNode>(nullptr)
             {}
-            CommandNodePtr(CommandNode* node) : shared_ptr<CommandNode>(node)
+            CommandNodePtr(CommandNode* node);
+            CommandNodePtr(const shared_ptr<CommandNode>& node) : shared_ptr<CommandNode>(node)
             {}
 
             // ---------------------- ACCESSORS ------------------------	
@@ -44,14 +46,155 @@ namespace Logic
          class LogicExport CommandNode 
          {
             friend class ::Testing::LogicTests;
+            friend class Logic::Utils::MemoryArena;
 
             // ------------------------ TYPES --------------------------
+         public:
+            /// <summary>Child nodes, linked through their sibling pointers.  Does not own the nodes, which belong to their arena</summary>
+            class ChildList
+            {
+               // ------------------------ TYPES --------------------------
+            public:
+               /// <summary>Bidirectional iterator over child nodes</summary>
+               template <bool REVERSE>
+               class Iterator : public std::iterator<std::bidirectional_iterator_tag, CommandNode*, ptrdiff_t, CommandNode* const*, CommandNode* const&>
+               {
+                  friend class ChildList;
+
+                  // --------------------- CONSTRUCTION ----------------------
+               public:
+                  Iterator() : List(nullptr), Node(nullptr)
+                  {}
+               protected:
+                  Iterator(const ChildList* l, CommandNode* n) : List(l), Node(n)
+                  {}
+
+                  // ---------------------- ACCESSORS ------------------------			
+               public:
+                  CommandNode* const& operator*() const         { return Node; }
+                  bool operator==(const Iterator& r) const      { return Node == r.Node; }
+                  bool operator!=(const Iterator& r) const      { return Node != r.Node; }
+
+                  // ----------------------- MUTATORS ------------------------
+               public:
+                  Iterator& operator++()
+                  {
+                     Node = (REVERSE ? Node->PrevSibling : Node->NextSibling);
+                     return *this;
+                  }
+
+                  Iterator& operator--()
+                  {
+                     // End: Move to final node
+                     if (!Node)
+                        Node = (REVERSE ? List->First : List->Last);
+                     else
+                        Node = (REVERSE ? Node->NextSibling : Node->PrevSibling);
+                     return *this;
+                  }
+
+                  Iterator operator++(int)
+                  {
+                     Iterator tmp(*this);
+                     operator++();
+                     return tmp;
+                  }
+
+                  Iterator operator--(int)
+                  {
+                     Iterator tmp(*this);
+                     operator--();
+                     return tmp;
+                  }
+
+                  // -------------------- REPRESENTATION ---------------------
+               protected:
+                  const ChildList* List;     // List being iterated
+                  CommandNode*     Node;     // Current node, or nullptr at end
+               };
+
+               typedef Iterator<false>  iterator, const_iterator;
+               typedef Iterator<true>   reverse_iterator, const_reverse_iterator;
+
+               // --------------------- CONSTRUCTION ----------------------
+            public:
+               ChildList() : First(nullptr), Last(nullptr), Count(0)
+               {}
+
+               NO_COPY(ChildList);	// Cannot copy semantics
+               NO_MOVE(ChildList);	// Cannot move semantics
+
+               // ---------------------- ACCESSORS ------------------------			
+            public:
+               iterator          begin() const    { return iterator(this, First); }
+               iterator          end() const      { return iterator(this, nullptr); }
+               const_iterator    cbegin() const   { return begin(); }
+               const_iterator    cend() const     { return end(); }
+               reverse_iterator  rbegin() const   { return reverse_iterator(this, Last); }
+               reverse_iterator  rend() const     { return reverse_iterator(this, nullptr); }
+               bool              empty() const    { return Count == 0; }
+               size_t            size() const     { return Count; }
+               CommandNode*      front() const    { return First; }
+               CommandNode*      back() const     { return Last; }
+
+               // ----------------------- MUTATORS ------------------------
+            public:
+               /// <summary>Links a node before a position</summary>
+               /// <param name="pos">Position</param>
+               /// <param name="n">Node, which must not belong to a list</param>
+               /// <returns>Position of node</returns>
+               iterator  insert(const_iterator pos, CommandNode* n)
+               {
+                  CommandNode* next = pos.Node;
+                  CommandNode* prev = (next ? next->PrevSibling : Last);
+
+                  // Link node between neighbours
+                  n->PrevSibling = prev;
+                  n->NextSibling = next;
+                  (prev ? prev->NextSibling : First) = n;
+                  (next ? next->PrevSibling : Last) = n;
+
+                  ++Count;
+                  return iterator(this, n);
+               }
+
+               /// <summary>Unlinks the node at a position</summary>
+               /// <param name="pos">Position</param>
+               /// <returns>Position following the node</returns>
+               iterator  erase(const_iterator pos)
+               {
+                  CommandNode* n = pos.Node;
+                  CommandNode* next = n->NextSibling;
+
+                  // Link neighbours
+                  (n->PrevSibling ? n->PrevSibling->NextSibling : First) = next;
+                  (next ? next->PrevSibling : Last) = n->PrevSibling;
+                  n->PrevSibling = n->NextSibling = nullptr;
+
+                  --Count;
+                  return iterator(this, next);
+               }
+
+               /// <summary>Links a node as the last child</summary>
+               /// <param name="n">Node, which must not belong to a list</param>
+               void  push_back(CommandNode* n)
+               {
+                  insert(end(), n);
+               }
+
+               // -------------------- REPRESENTATION ---------------------
+            protected:
+               CommandNode  *First,    // First child
+                            *Last;     // Last child
+               size_t        Count;    // Number of children
+            };
+
          protected:
             /// <summary>CommandNode array iterator</summary>
-            typedef CommandNodeList::const_iterator   NodeIterator;
+            typedef ChildList::const_iterator   NodeIterator;
 
             /// <summary>CommandNode predicate</summary>
-            typedef function<bool (const CommandNodePtr&)>  NodeDelegate;
+            typedef function<bool (const CommandNode*)>  NodeDelegate;
 
 
          public:
@@ -71,15 +214,18 @@ namespace Logic
             };
 
             // --------------------- CONSTRUCTION ----------------------
+         protected:
+            CommandNode(MemoryArena& arena);
+            CommandNode(MemoryArena& arena, const CommandNode& macro, const CommandNode& expanded);
+            CommandNode(MemoryArena& arena, Conditional cnd, CommandSyntaxRef syntax, ParameterArray& params, const CommandLexer& lex, UINT line, bool commented);
+            CommandNode(MemoryArena& arena, Conditional cnd, CommandSyntaxRef syntax, ParameterArray& infix, ParameterArray& postfix, const CommandLexer& lex, UINT line, bool commented);
+            CommandNode(MemoryArena& arena, const CommandNode& parent, const CommandNode* target);
+
          public:
-            CommandNode();
-            CommandNode(const CommandNode& macro, const CommandNode& expanded);
-            CommandNode(Conditional cnd, CommandSyntaxRef syntax, ParameterArray& params, const CommandLexer& lex, UINT line, bool commented);
-            CommandNode(Conditional cnd, CommandSyntaxRef syntax, ParameterArray& infix, ParameterArray& postfix, const CommandLexer& lex, UINT line, bool commented);
             virtual ~CommandNode();
 
-         protected:
-            CommandNode(const CommandNode& parent, const CommandNode* target);
+            NO_COPY(CommandNode);	// Cannot copy semantics
+            NO_MOVE(CommandNode);	// Cannot move semantics
 
             // ------------------------ STATIC -------------------------
          public:
@@ -88,11 +234,19 @@ namespace Logic
             static NodeDelegate  isExecutableCommand;
             static NodeDelegate  isStandardCommand;
             static NodeDelegate  isSkipIfCompatible;
-            
-#ifdef VALIDATION
-            /// <summary>An invisible node that functions as a jump target with address 'script_length+1'</summary>
-            static CommandNode  EndOfScript;
-#endif
+
+            /// <summary>Creates a node within an arena, which owns it until the arena is reset</summary>
+            /// <remarks>The node's parameter arrays and text are drawn from the same arena, and its children are linked through their sibling pointers, 
+            /// so releasing a tree is a single reset of its arena.  The arena must be owned by a shared pointer.</remarks>
+            /// <param name="arena">Arena owned by the parser</param>
+            /// <param name="args">Constructor arguments, excluding the arena</param>
+            /// <returns>New node</returns>
+            template <typename... Args>
+            static CommandNodePtr  Create(MemoryArena& arena, Args&&... args)
+            {
+               return arena.New<CommandNode>(arena, std::forward<Args>(args)...);
+            }
+
             // --------------------- PROPERTIES ------------------------
          public:
             PROPERTY_GET(bool,Empty,IsEmpty);
@@ -141,14 +295,15 @@ namespace Logic
             
             // -------------------- REPRESENTATION ---------------------
          public:
+            MemoryArena&       Arena;         // Arena containing this node
             CommandNode*       Parent;        // Parent node
-            CommandNodeList    Children;      // Child commands
+            ChildList          Children;      // Child commands
 
             ParameterArray     Parameters,    // script parameters in display order
                                Postfix;       // expression parameters in postfix order
             CommandSyntaxRef   Syntax;        // command syntax
             bool               CmdComment;    // Whether a command comment  [false for ordinary comments]
-            GuiString          LineText;      // line text
+            ArenaString        LineText;      // line text
 
             const UINT         LineNumber;    // 1-based line number
             const CHARRANGE    Extent;        // Start/end character offsets
@@ -157,6 +312,10 @@ namespace Logic
             Conditional        Condition;     // Conditional
             const CommandNode* JumpTarget;    // Destination of unconditional-jmp or jump-if-false
             UINT               Index;         // 0-based standard codearray index
+
+         protected:
+            CommandNode       *PrevSibling,   // Previous sibling, linked by the parent's child list
+                              *NextSibling;   // Next sibling, linked by the parent's child list
          };
       }
    }
@@ -2,6 +2,8 @@
 #include "CommandTree.h"
 #include "PreferencesLibrary.h"
 #include "ScriptFile.h"
+#include "PassManager.h"
+#include "Profiler.h"
 
 namespace Logic
 {
@@ -11,8 +13,17 @@ namespace Logic
       {
          // -------------------------------- CONSTRUCTION --------------------------------
 
+         /// <summary>Creates a tree within its own arena</summary>
          CommandTree::CommandTree() 
-            : Root(new CommandNode()),
+            : Root(CommandNode::Create(*MemoryArenaPtr(new MemoryArena()))),
+              State(TreeState::Raw)
+         {
+         }
+
+         /// <summary>Creates a tree whose nodes are allocated from an arena</summary>
+         /// <param name="arena">Arena owned by the parser</param>
+         CommandTree::CommandTree(const MemoryArenaPtr& arena) 
+            : Root(CommandNode::Create(*arena)),
               State(TreeState::Raw)
          {
          }
@@ -44,13 +55,10 @@ namespace Logic
          /// <exception cref="Logic::AlgorithmException">Error in linking algorithm</exception>
          void  CommandTree::Compile(ScriptFile& script, ErrorArray& errors)
          {
+            PROFILE_FUNCTION();
+            typedef PassManager::Dependency Dependency;
             UINT i = 0;
-            CommandGenerator   generator(script, errors);
-            ConstantIdentifier constants(script, errors);
-            LinkageFinalizer   finalizer(errors);
-            NodeIndexer        indexer(i);
-            NodeLinker         linker(errors);
-            VariableIdentifier variables(script, errors);
+            PassManager linking(*Root), generation(*Root);
 
             // Macros: Query whether macros are enabled
             if (PrefsLib.UseMacroCommands)
@@ -63,24 +71,26 @@ namespace Logic
                script.Clear();
 
                // Re-index variables to account for hidden iterator variables
-               Transform(variables);
+               linking.Add(Dependency::Node, [&](ErrorArray& e) { return new VariableIdentifier(script, e); });
 
                // Re-identify constants
-               Transform(constants);
+               linking.Add(Dependency::Node, [&](ErrorArray& e) { return new ConstantIdentifier(script, e); });
 #endif
             }
 
-            // Linking/Indexing
-            Transform(linker);
-            Transform(indexer);
+            // Linking/Indexing  [Indexing must include the jumps inserted by linking]
+            linking.Add(Dependency::Node, [&](ErrorArray& e) { return new NodeLinker(e); }, true);
+            linking.Add(Dependency::Tree, [&](ErrorArray&) { return new NodeIndexer(i); });
+            linking.Run(errors);
                
 #ifdef VALIDATION
-            // Set address of EOF
-            CommandNode::EndOfScript.Index = i;     
+            // Set address of EOF  [Root is the end-of-script jump target]
+            Root->Index = i;     
 #endif
-            // Finalize linkage + generate commands
-            Transform(finalizer);
-            Transform(generator);
+            // Finalize linkage + generate commands  [Finalizing requires every index be assigned]
+            generation.Add(Dependency::Tree, [&](ErrorArray& e) { return new LinkageFinalizer(e); });
+            generation.Add(Dependency::Node, [&](ErrorArray& e) { return new CommandGenerator(script, e); });
+            generation.Run(errors);
             
             // Update state
             State = TreeState::Compiled;
@@ -132,6 +142,8 @@ namespace Logic
          /// <param name="v">The visitor.</param>
          void  CommandTree::Transform(CommandNode::Visitor& v)
          {
+            PROFILE_ZONE(typeid(v).name());     // Zone per visitor type
+
             // Execute visitor
             for (auto& c : *this)
                c->Accept(v);
@@ -142,21 +154,21 @@ namespace Logic
          /// <param name="errors">errors collection</param>
          void  CommandTree::Verify(ScriptFile& script, ErrorArray& errors) 
          {
-            CommandGenerator    commands(script, errors);
-            ConstantIdentifier  constants(script, errors);
-            LogicVerifier       logic(errors);
+            PROFILE_FUNCTION();
+            typedef PassManager::Dependency Dependency;
+            PassManager         verification(*Root);
             TerminationVerifier termination(errors);
-            VariableIdentifier  variables(script, errors);
 
             // Identify labels/variables/constants
-            Transform(variables);
-            Transform(constants);
+            verification.Add(Dependency::Node, [&](ErrorArray& e) { return new VariableIdentifier(script, e); });
+            verification.Add(Dependency::Node, [&](ErrorArray& e) { return new ConstantIdentifier(script, e); });
 
-            // Verify commands+parameters
-            Transform(commands);
+            // Verify commands+parameters  [Requires every label and constant be identified]
+            verification.Add(Dependency::Tree, [&](ErrorArray& e) { return new CommandGenerator(script, e); });
 
             // branching logic
-            Transform(logic);
+            verification.Add(Dependency::Node, [&](ErrorArray& e) { return new LogicVerifier(e); });
+            verification.Run(errors);
 
             // Ensure script has std commands  [don't count break/continue]
             if (!any_of(begin(), end(), CommandNode::isStandardCommand))
@@ -188,7 +200,7 @@ namespace Logic
             r->Parent = Root.get();
 
             // Append child
-            Root->Children.push_back(r);
+            Root->Children.push_back(r.get());
             return *this;
          }
 
@@ -15,7 +15,7 @@ namespace Logic
          public:
             /// <summary>Forward-only iterator for nodes in a CommandNode</summary>
             template <typename TRAVERSAL>
-            class Iterator : public std::iterator<std::forward_iterator_tag, CommandNodePtr>
+            class Iterator : public std::iterator<std::forward_iterator_tag, CommandNode*, ptrdiff_t, CommandNode* const*, CommandNode* const&>
             {
                friend class CommandTree;
                
@@ -35,7 +35,7 @@ namespace Logic
                /// <param name="t">Tree</param>
                /// <param name="n">Start node</param>
                /// <exception cref="Logic::ArgumentNullException">start node is nullptr</exception>
-               Iterator(const CommandTree& t, CommandNodePtr& n) 
+               Iterator(const CommandTree& t, CommandNode* n) 
                   : Tree(&t), Position(n)
                {
                   REQUIRED(n);
@@ -77,7 +77,7 @@ namespace Logic
                /// <summary>Get reference to current node</summary>
                /// <returns></returns>
                /// <exception cref="Logic::InvalidOperationException">Iterator cannot be dereferenced</exception>
-               CommandNodePtr operator*() const
+               CommandNode* const& operator*() const
                { 
                   if (!Position)
                      throw InvalidOperationException(HERE, L"Cannot dereference iterator");
@@ -93,7 +93,7 @@ namespace Logic
                   if (!Position)
                      throw InvalidOperationException(HERE, L"Cannot dereference iterator");
 
-                  return Position.get();
+                  return Position;
                }
 
                /// <summary>Compares two positions</summary>
@@ -198,7 +198,7 @@ namespace Logic
                // -------------------- REPRESENTATION ---------------------
             protected:
                const CommandTree* Tree;        // Parent tree
-               CommandNodePtr     Position;    // Current position
+               CommandNode*       Position;    // Current position
                TRAVERSAL          Traversal;   // Traversal type
             };
 
@@ -214,6 +214,7 @@ namespace Logic
             // --------------------- CONSTRUCTION ----------------------
          public:
             CommandTree();
+            CommandTree(const MemoryArenaPtr& arena);
             virtual ~CommandTree();
 
             DEFAULT_COPY(CommandTree);	// Default copy semantics
@@ -235,7 +236,7 @@ namespace Logic
             template <typename T>
             Iterator<T> begin() const
             {
-               return Iterator<T>(*this, const_cast<CommandNodePtr&>(Root));
+               return Iterator<T>(*this, Root.get());
             }
 
             /// <summary>Get finish iterator for tree</summary>
@@ -281,7 +282,7 @@ namespace Logic
             
             // -------------------- REPRESENTATION ---------------------
          protected:
-            CommandNodePtr Root;    // Root node of parse tree
+            CommandNodePtr Root;    // Root node of parse tree, which keeps the arena containing the tree alive
             TreeState      State;   // processing state
          };
       }
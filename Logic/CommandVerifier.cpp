@@ -4,6 +4,7 @@
 #include "GameObjectLibrary.h"
 #include "ScriptObjectLibrary.h"
 #include "PreferencesLibrary.h"
+#include "GameDataSet.h"
 
 namespace Logic
 {
@@ -16,7 +17,7 @@ namespace Logic
          /// <summary>Create command verifying visitor</summary>
          /// <param name="s">script</param>
          /// <param name="e">errors collection</param>
-         CommandVerifier::CommandVerifier(ScriptFile& s, ErrorArray& e) : Errors(e), Script(s)
+         CommandVerifier::CommandVerifier(ScriptFile& s, ErrorArray& e) : Errors(e), Script(s), GameData(GameDataSet::Find(s.Game))
          {
          }
 
@@ -33,6 +34,8 @@ namespace Logic
          /// <param name="n">Node</param>
          void  CommandVerifier::VisitNode(CommandNode* n) 
          {
+            GameDataSet::Scope game(GameData);
+
             try
             {
                // Skip for unrecognised commands
@@ -31,6 +31,21 @@ namespace Logic
          StreamDecorator::SafeClose();
       }
 
+      // ------------------------------- STATIC METHODS -------------------------------
+
+      /// <summary>Encodes a byte buffer</summary>
+      /// <param name="buffer">Buffer to encode</param>
+      /// <param name="length">Length of buffer</param>
+      /// <exception cref="Logic::ArgumentNullException">Buffer is null</exception>
+      void  DataStream::Encode(byte* buffer, DWORD length)
+      {
+         REQUIRED(buffer);
+
+         // Encode buffer
+         for (DWORD i = 0; i < length; i++)
+            buffer[i] ^= DATAFILE_ENCRYPT_KEY;
+      }
+
       // ------------------------------- PUBLIC METHODS -------------------------------
 
       /// <summary>Gets the length of the logical file</summary>
@@ -96,7 +111,7 @@ namespace Logic
       /// <param name="buffer">The buffer.</param>
       /// <param name="length">The length of the buffer.</param>
       /// <returns>Number of bytes written</returns>
-      /// <exception cref="Logic::NotImplementedException">Always</exception>
+      /// <exception cref="Logic::NotImplementedException">Always.  Use CatalogWriter to build catalogs</exception>
       DWORD  DataStream::Write(const BYTE* buffer, DWORD length)
       {
          throw NotImplementedException(HERE, L"writing .dat files");
@@ -114,19 +129,6 @@ namespace Logic
 
 		// ------------------------------- PRIVATE METHODS ------------------------------
 
-      /// <summary>Encodes a byte buffer</summary>
-      /// <param name="buffer">Buffer to encode</param>
-      /// <param name="length">Length of buffer</param>
-      /// <exception cref="Logic::ArgumentNullException">Buffer is null</exception>
-      void  DataStream::Encode(byte* buffer, DWORD length)
-      {
-         REQUIRED(buffer);
-
-         // Encode buffer
-         for (DWORD i = 0; i < length; i++)
-            buffer[i] ^= DATAFILE_ENCRYPT_KEY;
-      }
-
       // -------------------------------- NESTED CLASSES ------------------------------
    }
 }
\ No newline at end of file
@@ -11,7 +11,7 @@ namespace Logic
       /// <summary>Provides stream access to the contents of catalog data files</summary>
       class LogicExport DataStream : public StreamDecorator
       {
-      const byte  DATAFILE_ENCRYPT_KEY = 0x33;
+      static const byte  DATAFILE_ENCRYPT_KEY = 0x33;
          
          // --------------------- CONSTRUCTION ----------------------
 
@@ -24,6 +24,10 @@ namespace Logic
          // This class LogicExport cannot be copied
          NO_COPY(DataStream);
 
+         // ------------------------ STATIC -------------------------
+      public:
+         static void  Encode(byte* buffer, DWORD length);
+
          // --------------------- PROPERTIES ------------------------
 			
 			// ---------------------- ACCESSORS ------------------------
@@ -37,9 +41,6 @@ namespace Logic
          void   Seek(LONG  offset, SeekOrigin  mode);
          DWORD  Write(const BYTE* buffer, DWORD length);
 
-      private:
-         void   Encode(byte* buffer, DWORD length);
-
          // -------------------- REPRESENTATION ---------------------
 
          const XFileInfo&  File;
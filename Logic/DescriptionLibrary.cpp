@@ -3,6 +3,7 @@
 #include "DescriptionFileReader.h"
 #include "FileStream.h"
 #include "SyntaxLibrary.h"
+#include "Profiler.h"
 
 namespace Logic
 {
@@ -46,6 +47,7 @@ namespace Logic
       /// <exception cref="Logic::IOException">An I/O error occurred</exception>
       UINT  DescriptionLibrary::Enumerate(WorkerData* data)
       {
+         PROFILE_FUNCTION();
          try
          {
             // Clear previous contents
@@ -1,8 +1,6 @@
 #include "stdafx.h"
 #include "ExpressionParser.h"
 
-//#define  PRINT_DEBUG
-
 namespace Logic
 {
    namespace Scripts
@@ -14,7 +12,6 @@ namespace Logic
          /// <summary>Creates a script expression parser</summary>
          /// <param name="begin">Position of first expression token</param>
          /// <param name="end">Position after last expression token</param>
-         /// <exception cref="Logic::AlgorithmException">Error in parsing algorithm</exception>
          /// <exception cref="Logic::ExpressionParserException">Syntax error in expression</exception>
          ExpressionParser::ExpressionParser(TokenIterator& begin, const TokenIterator end)
             : InputBegin(begin), InputEnd(end)
@@ -29,33 +26,103 @@ namespace Logic
 
          // ------------------------------- STATIC METHODS -------------------------------
 
+         /// <summary>Binary precedence of each operator, taken from the X2 scripting manual</summary>
+         /// <remarks>'-' is matched at the same level as the unary operators, which binds subtraction tighter than the manual states.
+         /// This is how expressions have always been compiled, so it is preserved.</remarks>
+         const UINT  ExpressionParser::Precedence[] =
+         {
+            NOT_BINARY,       // None
+            0, 1,             // OR, AND
+            2, 3, 4,          // |, ^, &
+            5, 5,             // ==, !=
+            6, 6, 6, 6,       // <, >, <=, >=
+            7, 9,             // +, -
+            8, 8, 8,          // *, /, % MOD
+            9, 9,             // ~, !
+            NOT_BINARY,       // (
+            NOT_BINARY,       // )
+         };
+
+         /// <summary>Identifies an operator token</summary>
+         /// <param name="tok">The token</param>
+         /// <returns>Operator, or Operator::None if token is not an operator</returns>
+         ExpressionParser::Operator  ExpressionParser::Identify(const ScriptToken& tok)
+         {
+            const wstring& txt = tok.Text;
+
+            // Ensure operator
+            if (tok.Type != TokenType::BinaryOp && tok.Type != TokenType::UnaryOp)
+               return Operator::None;
+
+            // Compare by length then characters
+            switch (txt.length())
+            {
+            case 1:
+               switch (txt[0])
+               {
+               case '|':  return Operator::BitwiseOr;
+               case '^':  return Operator::BitwiseXor;
+               case '&':  return Operator::BitwiseAnd;
+               case '<':  return Operator::Less;
+               case '>':  return Operator::Greater;
+               case '+':  return Operator::Add;
+               case '-':  return Operator::Subtract;
+               case '*':  return Operator::Multiply;
+               case '/':  return Operator::Divide;
+               case '%':  return Operator::Modulus;
+               case '~':  return Operator::BitwiseNot;
+               case '!':  return Operator::LogicalNot;
+               case '(':  return Operator::OpenBracket;
+               case ')':  return Operator::CloseBracket;
+               }
+               break;
+
+            case 2:
+               if (txt == L"OR" || txt == L"||")   return Operator::Or;
+               if (txt == L"&&")                   return Operator::And;
+               if (txt == L"==")                   return Operator::Equal;
+               if (txt == L"!=")                   return Operator::NotEqual;
+               if (txt == L"<=")                   return Operator::LessEqual;
+               if (txt == L">=")                   return Operator::GreaterEqual;
+               break;
+
+            case 3:
+               if (txt == L"AND")   return Operator::And;
+               if (txt == L"MOD")   return Operator::Modulus;
+               break;
+            }
+
+            return Operator::None;
+         }
+
+         /// <summary>Query whether an operator may precede a value</summary>
+         /// <param name="op">The operator</param>
+         /// <returns></returns>
+         bool  ExpressionParser::IsUnary(Operator op)
+         {
+            return op == Operator::BitwiseNot || op == Operator::LogicalNot || op == Operator::Subtract;
+         }
+
          // ------------------------------- PUBLIC METHODS -------------------------------
          
          // ------------------------------ PROTECTED METHODS -----------------------------
          
          /// <summary>Parses the expression, ensures it is correct and produces infix/postfix tokens.</summary>
-         /// <exception cref="Logic::AlgorithmException">Error in parsing algorithm</exception>
          /// <exception cref="Logic::ExpressionParserException">Syntax error in expression</exception>
          void  ExpressionParser::Parse(TokenIterator& start)
          {
             TokenIterator pos = InputBegin;
 
-            // Produce parse tree
-            ExpressionTree tree = ReadExpression(pos);
+            // Each token is output at most once per array
+            InfixParams.reserve(InputEnd - InputBegin);
+            PostfixParams.reserve(InputEnd - InputBegin);
+
+            // Produce infix + postfix tokens
+            ReadExpression(pos, MIN_PRECEDENCE);
 
             // Ensure all tokens parsed
             if (pos != InputEnd)
                throw ExpressionParserException(HERE, pos, L"Unexpected token");
-
-            // Extract tokens
-            tree->getTokenArray(Traversal::InOrder, InfixParams);
-            tree->getTokenArray(Traversal::PostOrder, PostfixParams);
-
-#ifdef PRINT_DEBUG
-            Console << L"Output: " << tree->debugPrint() << ENDL;
-            //Console << L"Infix: " << tree->debugPrintTraversal(Traversal::InOrder) << ENDL;
-            //Console << L"Postfix: " << tree->debugPrintTraversal(Traversal::PostOrder) << ENDL;
-#endif
          }
 
          // ------------------------------- PRIVATE METHODS ------------------------------
@@ -63,7 +130,7 @@ namespace Logic
          /// <summary>Attempts to matches any literal</summary>
          /// <param name="pos">Position of literal</param>
          /// <returns></returns>
-         bool  ExpressionParser::MatchLiteral(const TokenIterator& pos)
+         bool  ExpressionParser::MatchLiteral(const TokenIterator& pos) const
          {
             // Validate position 
             if (pos < InputEnd) 
@@ -82,107 +149,21 @@ namespace Logic
             return false;
          }
 
-         /// <summary>Attempts to matches a specific operator</summary>
-         /// <param name="pos">Position of operator</param>
-         /// <returns></returns>
-         bool ExpressionParser::MatchOperator(const TokenIterator& pos, const WCHAR* op)
-         {
-            // Validate position and compare operator
-            return pos < InputEnd && (pos->Type == TokenType::BinaryOp || pos->Type == TokenType::UnaryOp) && pos->Text == op;
-         }
-
-         /// <summary>Attempts to matches any operator of a given precedence</summary>
+         /// <summary>Identifies the operator at a position</summary>
          /// <param name="pos">Position of operator</param>
-         /// <returns></returns>
-         /// <exception cref="Logic::AlgorithmException">Invalid precendence detected</exception>
-         bool ExpressionParser::MatchOperator(const TokenIterator& pos, UINT precedence)
-         {
-            // Validate position. Ensure operator
-            if (pos >= InputEnd || (pos->Type != TokenType::BinaryOp && pos->Type != TokenType::UnaryOp))
-               return false;
-
-            // Precedence table taken from X2 scripting manual
-            switch (precedence)
-            {
-            case 0: return pos->Text == L"OR" || pos->Text == L"||";
-            case 1: return pos->Text == L"AND" || pos->Text == L"&&";
-            case 2: return pos->Text == L"|";
-            case 3: return pos->Text == L"^";
-            case 4: return pos->Text == L"&";
-            case 5: return pos->Text == L"==" || pos->Text == L"!=";
-            case 6: return pos->Text == L"<" || pos->Text == L">" || pos->Text == L"<=" || pos->Text == L">=";
-            case 7: return pos->Text == L"+" || pos->Text == L"-"; 
-            case 8: return pos->Text == L"*" || pos->Text == L"/" || pos->Text == L"%" || pos->Text == L"MOD";
-            case 9: return pos->Text == L"~" || pos->Text == L"!" || pos->Text == L"-"; 
-            }
-
-            throw AlgorithmException(HERE, VString(L"Invalid precedence %d", precedence));
-         }
-
-         /// <summary>Reads the current token as a literal</summary>
-         /// <param name="pos">Current position</param>
-         /// <returns>Token</returns>
-         /// <exception cref="Logic::AlgorithmException">Token is not a literal</exception>
-         /// <remarks>Advances the iterator to beyond the literal</remarks>
-         const ScriptToken&  ExpressionParser::ReadLiteral(TokenIterator& pos)
-         {
-            // Validation position
-            if (pos < InputEnd)
-               switch (pos->Type)
-               {
-               // Check type
-               case TokenType::Variable:
-               case TokenType::Number:
-               case TokenType::Null:
-               case TokenType::String:
-               case TokenType::GameObject:
-               case TokenType::ScriptObject:
-                  // Read literal. Advance position
-                  return *(pos++);
-               }
-          
-            // Error:
-            throw AlgorithmException(HERE, VString(L"'%s' is not a literal", pos < InputEnd ? pos->Text : L"<eof>"));
-         }
-
-         /// <summary>Reads the current token as an operator</summary>
-         /// <param name="pos">Current position</param>
-         /// <returns>Token</returns>
-         /// <exception cref="Logic::AlgorithmException">Token is not a operator</exception>
-         /// <remarks>Advances the iterator to beyond the operator</remarks>
-         const ScriptToken&  ExpressionParser::ReadOperator(TokenIterator& pos)
+         /// <returns>Operator, or Operator::None if position is not an operator</returns>
+         ExpressionParser::Operator  ExpressionParser::MatchOperator(const TokenIterator& pos) const
          {
-            // Verify operator
-            if (pos >= InputEnd || (pos->Type != TokenType::BinaryOp && pos->Type != TokenType::UnaryOp))
-               throw AlgorithmException(HERE, L"Not an operator");
-
-            // Read operator. Advance position
-            return *(pos++);
+            return pos < InputEnd ? Identify(*pos) : Operator::None;
          }
 
-
-         /// <summary>Reads an entire expression</summary>
+         /// <summary>Reads an expression whose binary operators are of at least a given precedence</summary>
          /// <param name="pos">Position of first token of expression</param>
-         /// <returns>Expression tree</returns>
-         /// <exception cref="Logic::AlgorithmException">Attempted to read incorrect type of Token</exception>
+         /// <param name="precedence">Minimum precedence</param>
          /// <exception cref="Logic::ExpressionParserException">Syntax error</exception>
          /// <remarks>Advances the iterator to beyond the end of the expression</remarks>
-         ExpressionParser::ExpressionTree  ExpressionParser::ReadExpression(TokenIterator& pos)
+         void  ExpressionParser::ReadExpression(TokenIterator& pos, UINT precedence)
          {
-            // Rule: Expression = Comparison
-            return ReadBinaryExpression(pos, MIN_PRECEDENCE);
-         }
-
-         /// <summary>Reads a binary expression, unary expression, sub-expression, or literal</summary>
-         /// <param name="pos">Position of first token of expression</param>
-         /// <returns>Expression tree</returns>
-         /// <exception cref="Logic::AlgorithmException">Attempted to read incorrect type of Token</exception>
-         /// <exception cref="Logic::ExpressionParserException">Syntax error</exception>
-         /// <remarks>Advances the iterator to beyond the end of the expression</remarks>
-         ExpressionParser::ExpressionTree  ExpressionParser::ReadBinaryExpression(TokenIterator& pos, UINT precedence)
-         {
-            ExpressionTree expr = nullptr;
-
             // Rule: Expr        = LogicalExpr
             // Rule: LogicalExpr = BitwiseExpr (AND/OR BitwiseExpr)*
             // Rule: BitwiseExpr = Comparison (&/|/^ Comparison)*
@@ -192,70 +173,73 @@ namespace Logic
             // Rule: UnaryExpr   = (!/-/~)? Value
             // Rule: Value       = literal / '(' expr ')'
 
-            // Read: BinaryExpr := higher-precedence-expr (input-precedence-operator  higher-precedence-expr)*
-            expr = (precedence < MAX_PRECEDENCE ? ReadBinaryExpression(pos, precedence+1) : ReadUnaryExpression(pos));    // throws
+            // Read: UnaryExpr
+            ReadUnaryExpression(pos);
 
-            // Match: operator  
-            while (MatchOperator(pos, precedence))
-            {  
+            // Match: operator of sufficient precedence. Operators of equal precedence are left-associative
+            for (UINT level; (level = Precedence[(UINT)MatchOperator(pos)]) != NOT_BINARY && level >= precedence; )
+            {
                // Read: operator
-               auto op = ReadOperator(pos);                                                        
+               const ScriptToken& op = *(pos++);
+               InfixParams += op;
 
-               // Read: higher-precedence-expr / Value
-               auto rhs = (precedence < MAX_PRECEDENCE ? ReadBinaryExpression(pos, precedence+1) : ReadUnaryExpression(pos));  // throws
-               expr = ExpressionTree(new BinaryExpression(op, expr, rhs));     // throws
+               // Read: higher-precedence-expr
+               ReadExpression(pos, level+1);
+               PostfixParams += op;
             }
-
-            // Success:
-            return expr;
          }
 
-
          /// <summary>Reads a unary expression, sub-expression, or literal</summary>
          /// <param name="pos">Position of first token of expression</param>
-         /// <returns>Expression tree</returns>
-         /// <exception cref="Logic::AlgorithmException">Attempted to read incorrect type of Token</exception>
          /// <exception cref="Logic::ExpressionParserException">Syntax error</exception>
          /// <remarks>Advances the iterator to beyond the end of the expression</remarks>
-         ExpressionParser::ExpressionTree  ExpressionParser::ReadUnaryExpression(TokenIterator& pos)
+         void  ExpressionParser::ReadUnaryExpression(TokenIterator& pos)
          {
             // Rule: Unary = (! / - / ~)? Value
 
             // Match: Operator  
-            if (MatchOperator(pos, MAX_PRECEDENCE)) 
+            if (IsUnary(MatchOperator(pos))) 
             {  
-               // Read: operator  (may throw)
-               const ScriptToken& op = ReadOperator(pos);
-               
-               // Manually convert binary-substract to unary-minus
-               ScriptToken unary = (op.Text != L"-" ? op : ScriptToken(TokenType::UnaryOp, op.Start, op.End, op.Text));
+               // Read: operator. Manually convert binary-substract to unary-minus
+               const ScriptToken& op = *(pos++);
+               if (op.Text == L"-")
+                  InfixParams += ScriptToken(TokenType::UnaryOp, op.Start, op.End, op.Text);
+               else
+                  InfixParams += op;
 
                // Read: Value  (may throw)
-               return ExpressionTree(new UnaryExpression(unary, ReadValue(pos)));
+               ReadValue(pos);
+
+               // Output operator after its operand
+               if (op.Text == L"-")
+                  PostfixParams += ScriptToken(TokenType::UnaryOp, op.Start, op.End, op.Text);
+               else
+                  PostfixParams += op;
+               return;
             }
 
             // Read: Value  (may throw)
-            return ReadValue(pos);
+            ReadValue(pos);
          }
 
          /// <summary>Reads a literal or sub-expression</summary>
          /// <param name="pos">Position of literal or first token of sub-expression</param>
-         /// <returns>Expression tree</returns>
-         /// <exception cref="Logic::AlgorithmException">Attempted to read incorrect type of Token</exception>
          /// <exception cref="Logic::ExpressionParserException">Syntax error</exception>
          /// <remarks>Advances the iterator to beyond the end of the literal or sub-expression</remarks>
-         ExpressionParser::ExpressionTree  ExpressionParser::ReadValue(TokenIterator& pos)
+         void  ExpressionParser::ReadValue(TokenIterator& pos)
          {
-            ExpressionTree expr = nullptr;
-
             // Rule: Value = Literal / '(' Expression ')'
 
             // Match: Literal  
             if (MatchLiteral(pos)) 
-               return ExpressionTree( new LiteralValue(ReadLiteral(pos)) );
+            {
+               InfixParams += *pos;
+               PostfixParams += *(pos++);
+               return;
+            }
 
             // Read: Bracket   [nothrow]
-            if (!MatchOperator(pos, L"(")) 
+            if (MatchOperator(pos) != Operator::OpenBracket) 
             {
                // Failed: Unexpected EOF
                if (pos >= InputEnd)
@@ -265,13 +249,16 @@ namespace Logic
                throw ExpressionParserException(HERE, pos, VString(L"Unexpected '%s'", pos->Text.c_str()));
             }
             
-            // Read: Expression  (may throw)
-            const ScriptToken& open = ReadOperator(pos);
-            expr = ReadExpression(pos);   // Adv. then match
+            // Read: Expression  (may throw)  [Brackets are implicit within postfix]
+            InfixParams += *(pos++);
+            ReadExpression(pos, MIN_PRECEDENCE);
 
             // Read: Bracket   [nothrow]
-            if (MatchOperator(pos, L")")) 
-               return ExpressionTree( new BracketedExpression(open, expr, ReadOperator(pos)) );
+            if (MatchOperator(pos) == Operator::CloseBracket) 
+            {
+               InfixParams += *(pos++);
+               return;
+            }
             
             // Failure: Missing closing bracket
             if (pos >= InputEnd)
@@ -1,5 +1,6 @@
 #include "stdafx.h"
 #include "FileStream.h"
+#include "TextDecoder.h"
 
 namespace Logic
 {
@@ -70,52 +71,62 @@ namespace Logic
       /// <param name="s">The input stream</param>
       /// <param name="length">Stream length on input, character length on output</param>
       /// <returns>Wide char buffer</returns>
-      /// <exception cref="Logic::IOException">Conversion failed</exception>
+      /// <remarks>The stream is decoded in chunks directly into the output buffer.  Files without a byte ordering mark are decoded as code page 1250</remarks>
+      /// <exception cref="Logic::IOException">An I/O error occurred</exception>
       CharArrayPtr  FileStream::ConvertFileBuffer(StreamPtr  s, DWORD&  Length)
       {
-         BYTE         utf8[3] = { 0xEF, 0xBB, 0xBF },    // UTF-8 byte ordering header
+         const BYTE   utf8[3] = { 0xEF, 0xBB, 0xBF },    // UTF-8 byte ordering header
                       utf16[2] = { 0xFF, 0xFE };         // UTF-16 byte ordering header
-         UINT         newLength;
+         const DWORD  CHUNK_SIZE = 64*1024;
          CharArrayPtr output;
+         DWORD        total = Length;
 
-         // Read entire file
-         auto input = s->ReadAllBytes();
-
-         // UTF16: Convert byte array -> wchar array
-         if (Length > 2 && memcmp(input.get(), utf16, 2) == 0)
+         // Reads until the buffer is full or the stream is exhausted
+         auto fill = [&s](BYTE* buffer, DWORD length) -> DWORD
          {
-            // Conv byte length -> char length  (minus 2byte BOM)
-            newLength = (Length -= 2) / 2;
-
-            // Copy exluding 2 byte BOM
-            output = CharArrayPtr(new WCHAR[newLength+1]);
-            memcpy(output.get(), input.get()+2, Length);
-         }
-         // UTF8: Convert UTF8 to UTF16
-         if (Length > 3 && memcmp(input.get(), utf8, 3) == 0)
+            DWORD count = 0;
+            for (DWORD read; count < length && (read = s->Read(buffer + count, length - count)) > 0; )
+               count += read;
+            return count;
+         };
+
+         // Read first chunk
+         ByteArrayPtr chunk(new BYTE[CHUNK_SIZE]);
+         DWORD count = fill(chunk.get(), min(total, CHUNK_SIZE)),
+               consumed = count;
+
+         // UTF16: Copy excluding 2 byte BOM, read remainder directly into output
+         if (count >= 2 && memcmp(chunk.get(), utf16, 2) == 0)
          {
-            // Calculate UTF16 length (minus 3byte BOM)
-            newLength = 2 * (Length -= 3);
+            output = CharArrayPtr(new WCHAR[(total-2)/2 + 1]);
+            BYTE* bytes = reinterpret_cast<BYTE*>(output.get());
 
-            // Copy excluding 3 byte BOM
-            output = CharArrayPtr(new WCHAR[newLength+1]);
-            newLength = MultiByteToWideChar(CP_UTF8, NULL, (char*)input.get()+3, Length, output.get(), newLength);
+            memcpy(bytes, chunk.get()+2, count-2);
+            Length = (count-2 + fill(bytes + count-2, total - count)) / 2;
          }
-         // ASCII: Convert ASCII to UTF16
+         // UTF8/ASCII: Decode in chunks.  Each byte produces at most one character
          else
          {
-            // Simple double in length
-            newLength = 2*Length;
-            output = CharArrayPtr(new WCHAR[newLength+1]);
-            newLength = MultiByteToWideChar(1250, NULL, (char*)input.get(), Length, output.get(), newLength);
-         }
+            bool isUTF8 = (count >= 3 && memcmp(chunk.get(), utf8, 3) == 0);
+            TextDecoder decoder(isUTF8 ? TextDecoder::Encoding::UTF8 : TextDecoder::Encoding::Windows1250);
+            DWORD offset = (isUTF8 ? 3 : 0);
 
-         // Failed: Throw
-         if (Length > 0 && (Length=newLength) == 0)
-            throw IOException(HERE, SysErrorString());
+            output = CharArrayPtr(new WCHAR[total + 1]);
+            Length = 0;
+
+            // Decode each chunk, excluding 3 byte BOM
+            for (bool final = false; !final; offset = 0)
+            {
+               final = (count == 0 || consumed >= total);
+               Length += decoder.Decode(chunk.get() + offset, count - offset, output.get() + Length, final);
+
+               if (!final)
+                  consumed += (count = fill(chunk.get(), min(total - consumed, CHUNK_SIZE)));
+            }
+         }
 
          // Null terminate + return
-         output.get()[newLength] = '\0';
+         output.get()[Length] = '\0';
          return output;
       }
 
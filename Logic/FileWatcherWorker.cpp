@@ -1,13 +1,14 @@
 #include "stdafx.h"
 #include "FileWatcherWorker.h"
 #include "ComThreadHelper.h"
+#include "XFileSystem.h"
 #include <strsafe.h>
 
 namespace Logic
 {
    namespace Threads
    {
-      /// <summary>Watches a file for changes by external programs</summary>
+      /// <summary>Watches a file, or a folder and its sub-folders, for changes by external programs</summary>
       class FileWatcher
       {
          // ------------------------ TYPES --------------------------
@@ -110,9 +111,10 @@ namespace Logic
 
          // --------------------- CONSTRUCTION ----------------------
       public:
-         /// <summary>Create file watcher for a file</summary>
-         /// <param name="f">Full path of file</param>
-         FileWatcher(const Path& f) : FullPath(f)
+         /// <summary>Create file watcher for a file, or for a folder and its sub-folders</summary>
+         /// <param name="f">Full path of file or folder</param>
+         /// <param name="subtree">False to watch a file, true to watch a folder and its sub-folders</param>
+         FileWatcher(const Path& f, bool subtree = false) : FullPath(f), Folder(subtree ? f.AppendBackslash() : f.Folder), Subtree(subtree)
          {}
          virtual ~FileWatcher()
          {}
@@ -136,13 +138,13 @@ namespace Logic
       
          // ----------------------- MUTATORS ------------------------
       public:
-         /// <summary>Suspends calling thread and waits for notification of changes to target file</summary>
+         /// <summary>Suspends calling thread and waits for notification of changes to target file or folder</summary>
          /// <param name="abort">Handle to the event used to abort operation</param>
          /// <returns>List of changes</returns>
          /// <exception cref="Logic::Win32Exception">Unable to listen for changes</exception>
          list<FileChange> Watch(ManualEvent& abort)
          {
-            FolderHandle handle(FullPath.Folder);     // Folder handle
+            FolderHandle handle(Folder);              // Folder handle
             ByteArrayPtr Buffer(new byte[4096]);      // FILE_NOTIFY_INFORMATION record buffer
             OVERLAPPED   async;
 
@@ -155,8 +157,9 @@ namespace Logic
             
             try
             {
-               // Init async notification of changes
-               if (!ReadDirectoryChangesW(handle, Buffer.get(), 4096, FALSE, FILE_NOTIFY_CHANGE_LAST_WRITE, nullptr, &async, FileIOCompletionRoutine))
+               // Init async notification of changes.  Subtree: Include files added, removed or renamed
+               DWORD filter = FILE_NOTIFY_CHANGE_LAST_WRITE | (Subtree ? FILE_NOTIFY_CHANGE_FILE_NAME : 0);
+               if (!ReadDirectoryChangesW(handle, Buffer.get(), 4096, Subtree ? TRUE : FALSE, filter, nullptr, &async, FileIOCompletionRoutine))
                   throw Win32Exception(HERE, L"Unable to create file-change listener");
                Console << Cons::Success << ENDL;
 
@@ -195,7 +198,7 @@ namespace Logic
             // Extract each record
             for (NOTIFICATION* n = (NOTIFICATION*)buf; n->NextEntryOffset < len; n = (NOTIFICATION*)((BYTE*)n + n->NextEntryOffset))
             {
-               c.push_back(FileChange(FullPath.Folder, n));
+               c.push_back(FileChange(Folder, n));
             
                // Abort once complete
                if (!n->NextEntryOffset)
@@ -207,19 +210,23 @@ namespace Logic
 
          // -------------------- REPRESENTATION ---------------------
       protected:
-         Path  FullPath;
+         Path  FullPath;      // Full path of file or folder
+         Path  Folder;        // Folder to watch
+         bool  Subtree;       // Whether to watch sub-folders
       };
 
       // -------------------------------- CONSTRUCTION --------------------------------
 
       /// <summary>Creates a new file watcher worker.</summary>
-      FileWatcherWorker::FileWatcherWorker() : BackgroundWorker((ThreadProc)ThreadMain)
+      FileWatcherWorker::FileWatcherWorker() : BackgroundWorker((ThreadProc)ThreadMain, true)
       {
       }
 
 
+      /// <summary>Aborts the operation if still running</summary>
       FileWatcherWorker::~FileWatcherWorker()
       {
+         Shutdown();
       }
 
       // ------------------------------- STATIC METHODS -------------------------------
@@ -234,22 +241,42 @@ namespace Logic
             REQUIRED(data);
             ComThreadHelper COM; 
             Path            path = data->GetFullPath();
+            XFileSystem*    vfs = data->GetFileSystem();
 
             // Await notification
             do 
             {
-               FileWatcher fw(path);
+               FileWatcher   fw(path, vfs != nullptr);
+               set<Path>     folders;
                
                // Watch for changes
                for (auto& c : fw.Watch(data->AbortEvent))
                {
+                  // Game folder: Collect folders containing changed files
+                  if (vfs)
+                     folders.insert(c.FullPath.Folder);
+
                   // Notify owner window if file was modified
-                  if (c.Action == FileWatcher::ChangeType::Modified && c.FullPath == path)
+                  else if (c.Action == FileWatcher::ChangeType::Modified && c.FullPath == path)
                   {
                      SyncConsole(Cons::UserAction << "External changes detected in: " << path << ENDL);
                      data->NotifyOwner();
                   }
                }
+
+               // Game folder: Rescan only the affected folders
+               for (auto& f : folders)
+               {
+                  try
+                  {
+                     if (vfs->Refresh(f))
+                        SyncConsole(Cons::UserAction << "External changes detected in: " << f << ENDL);
+                  }
+                  catch (ExceptionBase& e) 
+                  {
+                     Console.Log(HERE, e);
+                  }
+               }
                // Repeat until aborted
             } while (!data->AbortEvent.Signalled);
 
@@ -285,6 +312,24 @@ namespace Logic
          __super::Start(&Data);
       }
 
+      /// <summary>Starts watching the game folder of a file system, rescanning folders whose files change</summary>
+      /// <param name="vfs">Enumerated file system</param>
+      /// <exception cref="Logic::DirectoryNotFoundException">Game folder does not exist</exception>
+      /// <exception cref="Logic::InvalidOperationException">Thread already running</exception>
+      /// <exception cref="Logic::Win32Exception">Failed to start Thread</exception>
+      void  FileWatcherWorker::Start(XFileSystem& vfs)
+      {
+         // Ensure folder exists + thread not running
+         if (!vfs.GetFolder().Exists())
+            throw DirectoryNotFoundException(HERE, vfs.GetFolder());
+         if (IsRunning())
+            throw InvalidOperationException(HERE, L"Thread already running");
+
+         // Setup/Start thread
+         Data.Reset(vfs, vfs.GetFolder());
+         __super::Start(&Data);
+      }
+
       // ------------------------------ PROTECTED METHODS -----------------------------
 
       // ------------------------------- PRIVATE METHODS ------------------------------
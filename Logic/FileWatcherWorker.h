@@ -5,6 +5,11 @@
 
 namespace Logic
 {
+   namespace FileSystem
+   {
+      class XFileSystem;
+   }
+
    namespace Threads
    {
       /// <summary>Notifies a window of a file change</summary>
@@ -12,6 +17,8 @@ namespace Logic
 
 
       /// <summary>Registers and processes file-change notifications</summary>
+      /// <remarks>Watches either a single file, notifying a window when it is modified, or the game folder of a file system, 
+      /// refreshing only the folders whose files are added, removed or modified</remarks>
       class LogicExport FileWatcherWorker : public BackgroundWorker
       {
          // ------------------------ TYPES --------------------------
@@ -22,20 +29,27 @@ namespace Logic
             // --------------------- CONSTRUCTION ----------------------
          public:
             /// <summary>Create data for a file watcher worker</summary>
-            FileWatcherData() : WorkerData(Operation::FileWatcher)
+            FileWatcherData() : WorkerData(Operation::FileWatcher), Owner(nullptr), FileSystem(nullptr)
             {}
 
             // --------------------- PROPERTIES ------------------------
          
             // ---------------------- ACCESSORS ------------------------			
          public:
-            /// <summary>Gets the full path of the target file.</summary>
+            /// <summary>Gets the full path of the target file, or game folder.</summary>
             /// <returns></returns>
             Path GetFullPath() const
             {
                return FullPath;
             }
 
+            /// <summary>Gets the file system to refresh, if watching a game folder.</summary>
+            /// <returns>File system, or nullptr if watching a file</returns>
+            FileSystem::XFileSystem* GetFileSystem() const
+            {
+               return FileSystem;
+            }
+
             // ----------------------- MUTATORS ------------------------
          public:
             /// <summary>Notifies owner the file has changed</summary>
@@ -55,6 +69,21 @@ namespace Logic
                // Reset
                Owner = owner;
                FullPath = file;
+               FileSystem = nullptr;
+
+               // Reset base
+               __super::Reset();
+            }
+
+            /// <summary>Resets to initial state.</summary>
+            /// <param name="vfs">File system whose game folder is watched</param>
+            /// <param name="folder">Full path of game folder</param>
+            void Reset(FileSystem::XFileSystem& vfs, const Path& folder)
+            {
+               // Reset
+               Owner = nullptr;
+               FullPath = folder;
+               FileSystem = &vfs;
 
                // Reset base
                __super::Reset();
@@ -62,8 +91,9 @@ namespace Logic
             
             // -------------------- REPRESENTATION ---------------------
          protected:
-            CWnd* Owner;      // Window to notify upon changes
-            Path  FullPath;   // Full path of file to watch
+            CWnd*                     Owner;        // Window to notify upon changes
+            Path                      FullPath;     // Full path of file, or game folder, to watch
+            FileSystem::XFileSystem*  FileSystem;   // File system to refresh upon changes, or nullptr if watching a file
          };
 
          // --------------------- CONSTRUCTION ----------------------
@@ -93,6 +123,13 @@ namespace Logic
          /// <exception cref="Logic::Win32Exception">Failed to start Thread</exception>
          void  Start(CWnd* owner, const Path& file);
 
+         /// <summary>Starts watching the game folder of a file system, rescanning folders whose files change</summary>
+         /// <param name="vfs">Enumerated file system</param>
+         /// <exception cref="Logic::DirectoryNotFoundException">Game folder does not exist</exception>
+         /// <exception cref="Logic::InvalidOperationException">Thread already running</exception>
+         /// <exception cref="Logic::Win32Exception">Failed to start Thread</exception>
+         void  Start(FileSystem::XFileSystem& vfs);
+
          // -------------------- REPRESENTATION ---------------------
       protected:
          FileWatcherData  Data;
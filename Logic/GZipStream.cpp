@@ -1,5 +1,6 @@
 #include "stdafx.h"
 #include "GZipStream.h"
+#include "TaskScheduler.h"
 
 namespace Logic
 {
@@ -10,10 +11,12 @@ namespace Logic
       /// <summary>Creates a GZip stream using another stream as input</summary>
       /// <param name="src">The input stream</param>
       /// <param name="op">Whether to compress or decompress</param>
+      /// <param name="opt">Compression level, strategy and number of threads.  Ignored when decompressing</param>
       /// <exception cref="Logic::ArgumentException">Stream is not readable</exception>
       /// <exception cref="Logic::ArgumentNullException">Stream is null</exception>
       /// <exception cref="Logic::GZipException">Unable to inititalise stream</exception>
-      GZipStream::GZipStream(StreamPtr  src, Operation  op) : StreamDecorator(src), Mode(op)
+      GZipStream::GZipStream(StreamPtr  src, Operation  op, const CompressionOptions& opt) 
+         : StreamDecorator(src), Mode(op), Options(opt), Checksum(crc32(0L, Z_NULL, 0)), TotalIn(0), TotalOut(0), Closed(false)
       {
          // Clear structs
          ZeroMemory(&ZStream, sizeof(ZStream));
@@ -39,8 +42,12 @@ namespace Logic
             if (!src->CanWrite())
                throw ArgumentException(HERE, L"src", GuiString(ERR_NO_WRITE_ACCESS));
 
+            // Parallel: Each block is compressed by its own stream, the GZip header/trailer are written manually
+            if (IsParallel())
+               return;
+
             // Init stream
-            if (deflateInit2(&ZStream, Z_BEST_COMPRESSION, Z_DEFLATED, WINDOW_SIZE+DETECT_HEADER, 9, Z_DEFAULT_STRATEGY) != Z_OK)
+            if (deflateInit2(&ZStream, Options.Level, Z_DEFLATED, WINDOW_SIZE+DETECT_HEADER, 9, Options.Strategy) != Z_OK)
                throw GZipException(HERE, ZStream.msg);
 
             // Allocate + set output buffer
@@ -56,6 +63,44 @@ namespace Logic
          SafeClose();
       }
 
+      // ------------------------------- STATIC METHODS -------------------------------
+
+      /// <summary>Compresses a block as raw deflate data, primed with the input preceeding it</summary>
+      /// <param name="b">The block.  On return, contains the output and checksum or an error</param>
+      /// <param name="opt">Compression options</param>
+      void  GZipStream::CompressBlock(Block& b, const CompressionOptions& opt)
+      {
+         z_stream zs;
+         ZeroMemory(&zs, sizeof(zs));
+
+         // Init stream
+         if (deflateInit2(&zs, opt.Level, Z_DEFLATED, -15, 9, opt.Strategy) != Z_OK)
+         {
+            b.Error = zs.msg ? zs.msg : "Unable to initialise block";
+            return;
+         }
+
+         // Prime with preceeding input
+         if (b.DictionaryLength)
+            deflateSetDictionary(&zs, b.Dictionary, b.DictionaryLength);
+
+         // Allocate for worst case + sync marker
+         b.Output.resize(deflateBound(&zs, b.Length) + 16);
+         zs.next_in = const_cast<BYTE*>(b.Input);
+         zs.avail_in = b.Length;
+         zs.next_out = &b.Output[0];
+         zs.avail_out = b.Output.size();
+
+         // Compress entire block.  Non-final blocks end on a byte boundary so they can be concatenated
+         int res = deflate(&zs, b.Final ? Z_FINISH : Z_SYNC_FLUSH);
+         if (res != (b.Final ? Z_STREAM_END : Z_OK) || zs.avail_in > 0)
+            b.Error = zs.msg ? zs.msg : "Unable to compress block";
+
+         b.Output.resize(zs.total_out);
+         b.Checksum = crc32(0L, b.Input, b.Length);
+         deflateEnd(&zs);
+      }
+
       // ------------------------------- PUBLIC METHODS -------------------------------
       
       /// <summary>Stream is not seekable.</summary>
@@ -78,34 +123,35 @@ namespace Logic
                if (Mode == Operation::Decompression && inflateEnd(&ZStream) != Z_OK)
                   throw GZipException(HERE, ZStream.msg);
             
-               // Compression: Write internal compression buffer to disc
+               // Compression: Compress remaining input and write GZip trailer
+               else if (Mode == Operation::Compression && IsParallel())
+                  CompressBlocks(true);
+
+               // Compression: Flush remaining data to disc
                else if (Mode == Operation::Compression)
                {
                   ZStream.avail_in = 0;      // No input
                   ZStream.next_in = Z_NULL;
 
-                  // Flush remaining data into the output buffer
-                  if (deflate(&ZStream, Z_FINISH) != Z_STREAM_END)
-                     throw GZipException(HERE, ZStream.msg);
-                  else
-                  {
-                     // Success: Write GZIP to underlying stream 
-                     for (DWORD out = 0; out < ZStream.total_out; )
-                        out += StreamDecorator::Write(&Buffer.get()[out], ZStream.total_out - out);
-
-                     // Cleanup zstream
-                     if (deflateEnd(&ZStream) != Z_OK)
+                  // Finish stream, writing output whenever buffer is full
+                  for (int res = Z_OK; res != Z_STREAM_END; FlushOutput())
+                     if ((res = deflate(&ZStream, Z_FINISH)) != Z_OK && res != Z_STREAM_END)
                         throw GZipException(HERE, ZStream.msg);
-                  }
+
+                  // Cleanup zstream
+                  if (deflateEnd(&ZStream) != Z_OK)
+                     throw GZipException(HERE, ZStream.msg);
                }
             }
             catch (ExceptionBase&) {
                // Close before rethrowing
+               Closed = true;
                StreamDecorator::Close();
                throw;
             }
             
             // Close stream
+            Closed = true;
             StreamDecorator::Close();
          }
       }
@@ -139,7 +185,7 @@ namespace Logic
       /// <returns></returns>
       DWORD  GZipStream::GetPosition() const
       {
-         return ZStream.total_out;
+         return IsParallel() ? TotalOut : ZStream.total_out;
       }
 
       /// <summary>Closes the stream without throwing.</summary>
@@ -150,8 +196,9 @@ namespace Logic
             // Close ZLib stream
             if (Mode == Operation::Decompression)
                inflateEnd(&ZStream);
-            else
+            else if (!IsParallel())
                deflateEnd(&ZStream);
+            Closed = true;
 
             // Close underlying stream
             StreamDecorator::SafeClose();
@@ -173,13 +220,17 @@ namespace Logic
       /// <exception cref="Logic::GZipException">GZip error</exception>
       void  GZipStream::SetFileName(const wstring& name)
       {
-         if (ZStream.total_out > 0)
+         if (GetPosition() > 0)
             throw InvalidOperationException(HERE, L"Cannot set filename after writing");
 
          // Convert to ANSI
          FileName = GuiString::Convert(name, CP_ACP);
          ZHeader.name = (Byte*)FileName.c_str();
 
+         // Parallel: Header is written manually
+         if (IsParallel())
+            return;
+
          // Set header
          if (deflateSetHeader(&ZStream, &ZHeader) != Z_OK)
             throw GZipException(HERE, ZStream.msg);
@@ -244,8 +295,11 @@ namespace Logic
       /// <summary>Writes/compresses the specified buffer to the stream</summary>
       /// <param name="buffer">The buffer.</param>
       /// <param name="length">The length of the buffer.</param>
-      /// <returns>Number of bytes written</returns>
-      /// <exception cref="Logic::NotImplementedException">Always</exception>
+      /// <returns>Number of bytes consumed</returns>
+      /// <exception cref="Logic::ArgumentNullException">Buffer is null</exception>
+      /// <exception cref="Logic::NotSupportedException">Output stream is not writeable</exception>
+      /// <exception cref="Logic::GZipException">Unable to compress data</exception>
+      /// <exception cref="Logic::IOException">An I/O error occurred</exception>
       DWORD  GZipStream::Write(const BYTE* input, DWORD length)
       {
          REQUIRED(input);
@@ -254,50 +308,165 @@ namespace Logic
          if (!StreamDecorator::CanWrite())
             throw NotSupportedException(HERE, GuiString(ERR_NO_WRITE_ACCESS));
 
-         // Supply input buffer
-         ZStream.next_in = const_cast<BYTE*>(input);
-         ZStream.avail_in = length;
-
          // Empty: Return zero
          if (length == 0)
             return 0;
 
-         // Re-Fill output buffer if necessary
-         /*if (ZStream.avail_out == 0)
-            ZStream.avail_out = StreamDecorator::Read(ZStream.next_in, StreamDecorator::GetLength());*/
+         // Parallel: Queue input until there is a block for each thread
+         if (IsParallel())
+         {
+            Pending.insert(Pending.end(), input, input+length);
+            if (Pending.size() >= BLOCK_SIZE * Options.Threads)
+               CompressBlocks(false);
+            return length;
+         }
 
-         DWORD start = ZStream.avail_out;
-         
-         // Compress available input into the output buffer
-         switch (int res = deflate(&ZStream, Z_NO_FLUSH))
+         // Supply input buffer
+         ZStream.next_in = const_cast<BYTE*>(input);
+         ZStream.avail_in = length;
+
+         // Compress all input, writing output whenever buffer is full
+         while (ZStream.avail_in > 0)
          {
-         // Complete: Write to underlying stream + Return count
-         /*case Z_STREAM_END:
-            DWORD compressed = COMPRESS_BUFFER - ZStream.avail_out;
-            for (DWORD out = 0; out < compressed; )
-               out += StreamDecorator::Write(&Buffer.get()[out], compressed - out);
-            return compressed;*/
-
-         // Incomplete: Return # of bytes compressed
-         case Z_OK:
-            return ZStream.avail_out - start;
+            if (deflate(&ZStream, Z_NO_FLUSH) != Z_OK)
+               throw GZipException(HERE, ZStream.msg);
 
-         // Error: throw
-         case Z_BUF_ERROR:
-         default:
-            throw GZipException(HERE, ZStream.msg);
+            if (ZStream.avail_out == 0)
+               FlushOutput();
          }
+
+         return length;
       }
 
       // ------------------------------ PROTECTED METHODS -----------------------------
 
+      /// <summary>Compresses pending input as a batch of blocks, one per thread, and writes the output</summary>
+      /// <param name="final">Whether this is the end of the input.  Writes the GZip trailer if true.</param>
+      /// <exception cref="Logic::GZipException">Unable to compress data</exception>
+      /// <exception cref="Logic::IOException">An I/O error occurred</exception>
+      void  GZipStream::CompressBlocks(bool final)
+      {
+         vector<Block> blocks;
+         UINT size = Pending.size();
+
+         // Divide input into blocks, each primed with the preceeding 32KB  [Final stream must end with a block, even if empty]
+         for (UINT pos = 0; pos < size || blocks.empty(); pos += BLOCK_SIZE)
+         {
+            Block b;
+            b.Input = size ? &Pending[pos] : nullptr;
+            b.Length = min(BLOCK_SIZE, size - pos);
+            b.Final = final && pos + BLOCK_SIZE >= size;
+            b.Checksum = 0;
+
+            // Dictionary: Previous batch or previous block
+            if (pos == 0)
+            {
+               b.Dictionary = Dictionary.empty() ? nullptr : &Dictionary[0];
+               b.DictionaryLength = Dictionary.size();
+            }
+            else
+            {
+               b.DictionaryLength = min(DICTIONARY_SIZE, pos);
+               b.Dictionary = b.Input - b.DictionaryLength;
+            }
+            blocks.push_back(b);
+         }
+
+         // Compress: Inline if only one block, otherwise one task per block
+         if (blocks.size() == 1)
+            CompressBlock(blocks.front(), Options);
+         else
+         {
+            auto& scheduler = TaskScheduler::GetDefault();
+            TaskArray tasks;
+
+            for (auto& b : blocks)
+               tasks.push_back(scheduler.Run([&b,this] (const CancellationToken&) -> DWORD { CompressBlock(b, Options); return 0; }));
+
+            scheduler.WaitAll(tasks);
+         }
+
+         // Header: Write before first block
+         if (TotalOut == 0)
+         {
+            BYTE header[10] = { 0x1f, 0x8b, Z_DEFLATED, (BYTE)(FileName.empty() ? 0 : 0x08), 0,0,0,0, 
+                                (BYTE)(Options.Level == Z_BEST_COMPRESSION ? 2 : Options.Level == Z_BEST_SPEED ? 4 : 0), 0 };
+            WriteOutput(header, sizeof(header));
+
+            // Filename: null terminated
+            if (!FileName.empty())
+               WriteOutput((const BYTE*)FileName.c_str(), FileName.length()+1);
+         }
+
+         // Write blocks in order
+         for (auto& b : blocks)
+         {
+            if (!b.Error.empty())
+               throw GZipException(HERE, b.Error.c_str());
+
+            if (!b.Output.empty())
+               WriteOutput(&b.Output[0], b.Output.size());
+            
+            Checksum = crc32_combine(Checksum, b.Checksum, b.Length);
+            TotalIn += b.Length;
+         }
+
+         // Preserve final 32KB of input as dictionary for next batch
+         Dictionary.insert(Dictionary.end(), Pending.begin(), Pending.end());
+         if (Dictionary.size() > DICTIONARY_SIZE)
+            Dictionary.erase(Dictionary.begin(), Dictionary.end() - DICTIONARY_SIZE);
+         Pending.clear();
+
+         // Trailer: CRC32 + input length, little endian
+         if (final)
+         {
+            BYTE trailer[8];
+            for (int i = 0; i < 4; ++i)
+            {
+               trailer[i] = (BYTE)(Checksum >> (8*i));
+               trailer[4+i] = (BYTE)(TotalIn >> (8*i));
+            }
+            WriteOutput(trailer, sizeof(trailer));
+         }
+      }
+
+      /// <summary>Writes the contents of the output buffer to the underlying stream, then empties it</summary>
+      /// <exception cref="Logic::IOException">An I/O error occurred</exception>
+      void  GZipStream::FlushOutput()
+      {
+         WriteOutput(Buffer.get(), COMPRESS_BUFFER - ZStream.avail_out);
+
+         // Reset output buffer
+         ZStream.next_out = Buffer.get();
+         ZStream.avail_out = COMPRESS_BUFFER;
+      }
+
+      /// <summary>Writes an entire buffer to the underlying stream</summary>
+      /// <param name="buffer">The buffer.</param>
+      /// <param name="length">The length of the buffer.</param>
+      /// <exception cref="Logic::IOException">An I/O error occurred</exception>
+      void  GZipStream::WriteOutput(const BYTE* buffer, DWORD length)
+      {
+         for (DWORD out = 0; out < length; )
+            out += StreamDecorator::Write(&buffer[out], length - out);
+
+         TotalOut += length;
+      }
+
 		// ------------------------------- PRIVATE METHODS ------------------------------
 
       /// <summary>Determines whether the stream is closed.</summary>
       /// <returns></returns>
       bool   GZipStream::IsClosed() const
       {
-         return ZStream.zalloc == Z_NULL;
+         return Closed;
+      }
+
+      /// <summary>Determines whether the stream compresses blocks in parallel.</summary>
+      /// <returns></returns>
+      bool   GZipStream::IsParallel() const
+      {
+         return Mode == Operation::Compression && Options.Threads > 1;
       }
 
       // -------------------------------- NESTED CLASSES ------------------------------
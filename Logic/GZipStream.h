@@ -10,6 +10,41 @@ namespace Logic
    namespace IO
    {
 
+      /// <summary>Defines how a GZip stream compresses its output</summary>
+      class LogicExport CompressionOptions
+      {
+         // --------------------- CONSTRUCTION ----------------------
+      public:
+         /// <summary>Creates compression options</summary>
+         /// <param name="level">ZLib compression level</param>
+         /// <param name="strategy">ZLib compression strategy</param>
+         /// <param name="threads">Number of blocks compressed per batch, or 1 to compress serially.  Batches run on the default task scheduler</param>
+         CompressionOptions(int level = Z_BEST_COMPRESSION, int strategy = Z_DEFAULT_STRATEGY, UINT threads = 1)
+            : Level(level), Strategy(strategy), Threads(max(1U, threads))
+         {}
+
+         DEFAULT_COPY(CompressionOptions);	// Default copy semantics
+         DEFAULT_MOVE(CompressionOptions);	// Default move semantics
+
+         // ------------------------ STATIC -------------------------
+      public:
+         /// <summary>Gets options for compressing large files in parallel, one block per processor</summary>
+         /// <param name="level">ZLib compression level</param>
+         /// <returns></returns>
+         static CompressionOptions  Parallel(int level = Z_BEST_COMPRESSION)
+         {
+            SYSTEM_INFO info;
+            GetSystemInfo(&info);
+            return CompressionOptions(level, Z_DEFAULT_STRATEGY, info.dwNumberOfProcessors);
+         }
+
+         // -------------------- REPRESENTATION ---------------------
+      public:
+         int   Level;      // Compression level
+         int   Strategy;   // Compression strategy
+         UINT  Threads;    // Number of blocks compressed per batch
+      };
+
       /// <summary>Provides stream access to the contents of GZip files</summary>
       class LogicExport GZipStream : public StreamDecorator
       {
@@ -17,19 +52,41 @@ namespace Logic
          const int  WINDOW_SIZE = 15,
                     DETECT_HEADER = 16;
          const int  COMPRESS_BUFFER = 256*1024;
+         const UINT BLOCK_SIZE = 128*1024,
+                    DICTIONARY_SIZE = 32*1024;
          
       public:
          enum class Operation   { Compression, Decompression };
+
+      protected:
+         /// <summary>Block of input compressed independently of its neighbours, in parallel mode</summary>
+         class Block
+         {
+         public:
+            const BYTE*   Input;            // Uncompressed input
+            UINT          Length;           // Length of input
+            const BYTE*   Dictionary;       // Input preceeding the block
+            UINT          DictionaryLength; // Length of dictionary
+            bool          Final;            // Whether block ends the stream
+            vector<BYTE>  Output;           // Compressed output
+            uLong         Checksum;         // CRC32 of input
+            string        Error;            // ZLib error, if any
+         };
+
       
          // --------------------- CONSTRUCTION ----------------------
       public:
-         GZipStream(StreamPtr  src, Operation  op);
+         GZipStream(StreamPtr  src, Operation  op, const CompressionOptions& opt = CompressionOptions());
          ~GZipStream();
 
          // Prevent copying/moving
          NO_MOVE(GZipStream);
          NO_COPY(GZipStream);
 
+         // ------------------------ STATIC -------------------------
+      protected:
+         static void   CompressBlock(Block& b, const CompressionOptions& opt);
+
          // --------------------- PROPERTIES ------------------------
 			
 			// ---------------------- ACCESSORS ------------------------
@@ -39,6 +96,7 @@ namespace Logic
 
       protected:
          bool   IsClosed() const;
+         bool   IsParallel() const;
 
          // ----------------------- MUTATORS ------------------------
 
@@ -53,6 +111,11 @@ namespace Logic
          DWORD  Read(BYTE* buffer, DWORD length);
          DWORD  Write(const BYTE* buffer, DWORD length);
 
+      protected:
+         void   CompressBlocks(bool final);
+         void   FlushOutput();
+         void   WriteOutput(const BYTE* buffer, DWORD length);
+
          // -------------------- REPRESENTATION ---------------------
       protected:
          z_stream     ZStream;
@@ -60,6 +123,14 @@ namespace Logic
          ByteArrayPtr Buffer;
          Operation    Mode;
          string       FileName;
+
+         CompressionOptions  Options;     // Compression options
+         vector<BYTE>        Pending,     // [Parallel] Input awaiting compression
+                             Dictionary;  // [Parallel] Final 32KB of input already compressed
+         uLong               Checksum;    // [Parallel] CRC32 of input already compressed
+         DWORD               TotalIn,     // [Parallel] Length of input already compressed
+                             TotalOut;    // [Parallel] Length of output written, including header
+         bool                Closed;      // Whether stream has been closed
       };
 
    }
@@ -0,0 +1,222 @@
+#include "stdafx.h"
+#include "GameDataSet.h"
+#include "PreferencesLibrary.h"
+
+namespace Logic
+{
+   /// <summary>Resident data sets</summary>
+   GameDataSet::SetCollection  GameDataSet::Resident;
+
+   /// <summary>Active data set, or nullptr if the default libraries are active</summary>
+   GameDataSetPtr  GameDataSet::Current;
+
+   /// <summary>Number of read locks held by worker threads</summary>
+   volatile LONG  GameDataSet::Readers = 0;
+
+   /// <summary>Guards the resident and active sets</summary>
+   std::recursive_mutex  GameDataSet::Lock;
+
+   /// <summary>Data set in scope upon each thread, or nullptr to use the active set</summary>
+   static __declspec(thread) GameDataSet*  ScopedSet = nullptr;
+
+   // -------------------------------- CONSTRUCTION --------------------------------
+
+   /// <summary>Creates an empty data set</summary>
+   /// <param name="folder">Game folder</param>
+   /// <param name="ver">Game version</param>
+   /// <param name="lang">Game language</param>
+   GameDataSet::GameDataSet(Path folder, GameVersion ver, GameLanguage lang) 
+      : Folder(folder), Version(ver), Language(lang), Loaded(false)
+   {
+   }
+
+   GameDataSet::~GameDataSet()
+   {
+   }
+
+   /// <summary>Marks the libraries as being read</summary>
+   GameDataSet::ReadLock::ReadLock()
+   {
+      InterlockedIncrement(&Readers);
+   }
+
+   /// <summary>Releases the libraries</summary>
+   GameDataSet::ReadLock::~ReadLock()
+   {
+      InterlockedDecrement(&Readers);
+   }
+
+   /// <summary>Brings a data set into scope upon the calling thread</summary>
+   /// <param name="set">Data set, or nullptr to leave the current scope in effect</param>
+   GameDataSet::Scope::Scope(GameDataSetPtr set) : Set(set), Previous(ScopedSet)
+   {
+      if (Set)
+         ScopedSet = Set.get();
+   }
+
+   /// <summary>Restores the data set previously in scope</summary>
+   GameDataSet::Scope::~Scope()
+   {
+      ScopedSet = Previous;
+   }
+
+   // ------------------------------- STATIC METHODS -------------------------------
+
+   /// <summary>Makes a data set the target of the string, script object and game object libraries</summary>
+   /// <param name="set">Data set, or nullptr to activate the default (empty) libraries</param>
+   /// <remarks>Must not be called while any thread is reading the libraries, see IsReading</remarks>
+   void  GameDataSet::Activate(GameDataSetPtr set)
+   {
+      std::lock_guard<std::recursive_mutex> lock(Lock);
+      Current = set;
+
+      StringLibrary::Active       = (set ? &set->Strings       : &StringLibrary::Instance);
+      ScriptObjectLibrary::Active = (set ? &set->ScriptObjects : &ScriptObjectLibrary::Instance);
+      GameObjectLibrary::Active   = (set ? &set->GameObjects   : &GameObjectLibrary::Instance);
+   }
+
+   /// <summary>Discards all data sets and activates the default libraries</summary>
+   void  GameDataSet::Clear()
+   {
+      std::lock_guard<std::recursive_mutex> lock(Lock);
+      Activate(nullptr);
+      Resident.clear();
+   }
+
+   /// <summary>Creates and activates an empty data set, replacing any existing set for the same game and any sets that failed to load</summary>
+   /// <param name="folder">Game folder</param>
+   /// <param name="ver">Game version</param>
+   /// <param name="lang">Game language</param>
+   /// <returns>New data set</returns>
+   GameDataSetPtr  GameDataSet::Create(Path folder, GameVersion ver, GameLanguage lang)
+   {
+      auto set = GameDataSetPtr(new GameDataSet(folder, ver, lang));
+      std::lock_guard<std::recursive_mutex> lock(Lock);
+
+      // Activate before releasing the set it replaces
+      Activate(set);
+
+      // Replace previous
+      Resident.remove_if([&](const GameDataSetPtr& s) { return !s->Loaded || s->Matches(folder, ver, lang); });
+      Resident.push_back(set);
+      return set;
+   }
+
+   /// <summary>Finds a loaded data set</summary>
+   /// <param name="folder">Game folder</param>
+   /// <param name="ver">Game version</param>
+   /// <param name="lang">Game language</param>
+   /// <returns>Data set, or nullptr if not resident</returns>
+   GameDataSetPtr  GameDataSet::Find(Path folder, GameVersion ver, GameLanguage lang)
+   {
+      std::lock_guard<std::recursive_mutex> lock(Lock);
+
+      for (auto& s : Resident)
+         if (s->Loaded && s->Matches(folder, ver, lang))
+            return s;
+
+      return nullptr;
+   }
+
+   /// <summary>Finds a loaded data set for a game version, preferring the active set then those in the specified language</summary>
+   /// <param name="ver">Game version</param>
+   /// <param name="lang">Preferred language</param>
+   /// <returns>Data set, or nullptr if none are resident for that version</returns>
+   GameDataSetPtr  GameDataSet::Find(GameVersion ver, GameLanguage lang)
+   {
+      std::lock_guard<std::recursive_mutex> lock(Lock);
+      GameDataSetPtr match;
+
+      // Active: Keep
+      if (Current && Current->Loaded && Current->Version == ver)
+         return Current;
+
+      // Prefer matching language, otherwise earliest loaded
+      for (auto& s : Resident)
+         if (s->Loaded && s->Version == ver)
+         {
+            if (s->Language == lang)
+               return s;
+            else if (!match)
+               match = s;
+         }
+
+      return match;
+   }
+
+   /// <summary>Finds a loaded data set for the game of a script, preferring the active set then those in the preferred language</summary>
+   /// <param name="ver">Game version</param>
+   /// <returns>Data set, or nullptr if none are resident for that version</returns>
+   GameDataSetPtr  GameDataSet::Find(GameVersion ver)
+   {
+      return Find(ver, PrefsLib.GameDataLanguage);
+   }
+
+   /// <summary>Gets the active data set</summary>
+   /// <returns>Data set, or nullptr if the default libraries are active</returns>
+   GameDataSetPtr  GameDataSet::GetActive()
+   {
+      std::lock_guard<std::recursive_mutex> lock(Lock);
+      return Current;
+   }
+
+   /// <summary>Gets the number of resident data sets that loaded successfully</summary>
+   /// <returns></returns>
+   UINT  GameDataSet::GetCount()
+   {
+      std::lock_guard<std::recursive_mutex> lock(Lock);
+      return count_if(Resident.begin(), Resident.end(), [](const GameDataSetPtr& s) { return s->Loaded; });
+   }
+
+   /// <summary>Gets the data set in scope upon the calling thread</summary>
+   /// <returns>Data set, or nullptr if the active set is in effect</returns>
+   GameDataSet*  GameDataSet::GetScoped()
+   {
+      return ScopedSet;
+   }
+
+   /// <summary>Query whether any worker thread holds a read lock upon the libraries</summary>
+   /// <returns></returns>
+   bool  GameDataSet::IsReading()
+   {
+      return Readers > 0;
+   }
+
+   // ------------------------------- PUBLIC METHODS -------------------------------
+
+   /// <summary>Query whether this is the active data set</summary>
+   /// <returns></returns>
+   bool  GameDataSet::IsActive() const
+   {
+      return Current.get() == this;
+   }
+
+   /// <summary>Query whether this set holds data for a game folder, version and language</summary>
+   /// <param name="folder">Game folder</param>
+   /// <param name="ver">Game version</param>
+   /// <param name="lang">Game language</param>
+   /// <returns></returns>
+   bool  GameDataSet::Matches(Path folder, GameVersion ver, GameLanguage lang) const
+   {
+      return Folder == folder && Version == ver && Language == lang;
+   }
+
+   /// <summary>Starts watching the game folder, so folders whose files change are rescanned by the file system</summary>
+   /// <remarks>Must be called once the file system has been enumerated.  Failure is logged, leaving the file system as enumerated</remarks>
+   void  GameDataSet::WatchFiles()
+   {
+      try
+      {
+         FileWatcher.Start(FileSystem);
+      }
+      catch (ExceptionBase& e) 
+      {
+         Console.Log(HERE, e, L"Unable to watch the game folder for changes");
+      }
+   }
+
+   // ------------------------------ PROTECTED METHODS -----------------------------
+
+   // ------------------------------- PRIVATE METHODS ------------------------------
+}
+
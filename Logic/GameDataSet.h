@@ -0,0 +1,120 @@
+#pragma once
+
+#include "StringLibrary.h"
+#include "ScriptObjectLibrary.h"
+#include "GameObjectLibrary.h"
+#include "FileWatcherWorker.h"
+#include <mutex>
+
+namespace Logic
+{
+   class GameDataSet;
+
+   /// <summary>Shared pointer to a game data set</summary>
+   typedef shared_ptr<GameDataSet>  GameDataSetPtr;
+
+   /// <summary>Game data loaded from one game folder in one language</summary>
+   /// <remarks>Several data sets remain resident at once, one of which is active.  The string, script object and game object
+   /// library macros resolve to the libraries of the active set, so activating another set is a pointer swap.  The syntax and
+   /// description libraries do not depend upon the game and are shared by every set.  Not thread safe: Sets must only be
+   /// created or activated while no thread is reading the libraries.  Worker threads that read the libraries hold a ReadLock,
+   /// so the main window can defer switching until they have finished.  Scripts are read and parsed against the set for their own
+   /// game, which is brought into scope upon the calling thread without being activated.  The file system remains resident with the set, holding
+   /// the catalogs open, and is kept current by a file watcher that rescans only the folders that change.</remarks>
+   class LogicExport GameDataSet
+   {
+      // ------------------------ TYPES --------------------------
+   public:
+      /// <summary>Marks the libraries as being read by a worker thread while held</summary>
+      class LogicExport ReadLock
+      {
+      public:
+         ReadLock();
+         ~ReadLock();
+
+         NO_COPY(ReadLock);	// No copy semantics
+         NO_MOVE(ReadLock);	// No move semantics
+      };
+
+      /// <summary>Read lock handed from the thread that starts a worker to the worker itself</summary>
+      typedef unique_ptr<ReadLock>  ReadLockPtr;
+
+      /// <summary>Resolves the library macros to a data set upon the calling thread while held, without activating it</summary>
+      /// <remarks>Scopes must be nested.  A scope for no data set leaves the enclosing scope, or the active set, in effect</remarks>
+      class LogicExport Scope
+      {
+      public:
+         Scope(GameDataSetPtr set);
+         ~Scope();
+
+         NO_COPY(Scope);	// No copy semantics
+         NO_MOVE(Scope);	// No move semantics
+
+      protected:
+         GameDataSetPtr  Set;        // Data set in scope, kept alive while held
+         GameDataSet*    Previous;   // Data set in scope beforehand, or nullptr
+      };
+
+   protected:
+      /// <summary>Resident data sets, in order of creation</summary>
+      typedef list<GameDataSetPtr>  SetCollection;
+
+      // --------------------- CONSTRUCTION ----------------------
+   public:
+      GameDataSet(Path folder, GameVersion ver, GameLanguage lang);
+      virtual ~GameDataSet();
+
+      NO_COPY(GameDataSet);	// No copy semantics
+      NO_MOVE(GameDataSet);	// No move semantics
+
+      // ------------------------ STATIC -------------------------
+   public:
+      static void            Activate(GameDataSetPtr set);
+      static void            Clear();
+      static GameDataSetPtr  Create(Path folder, GameVersion ver, GameLanguage lang);
+      static GameDataSetPtr  Find(Path folder, GameVersion ver, GameLanguage lang);
+      static GameDataSetPtr  Find(GameVersion ver, GameLanguage lang);
+      static GameDataSetPtr  Find(GameVersion ver);
+      static GameDataSetPtr  GetActive();
+      static UINT            GetCount();
+      static GameDataSet*    GetScoped();
+      static bool            IsReading();
+
+   protected:
+      static SetCollection          Resident;
+      static GameDataSetPtr         Current;
+      static volatile LONG          Readers;      // Number of read locks held
+      static std::recursive_mutex   Lock;         // Guards the resident and active sets against lookups by worker threads
+
+      // --------------------- PROPERTIES ------------------------
+   public:
+      PROPERTY_GET(bool,Active,IsActive);
+
+      // ---------------------- ACCESSORS ------------------------
+   public:
+      bool  IsActive() const;
+      bool  Matches(Path folder, GameVersion ver, GameLanguage lang) const;
+
+      // ----------------------- MUTATORS ------------------------
+   public:
+      void  WatchFiles();
+
+      // -------------------- REPRESENTATION ---------------------
+   public:
+      const Path          Folder;          // Game folder
+      const GameVersion   Version;         // Game version
+      const GameLanguage  Language;        // Language of strings
+      bool                Loaded;          // Whether all libraries were populated successfully
+
+      XFileSystem          FileSystem;      // Game files, kept current once loaded
+      StringLibrary        Strings;
+      ScriptObjectLibrary  ScriptObjects;
+      GameObjectLibrary    GameObjects;
+
+   protected:
+      FileWatcherWorker    FileWatcher;     // Rescans changed folders of the file system.  Stopped before the file system is destroyed
+   };
+
+}
+
+using namespace Logic;
@@ -11,6 +11,7 @@
 #include "GameObjectLibrary.h"
 #include "DescriptionLibrary.h"
 #include "PreferencesLibrary.h"
+#include "Profiler.h"
 
 namespace Logic
 {
@@ -23,8 +24,10 @@ namespace Logic
       {
       }
 
+      /// <summary>Aborts the operation if still running</summary>
       GameDataWorker::~GameDataWorker()
       {
+         Shutdown();
       }
 
       // ------------------------------- STATIC METHODS -------------------------------
@@ -32,12 +35,8 @@ namespace Logic
       /// <summary>Clears all game data.</summary>
       void  GameDataWorker::Clear()
       {
-         // Strings
-         StringLib.Clear();
-
-         // script/game objects
-         ScriptObjectLib.Clear();
-         GameObjectLib.Clear();
+         // Strings, script/game objects
+         GameDataSet::Clear();
 
          // Descriptions
          DescriptionLib.Clear();
@@ -46,6 +45,60 @@ namespace Logic
          SyntaxLib.Clear();
       }
 
+      /// <summary>Populates the game data libraries synchronously on the calling thread.</summary>
+      /// <param name="folder">Game folder.</param>
+      /// <param name="ver">Game version.</param>
+      /// <param name="lang">Game language.</param>
+      /// <param name="data">Background worker data.</param>
+      /// <param name="shared">Whether to load the syntax and descriptions, which are shared by all game data sets.</param>
+      /// <remarks>COM must be initialised by the caller.  Populates the libraries of the active data set</remarks>
+      /// <exception cref="Logic::ArgumentNullException">Worker data is null</exception>
+      /// <exception cref="Logic::DirectoryNotFoundException">Folder does not exist</exception>
+      /// <exception cref="Logic::NotSupportedException">Version is X2 or X-Rebirth</exception>
+      /// <exception cref="Logic::IOException">I/O error occurred</exception>
+      void  GameDataWorker::Load(Path folder, GameVersion ver, GameLanguage lang, WorkerData* data, bool shared)
+      {
+         XFileSystem vfs;
+         Load(vfs, folder, ver, lang, data, shared);
+      }
+
+      /// <summary>Populates the game data libraries synchronously on the calling thread, from a file system that outlives the load.</summary>
+      /// <param name="vfs">File system to enumerate.</param>
+      /// <param name="folder">Game folder.</param>
+      /// <param name="ver">Game version.</param>
+      /// <param name="lang">Game language.</param>
+      /// <param name="data">Background worker data.</param>
+      /// <param name="shared">Whether to load the syntax and descriptions, which are shared by all game data sets.</param>
+      /// <remarks>COM must be initialised by the caller.  Populates the libraries of the active data set</remarks>
+      /// <exception cref="Logic::ArgumentNullException">Worker data is null</exception>
+      /// <exception cref="Logic::DirectoryNotFoundException">Folder does not exist</exception>
+      /// <exception cref="Logic::NotSupportedException">Version is X2 or X-Rebirth</exception>
+      /// <exception cref="Logic::IOException">I/O error occurred</exception>
+      void  GameDataWorker::Load(XFileSystem& vfs, Path folder, GameVersion ver, GameLanguage lang, WorkerData* data, bool shared)
+      {
+         PROFILE_FUNCTION();
+
+         // Build VFS. 
+         vfs.Enumerate(folder, ver, data);
+
+         // language files
+         StringLib.Enumerate(vfs, lang, data);
+
+         // script/game objects
+         ScriptObjectLib.Enumerate(data);
+         GameObjectLib.Enumerate(vfs, data);
+
+         // Shared: Already loaded
+         if (!shared)
+            return;
+
+         // Descriptions
+         DescriptionLib.Enumerate(data);
+
+         // legacy syntax file
+         SyntaxLib.Enumerate(data);
+      }
+
       /// <summary>Loads game data</summary>
       /// <param name="data">arguments.</param>
       /// <returns></returns>
@@ -53,7 +106,6 @@ namespace Logic
       {
          try
          {
-            XFileSystem vfs;
             HRESULT  hr;
 
             // Init COM
@@ -64,21 +116,35 @@ namespace Logic
             Console << Cons::UserAction << L"Loading " << VersionString(data->Version) << L" game data from " << data->GameFolder << ENDL;
             data->SendFeedback(ProgressType::Operation, 0, VString(L"Loading %s game data from '%s'", VersionString(data->Version).c_str(), data->GameFolder.c_str()));
 
-            // Build VFS. 
-            vfs.Enumerate(data->GameFolder, data->Version, data);
-
-            // language files
-            StringLib.Enumerate(vfs, data->Language, data);
-
-            // script/game objects
-            ScriptObjectLib.Enumerate(data);
-            GameObjectLib.Enumerate(vfs, data);
-
-            // Descriptions
-            DescriptionLib.Enumerate(data);
-
-            // legacy syntax file
-            SyntaxLib.Enumerate(data);
+#ifdef LOGIC_PROFILING
+            // Profiling: Record loading if enabled
+            Profiler::Instance.Enabled = PrefsLib.EnableProfiling;
+            Profiler::Instance.Clear();
+#endif
+
+            // Populate libraries of the new set, whether or not it remains active.  Keep file system current
+            GameDataSet::Scope scope(data->DataSet);
+            Load(data->DataSet->FileSystem, data->GameFolder, data->Version, data->Language, data, data->LoadShared);
+            data->DataSet->Loaded = true;
+            data->DataSet->WatchFiles();
+
+#ifdef LOGIC_PROFILING
+            // Profiling: Summarise + export trace, then stop recording
+            if (Profiler::Instance.Enabled)
+            {
+               Profiler::Instance.Enabled = false;
+               Profiler::Instance.Summarise(data, 15);
+
+               // Failure to write the trace does not affect the game data
+               try {
+                  Profiler::Instance.ExportTrace(Profiler::GetDefaultTracePath());
+               }
+               catch (ExceptionBase& e) {
+                  Console.Log(HERE, e, L"Unable to export profiling trace");
+               }
+               Profiler::Instance.Clear();
+            }
+#endif
 
             // Cleanup
             data->SendFeedback(Cons::UserAction, ProgressType::Succcess, 0, VString(L"Loaded %s game data successfully", VersionString(data->Version).c_str()));
@@ -92,6 +158,12 @@ namespace Logic
             Console << ENDL;
             data->SendFeedback(Cons::Error, ProgressType::Failure, 0, GuiString(L"Failed to load game data : ") + e.Message);
 
+#ifdef LOGIC_PROFILING
+            // Profiling: Stop recording
+            Profiler::Instance.Enabled = false;
+            Profiler::Instance.Clear();
+#endif
+
             // BEEP!
             MessageBeep(MB_ICONERROR);
 
@@ -102,6 +174,23 @@ namespace Logic
       }
 
       // ------------------------------- PUBLIC METHODS -------------------------------
+
+      /// <summary>Reactivates the data set that was active before the last load, if that load failed.</summary>
+      /// <returns>True if a previous data set was reactivated, otherwise false</returns>
+      /// <remarks>Must be called on the main thread once the worker has completed</remarks>
+      bool  GameDataWorker::RestorePrevious()
+      {
+         // Running/Succeeded: Nothing to restore
+         if (IsRunning() || !Data.DataSet || Data.DataSet->Loaded)
+            return false;
+
+         // None resident: Keep default libraries
+         if (!Data.Previous || !Data.Previous->Loaded)
+            return false;
+
+         GameDataSet::Activate(Data.Previous);
+         return true;
+      }
    
       // ------------------------------ PROTECTED METHODS -----------------------------
 
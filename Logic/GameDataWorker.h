@@ -1,6 +1,7 @@
 #pragma once
 #include "BackgroundWorker.h"
 #include "PreferencesLibrary.h"
+#include "GameDataSet.h"
 
 namespace Logic
 {
@@ -16,7 +17,7 @@ namespace Logic
          class LogicExport GameDataWorkerData : public WorkerData
          {
          public:
-            GameDataWorkerData() : WorkerData(Operation::LoadGameData), Version(GameVersion::Threat), Language(GameLanguage::English)
+            GameDataWorkerData() : WorkerData(Operation::LoadGameData), Version(GameVersion::Threat), Language(GameLanguage::English), LoadShared(true)
             {}
 
             /// <summary>Resets data + update values from preferences.</summary>
@@ -32,9 +33,12 @@ namespace Logic
             }
 
          public:
-            Path         GameFolder;
-            GameVersion  Version;
-            GameLanguage Language;
+            Path           GameFolder;
+            GameVersion    Version;
+            GameLanguage   Language;
+            GameDataSetPtr DataSet;       // Data set being populated
+            GameDataSetPtr Previous;      // Data set active beforehand, or nullptr if discarded
+            bool           LoadShared;    // Whether to load the syntax and descriptions shared by all data sets
          };
 	  
          // --------------------- CONSTRUCTION ----------------------
@@ -43,6 +47,10 @@ namespace Logic
 	      virtual ~GameDataWorker();
        
          // ------------------------ STATIC -------------------------
+      public:
+         static void         Load(Path folder, GameVersion ver, GameLanguage lang, WorkerData* data, bool shared = true);
+         static void         Load(XFileSystem& vfs, Path folder, GameVersion ver, GameLanguage lang, WorkerData* data, bool shared = true);
+
       protected:
          static void         Clear();
          static DWORD WINAPI ThreadMain(GameDataWorkerData* data);
@@ -53,7 +61,11 @@ namespace Logic
       
          // ----------------------- MUTATORS ------------------------
       public:
-         /// <summary>Loads game data using the current game data preferences.</summary>
+         bool  RestorePrevious();
+
+         /// <summary>Loads game data using the current game data preferences into a new data set, which is activated.</summary>
+         /// <remarks>Data sets for other games remain resident.  Reloading a resident data set, or loading the first, discards
+         /// all data sets and re-reads the syntax and descriptions they share.</remarks>
          /// <exception cref="Logic::InvalidOperationException">Thread already running</exception>
          /// <exception cref="Logic::Win32Exception">Failed to start Thread</exception>
          void  Start()
@@ -61,12 +73,20 @@ namespace Logic
             if (IsRunning())
                throw InvalidOperationException(HERE, L"Thread already running");
 
-            // Clear previous (if any)
-            Clear();
-
             // Update Game folder/version
             Data.Reset();
 
+            // Reload/First: Clear all
+            Data.LoadShared = GameDataSet::Find(Data.GameFolder, Data.Version, Data.Language) || GameDataSet::GetCount() == 0;
+            if (Data.LoadShared)
+               Clear();
+
+            // Remember active data set, restored if loading fails
+            Data.Previous = GameDataSet::GetActive();
+
+            // Create + activate data set for this game
+            Data.DataSet = GameDataSet::Create(Data.GameFolder, Data.Version, Data.Language);
+
             // Start thread
             __super::Start(&Data);
          }
@@ -1,5 +1,6 @@
 #include "stdafx.h"
 #include "GameObjectLibrary.h"
+#include "GameDataSet.h"
 #include "ScriptObjectLibrary.h"
 #include "XFileSystem.h"
 #include "WorkerData.h"
@@ -10,6 +11,7 @@
 #include "TFactory.h"
 #include "TDock.h"
 #include "TWare.h"
+#include "Profiler.h"
 
 namespace Logic
 {
@@ -18,6 +20,9 @@ namespace Logic
       /// <summary>Game object library singleton</summary>
       GameObjectLibrary  GameObjectLibrary::Instance;
 
+      /// <summary>Library of the active game data set, or the default instance if none</summary>
+      GameObjectLibrary*  GameObjectLibrary::Active = &GameObjectLibrary::Instance;
+
       /// <summary>Ware placeholder regular expression: {SSTYPE_LASER@1234}</summary>
       const wregex  GameObjectLibrary::PlaceHolder(L"([\\w_]+)@(\\d+)");
 
@@ -35,6 +40,14 @@ namespace Logic
 
       // ------------------------------- STATIC METHODS -------------------------------
 
+      /// <summary>Gets the library of the game data set in scope upon the calling thread, otherwise the active set</summary>
+      /// <returns></returns>
+      GameObjectLibrary&  GameObjectLibrary::GetCurrent()
+      {
+         auto set = GameDataSet::GetScoped();
+         return set ? set->GameObjects : *Active;
+      }
+
       // ------------------------------- PUBLIC METHODS -------------------------------
 
       /// <summary>Clears all loaded objects</summary>
@@ -90,6 +103,7 @@ namespace Logic
       /// <exception cref="Logic::NotSupportedException">Unsupported file type identified, but reader not available</exception>
       UINT GameObjectLibrary::Enumerate(const XFileSystem& vfs, WorkerData* data)
       {
+         PROFILE_FUNCTION();
          REQUIRED(data);
 
          // Clear previous contents
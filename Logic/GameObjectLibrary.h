@@ -213,6 +213,9 @@ namespace Logic
          // ------------------------ STATIC -------------------------
       public:
          static GameObjectLibrary  Instance;
+         static GameObjectLibrary* Active;
+
+         static GameObjectLibrary&  GetCurrent();
 
       private:
          static const wregex  PlaceHolder;
@@ -246,8 +249,8 @@ namespace Logic
          LookupCollection  Lookup;
       };
    
-      // Access to Game object library singleton
-      #define GameObjectLib  GameObjectLibrary::Instance
+      // Access to Game object library of the game data set in scope, otherwise the active set
+      #define GameObjectLib  (GameObjectLibrary::GetCurrent())
    }
 }
 
@@ -18,8 +18,10 @@ namespace Logic
       }
 
 
+      /// <summary>Aborts the operation if still running</summary>
       ImportProjectWorker::~ImportProjectWorker()
       {
+         Shutdown();
       }
 
       // ------------------------------- STATIC METHODS -------------------------------
@@ -29,6 +31,7 @@ namespace Logic
       /// <returns>TRUE if successful, FALSE if failed</returns>
       DWORD WINAPI ImportProjectWorker::ThreadMain(ImportProjectData* data)
       {
+         auto reading = move(data->Reading);    // Release game data upon exit
          list<Path> created;
 
          try
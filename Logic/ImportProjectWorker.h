@@ -1,5 +1,6 @@
 #pragma once
 #include "BackgroundWorker.h"
+#include "GameDataSet.h"
 
 namespace Logic
 {
@@ -40,6 +41,7 @@ namespace Logic
          public:
             Path   LegacyPath,
                    UpgradePath;
+            GameDataSet::ReadLockPtr  Reading;    // Held from Start until the thread exits
          };
 
          // --------------------- CONSTRUCTION ----------------------
@@ -73,8 +75,19 @@ namespace Logic
             // Reset data
             Data.Reset(legacy, upgrade);
 
+            // Prevent game data being switched until thread exits
+            Data.Reading.reset(new GameDataSet::ReadLock);
+
             // Start thread
-            __super::Start(&Data);
+            try
+            {
+               __super::Start(&Data);
+            }
+            catch (ExceptionBase&)
+            {
+               Data.Reading.reset();
+               throw;
+            }
          }
 
          // -------------------- REPRESENTATION ---------------------
@@ -0,0 +1,485 @@
+#include "stdafx.h"
+#include "LanguageFileIndex.h"
+#include "LanguageFileReader.h"
+#include "MemoryStream.h"
+
+namespace Logic
+{
+   namespace IO
+   {
+      /// <summary>Query whether a character is XML whitespace</summary>
+      /// <param name="ch">The character</param>
+      /// <returns></returns>
+      static bool  IsSpace(wchar ch)
+      {
+         return ch == L' ' || ch == L'\t' || ch == L'\r' || ch == L'\n';
+      }
+
+      /// <summary>Query whether a character terminates an element or attribute name</summary>
+      /// <param name="ch">The character</param>
+      /// <returns></returns>
+      static bool  IsNameEnd(wchar ch)
+      {
+         return IsSpace(ch) || ch == L'/' || ch == L'>' || ch == L'=';
+      }
+
+      /// <summary>Skips whitespace</summary>
+      /// <param name="pos">Position to search from</param>
+      /// <param name="end">End of text</param>
+      /// <returns>Position of the first non-whitespace character, or 'end' if none</returns>
+      static const wchar*  SkipSpace(const wchar* pos, const wchar* end)
+      {
+         while (pos < end && IsSpace(*pos))
+            ++pos;
+         return pos;
+      }
+
+      /// <summary>Gets the name of the element whose start tag begins at a position</summary>
+      /// <param name="tag">Position of the '&lt;'</param>
+      /// <param name="tagEnd">Position of the closing '&gt;'</param>
+      /// <returns></returns>
+      static wstring  GetElementName(const wchar* tag, const wchar* tagEnd)
+      {
+         return wstring(tag+1, find_if(tag+1, tagEnd, IsNameEnd));
+      }
+
+      // -------------------------------- CONSTRUCTION --------------------------------
+
+      /// <summary>Creates an index without any pages</summary>
+      LanguageFileIndex::LanguageFileIndex() : Length(0)
+      {
+      }
+
+      /// <summary>Nothing</summary>
+      LanguageFileIndex::~LanguageFileIndex()
+      {
+      }
+
+      // ------------------------------- STATIC METHODS -------------------------------
+
+      // ------------------------------- PUBLIC METHODS -------------------------------
+
+      /// <summary>Gets the number of pages whose strings have not been loaded</summary>
+      /// <returns></returns>
+      UINT  LanguageFileIndex::GetPendingPages() const
+      {
+         return Pending.size();
+      }
+
+      /// <summary>Gets the number of strings in a page, without loading it</summary>
+      /// <param name="page">The page</param>
+      /// <returns>Number of strings, or number of string elements if the page has not been loaded</returns>
+      UINT  LanguageFileIndex::GetStringCount(const LanguagePage& page) const
+      {
+         auto pos = Pending.find(page.ID);
+         if (pos == Pending.end())
+            return page.Strings.size();
+
+         UINT count = 0;
+         for (auto& extent : pos->second)
+            count += extent.Count;
+         return count;
+      }
+
+      /// <summary>Query whether the strings of a page have been loaded</summary>
+      /// <param name="page">The page ID</param>
+      /// <returns></returns>
+      bool  LanguageFileIndex::IsLoaded(UINT page) const
+      {
+         return Pending.find(page) == Pending.end();
+      }
+
+      /// <summary>Loads the strings of a page, if not already loaded</summary>
+      /// <param name="page">The page</param>
+      /// <exception cref="Logic::ComException">COM Error</exception>
+      /// <exception cref="Logic::FileFormatException">Corrupt XML / Missing elements / missing attributes</exception>
+      /// <exception cref="Logic::InvalidValueException">Invalid pageID</exception>
+      void  LanguageFileIndex::Load(LanguagePage& page)
+      {
+         auto pos = Pending.find(page.ID);
+         if (pos == Pending.end())
+            return;
+
+         // Parse each element in file order, merging strings
+         for (auto& extent : pos->second)
+         {
+            LanguagePage element = LanguageFileReader(CreateStream(extent.Offset, extent.Length)).ReadPage();
+            for (auto& pair : element.Strings)
+               page.Strings.Add(pair.second);
+         }
+
+         // Release text once every page is loaded
+         Pending.erase(pos);
+         if (Pending.empty())
+            Text.reset();
+      }
+
+      /// <summary>Loads the strings of every page not already loaded</summary>
+      /// <param name="pages">Pages of the file</param>
+      /// <exception cref="Logic::ComException">COM Error</exception>
+      /// <exception cref="Logic::FileFormatException">Corrupt XML / Missing elements / missing attributes</exception>
+      /// <exception cref="Logic::InvalidValueException">Invalid pageID</exception>
+      void  LanguageFileIndex::LoadAll(LanguageFile::PageCollection& pages)
+      {
+         while (!Pending.empty())
+         {
+            auto page = pages.find(Pending.begin()->first);
+
+            // Removed from file: Discard
+            if (page == pages.end())
+               Pending.erase(Pending.begin());
+            else
+               Load(page->second);
+         }
+
+         Text.reset();
+      }
+
+      /// <summary>Discards the elements of a page that has not been loaded, so they are not merged into a page later created with the same ID</summary>
+      /// <param name="page">The page ID</param>
+      void  LanguageFileIndex::Remove(UINT page)
+      {
+         Pending.erase(page);
+
+         // Release text once every page is loaded
+         if (Pending.empty())
+            Text.reset();
+      }
+
+      /// <summary>Changes the ID of a page that has not been loaded, so its elements are loaded by the page under its new ID</summary>
+      /// <param name="page">The page ID</param>
+      /// <param name="newID">The new page ID</param>
+      void  LanguageFileIndex::Rename(UINT page, UINT newID)
+      {
+         auto pos = Pending.find(page);
+         if (pos == Pending.end() || page == newID)
+            return;
+
+         Pending[newID] = move(pos->second);
+         Pending.erase(pos);
+      }
+
+      /// <summary>Reads the language tag and page attributes of a language file, and records the position of each page</summary>
+      /// <param name="in">Input stream</param>
+      /// <param name="path">Full path</param>
+      /// <returns>New language file, containing pages without strings</returns>
+      /// <exception cref="Logic::ArgumentNullException">Stream is null</exception>
+      /// <exception cref="Logic::ComException">COM Error</exception>
+      /// <exception cref="Logic::FileFormatException">Corrupt XML / Missing elements / missing attributes</exception>
+      /// <exception cref="Logic::InvalidValueException">Invalid languageID or pageID</exception>
+      /// <exception cref="Logic::IOException">An I/O error occurred</exception>
+      LanguageFile  LanguageFileIndex::ReadFile(StreamPtr in, Path path)
+      {
+         REQUIRED(in);
+
+         LanguageFile file(path);
+         file.ID = LanguageFilenameReader(path.FileName).FileID;
+         Pending.clear();
+
+         // Sanity check
+         if (!(Length = in->GetLength()))
+            throw FileFormatException(HERE, L"The file is empty");
+
+         // Convert ASCII/UTF8/UTF16 file into wchar array
+         Text = FileStream::ConvertFileBuffer(in, Length);
+         in->SafeClose();
+
+         const wchar *pos = Text.get(),
+                     *end = Text.get() + Length;
+
+         // Skip declaration, comments, processing instructions
+         for (pos = SkipSpace(pos, end); SkipMarkup(pos); pos = SkipSpace(pos, end))
+         {}
+
+         // Document type: May declare entities, so parse the whole document
+         if (wcsncmp(pos, L"<!", 2) == 0)
+         {
+            file = LanguageFileReader(CreateStream(0, Length)).ReadFile(path);
+            Text.reset();
+            return file;
+         }
+
+         // Ensure present: "Missing '%s' element"
+         if (pos == end || *pos != L'<')
+            throw FileFormatException(HERE, VString(ERR_XML_MISSING_ELEMENT, L"language"));
+
+         // Verify tag: "Unexpected '<%s>' element while searching for '<%s>' element"
+         const wchar* tagEnd = FindTagEnd(pos);
+         if (GetElementName(pos, tagEnd) != L"language")
+            throw FileFormatException(HERE, VString(ERR_XML_UNEXPECTED_ELEMENT, GetElementName(pos, tagEnd).c_str(), L"language"));
+
+         // Convert language ID
+         file.Language = LanguageFilenameReader::ParseLanguageID(ReadAttribute(pos, tagEnd, L"id", true));
+         if (tagEnd[-1] == L'/')
+            return file;
+
+         // Record pages
+         for (pos = tagEnd+1; ; )
+         {
+            if ((pos = find(pos, end, L'<')) == end)
+               throw FileFormatException(HERE, GetLineNumber(end), L"Unterminated language element");
+
+            // Skip comments etc.  Stop at closing tag
+            if (SkipMarkup(pos))
+               continue;
+            else if (pos[1] == L'/')
+               break;
+
+            // Verify tag
+            tagEnd = FindTagEnd(pos);
+            if (GetElementName(pos, tagEnd) != L"page")
+               throw FileFormatException(HERE, VString(ERR_XML_UNEXPECTED_ELEMENT, GetElementName(pos, tagEnd).c_str(), L"page"));
+
+            // Read properties.  Create page (also normalise PageID)
+            GameVersion ver;
+            LanguagePage page(LanguageFileReader::ParsePageID(ReadAttribute(pos, tagEnd, L"id", true), ver),
+                              ReadAttribute(pos, tagEnd, L"title", false),
+                              ReadAttribute(pos, tagEnd, L"descr", false),
+                              ReadAttribute(pos, tagEnd, L"voice", false) == L"yes");
+            file.Pages.Add(page);
+
+            // Record position of strings, if any
+            const wchar* element = pos;
+            if (UINT count = ReadElement(pos))
+               Pending[page.ID].push_back(PageExtent(element - Text.get(), pos - element, count));
+         }
+
+         // Release text if there are no strings
+         if (Pending.empty())
+            Text.reset();
+
+         return file;
+      }
+
+      // ------------------------------ PROTECTED METHODS -----------------------------
+
+      /// <summary>Creates a UTF-16 stream containing part of the decoded text</summary>
+      /// <param name="offset">Offset of first character</param>
+      /// <param name="length">Number of characters</param>
+      /// <returns></returns>
+      StreamPtr  LanguageFileIndex::CreateStream(UINT offset, UINT length) const
+      {
+         const wchar bom = 0xFEFF;
+         StreamPtr s(new MemoryStream((length+1) * sizeof(wchar), FileAccess::ReadWrite));
+
+         // Write byte ordering header + text.  Rewind
+         s->Write((BYTE*)&bom, sizeof(wchar));
+         s->Write((BYTE*)(Text.get() + offset), length * sizeof(wchar));
+         s->Seek(0, SeekOrigin::Begin);
+         return s;
+      }
+
+      /// <summary>Locates the '>' that ends the tag at a position</summary>
+      /// <param name="pos">Position of the '&lt;'</param>
+      /// <returns>Position of the '&gt;'</returns>
+      /// <exception cref="Logic::FileFormatException">Unterminated tag</exception>
+      const wchar*  LanguageFileIndex::FindTagEnd(const wchar* pos) const
+      {
+         const wchar* end = Text.get() + Length;
+         wchar quote = 0;
+
+         // Ignore '>' within quoted attribute values
+         for (const wchar* ch = pos+1; ch < end; ++ch)
+            if (quote)
+               quote = (*ch == quote ? 0 : quote);
+            else if (*ch == L'"' || *ch == L'\'')
+               quote = *ch;
+            else if (*ch == L'>')
+               return ch;
+
+         throw FileFormatException(HERE, GetLineNumber(pos), L"Unterminated element");
+      }
+
+      /// <summary>Gets the line number of a position, for error reporting</summary>
+      /// <param name="pos">Position within the text</param>
+      /// <returns>One-based line number</returns>
+      UINT  LanguageFileIndex::GetLineNumber(const wchar* pos) const
+      {
+         return 1 + (UINT)count((const wchar*)Text.get(), pos, L'\n');
+      }
+
+      /// <summary>Reads the value of an attribute from a start tag</summary>
+      /// <param name="tag">Position of the '&lt;'</param>
+      /// <param name="tagEnd">Position of the closing '&gt;'</param>
+      /// <param name="name">The attribute name</param>
+      /// <param name="required">Whether the attribute must be present</param>
+      /// <returns>Attribute value, or empty string if missing</returns>
+      /// <exception cref="Logic::FileFormatException">Malformed or missing attribute</exception>
+      wstring  LanguageFileIndex::ReadAttribute(const wchar* tag, const wchar* tagEnd, const wchar* name, bool required) const
+      {
+         const wchar* pos = find_if(tag+1, tagEnd, IsNameEnd);
+         wstring value;
+
+         while ((pos = SkipSpace(pos, tagEnd)) < tagEnd && *pos != L'/')
+         {
+            // Name
+            const wchar* nameEnd = find_if(pos, tagEnd, IsNameEnd);
+            bool match = (wstring(pos, nameEnd) == name);
+
+            // Value: Expect '=' then quoted text
+            pos = SkipSpace(nameEnd, tagEnd);
+            if (pos == tagEnd || *pos != L'=' || (pos = SkipSpace(pos+1, tagEnd)) == tagEnd || (*pos != L'"' && *pos != L'\''))
+               throw FileFormatException(HERE, GetLineNumber(pos), VString(L"Malformed attribute on '<%s>' element", GetElementName(tag, tagEnd).c_str()));
+
+            const wchar* valueEnd = find(pos+1, tagEnd, *pos);
+            if (match)
+            {
+               ReadText(pos+1, valueEnd, value);
+               return value;
+            }
+            pos = valueEnd+1;
+         }
+
+         // Ensure present : "Missing '%s' attribute on '<%s>' element"
+         if (required)
+            throw FileFormatException(HERE, VString(ERR_XML_MISSING_ATTRIBUTE, name, GetElementName(tag, tagEnd).c_str()));
+
+         return value;
+      }
+
+      /// <summary>Skips an element and its content, counting its child elements</summary>
+      /// <param name="pos">Position of the '&lt;'.  On return, the position following the element</param>
+      /// <returns>Number of child elements</returns>
+      /// <exception cref="Logic::FileFormatException">Unterminated element or comment</exception>
+      UINT  LanguageFileIndex::ReadElement(const wchar*& pos) const
+      {
+         const wchar *end = Text.get() + Length,
+                     *start = pos;
+         UINT children = 0,
+              depth = 0;
+
+         // Empty: Skip tag
+         pos = FindTagEnd(pos) + 1;
+         if (pos[-2] == L'/')
+            return 0;
+
+         while ((pos = find(pos, end, L'<')) < end)
+         {
+            // Skip comments, CDATA, processing instructions
+            if (SkipMarkup(pos))
+               continue;
+
+            const wchar* tagEnd = FindTagEnd(pos);
+
+            // Closing tag: Finished once closing the element
+            if (pos[1] == L'/')
+            {
+               pos = tagEnd+1;
+               if (depth-- == 0)
+                  return children;
+            }
+            // Start tag: Count children
+            else
+            {
+               if (depth == 0)
+                  ++children;
+               if (tagEnd[-1] != L'/')
+                  ++depth;
+               pos = tagEnd+1;
+            }
+         }
+
+         throw FileFormatException(HERE, GetLineNumber(start), VString(L"Unterminated '<%s>' element", GetElementName(start, FindTagEnd(start)).c_str()));
+      }
+
+      /// <summary>Decodes an attribute value, normalising whitespace and replacing entities</summary>
+      /// <param name="pos">Start of value</param>
+      /// <param name="end">End of value</param>
+      /// <param name="value">On return, the value</param>
+      /// <exception cref="Logic::FileFormatException">Unrecognised or unterminated entity</exception>
+      void  LanguageFileIndex::ReadText(const wchar* pos, const wchar* end, wstring& value) const
+      {
+         value.clear();
+
+         for (; pos < end; ++pos)
+            switch (*pos)
+            {
+            // Line break: CRLF is a single space
+            case L'\r':
+               if (pos+1 < end && pos[1] == L'\n')
+                  ++pos;
+               // [Fall through]
+            case L'\n':
+            case L'\t':
+               value += L' ';
+               break;
+
+            // Entity
+            case L'&':
+               {
+                  const wchar* semi = find(pos, end, L';');
+                  wstring entity(pos+1, semi);
+                  UINT ch = 0;
+
+                  if (semi == end)
+                     throw FileFormatException(HERE, GetLineNumber(pos), L"Unterminated entity reference in attribute");
+
+                  if (entity == L"lt")         ch = L'<';
+                  else if (entity == L"gt")    ch = L'>';
+                  else if (entity == L"amp")   ch = L'&';
+                  else if (entity == L"quot")  ch = L'"';
+                  else if (entity == L"apos")  ch = L'\'';
+                  else if (entity.length() > 1 && entity[0] == L'#')
+                     ch = (entity[1] == L'x' ? wcstoul(entity.c_str()+2, nullptr, 16) : wcstoul(entity.c_str()+1, nullptr, 10));
+
+                  if (ch == 0 || ch > 0x10FFFF)
+                     throw FileFormatException(HERE, GetLineNumber(pos), VString(L"Unrecognised entity '&%s;' in attribute", entity.c_str()));
+
+                  // Supplementary: Encode as surrogate pair where necessary
+                  if (ch >= 0x10000 && sizeof(wchar) == 2)
+                  {
+                     value += static_cast<wchar>(0xD800 + ((ch - 0x10000) >> 10));
+                     value += static_cast<wchar>(0xDC00 + ((ch - 0x10000) & 0x3FF));
+                  }
+                  else
+                     value += static_cast<wchar>(ch);
+
+                  pos = semi;
+               }
+               break;
+
+            default:
+               value += *pos;
+               break;
+            }
+      }
+
+      /// <summary>Skips a comment, CDATA section or processing instruction</summary>
+      /// <param name="pos">Position to test.  On return, the position following the markup, if any</param>
+      /// <returns>True if markup was skipped, otherwise false</returns>
+      /// <exception cref="Logic::FileFormatException">Unterminated markup</exception>
+      bool  LanguageFileIndex::SkipMarkup(const wchar*& pos) const
+      {
+         // Text is null terminated, so comparisons stop at the end
+         if (wcsncmp(pos, L"<!--", 4) == 0)
+            pos = SkipPast(pos+4, L"-->");
+         else if (wcsncmp(pos, L"<![CDATA[", 9) == 0)
+            pos = SkipPast(pos+9, L"]]>");
+         else if (wcsncmp(pos, L"<?", 2) == 0)
+            pos = SkipPast(pos+2, L"?>");
+         else
+            return false;
+
+         return true;
+      }
+
+      /// <summary>Finds the position following a terminator</summary>
+      /// <param name="pos">Position to search from</param>
+      /// <param name="terminator">The terminator</param>
+      /// <returns>Position following the terminator</returns>
+      /// <exception cref="Logic::FileFormatException">Terminator not found</exception>
+      const wchar*  LanguageFileIndex::SkipPast(const wchar* pos, const wchar* terminator) const
+      {
+         const wchar *end = Text.get() + Length,
+                     *termEnd = terminator + wcslen(terminator),
+                     *match = search(pos, end, terminator, termEnd);
+
+         if (match == end)
+            throw FileFormatException(HERE, GetLineNumber(pos), VString(L"Missing '%s'", terminator));
+
+         return match + (termEnd - terminator);
+      }
+
+		// ------------------------------- PRIVATE METHODS ------------------------------
+   }
+}
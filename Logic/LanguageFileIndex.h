@@ -0,0 +1,80 @@
+#pragma once
+
+#include "LanguageFile.h"
+#include "Stream.h"
+
+namespace Logic
+{
+   namespace IO
+   {
+      /// <summary>Reads an X3 language xml file a page at a time</summary>
+      /// <remarks>The file is decoded once and scanned without building a document, recording the attributes of each page, the
+      /// position of its element within the text and the number of strings it contains.  The strings of a page are parsed the
+      /// first time the page is loaded, so opening a file only costs a pass over its text.  Pages that share an ID are merged
+      /// when loaded, in file order, exactly as LanguageFileReader merges them.</remarks>
+      class LogicExport LanguageFileIndex
+      {
+         // ------------------------ TYPES --------------------------
+      protected:
+         /// <summary>Position of a page element within the decoded text</summary>
+         class PageExtent
+         {
+         public:
+            PageExtent(UINT offset, UINT length, UINT count) : Offset(offset), Length(length), Count(count)
+            {}
+
+            UINT  Offset,     // Offset of the start tag, in characters
+                  Length,     // Length of the element, in characters
+                  Count;      // Number of string elements
+         };
+
+         /// <summary>Elements of pages not yet loaded, by page ID.  Pages with duplicate IDs have several elements</summary>
+         typedef map<UINT, vector<PageExtent>>  PendingCollection;
+
+         // --------------------- CONSTRUCTION ----------------------
+      public:
+         LanguageFileIndex();
+         virtual ~LanguageFileIndex();
+
+         NO_COPY(LanguageFileIndex);	// No copy semantics
+         NO_MOVE(LanguageFileIndex);	// No move semantics
+
+         // --------------------- PROPERTIES ------------------------
+      public:
+         PROPERTY_GET(UINT,PendingPages,GetPendingPages);
+
+         // ---------------------- ACCESSORS ------------------------
+      public:
+         UINT  GetPendingPages() const;
+         UINT  GetStringCount(const LanguagePage& page) const;
+         bool  IsLoaded(UINT page) const;
+
+      protected:
+         StreamPtr     CreateStream(UINT offset, UINT length) const;
+         const wchar*  FindTagEnd(const wchar* pos) const;
+         UINT          GetLineNumber(const wchar* pos) const;
+         wstring       ReadAttribute(const wchar* tag, const wchar* tagEnd, const wchar* name, bool required) const;
+         UINT          ReadElement(const wchar*& pos) const;
+         void          ReadText(const wchar* pos, const wchar* end, wstring& value) const;
+         bool          SkipMarkup(const wchar*& pos) const;
+         const wchar*  SkipPast(const wchar* pos, const wchar* terminator) const;
+
+         // ----------------------- MUTATORS ------------------------
+      public:
+         void          Load(LanguagePage& page);
+         void          LoadAll(LanguageFile::PageCollection& pages);
+         LanguageFile  ReadFile(StreamPtr in, Path path);
+         void          Remove(UINT page);
+         void          Rename(UINT page, UINT newID);
+
+         // -------------------- REPRESENTATION ---------------------
+      protected:
+         CharArrayPtr       Text;       // Decoded file
+         DWORD              Length;     // Length of decoded file, in characters
+         PendingCollection  Pending;    // Pages not yet loaded
+      };
+
+   }
+}
+
+using namespace Logic::IO;
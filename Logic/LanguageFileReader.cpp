@@ -168,6 +168,28 @@ namespace Logic
          }
       }
 
+      /// <summary>Reads a document containing a single page, such as a page element extracted from a language file</summary>
+      /// <returns>New language page</returns>
+      /// <exception cref="Logic::ComException">COM Error</exception>
+      /// <exception cref="Logic::FileFormatException">Corrupt XML / Missing elements / missing attributes</exception>
+      /// <exception cref="Logic::InvalidValueException">Invalid pageID</exception>
+      /// <exception cref="Logic::IOException">An I/O error occurred</exception>
+      LanguagePage LanguageFileReader::ReadPage()
+      {
+         try
+         {
+            // Parse document
+            LoadDocument();
+
+            // Read page
+            XmlNodePtr pageNode(Document->documentElement);
+            return ReadPage(pageNode);
+         }
+         catch (_com_error& ex) {
+            throw ComException(HERE, ex);
+         }
+      }
+
       // ------------------------------ PROTECTED METHODS -----------------------------
 
 		// ------------------------------- PRIVATE METHODS ------------------------------
@@ -45,7 +45,7 @@ namespace Logic
 
          // ------------------------ STATIC -------------------------
 
-      private:
+      public:
          static UINT    ParsePageID(const wstring&  pageid, GameVersion&  v);
 
          // --------------------- PROPERTIES ------------------------
@@ -56,6 +56,7 @@ namespace Logic
 
       public:
          LanguageFile   ReadFile(Path path);
+         LanguagePage   ReadPage();
 
       private:
          GameLanguage   ReadLanguageTag(XmlNodePtr& element);
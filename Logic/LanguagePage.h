@@ -2,6 +2,7 @@
 
 #include "MapIterator.hpp"
 #include "RichString.h"
+#include "StringPool.h"
 
 namespace Logic
 {
@@ -44,6 +45,7 @@ namespace Logic
       enum class ColourTag { Undetermined, Unix, Message };
 
       /// <summary>Represents a string in a language file</summary>
+      /// <remarks>Text is held in the string pool, so strings repeated across pages and files share a single copy</remarks>
       class LogicExport LanguageString
       {
          // --------------------- CONSTRUCTION ----------------------
@@ -62,6 +64,7 @@ namespace Logic
       public:
          PROPERTY_GET(wstring,ResolvedText,GetResolvedText);
          PROPERTY_GET(RichString,RichText,GetRichText);
+         PROPERTY_GET_SET(const wstring&,Text,GetText,SetText);
 
 		   // ---------------------- ACCESSORS ------------------------
       public:
@@ -70,17 +73,33 @@ namespace Logic
          bool       IsScriptObject() const;
          GuiString  ToXML() const;
 
+         /// <summary>Gets the source text</summary>
+         /// <returns>Pooled text, valid until the text is changed or the string destroyed</returns>
+         const wstring&  GetText() const
+         {
+            return Content.Text;
+         }
+
 		   // ----------------------- MUTATORS ------------------------
       public:
          ColourTag  IdentifyColourTags();
 
+         /// <summary>Sets the source text</summary>
+         /// <param name="txt">The text</param>
+         void  SetText(const wstring& txt)
+         {
+            Content = PooledString(txt);
+         }
+
 		   // -------------------- REPRESENTATION ---------------------
       public:
          UINT         ID,
                       Page;
-         wstring      Text;
          GameVersion  Version;
          ColourTag    TagType;
+
+      protected:
+         PooledString  Content;     // Source text
       };
 
       /// <summary>Write string to console</summary>
@@ -18,12 +18,12 @@ namespace Logic
       // -------------------------------- CONSTRUCTION --------------------------------
       
       LanguageString::LanguageString(UINT  id, UINT page, wstring  txt, GameVersion v)
-         : ID(id), Page(page), Text(txt), Version(v), TagType(ColourTag::Undetermined)
+         : ID(id), Page(page), Version(v), TagType(ColourTag::Undetermined), Content(txt)
       {
       }
 
       LanguageString::LanguageString(LanguageString&& r) 
-         : ID(r.ID), Page(r.Page), Text(move(r.Text)), Version(r.Version), TagType(r.TagType)
+         : ID(r.ID), Page(r.Page), Version(r.Version), TagType(r.TagType), Content(move(r.Content))
       {
       }
 
@@ -66,15 +66,15 @@ namespace Logic
 
                   // Script:
                   if (doc.FileType == FileType::Script)
-                     scripts.Add(doc);
+                     file.Add(doc, scripts);
                   
                   // LanguageFile:
                   else if (doc.FileType == FileType::Language)
-                     language.Add(doc);
+                     file.Add(doc, language);
                }
                // Variable
                else if (n->nodeName == _bstr_t(L"variable"))
-                  variables.Add(ReadVariable(n));
+                  file.Add(ReadVariable(n), variables);
                else  
                   // Unrecognised
                   throw FileFormatException(HERE, L"Unrecognised element");;
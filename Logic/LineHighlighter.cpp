@@ -0,0 +1,96 @@
+#include "stdafx.h"
+#include "LineHighlighter.h"
+#include "CommandLexer.h"
+
+namespace Logic
+{
+   namespace Scripts
+   {
+      // -------------------------------- CONSTRUCTION --------------------------------
+
+      /// <summary>Create highlighter using the current colour preferences</summary>
+      LineHighlighter::LineHighlighter()
+      {
+      }
+
+      LineHighlighter::~LineHighlighter()
+      {
+      }
+
+      // ------------------------------- STATIC METHODS -------------------------------
+
+      // ------------------------------- PUBLIC METHODS -------------------------------
+
+      /// <summary>Discards all cached lines.  Used when variable colours may have changed</summary>
+      void  LineHighlighter::Clear()
+      {
+         Cache.clear();
+      }
+
+      /// <summary>Gets the number of cached lines</summary>
+      /// <returns></returns>
+      UINT  LineHighlighter::GetCount() const
+      {
+         return Cache.size();
+      }
+
+      /// <summary>Gets the colour runs for a line of script, lexing the line only if not already cached</summary>
+      /// <param name="script">Script containing the line, used to colour arguments and constants</param>
+      /// <param name="line">Line text</param>
+      /// <returns>Colour runs, valid until the next call</returns>
+      /// <exception cref="Logic::ArgumentException">Unknown token type</exception>
+      const LineHighlighter::ColourRunArray&  LineHighlighter::GetRuns(const ScriptFile& script, const wstring& line)
+      {
+         size_t hash = std::hash<wstring>()(line);
+
+         // Lookup line
+         auto it = Cache.find(hash);
+         if (it != Cache.end() && it->second.Text == line)
+            return it->second.Runs;
+
+         // Full: Discard everything rather than tracking usage
+         if (it == Cache.end() && Cache.size() >= CACHE_SIZE)
+            Cache.clear();
+
+         // Lex line. Replaces any entry with a colliding hash
+         CacheEntry& entry = Cache[hash];
+         entry.Text = line;
+         entry.Runs.clear();
+         Lex(script, line, entry.Runs);
+         return entry.Runs;
+      }
+
+      /// <summary>Reloads the colour preferences and discards all cached lines</summary>
+      void  LineHighlighter::Reset()
+      {
+         Colours = SyntaxHighlight();
+         Cache.clear();
+      }
+
+      // ------------------------------ PROTECTED METHODS -----------------------------
+
+      /// <summary>Lexes a line and generates the colour runs</summary>
+      /// <param name="script">Script containing the line</param>
+      /// <param name="line">Line text</param>
+      /// <param name="runs">On return, colour runs.  Adjacent tokens of the same colour share a run</param>
+      /// <exception cref="Logic::ArgumentException">Unknown token type</exception>
+      void  LineHighlighter::Lex(const ScriptFile& script, const wstring& line, ColourRunArray& runs) const
+      {
+         CommandLexer lex(line);
+
+         for (const auto& tok : lex.Tokens)
+         {
+            COLORREF colour = Colours.GetColour(script, tok);
+
+            // Extend previous run, or start a new one
+            if (!runs.empty() && runs.back().Colour == colour)
+               runs.back().End = tok.End;
+            else
+               runs.push_back(ColourRun(tok.Start, tok.End, colour));
+         }
+      }
+
+      // ------------------------------- PRIVATE METHODS ------------------------------
+   
+   }
+}
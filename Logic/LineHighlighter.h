@@ -0,0 +1,82 @@
+#pragma once
+
+#include "SyntaxHighlight.h"
+#include <unordered_map>
+
+namespace Logic
+{
+   namespace Scripts
+   {
+      /// <summary>Converts lines of script text into runs of syntax colours, caching the result for each line</summary>
+      /// <remarks>Cache entries are keyed by a hash of the line text, so a line is only lexed again once its text changes</remarks>
+      class LogicExport LineHighlighter
+      {
+         // ------------------------ TYPES --------------------------
+      public:
+         /// <summary>Range of characters within a line sharing a colour</summary>
+         class ColourRun
+         {
+         public:
+            ColourRun(UINT start, UINT end, COLORREF col) : Start(start), End(end), Colour(col)
+            {}
+
+            UINT      Start,      // Zero-based character index
+                      End;        // Zero-based character index, exclusive
+            COLORREF  Colour;     // Text colour
+         };
+
+         /// <summary>Colour runs of a line, in order</summary>
+         typedef vector<ColourRun>  ColourRunArray;
+
+      protected:
+         /// <summary>Cached line</summary>
+         class CacheEntry
+         {
+         public:
+            wstring         Text;    // Line text, to resolve hash collisions
+            ColourRunArray  Runs;    // Colour runs
+         };
+
+         /// <summary>Cached lines by text hash</summary>
+         typedef unordered_map<size_t,CacheEntry>  CacheMap;
+
+      private:
+         static const UINT  CACHE_SIZE = 16*1024;
+
+         // --------------------- CONSTRUCTION ----------------------
+      public:
+         LineHighlighter();
+         virtual ~LineHighlighter();
+
+         NO_COPY(LineHighlighter);	// No copy semantics
+         NO_MOVE(LineHighlighter);	// No move semantics
+
+         // ------------------------ STATIC -------------------------
+
+         // --------------------- PROPERTIES ------------------------
+      public:
+         PROPERTY_GET(UINT,Count,GetCount);
+
+         // ---------------------- ACCESSORS ------------------------
+      public:
+         UINT  GetCount() const;
+
+         // ----------------------- MUTATORS ------------------------
+      public:
+         void                   Clear();
+         const ColourRunArray&  GetRuns(const ScriptFile& script, const wstring& line);
+         void                   Reset();
+
+      protected:
+         void  Lex(const ScriptFile& script, const wstring& line, ColourRunArray& runs) const;
+
+         // -------------------- REPRESENTATION ---------------------
+      protected:
+         CacheMap         Cache;       // Colour runs by line text hash
+         SyntaxHighlight  Colours;     // Token colours
+      };
+
+   }
+}
+
+using namespace Logic::Scripts;
@@ -39,7 +39,7 @@ namespace Logic
 
             // Linked to break/continue: Link to associated JMP (1st child)
             if (n->JumpTarget && (n->JumpTarget->Is(CMD_BREAK) || n->JumpTarget->Is(CMD_CONTINUE)))
-               n->JumpTarget = n->JumpTarget->Children.begin()->get();
+               n->JumpTarget = n->JumpTarget->Children.front();
 
             // Verify linkage
             if (n->JumpTarget && n->JumpTarget->Index == EMPTY_JUMP)
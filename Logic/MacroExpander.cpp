@@ -52,7 +52,9 @@ namespace Logic
                   }
 
                   // Insert following self. All children have been moved to expanded commands.
-                  n->Parent->Children.insert(++n->Parent->FindChild(n), nodes.begin(), nodes.end());
+                  auto pos = ++n->Parent->FindChild(n);
+                  for (auto& c : nodes)
+                     n->Parent->Children.insert(pos, c.get());
                   return;
                }
             }
@@ -69,8 +71,8 @@ namespace Logic
          /// <returns></returns>
          CommandNodePtr  MacroExpander::ExpandCommand(CommandNode* n, const wstring& txt, GameVersion v)
          {
-            // Generate new node
-            return new CommandNode(*n, *ScriptParser::Generate(txt, v));
+            // Generate new node within the arena of the tree
+            return CommandNode::Create(n->Arena, *n, *ScriptParser::Generate(txt, v));
          }
          
          
@@ -2,6 +2,7 @@
 //
 #include <regex>
 #include "StringResolver.h"      // RegEx Exception
+#include "RegExPrefilter.h"
 
 namespace Logic
 {
@@ -37,7 +38,8 @@ namespace Logic
               MatchCase(regEx ? matchCase : false), 
               MatchWord(regEx ? matchWord : false),
               UseRegEx(regEx),
-              RegEx(GetSafeRegEx(regEx ? search : L""))
+              RegEx(GetSafeRegEx(regEx ? search : L"")),
+              Filter(regEx ? search : L"")
          {
          }
 
@@ -226,6 +228,7 @@ namespace Logic
                             MatchWord,     // Match whole word
                             UseRegEx;      // Search and replacement terms are regular expressions
          const wregex       RegEx;         // Search RegEx, if 'UseRegEx'
+         const RegExPrefilter Filter;      // Lines that could match 'RegEx', if 'UseRegEx'
 
 
       private:
@@ -0,0 +1,262 @@
+#pragma once
+
+namespace Logic
+{
+   namespace Utils
+   {
+      class MemoryArena;
+
+      /// <summary>Shared pointer to a memory arena</summary>
+      typedef shared_ptr<MemoryArena>  MemoryArenaPtr;
+
+      /// <summary>Bump allocator that carves many small allocations from large chunks and releases them all at once</summary>
+      /// <remarks>Not thread safe. Individual allocations are never reclaimed, only the entire arena.  Must be owned by a shared pointer 
+      /// for objects within it to hand out references to it.</remarks>
+      class MemoryArena : public enable_shared_from_this<MemoryArena>
+      {
+         // ------------------------ TYPES --------------------------
+      protected:
+         typedef unique_ptr<BYTE[]>  ChunkPtr;
+
+         /// <summary>Destructor of an object constructed within the arena</summary>
+         struct Finalizer
+         {
+            void      (*Destroy)(void*);   // Destroys the object
+            void*       Object;            // Object
+            Finalizer*  Next;              // Finalizer of the object constructed before it
+         };
+
+         // --------------------- CONSTRUCTION ----------------------
+      public:
+         /// <summary>Creates an empty arena</summary>
+         /// <param name="chunkSize">Size of each chunk, in bytes</param>
+         MemoryArena(size_t chunkSize = 64*1024)
+            : ChunkSize(chunkSize), Position(nullptr), Remaining(0), Used(0), Finalizers(nullptr)
+         {}
+
+         /// <summary>Destroys every object constructed within the arena</summary>
+         ~MemoryArena()
+         {
+            Reset();
+         }
+
+         NO_COPY(MemoryArena);	// Cannot copy semantics
+         NO_MOVE(MemoryArena);	// Cannot move semantics
+
+         // --------------------- PROPERTIES ------------------------
+      public:
+         PROPERTY_GET(size_t,Capacity,GetCapacity);
+         PROPERTY_GET(size_t,Size,GetSize);
+
+         // ---------------------- ACCESSORS ------------------------
+      public:
+         /// <summary>Gets the total size of all chunks, in bytes</summary>
+         /// <returns></returns>
+         size_t  GetCapacity() const
+         {
+            return Chunks.size() * ChunkSize;
+         }
+
+         /// <summary>Gets the number of bytes handed out</summary>
+         /// <returns></returns>
+         size_t  GetSize() const
+         {
+            return Used;
+         }
+
+         // ----------------------- MUTATORS ------------------------
+      public:
+         /// <summary>Allocates a block of memory from the arena</summary>
+         /// <param name="size">Size in bytes</param>
+         /// <param name="align">Alignment, must be a power of two</param>
+         /// <returns>Uninitialised memory, valid until the arena is destroyed</returns>
+         void*  Allocate(size_t size, size_t align = MEMORY_ALLOCATION_ALIGNMENT)
+         {
+            // Oversized: Allocate a dedicated chunk at the front, preserving the current chunk
+            if (size + align > ChunkSize)
+            {
+               Chunks.push_front(ChunkPtr(new BYTE[size + align]));
+               Used += size;
+               return AlignUp(Chunks.front().get(), align);
+            }
+
+            // Align current position. Start a new chunk if exhausted
+            BYTE* block = Position ? AlignUp(Position, align) : nullptr;
+            if (!block || block + size > Position + Remaining)
+            {
+               Chunks.push_back(ChunkPtr(new BYTE[ChunkSize]));
+               Position = Chunks.back().get();
+               Remaining = ChunkSize;
+               block = AlignUp(Position, align);
+            }
+
+            // Bump
+            Remaining -= (block + size) - Position;
+            Position = block + size;
+            Used += size;
+            return block;
+         }
+
+         /// <summary>Constructs an object within the arena, to be destroyed when the arena is reset</summary>
+         /// <param name="args">Constructor arguments</param>
+         /// <returns>New object, valid until the arena is reset or destroyed</returns>
+         template <typename T, typename... Args>
+         T*  New(Args&&... args)
+         {
+            auto fin = static_cast<Finalizer*>(Allocate(sizeof(Finalizer), __alignof(Finalizer)));
+            T*   obj = ::new (Allocate(sizeof(T), __alignof(T))) T(std::forward<Args>(args)...);
+
+            // Register destructor
+            fin->Destroy = &Destroy<T>;
+            fin->Object = obj;
+            fin->Next = Finalizers;
+            Finalizers = fin;
+            return obj;
+         }
+
+         /// <summary>Destroys every object constructed within the arena, most recent first, then rewinds it to a single empty chunk</summary>
+         /// <remarks>Storage is reclaimed in one step however many allocations were made.  Only objects created by New() are destroyed.</remarks>
+         void  Reset()
+         {
+            // Destroy objects
+            for (Finalizer* f = Finalizers; f != nullptr; f = f->Next)
+               f->Destroy(f->Object);
+            Finalizers = nullptr;
+
+            // Keep the current chunk for reuse, release the rest
+            if (Position)
+            {
+               Chunks.erase(Chunks.begin(), --Chunks.end());
+               Position = Chunks.back().get();
+               Remaining = ChunkSize;
+            }
+            else
+               Chunks.clear();
+
+            Used = 0;
+         }
+
+      protected:
+         /// <summary>Destroys an object of a given type</summary>
+         template <typename T>
+         static void  Destroy(void* obj)
+         {
+            static_cast<T*>(obj)->~T();
+         }
+
+         /// <summary>Rounds a pointer up to the next multiple of an alignment</summary>
+         static BYTE*  AlignUp(BYTE* p, size_t align)
+         {
+            return reinterpret_cast<BYTE*>((reinterpret_cast<UINT_PTR>(p) + (align-1)) & ~(UINT_PTR)(align-1));
+         }
+
+         // -------------------- REPRESENTATION ---------------------
+      protected:
+         list<ChunkPtr>  Chunks;       // Memory chunks
+         const size_t    ChunkSize;    // Size of each chunk
+         BYTE*           Position;     // Next free byte in current chunk
+         size_t          Remaining,    // Bytes remaining in current chunk
+                         Used;         // Bytes handed out
+         Finalizer*      Finalizers;   // Destructors of objects constructed within the arena, most recent first
+      };
+
+
+      /// <summary>STL allocator that draws from a memory arena, or from the heap when created without one.  Deallocating from an arena is a no-op.</summary>
+      /// <remarks>The allocator does not own its arena, which must outlive any container using it.  Copies of a container are drawn from the heap.</remarks>
+      template <typename T>
+      class ArenaAllocator
+      {
+         template <typename U> friend class ArenaAllocator;
+
+         // ------------------------ TYPES --------------------------
+      public:
+         typedef T                  value_type;
+         typedef T*                 pointer;
+         typedef const T*           const_pointer;
+         typedef T&                 reference;
+         typedef const T&           const_reference;
+         typedef size_t             size_type;
+         typedef ptrdiff_t          difference_type;
+
+         template <typename U>
+         struct rebind { typedef ArenaAllocator<U> other; };
+
+         // --------------------- CONSTRUCTION ----------------------
+      public:
+         /// <summary>Creates an allocator that draws from the heap</summary>
+         ArenaAllocator() : Arena(nullptr)
+         {}
+
+         /// <summary>Creates an allocator for an arena</summary>
+         /// <param name="arena">The arena</param>
+         explicit ArenaAllocator(MemoryArena& arena) : Arena(&arena)
+         {}
+
+         /// <summary>Rebinding copy constructor</summary>
+         template <typename U>
+         ArenaAllocator(const ArenaAllocator<U>& r) : Arena(r.Arena)
+         {}
+
+         DEFAULT_COPY(ArenaAllocator);	// Default copy semantics
+         DEFAULT_MOVE(ArenaAllocator);	// Default move semantics
+
+         // ---------------------- ACCESSORS ------------------------
+      public:
+         pointer  address(reference r) const                 { return &r; }
+         const_pointer  address(const_reference r) const     { return &r; }
+         size_type  max_size() const                          { return static_cast<size_type>(-1) / sizeof(T); }
+
+         template <typename U>
+         bool operator==(const ArenaAllocator<U>& r) const    { return Arena == r.Arena; }
+         template <typename U>
+         bool operator!=(const ArenaAllocator<U>& r) const    { return Arena != r.Arena; }
+
+         /// <summary>Copies of a container draw from the heap, so they may outlive the arena</summary>
+         ArenaAllocator  select_on_container_copy_construction() const
+         {
+            return ArenaAllocator();
+         }
+
+         // ----------------------- MUTATORS ------------------------
+      public:
+         /// <summary>Allocates uninitialised storage for 'n' objects</summary>
+         pointer  allocate(size_type n, const void* = nullptr)
+         {
+            if (!Arena)
+               return static_cast<pointer>(::operator new(n * sizeof(T)));
+
+            return static_cast<pointer>(Arena->Allocate(n * sizeof(T), __alignof(T)));
+         }
+
+         /// <summary>Releases heap storage. Does nothing for an arena, whose memory is reclaimed when it is reset</summary>
+         void  deallocate(pointer p, size_type)
+         {
+            if (!Arena)
+               ::operator delete(p);
+         }
+
+         template <typename U, typename... Args>
+         void  construct(U* p, Args&&... args)
+         {
+            ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+         }
+
+         template <typename U>
+         void  destroy(U* p)
+         {
+            p->~U();
+         }
+
+         // -------------------- REPRESENTATION ---------------------
+      protected:
+         MemoryArena*  Arena;    // Arena, or nullptr for the heap
+      };
+
+
+      /// <summary>Wide string drawn from a memory arena</summary>
+      typedef basic_string<wchar, char_traits<wchar>, ArenaAllocator<wchar>>  ArenaString;
+
+   }
+}
+
+using namespace Logic::Utils;
@@ -80,8 +80,10 @@ namespace Logic
          if (!CanRead())
             throw NotSupportedException(HERE, GuiString(ERR_NO_READ_ACCESS));
 
-         // Copy contents from stream
-         memcpy(buf, Buffer, length);
+         // Copy contents from current position
+         length = min(length, Length - min(Position, Length));
+         memcpy(buf, Buffer + Position, length);
+         Position += length;
          return length;
       }
 
@@ -94,8 +96,13 @@ namespace Logic
          if (!CanWrite())
             throw NotSupportedException(HERE, GuiString(ERR_NO_WRITE_ACCESS));
 
-         // Copy contents to stream
-         memcpy(Buffer, buf, length);
+         // Extend if necessary
+         if (Position + length > Length)
+            SetLength(Position + length);
+
+         // Copy contents to current position
+         memcpy(Buffer + Position, buf, length);
+         Position += length;
          return length;
       }
 
@@ -31,7 +31,7 @@ namespace Logic
             // Line#/Logic/Text
             VString   line(!n->Is(CMD_HIDDEN_JUMP) ? L"%03d: " : L"---: ", n->LineNumber), 
                       logic(::GetString(n->Logic));
-            GuiString txt(n->LineText);
+            GuiString txt(n->LineText.c_str());
             Cons      colour(Cons::White);
             
             // Index
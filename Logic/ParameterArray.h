@@ -1,5 +1,5 @@
 #pragma once
-
+#include "MemoryArena.h"
 
 namespace Logic
 {
@@ -7,12 +7,20 @@ namespace Logic
    {
       class ScriptParameter;
 
-      /// <summary>Vector of script parameters</summary>
-      class LogicExport ParameterArray : public vector<ScriptParameter> 
+      /// <summary>Vector of script parameters, drawn from the heap unless created for an arena</summary>
+      class LogicExport ParameterArray : public vector<ScriptParameter, ArenaAllocator<ScriptParameter>> 
       {
+         typedef vector<ScriptParameter, ArenaAllocator<ScriptParameter>>  base;
+
       public:
          ParameterArray()
          {}
+         /// <summary>Create empty array within an arena</summary>
+         explicit ParameterArray(MemoryArena& arena) : base(allocator_type(arena))
+         {}
+         /// <summary>Move an array into an arena.  Elements are moved individually unless already within it</summary>
+         ParameterArray(ParameterArray&& r, const allocator_type& a) : base(std::move(r), a)
+         {}
          /// <summary>Create from single parameter</summary>
          ParameterArray(const ScriptParameter& p)
          {
@@ -0,0 +1,157 @@
+#include "stdafx.h"
+#include "PassManager.h"
+#include "Profiler.h"
+
+namespace Logic
+{
+   namespace Scripts
+   {
+      namespace Compiler
+      {
+         // -------------------------------- CONSTRUCTION --------------------------------
+
+         /// <summary>Creates an empty pass manager for a tree</summary>
+         /// <param name="root">Root node of the tree</param>
+         PassManager::PassManager(CommandNode& root) : Root(root)
+         {
+         }
+
+         /// <summary>Nothing</summary>
+         PassManager::~PassManager()
+         {
+         }
+
+         // ------------------------------- STATIC METHODS -------------------------------
+
+         /// <summary>Flattens a node and its descendants into depth-first order</summary>
+         /// <param name="n">Node</param>
+         /// <param name="nodes">On return, contains the node followed by its descendants</param>
+         void  PassManager::Flatten(CommandNode* n, NodeArray& nodes)
+         {
+            nodes.push_back(n);
+
+            for (auto& c : n->Children)
+               Flatten(c, nodes);
+         }
+
+         // ------------------------------- PUBLIC METHODS -------------------------------
+
+         /// <summary>Appends a pass to the schedule</summary>
+         /// <param name="d">Dependency upon the passes added before it</param>
+         /// <param name="create">Creates the visitor, supplying the errors collection it should use</param>
+         /// <param name="restructures">Whether the visitor inserts or removes child nodes</param>
+         /// <exception cref="Logic::ArgumentNullException">Factory returned nullptr</exception>
+         void  PassManager::Add(Dependency d, VisitorFactory create, bool restructures)
+         {
+            Passes.push_back(Pass(d, restructures));
+
+            // Create visitor that reports to the buffer
+            auto& p = Passes.back();
+            p.Visitor.reset(create(p.Errors));
+            REQUIRED(p.Visitor);
+         }
+
+         /// <summary>Gets the number of traversals required to execute all passes</summary>
+         /// <returns></returns>
+         UINT  PassManager::GetTraversals() const
+         {
+            UINT traversals = 0;
+            bool restructured = true;
+
+            // Start a new traversal upon a whole-tree dependency or after structure changes
+            for (auto& p : Passes)
+            {
+               if (restructured || p.Requires == Dependency::Tree)
+                  ++traversals;
+               restructured = p.Restructures;
+            }
+
+            return traversals;
+         }
+
+         /// <summary>Executes all passes, each fused group of passes in a single traversal</summary>
+         /// <param name="errors">Errors collection, receives the errors of each pass in the order passes were added</param>
+         void  PassManager::Run(ErrorArray& errors)
+         {
+            PROFILE_FUNCTION();
+            NodeArray nodes;
+
+            for (auto first = Passes.begin(); first != Passes.end(); )
+            {
+               // Group passes up to the next whole-tree dependency, or after the first that restructures
+               auto last = first;
+               while (!(last++)->Restructures && last != Passes.end() && last->Requires == Dependency::Node)
+               {}
+
+               // Flatten tree.  Restructured trees are re-flattened
+               if (nodes.empty())
+                  Flatten(&Root, nodes);
+
+               try
+               {
+                  PROFILE_ZONE("PassManager::Traversal");
+                  Visit(nodes, first, last);
+               }
+               catch (...) {
+                  // Preserve errors raised before the failure
+                  for (auto p = first; p != last; ++p)
+                     errors.insert(errors.end(), p->Errors.begin(), p->Errors.end());
+                  throw;
+               }
+
+               // Merge errors in pass order
+               for (auto p = first; p != last; ++p)
+               {
+                  errors.insert(errors.end(), p->Errors.begin(), p->Errors.end());
+
+                  if (p->Restructures)
+                     nodes.clear();
+               }
+
+               first = last;
+            }
+         }
+
+         // ------------------------------ PROTECTED METHODS -----------------------------
+
+         /// <summary>Visits each node with each pass of a fused group in turn</summary>
+         /// <param name="nodes">Nodes in depth-first order</param>
+         /// <param name="first">First pass of group</param>
+         /// <param name="last">Position after the last pass of group</param>
+         void  PassManager::Visit(const NodeArray& nodes, PassIterator first, PassIterator last)
+         {
+#ifdef LOGIC_PROFILING
+            // Profiling: Time each pass separately, since passes share a traversal
+            if (Profiler::Instance.Enabled)
+            {
+               vector<LONGLONG> ticks(distance(first, last), 0LL);
+               LONGLONG start = Stopwatch::Now();
+
+               for (auto n : nodes)
+               {
+                  UINT i = 0;
+                  for (auto p = first; p != last; ++p, ++i)
+                  {
+                     LONGLONG enter = Stopwatch::Now();
+                     n->Accept(*p->Visitor);
+                     ticks[i] += Stopwatch::Now() - enter;
+                  }
+               }
+
+               // Record one zone per visitor type, consecutively, so each shows its share of the traversal
+               UINT i = 0;
+               for (auto p = first; p != last; start += ticks[i++], ++p)
+                  Profiler::Instance.Record(typeid(*p->Visitor).name(), start, start + ticks[i]);
+               return;
+            }
+#endif
+            // Visit each node with each pass in turn
+            for (auto n : nodes)
+               for (auto p = first; p != last; ++p)
+                  n->Accept(*p->Visitor);
+         }
+
+         // ------------------------------- PRIVATE METHODS ------------------------------
+      }
+   }
+}
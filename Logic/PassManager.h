@@ -0,0 +1,85 @@
+#pragma once
+#include "CommandNode.h"
+
+namespace Logic
+{
+   namespace Scripts
+   {
+      namespace Compiler
+      {
+
+         /// <summary>Schedules a sequence of tree visitors, fusing those without mutual dependencies into a single traversal</summary>
+         /// <remarks>Errors are buffered per pass and merged in the order passes were added, so diagnostics match running each pass separately</remarks>
+         class PassManager
+         {
+            // ------------------------ TYPES --------------------------
+         public:
+            /// <summary>Defines what a pass requires of the passes added before it</summary>
+            enum class Dependency
+            {
+               Node,    // Requires only that preceeding passes have visited the current node
+               Tree     // Requires that preceeding passes have visited the entire tree
+            };
+
+            /// <summary>Creates a visitor that reports to the supplied errors collection</summary>
+            typedef function<CommandNode::Visitor* (ErrorArray&)>  VisitorFactory;
+
+         protected:
+            /// <summary>Visitor and its buffered errors</summary>
+            class Pass
+            {
+            public:
+               Pass(Dependency d, bool restructures) : Requires(d), Restructures(restructures)
+               {}
+
+               shared_ptr<CommandNode::Visitor>  Visitor;       // Visitor
+               ErrorArray                        Errors;        // Errors raised by visitor
+               Dependency                        Requires;      // Dependency upon preceeding passes
+               bool                              Restructures;  // Whether visitor modifies child lists
+            };
+
+            /// <summary>Nodes of the tree in depth-first order</summary>
+            typedef vector<CommandNode*>  NodeArray;
+
+            /// <summary>Position within the schedule</summary>
+            typedef list<Pass>::iterator  PassIterator;
+
+            // --------------------- CONSTRUCTION ----------------------
+         public:
+            PassManager(CommandNode& root);
+            virtual ~PassManager();
+
+            NO_COPY(PassManager);	// Cannot copy semantics
+            NO_MOVE(PassManager);	// Cannot move semantics
+
+            // ------------------------ STATIC -------------------------
+         protected:
+            static void  Flatten(CommandNode* n, NodeArray& nodes);
+
+            // --------------------- PROPERTIES ------------------------
+         public:
+            PROPERTY_GET(UINT,Traversals,GetTraversals);
+
+            // ---------------------- ACCESSORS ------------------------
+         public:
+            UINT  GetTraversals() const;
+
+            // ----------------------- MUTATORS ------------------------
+         public:
+            void  Add(Dependency d, VisitorFactory create, bool restructures = false);
+            void  Run(ErrorArray& errors);
+
+         protected:
+            void  Visit(const NodeArray& nodes, PassIterator first, PassIterator last);
+
+            // -------------------- REPRESENTATION ---------------------
+         protected:
+            CommandNode&  Root;        // Root of tree
+            list<Pass>    Passes;      // Passes in execution order
+         };
+
+      }
+   }
+}
+
+using namespace Logic::Scripts::Compiler;
@@ -244,6 +244,9 @@ namespace Logic
       /// <summary>Continue loading game data if a language file fails to load</summary>
       PREFERENCE_PROPERTY(bool,Bool,SkipBrokenFiles,true);
 
+      /// <summary>Keep language strings overridden by higher priority files, so the string library editor can display them when a component is excluded</summary>
+      PREFERENCE_PROPERTY(bool,Bool,RetainShadowedStrings,false);
+
       /// <summary>Game data folder</summary>
       PREFERENCE_PROPERTY_EX(Path,LPCWSTR,String,GameDataFolder,L"");
 
@@ -253,6 +256,13 @@ namespace Logic
       /// <summary>Game data language</summary>
       PREFERENCE_PROPERTY_ENUM(GameLanguage,GameDataLanguage,GameLanguage::English);
 
+      /// <summary>Names of the game sub-folders searched for physical files, or empty to search director, scripts, t and types</summary>
+      PREFERENCE_PROPERTY_LIST(wstring,StringList,GameDataIncludeFolders);
+
+      // Diagnostics:
+      /// <summary>Record profiling zones while loading game data  [Requires a build with LOGIC_PROFILING defined]</summary>
+      PREFERENCE_PROPERTY(bool,Bool,EnableProfiling,false);
+
       // ---------------------- ACCESSORS ------------------------			
    public:
       /// <summary>Gets the registry path of section</summary>
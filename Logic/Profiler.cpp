@@ -0,0 +1,206 @@
+#include "stdafx.h"
+#include "Profiler.h"
+#include "FileStream.h"
+#include "WorkerData.h"
+
+namespace Logic
+{
+   namespace Utils
+   {
+      /// <summary>Event buffer of the current thread, created upon first use</summary>
+      __declspec(thread) ProfileBuffer*  CurrentBuffer = nullptr;
+
+      /// <summary>Singleton instance</summary>
+      Profiler  Profiler::Instance;
+
+      // -------------------------------- CONSTRUCTION --------------------------------
+
+      Profiler::Profiler() : Active(FALSE), Origin(Stopwatch::Now())
+      {
+      }
+
+      Profiler::~Profiler()
+      {
+      }
+
+      // ------------------------------- STATIC METHODS -------------------------------
+
+      /// <summary>Gets the default path of the trace file, within the temporary folder.</summary>
+      /// <returns></returns>
+      /// <exception cref="Logic::Win32Exception">Unable to get temp folder</exception>
+      Path  Profiler::GetDefaultTracePath()
+      {
+         Path folder;
+
+         // Get temp folder
+         if (!GetTempPath(MAX_PATH, (wchar*)folder))
+            throw Win32Exception(HERE, L"Unable to get temp folder");
+
+         return folder + L"XStudio2.Trace.json";
+      }
+
+      /// <summary>Gets the display name of a zone, removing namespaces and type prefixes.</summary>
+      /// <param name="name">Function or type name.</param>
+      /// <returns>Final two components, eg. 'XFileSystem::Enumerate'</returns>
+      string  Profiler::GetZoneName(const char* name)
+      {
+         string str(name);
+         
+         // Strip 'class'/'struct' prefix produced by typeid
+         if (str.compare(0, 6, "class ") == 0)
+            str.erase(0, 6);
+         else if (str.compare(0, 7, "struct ") == 0)
+            str.erase(0, 7);
+
+         // Keep type + member
+         auto last = str.rfind("::");
+         if (last != string::npos && last > 0)
+         {
+            auto prev = str.rfind("::", last-1);
+            if (prev != string::npos)
+               str.erase(0, prev+2);
+         }
+         return str;
+      }
+
+      // ------------------------------- PUBLIC METHODS -------------------------------
+
+      /// <summary>Discards all recorded events.</summary>
+      void  Profiler::Clear()
+      {
+         Lock.Enter();
+         for (auto& b : Buffers)
+         {
+            b->Lock.Enter();
+            b->Events.clear();
+            b->Lock.Leave();
+         }
+         Lock.Leave();
+      }
+
+      /// <summary>Writes the recorded events as a Chrome trace-event file.</summary>
+      /// <param name="path">Full path.</param>
+      /// <remarks>Load the file in chrome://tracing to inspect the zones of each thread</remarks>
+      /// <exception cref="Logic::IOException">An I/O error occurred</exception>
+      void  Profiler::ExportTrace(Path path) const
+      {
+         LARGE_INTEGER freq;
+         string json("{\"traceEvents\":[\n");
+         char buf[512];
+         bool first = true;
+
+         QueryPerformanceFrequency(&freq);
+         const double toMicroseconds = 1000000.0 / freq.QuadPart;
+
+         // Generate one 'complete' event per zone
+         Lock.Enter();
+         for (auto& b : Buffers)
+         {
+            b->Lock.Enter();
+            for (auto& e : b->Events)
+            {
+               sprintf_s(buf, "%s{\"name\":\"%s\",\"cat\":\"logic\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%u,\"tid\":%u}", 
+                         first ? "" : ",\n", GetZoneName(e.Name).c_str(), (e.Start - Origin) * toMicroseconds, (e.End - e.Start) * toMicroseconds, 
+                         GetCurrentProcessId(), b->ThreadID);
+               json += buf;
+               first = false;
+            }
+            b->Lock.Leave();
+         }
+         Lock.Leave();
+
+         json += "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+         // Write 
+         FileStream fs(path, FileMode::CreateAlways, FileAccess::Write);
+         fs.Write((const BYTE*)json.c_str(), json.length());
+         fs.Close();
+      }
+
+      /// <summary>Query whether zones are being recorded.</summary>
+      /// <returns></returns>
+      bool  Profiler::IsEnabled() const
+      {
+         return Active != FALSE;
+      }
+      
+      /// <summary>Records a zone on the current thread.</summary>
+      /// <param name="name">Zone name.</param>
+      /// <param name="start">Performance counter on entry.</param>
+      /// <param name="end">Performance counter on exit.</param>
+      void  Profiler::Record(const char* name, LONGLONG start, LONGLONG end)
+      {
+         // First zone on this thread: Create + register buffer
+         if (!CurrentBuffer)
+         {
+            BufferPtr buffer(new ProfileBuffer());
+            Lock.Enter();
+            Buffers.push_back(buffer);
+            Lock.Leave();
+            CurrentBuffer = buffer.get();
+         }
+
+         // Append event
+         CurrentBuffer->Lock.Enter();
+         CurrentBuffer->Events.push_back(ProfileEvent(name, start, end));
+         CurrentBuffer->Lock.Leave();
+      }
+
+      /// <summary>Enables or disables recording.</summary>
+      /// <param name="enable">Whether to record zones.</param>
+      void  Profiler::SetEnabled(bool enable)
+      {
+         InterlockedExchange(&Active, enable ? TRUE : FALSE);
+      }
+
+      /// <summary>Outputs the zones with the greatest total time, most expensive first.</summary>
+      /// <param name="data">Worker data used for output.</param>
+      /// <param name="count">Maximum number of zones.</param>
+      /// <exception cref="Logic::ArgumentNullException">Worker data is null</exception>
+      void  Profiler::Summarise(WorkerData* data, UINT count) const
+      {
+         map<string, ZoneSummary> zones;
+         LARGE_INTEGER freq;
+
+         REQUIRED(data);
+         QueryPerformanceFrequency(&freq);
+
+         // Accumulate by name
+         Lock.Enter();
+         for (auto& b : Buffers)
+         {
+            b->Lock.Enter();
+            for (auto& e : b->Events)
+            {
+               auto& z = zones[GetZoneName(e.Name)];
+               z.Ticks += e.End - e.Start;
+               z.Count++;
+            }
+            b->Lock.Leave();
+         }
+         Lock.Leave();
+
+         // Sort by total time
+         vector<pair<string,ZoneSummary>> sorted(zones.begin(), zones.end());
+         sort(sorted.begin(), sorted.end(), [](const pair<string,ZoneSummary>& a, const pair<string,ZoneSummary>& b) { 
+            return a.second.Ticks > b.second.Ticks; 
+         });
+
+         // Output table
+         data->SendFeedback(Cons::Heading, ProgressType::Operation, 1, VString(L"Profiling summary: %d zones", sorted.size()));
+         for (UINT i = 0; i < count && i < sorted.size(); ++i)
+         {
+            const auto& z = sorted[i];
+            double total = (z.second.Ticks * 1000.0) / freq.QuadPart;
+
+            data->SendFeedback(ProgressType::Info, 2, VString(L"%-40s %6d calls %10.1fms total %8.2fms avg", 
+                                                              GuiString::Convert(z.first, CP_ACP).c_str(), z.second.Count, total, total / z.second.Count));
+         }
+      }
+
+      // ------------------------------ PROTECTED METHODS -----------------------------
+
+      // ------------------------------- PRIVATE METHODS ------------------------------
+
+   }
+}
@@ -0,0 +1,149 @@
+#pragma once
+#include "CriticalSection.h"
+#include "Stopwatch.h"
+
+namespace Logic
+{
+   namespace Threads
+   {
+      class WorkerData;
+   }
+
+   namespace Utils
+   {
+      
+   /// <summary>Concatenates tokens after expansion</summary>
+   #define PROFILE_CONCAT2(a,b)   a##b
+   #define PROFILE_CONCAT(a,b)    PROFILE_CONCAT2(a,b)
+
+#ifdef LOGIC_PROFILING
+   /// <summary>Records the time spent in the enclosing scope.  Name must be a string literal, or have static storage</summary>
+   #define PROFILE_ZONE(name)     ::Logic::Utils::ProfileZone  PROFILE_CONCAT(_zone,__LINE__)(name)
+
+   /// <summary>Records the time spent in the enclosing function</summary>
+   #define PROFILE_FUNCTION()     PROFILE_ZONE(__FUNCTION__)
+#else
+   #define PROFILE_ZONE(name)
+   #define PROFILE_FUNCTION()
+#endif
+
+      /// <summary>Time spent within a profiling zone</summary>
+      class ProfileEvent
+      {
+      public:
+         ProfileEvent(const char* name, LONGLONG start, LONGLONG end) : Name(name), Start(start), End(end)
+         {}
+
+         const char*  Name;     // Zone name
+         LONGLONG     Start,    // Performance counter on entry
+                      End;      // Performance counter on exit
+      };
+
+      /// <summary>Events recorded by a single thread</summary>
+      class ProfileBuffer
+      {
+      public:
+         ProfileBuffer() : ThreadID(GetCurrentThreadId())
+         {
+            Events.reserve(1024);
+         }
+
+         NO_COPY(ProfileBuffer);	// Unique per thread
+         NO_MOVE(ProfileBuffer);	// Unique per thread
+
+         CriticalSection       Lock;       // Uncontended except while exporting/clearing
+         vector<ProfileEvent>  Events;     // Events, in order of completion
+         const DWORD           ThreadID;   // Owning thread
+      };
+
+      /// <summary>Collects the events recorded by profiling zones on all threads</summary>
+      class LogicExport Profiler
+      {
+         // ------------------------ TYPES --------------------------
+      protected:
+         typedef shared_ptr<ProfileBuffer>  BufferPtr;
+         typedef list<BufferPtr>            BufferList;
+
+         /// <summary>Accumulated time of all events with the same name</summary>
+         class ZoneSummary
+         {
+         public:
+            ZoneSummary() : Count(0), Ticks(0)
+            {}
+
+            UINT      Count;     // Number of events
+            LONGLONG  Ticks;     // Total elapsed ticks
+         };
+
+         // --------------------- CONSTRUCTION ----------------------
+      private:
+         Profiler();
+      public:
+         virtual ~Profiler();
+
+         NO_COPY(Profiler);	// Singleton
+         NO_MOVE(Profiler);	// Singleton
+
+         // ------------------------ STATIC -------------------------
+      public:
+         static Profiler  Instance;
+
+         static Path  GetDefaultTracePath();
+
+      protected:
+         static string  GetZoneName(const char* name);
+
+         // --------------------- PROPERTIES ------------------------
+      public:
+         PROPERTY_GET_SET(bool,Enabled,IsEnabled,SetEnabled);
+
+         // ---------------------- ACCESSORS ------------------------			
+      public:
+         void  ExportTrace(Path path) const;
+         bool  IsEnabled() const;
+         void  Summarise(WorkerData* data, UINT count) const;
+
+         // ----------------------- MUTATORS ------------------------
+      public:
+         void  Clear();
+         void  Record(const char* name, LONGLONG start, LONGLONG end);
+         void  SetEnabled(bool enable);
+
+         // -------------------- REPRESENTATION ---------------------
+      protected:
+         mutable CriticalSection  Lock;         // Guards the buffer list
+         BufferList               Buffers;      // Per-thread event buffers
+         volatile LONG            Active;       // Whether zones are recorded
+         const LONGLONG           Origin;       // Performance counter when created
+      };
+
+      /// <summary>Records the time between construction and destruction, when profiling is enabled</summary>
+      class LogicExport ProfileZone
+      {
+         // --------------------- CONSTRUCTION ----------------------
+      public:
+         /// <summary>Enters a profiling zone</summary>
+         /// <param name="name">Zone name, must have static storage</param>
+         ProfileZone(const char* name) : Name(name), Start(Profiler::Instance.Enabled ? Stopwatch::Now() : 0LL)
+         {}
+
+         /// <summary>Leaves the profiling zone</summary>
+         ~ProfileZone()
+         {
+            if (Start)
+               Profiler::Instance.Record(Name, Start, Stopwatch::Now());
+         }
+
+         NO_COPY(ProfileZone);	// Scoped
+         NO_MOVE(ProfileZone);	// Scoped
+
+         // -------------------- REPRESENTATION ---------------------
+      protected:
+         const char*     Name;
+         const LONGLONG  Start;
+      };
+
+   }
+}
+
+using namespace Logic::Utils;
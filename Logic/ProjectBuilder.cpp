@@ -0,0 +1,379 @@
+#include "stdafx.h"
+#include "ProjectBuilder.h"
+#include "BuildCacheReader.h"
+#include "BuildCacheWriter.h"
+#include "ComThreadHelper.h"
+#include "FileStream.h"
+#include "ProjectFileReader.h"
+#include "ScriptFileReader.h"
+#include "ScriptFileWriter.h"
+#include "ScriptParser.h"
+#include "XFileInfo.h"
+
+namespace Logic
+{
+   namespace Projects
+   {
+      /// <summary>Name of the cache file within the cache folder</summary>
+      const wchar*  ProjectBuilder::CacheFileName = L"build.xml";
+
+      // -------------------------------- CONSTRUCTION --------------------------------
+
+      /// <summary>Creates a builder for a project</summary>
+      /// <param name="project">Project file</param>
+      /// <param name="cache">Folder containing the build cache and compiled scripts.  Created if necessary</param>
+      /// <param name="game">Game data folder</param>
+      /// <param name="ver">Game data version</param>
+      /// <param name="lang">Game data language</param>
+      /// <param name="compile">Whether to compile, or only verify</param>
+      ProjectBuilder::ProjectBuilder(const Path& project, const Path& cache, const Path& game, GameVersion ver, GameLanguage lang, bool compile)
+         : ProjectPath(project), CacheFolder(cache.AppendBackslash()), Compile(compile), 
+           Previous(game, ver, lang, compile), Current(game, ver, lang, compile), 
+           Rebuilt(0), Reused(0), Invalidated(0)
+      {
+      }
+
+      ProjectBuilder::~ProjectBuilder()
+      {
+      }
+
+      // ------------------------------- STATIC METHODS -------------------------------
+
+      // ------------------------------- PUBLIC METHODS -------------------------------
+
+      /// <summary>Builds the scripts that have changed, or call scripts whose arguments have changed, and updates the cache</summary>
+      /// <param name="scheduler">Scheduler to build upon</param>
+      /// <param name="output">Folder to copy compiled scripts to  [optional]</param>
+      /// <param name="data">Worker data</param>
+      /// <remarks>Scripts are copied to the output folder by file name alone.  Scripts sharing a file name with an earlier script are reported as errors</remarks>
+      /// <exception cref="Logic::ComException">COM error</exception>
+      /// <exception cref="Logic::FileFormatException">Corrupt project file</exception>
+      /// <exception cref="Logic::InvalidOperationException">Build was cancelled</exception>
+      /// <exception cref="Logic::IOException">An I/O error occurred</exception>
+      /// <exception cref="Logic::Win32Exception">Unable to create cache folder or copy compiled script</exception>
+      void  ProjectBuilder::Build(TaskScheduler& scheduler, const Path& output, WorkerData* data)
+      {
+         TaskArray tasks;
+
+         // Reset
+         External.clear();
+         Rebuilt = Reused = Invalidated = 0;
+
+         // Read project + previous results
+         LoadProject();
+         LoadCache();
+
+         // Hash sources concurrently, reading the arguments of those that changed
+         for (auto& s : Scripts)
+            tasks.push_back(scheduler.Run([this,&s] (const CancellationToken&) -> DWORD 
+            {
+               ComThreadHelper COM;
+               HashScript(s);
+               return 0;
+            }, data->Cancellation));
+         scheduler.WaitAll(tasks);
+
+         // Dependents: Rebuild unchanged scripts calling a script whose arguments changed
+         for (auto& s : Scripts)
+            if (!s.Dirty && Invalidate(s))
+            {
+               s.Dirty = true;
+               ++Invalidated;
+            }
+
+         // Build remainder concurrently
+         tasks.clear();
+         TaskProgress progress(data, L"Building scripts", (UINT)count_if(Scripts.begin(), Scripts.end(), [](const ScriptState& s) { return s.Dirty; }));
+         for (auto& s : Scripts)
+            if (s.Dirty)
+               tasks.push_back(scheduler.Run([this,&s,&progress] (const CancellationToken&) -> DWORD 
+               {
+                  ComThreadHelper COM;
+                  BuildScript(s);
+                  progress.Advance();
+                  return 0;
+               }, data->Cancellation));
+         scheduler.WaitAll(tasks);
+
+         // Collect results.  Reuse previous results of unchanged scripts
+         Current.Clear();
+         for (auto& s : Scripts)
+         {
+            if (s.Dirty)
+               ++Rebuilt;
+            else
+            {
+               s.Entry = *s.Previous;
+               ++Reused;
+            }
+            Current.Add(s.Entry);
+         }
+
+         // Save cache
+         SaveCache();
+
+         // Copy compiled scripts.  The game finds scripts by name, so only the first script with each file name is copied
+         if (!output.Empty())
+         {
+            map<wstring,Path> written;
+
+            for (auto& s : Scripts)
+            {
+               // Failed/Verified only: Skip
+               if (!s.Entry.IsSuccessful() || s.Entry.Output.empty())
+                  continue;
+
+               auto pos = written.insert(make_pair(GuiString(s.Entry.FullPath.FileName).ToLower(), s.Entry.FullPath));
+               if (pos.second)
+                  WriteOutput(s, output);
+               else
+               {
+                  // Duplicate: Report in this build's results only, the cached result remains valid
+                  s.Entry.Diagnostics.push_back(BuildDiagnostic(0, VString(L"Output file name is already used by '%s'", pos.first->second.c_str()), s.Entry.FullPath.FileName));
+                  Current.Add(s.Entry);
+               }
+            }
+         }
+      }
+
+      /// <summary>Gets the results of each script, rebuilt or reused</summary>
+      /// <returns></returns>
+      const BuildCache&  ProjectBuilder::GetResults() const
+      {
+         return Current;
+      }
+
+      // ------------------------------ PROTECTED METHODS -----------------------------
+
+      /// <summary>Reads, parses, verifies and (optionally) compiles a script into the cache folder, recording the signature of each script it calls.</summary>
+      /// <param name="s">Script</param>
+      void  ProjectBuilder::BuildScript(ScriptState& s)
+      {
+         auto& e = s.Entry;
+
+         try
+         {
+            LineArray lines;
+
+            // Read
+            auto script = ScriptFileReader(XFileInfo(e.FullPath).OpenRead()).ReadFile(e.FullPath, false);
+            for (const auto& cmd : script.Commands.Input)
+            {
+               lines.push_back(cmd.Text);
+
+               // Script-call: Record signature of target  [Name is empty when a variable]
+               if (cmd.Syntax.IsScriptCall())
+               {
+                  wstring name = cmd.GetScriptCallName();
+                  if (!name.empty() && !e.Calls.count(name))
+                     e.Calls[name] = GetCallSignature(e.FullPath.Folder, name);
+               }
+            }
+
+            // Parse + Verify
+            ScriptParser parser(script, lines, Current.Game);
+
+            // Failed: Copy errors
+            if (!parser.Successful)
+            {
+               for (const auto& err : parser.Errors)
+                  e.Diagnostics.push_back(BuildDiagnostic(err.Line, err.Message, err.Text));
+               return;
+            }
+
+            // Verify only: Done
+            if (!Compile)
+               return;
+
+            // Compile
+            parser.Compile();
+
+            // Write to cache.  Prefix name with hash of path, scripts may share a name
+            wstring key = BuildCache::GetPathKey(e.FullPath);
+            e.Output = VString(L"%08x.%s", (UINT)BuildCache::GetHash((const BYTE*)key.c_str(), key.length()*sizeof(wchar)), e.FullPath.FileName.c_str());
+
+            ScriptFileWriter w(XFileInfo(CacheFolder + e.Output).OpenWrite());
+            w.Write(script);
+            w.Close();
+         }
+         catch (ExceptionBase& ex)
+         {
+            e.Output.clear();
+            e.Diagnostics.push_back(BuildDiagnostic(0, ex.Message, L""));
+         }
+      }
+
+      /// <summary>Gets the current signature of the target of a script-call</summary>
+      /// <param name="folder">Folder of calling script</param>
+      /// <param name="name">Name of target script, without extension</param>
+      /// <returns>Signature, or zero if the target cannot be found or read</returns>
+      /// <remarks>Project scripts must have been hashed.  Scripts outside the project are read once per build</remarks>
+      UINT64  ProjectBuilder::GetCallSignature(const Path& folder, const wstring& name)
+      {
+         ScriptCallPath path(folder, name);
+
+         // Missing: Dependents are rebuilt should it appear
+         if (path.Empty())
+            return 0;
+
+         // Project script: Signature of current source
+         wstring key = BuildCache::GetPathKey(path);
+         auto index = ScriptIndex.find(key);
+         if (index != ScriptIndex.end())
+            return Scripts[index->second].Entry.Signature;
+
+         // External: Read unless previously read
+         std::lock_guard<std::mutex> lock(ExternalLock);
+         auto pos = External.find(key);
+         if (pos != External.end())
+            return pos->second;
+
+         UINT64 signature = 0;
+         try {
+            signature = BuildCache::GetSignature(ScriptFileReader(XFileInfo(path).OpenRead()).ReadFile(path, true));
+         }
+         catch (ExceptionBase&) {
+         }
+         return External[key] = signature;
+      }
+
+      /// <summary>Hashes a script and compares it against the previous build, reading the arguments of the script if it has changed</summary>
+      /// <param name="s">Script</param>
+      void  ProjectBuilder::HashScript(ScriptState& s)
+      {
+         auto& path = s.Entry.FullPath;
+
+         try
+         {
+            // Hash file
+            StreamPtr fs(new FileStream(path, FileMode::OpenExisting, FileAccess::Read));
+            DWORD length = fs->GetLength();
+            auto  bytes = fs->ReadAllBytes();
+            s.Entry.SourceHash = BuildCache::GetHash(bytes.get(), length);
+
+            // Unchanged: Keep previous signature
+            s.Previous = Previous.Find(path);
+            if (s.Previous && s.Previous->SourceHash == s.Entry.SourceHash)
+            {
+               s.Entry.Signature = s.Previous->Signature;
+               s.Dirty = false;
+            }
+            // Changed: Read arguments
+            else
+               s.Entry.Signature = BuildCache::GetSignature(ScriptFileReader(XFileInfo(path).OpenRead()).ReadFile(path, true));
+         }
+         catch (ExceptionBase&) {
+            // Unreadable: Reported when built
+            s.Dirty = true;
+         }
+      }
+
+      /// <summary>Determines whether an unchanged script must be rebuilt</summary>
+      /// <param name="s">Script</param>
+      /// <returns>True if the arguments of a script it calls have changed, or its compiled output is missing</returns>
+      bool  ProjectBuilder::Invalidate(ScriptState& s)
+      {
+         auto& prev = *s.Previous;
+
+         // Compiled output missing
+         if (Compile && prev.IsSuccessful() && (prev.Output.empty() || !(CacheFolder + prev.Output).Exists()))
+            return true;
+
+         // Compare signatures of targets
+         for (auto& call : prev.Calls)
+            if (GetCallSignature(s.Entry.FullPath.Folder, call.first) != call.second)
+               return true;
+
+         return false;
+      }
+
+      /// <summary>Reads the results of the previous build, if any</summary>
+      /// <remarks>A cache that cannot be read, or was built with different game data or options, is discarded</remarks>
+      /// <exception cref="Logic::Win32Exception">Unable to create cache folder</exception>
+      void  ProjectBuilder::LoadCache()
+      {
+         Path path = CacheFolder + CacheFileName;
+
+         // Ensure folder exists
+         switch (SHCreateDirectory(nullptr, CacheFolder.c_str()))
+         {
+         case ERROR_SUCCESS:
+         case ERROR_ALREADY_EXISTS:
+         case ERROR_FILE_EXISTS:
+            break;
+         default:
+            throw Win32Exception(HERE, VString(L"Unable to create build cache folder '%s'", CacheFolder.c_str()));
+         }
+
+         // First build: Rebuild all
+         if (!path.Exists())
+            return;
+
+         try
+         {
+            StreamPtr fs(new FileStream(path, FileMode::OpenExisting, FileAccess::Read));
+            Previous = BuildCacheReader(fs).ReadFile();
+
+            // Different game data/options: Rebuild all
+            if (!Previous.Matches(Current))
+               Previous.Clear();
+         }
+         catch (ExceptionBase&) {
+            // Corrupt: Rebuild all
+            Previous.Clear();
+         }
+      }
+
+      /// <summary>Reads the scripts of the project</summary>
+      /// <exception cref="Logic::ComException">COM error</exception>
+      /// <exception cref="Logic::FileFormatException">Corrupt project file</exception>
+      /// <exception cref="Logic::IOException">An I/O error occurred</exception>
+      void  ProjectBuilder::LoadProject()
+      {
+         StreamPtr fs(new FileStream(ProjectPath, FileMode::OpenExisting, FileAccess::Read));
+         auto project = ProjectFileReader(fs).ReadFile(ProjectPath);
+
+         Scripts.clear();
+         ScriptIndex.clear();
+
+         // Index scripts by path.  Ignore duplicates
+         for (auto item : project.ToList())
+            if (item->IsFile() && item->FileType == FileType::Script)
+            {
+               if (ScriptIndex.insert(make_pair(BuildCache::GetPathKey(item->FullPath), Scripts.size())).second)
+                  Scripts.push_back(ScriptState(item->FullPath));
+            }
+      }
+
+      /// <summary>Writes the results of this build to the cache</summary>
+      /// <exception cref="Logic::ComException">COM error</exception>
+      /// <exception cref="Logic::IOException">An I/O error occurred</exception>
+      void  ProjectBuilder::SaveCache()
+      {
+         StreamPtr fs(new FileStream(CacheFolder + CacheFileName, FileMode::CreateAlways, FileAccess::Write));
+         BuildCacheWriter w(fs);
+         w.WriteFile(Current);
+         w.Close();
+      }
+
+      /// <summary>Copies the compiled output of a script from the cache to the output folder</summary>
+      /// <param name="s">Script</param>
+      /// <param name="output">Output folder</param>
+      /// <exception cref="Logic::Win32Exception">Unable to copy file</exception>
+      void  ProjectBuilder::WriteOutput(const ScriptState& s, const Path& output)
+      {
+         // Failed/Verified only: Skip
+         if (!s.Entry.IsSuccessful() || s.Entry.Output.empty())
+            return;
+
+         Path source(CacheFolder + s.Entry.Output),
+              target(output.AppendBackslash() + s.Entry.FullPath.FileName);
+
+         if (!CopyFile(source.c_str(), target.c_str(), FALSE))
+            throw Win32Exception(HERE, VString(L"Unable to copy '%s' to '%s'", source.c_str(), target.c_str()));
+      }
+
+      // ------------------------------- PRIVATE METHODS ------------------------------
+   }
+}
+
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "BuildCache.h"
+#include "ProjectFile.h"
+#include "TaskScheduler.h"
+#include <mutex>
+
+namespace Logic
+{
+   namespace Projects
+   {
+      
+      /// <summary>Verifies and compiles the scripts of a project without the user interface, rebuilding only what has changed</summary>
+      /// <remarks>A script is rebuilt when its file has changed, or when the arguments of a script it calls have changed since 
+      /// it was last built, since script-calls are verified against them.  The results of other scripts are taken from the build 
+      /// cache, which records the scripts called by each script and the signatures they had.  Scripts are built concurrently
+      /// upon a task scheduler.  Game data must be loaded by the caller.</remarks>
+      class LogicExport ProjectBuilder
+      {
+         // ------------------------ TYPES --------------------------
+      protected:
+         /// <summary>State of a single script during a build</summary>
+         class ScriptState
+         {
+         public:
+            ScriptState(const Path& p) : Entry(p), Previous(nullptr), Dirty(true)
+            {}
+
+            BuildEntry         Entry;      // New result
+            const BuildEntry*  Previous;   // Previous result, if any
+            bool               Dirty;      // Whether to rebuild
+         };
+
+         /// <summary>Scripts in project order</summary>
+         typedef vector<ScriptState>  ScriptArray;
+
+         /// <summary>Signatures of scripts outside the project, by case-folded path</summary>
+         typedef map<wstring,UINT64>  SignatureMap;
+
+         // --------------------- CONSTRUCTION ----------------------
+      public:
+         ProjectBuilder(const Path& project, const Path& cache, const Path& game, GameVersion ver, GameLanguage lang, bool compile);
+         virtual ~ProjectBuilder();
+
+         NO_COPY(ProjectBuilder);	// No copy semantics
+         NO_MOVE(ProjectBuilder);	// No move semantics
+
+         // ------------------------ STATIC -------------------------
+      public:
+         static const wchar*  CacheFileName;
+
+         // --------------------- PROPERTIES ------------------------
+      public:
+         PROPERTY_GET(const BuildCache&,Results,GetResults);
+
+         // ---------------------- ACCESSORS ------------------------
+      public:
+         const BuildCache&  GetResults() const;
+
+      protected:
+         UINT64  GetCallSignature(const Path& folder, const wstring& name);
+         
+         // ----------------------- MUTATORS ------------------------
+      public:
+         void  Build(TaskScheduler& scheduler, const Path& output, WorkerData* data);
+
+      protected:
+         void  BuildScript(ScriptState& s);
+         void  HashScript(ScriptState& s);
+         bool  Invalidate(ScriptState& s);
+         void  LoadCache();
+         void  LoadProject();
+         void  SaveCache();
+         void  WriteOutput(const ScriptState& s, const Path& output);
+
+         // -------------------- REPRESENTATION ---------------------
+      public:
+         UINT  Rebuilt,          // Number of scripts rebuilt
+               Reused,           // Number of scripts whose previous result was reused
+               Invalidated;      // Number of unchanged scripts rebuilt because the signature of a script they call changed
+
+      protected:
+         const Path          ProjectPath,     // Project file
+                             CacheFolder;     // Folder containing cache file and compiled scripts
+         const bool          Compile;         // Whether to compile, or only verify
+         BuildCache          Previous,        // Results of previous build
+                             Current;         // Results of this build
+         ScriptArray         Scripts;         // Project scripts
+         map<wstring,UINT>   ScriptIndex;     // Indicies of project scripts, by case-folded path
+         SignatureMap        External;        // Signatures of scripts outside the project
+         std::mutex          ExternalLock;    // Guards external signatures
+      };
+
+   }
+}
+
+using namespace Logic::Projects;
@@ -13,11 +13,47 @@ namespace Logic
          Root.FullPath = path;
       }
 
+      /// <summary>Copies the item tree and indexes the copy</summary>
+      /// <param name="r">Source project</param>
+      ProjectFile::ProjectFile(const ProjectFile& r) : Root(r.Root)
+      {
+         Reindex();
+      }
+
       ProjectFile::~ProjectFile()
       {}
 
+      /// <summary>Copies the item tree and indexes the copy</summary>
+      /// <param name="r">Source project</param>
+      /// <returns></returns>
+      ProjectFile&  ProjectFile::operator=(const ProjectFile& r)
+      {
+         if (this != &r)
+         {
+            Root = r.Root;
+            Reindex();
+         }
+         return *this;
+      }
+
       // ------------------------------- STATIC METHODS -------------------------------
 
+      /// <summary>Generates the name index key for an item</summary>
+      /// <param name="type">Type.</param>
+      /// <param name="name">Name.</param>
+      /// <returns></returns>
+      wstring  ProjectFile::GetNameKey(ProjectItemType type, const wstring& name)
+      {
+         return wstring(1, L'0' + (int)type) + name;
+      }
+
+      /// <summary>Generates the path index key for an item, matching the case-insensitive path comparison</summary>
+      /// <param name="path">Full path.</param>
+      /// <returns></returns>
+      wstring  ProjectFile::GetPathKey(const Path& path)
+      {
+         return GuiString(path.c_str()).ToLower();
+      }
 
       // ------------------------------- PUBLIC METHODS -------------------------------
       
@@ -26,7 +62,18 @@ namespace Logic
       /// <exception cref="Logic::ArgumentException">Item is not fixed</exception>
       ProjectItem&  ProjectFile::Add(const ProjectItem& p)
       {
-         return Root.Add(p);
+         return Add(p, Root);
+      }
+
+      /// <summary>Add item to a folder</summary>
+      /// <param name="p">item</param>
+      /// <param name="folder">Parent folder within this project</param>
+      /// <returns>Reference to inserted item</returns>
+      ProjectItem&  ProjectFile::Add(const ProjectItem& p, ProjectItem& folder)
+      {
+         auto& item = folder.Add(p);
+         Index(item);
+         return item;
       }
 
       /// <summary>Query existence of item by path.</summary>
@@ -34,8 +81,7 @@ namespace Logic
       /// <returns></returns>
       bool  ProjectFile::Contains(Path path) const
       {
-         return Root.Contains(path);
-         //return any_of(Root.Children.begin(), Root.Children.end(), [&path](const ProjectItem& item) {return item.Contains(path);} );
+         return Find(path) != nullptr;
       }
 
       /// <summary>Finds item by path.</summary>
@@ -43,7 +89,13 @@ namespace Logic
       /// <returns>Item if found, otherwise nullptr</returns>
       ProjectItem*  ProjectFile::Find(Path path) const
       {
-         return Root.Find(path);
+         // Root
+         if (Root.FullPath == path)
+            return const_cast<ProjectItem*>(&Root);
+
+         // Lookup descendant
+         auto it = Paths.find(GetPathKey(path));
+         return it != Paths.end() ? it->second : nullptr;
       }
 
       /// <summary>Finds item by name and type.</summary>
@@ -52,7 +104,18 @@ namespace Logic
       /// <returns>Item if found, otherwise nullptr</returns>
       ProjectItem*  ProjectFile::Find(ProjectItemType type, const wstring& name) const
       {
-         return Root.Find(type, name);
+         // Root
+         if (Root.Type == type && Root.Name == name)
+            return const_cast<ProjectItem*>(&Root);
+
+         // Lookup descendant. Prefer base folders over user folders of the same name
+         ProjectItem* match = nullptr;
+         auto range = Names.equal_range(GetNameKey(type, name));
+         for (auto it = range.first; it != range.second; ++it)
+            if (!match || it->second->Fixed)
+               match = it->second;
+
+         return match;
       }
 
          /// <summary>Finds root folder for a filetype.</summary>
@@ -62,10 +125,10 @@ namespace Logic
       {
          switch (type)
          {
-         case FileType::Script:    return Root.Find(ProjectItemType::Folder, L"MSCI Scripts");
-         case FileType::Language:  return Root.Find(ProjectItemType::Folder, L"Language Files");
-         case FileType::Mission:   return Root.Find(ProjectItemType::Folder, L"MD Scripts");
-         default:                  return Root.Find(ProjectItemType::Folder, L"Other Files");
+         case FileType::Script:    return Find(ProjectItemType::Folder, L"MSCI Scripts");
+         case FileType::Language:  return Find(ProjectItemType::Folder, L"Language Files");
+         case FileType::Mission:   return Find(ProjectItemType::Folder, L"MD Scripts");
+         default:                  return Find(ProjectItemType::Folder, L"Other Files");
          }
       }
 
@@ -88,12 +151,87 @@ namespace Logic
          if (p.Fixed)
             throw ArgumentException(HERE, L"p", VString(L"Cannot remove fixed item '%s'", p.Name.c_str()));
 
-         // Remove
+         // Remove from indexes before item is destroyed
+         Unindex(p);
          return Root.Remove(p);
       }
 
+      /// <summary>Renames a folder or variable</summary>
+      /// <param name="p">item</param>
+      /// <param name="name">New name</param>
+      void  ProjectFile::Rename(ProjectItem& p, const wstring& name)
+      {
+         Rename(p, name, p.FullPath);
+      }
+
+      /// <summary>Renames a file</summary>
+      /// <param name="p">item</param>
+      /// <param name="name">New name</param>
+      /// <param name="path">New full path</param>
+      void  ProjectFile::Rename(ProjectItem& p, const wstring& name, const Path& path)
+      {
+         // Root: Not indexed
+         if (&p == &Root)
+         {
+            Root.Name = name;
+            Root.FullPath = path;
+            return;
+         }
+
+         // Re-index under new name/path
+         Unindex(p);
+         p.Name = name;
+         p.FullPath = path;
+         Index(p);
+      }
+
       // ------------------------------ PROTECTED METHODS -----------------------------
 
+      /// <summary>Adds an item and its descendants to the indexes</summary>
+      /// <param name="p">item</param>
+      void  ProjectFile::Index(ProjectItem& p)
+      {
+         if (!p.FullPath.Empty())
+            Paths[GetPathKey(p.FullPath)] = &p;
+
+         Names.insert(NameIndex::value_type(GetNameKey(p.Type, p.Name), &p));
+
+         for (auto& c : p.Children)
+            Index(c);
+      }
+
+      /// <summary>Rebuilds both indexes from the item tree</summary>
+      void  ProjectFile::Reindex()
+      {
+         Paths.clear();
+         Names.clear();
+
+         for (auto& c : Root.Children)
+            Index(c);
+      }
+
+      /// <summary>Removes an item and its descendants from the indexes</summary>
+      /// <param name="p">item</param>
+      void  ProjectFile::Unindex(ProjectItem& p)
+      {
+         // Path: Only remove entry if it refers to this item
+         auto path = Paths.find(GetPathKey(p.FullPath));
+         if (path != Paths.end() && path->second == &p)
+            Paths.erase(path);
+
+         // Name: Remove matching entry
+         auto range = Names.equal_range(GetNameKey(p.Type, p.Name));
+         for (auto it = range.first; it != range.second; ++it)
+            if (it->second == &p)
+            {
+               Names.erase(it);
+               break;
+            }
+
+         for (auto& c : p.Children)
+            Unindex(c);
+      }
+
       // ------------------------------- PRIVATE METHODS ------------------------------
    
    }
@@ -1,28 +1,37 @@
 #pragma once
 #include "ProjectItem.h"
+#include <unordered_map>
 
 namespace Logic
 {
    namespace Projects
    {
       
-      /// <summary></summary>
+      /// <summary>Project item tree, indexed by path and by type+name</summary>
+      /// <remarks>Items must be added, removed and renamed through the project file so the indexes remain current</remarks>
       class LogicExport ProjectFile
       {
          // ------------------------ TYPES --------------------------
-      public:
+      protected:
+         /// <summary>Items by case-folded full path</summary>
+         typedef unordered_map<wstring,ProjectItem*>  PathIndex;
+
+         /// <summary>Items by type+name.  Names are not unique</summary>
+         typedef unordered_multimap<wstring,ProjectItem*>  NameIndex;
 
          // --------------------- CONSTRUCTION ----------------------
       public:
          ProjectFile(const Path& path);
+         ProjectFile(const ProjectFile& r);
          virtual ~ProjectFile();
 
-         DEFAULT_COPY(ProjectFile);	// Default copy semantics
+         ProjectFile& operator=(const ProjectFile& r);
          DEFAULT_MOVE(ProjectFile);	// Default move semantics
 
          // ------------------------ STATIC -------------------------
-      public:
-         
+      protected:
+         static wstring  GetNameKey(ProjectItemType type, const wstring& name);
+         static wstring  GetPathKey(const Path& path);
 
          // --------------------- PROPERTIES ------------------------
 
@@ -68,17 +77,41 @@ namespace Logic
          /// <exception cref="Logic::ArgumentException">Item is not fixed</exception>
          ProjectItem&  Add(const ProjectItem& p);
 
+         /// <summary>Add item to a folder</summary>
+         /// <param name="p">item</param>
+         /// <param name="folder">Parent folder within this project</param>
+         /// <returns>Reference to inserted item</returns>
+         ProjectItem&  Add(const ProjectItem& p, ProjectItem& folder);
+
          /// <summary>Finds an removes an item</summary>
          /// <param name="p">item</param>
          /// <returns>Item removed, or nullptr</returns>
          /// <exception cref="Logic::ArgumentException">Item is fixed</exception>
          bool  Remove(ProjectItem& p);
 
+         /// <summary>Renames a folder or variable</summary>
+         /// <param name="p">item</param>
+         /// <param name="name">New name</param>
+         void  Rename(ProjectItem& p, const wstring& name);
+
+         /// <summary>Renames a file</summary>
+         /// <param name="p">item</param>
+         /// <param name="name">New name</param>
+         /// <param name="path">New full path</param>
+         void  Rename(ProjectItem& p, const wstring& name, const Path& path);
+
+      protected:
+         void  Index(ProjectItem& p);
+         void  Reindex();
+         void  Unindex(ProjectItem& p);
 
          // -------------------- REPRESENTATION ---------------------
       public:
          ProjectItem  Root;
-         
+
+      protected:
+         PathIndex    Paths;      // Descendants of root by path
+         NameIndex    Names;      // Descendants of root by type+name
       };
 
    }
@@ -0,0 +1,865 @@
+#include "stdafx.h"
+#include "RegExPrefilter.h"
+#include <algorithm>
+
+namespace Logic
+{
+   namespace Utils
+   {
+      // -------------------------------- CONSTRUCTION --------------------------------
+
+      /// <summary>Analyses a regular expression</summary>
+      /// <param name="pattern">ECMAScript expression, already known to be valid.  May be empty</param>
+      RegExPrefilter::RegExPrefilter(const wstring& pattern) : WithinLine(!pattern.empty()), Automaton(pattern)
+      {
+         // Unsupported: Search without filtering
+         if (!Parse(pattern))
+         {
+            RequiredLiteral.clear();
+            WithinLine = false;
+         }
+      }
+
+      // ------------------------------- STATIC METHODS -------------------------------
+
+      // ------------------------------- PUBLIC METHODS -------------------------------
+
+      /// <summary>Finds the first match at or after an offset</summary>
+      /// <param name="text">Text to search.  Lines are separated by single '\n' characters</param>
+      /// <param name="start">Offset to search from.  The expression treats this as the beginning of the text, as regex_search would</param>
+      /// <param name="regex">Expression this filter was created from</param>
+      /// <param name="pos">On return, offset of match</param>
+      /// <param name="length">On return, length of match</param>
+      /// <returns>True if found, otherwise false</returns>
+      bool  RegExPrefilter::Find(const wstring& text, UINT start, const wregex& regex, UINT& pos, UINT& length) const
+      {
+         // No literal: Search remainder
+         if (RequiredLiteral.empty())
+            return Search(text, start, text.length(), false, regex, pos, length);
+
+         // Find first line containing the literal
+         size_t lit = text.find(RequiredLiteral, start);
+         if (lit == wstring::npos)
+            return false;
+
+         // Multi-line: Search remainder
+         if (!WithinLine)
+            return Search(text, start, text.length(), false, regex, pos, length);
+
+         // Single line: Search each line containing the literal
+         while (lit != wstring::npos)
+         {
+            size_t lineStart = text.rfind(L'\n', lit),
+                   lineEnd = text.find(L'\n', lit + RequiredLiteral.length());
+
+            UINT from = (lineStart == wstring::npos || lineStart < start ? start : lineStart+1),
+                 to = (lineEnd == wstring::npos ? text.length() : lineEnd);
+
+            if (Search(text, from, to, from > start, regex, pos, length))
+               return true;
+
+            // Resume after line
+            lit = (to < text.length() ? text.find(RequiredLiteral, to + 1) : wstring::npos);
+         }
+
+         return false;
+      }
+
+      /// <summary>Gets the longest literal present in every match</summary>
+      /// <returns>Literal, or empty string if none</returns>
+      wstring  RegExPrefilter::GetLiteral() const
+      {
+         return RequiredLiteral;
+      }
+
+      /// <summary>Gets whether the expression is matched without backtracking</summary>
+      /// <returns>False if the expression uses syntax unsupported by the linear-time matcher</returns>
+      bool  RegExPrefilter::IsLinear() const
+      {
+         return Automaton.IsCompiled();
+      }
+
+      /// <summary>Gets whether every match lies within a single line</summary>
+      /// <returns></returns>
+      bool  RegExPrefilter::IsSingleLine() const
+      {
+         return WithinLine;
+      }
+
+      // ------------------------------ PROTECTED METHODS -----------------------------
+
+      /// <summary>Parses the expression to find the required literal and whether matches can contain line breaks</summary>
+      /// <param name="pattern">ECMAScript expression</param>
+      /// <returns>False if the expression uses syntax that cannot be analysed safely</returns>
+      /// <remarks>Only literals outside of groups are considered.  A literal followed by a quantifier with a minimum of zero is optional,
+      /// and any other quantifier ends the literal, since the repeated character need not be followed by the next.</remarks>
+      bool  RegExPrefilter::Parse(const wstring& pattern)
+      {
+         const UINT length = pattern.length();
+         wstring    run;                  // Literal being built
+         bool       literal = false,      // Whether previous atom was appended to 'run'
+                    alternation = false;  // Whether pattern has top-level alternatives
+         UINT       depth = 0;            // Group depth
+
+         // Ends the current literal, keeping the longest
+         auto commit = [&] {
+            if (run.length() > RequiredLiteral.length())
+               RequiredLiteral = run;
+            run.clear();
+            literal = false;
+         };
+
+         for (UINT i = 0; i < length; ++i)
+         {
+            wchar ch = pattern[i];
+
+            switch (ch)
+            {
+            // Escape: Punctuation and tabs are literals.  Classes end the literal
+            case '\\':
+               if (++i == length)
+                  return false;
+
+               ch = pattern[i];
+               if (ch == 't')
+                  ch = '\t';
+               else if (ch >= 0x80)
+                  return false;
+               else if (iswalnum(ch))
+               {
+                  // Classes matching line breaks
+                  if (wcschr(L"sWDnrvf", ch))
+                     WithinLine = false;
+                  // Unsupported: Character codes, named back-references
+                  else if (!wcschr(L"dwSbB123456789", ch))
+                     return false;
+
+                  commit();
+                  continue;
+               }
+               break;
+
+            // Class: Ends the literal.  Determine whether it can match a line break
+            case '[':
+               {
+                  UINT first = ++i;
+                  bool escaped = false;    // Whether previous character was a letter escape
+
+                  if (i < length && pattern[i] == '^')
+                  {
+                     WithinLine = false;
+                     first = ++i;
+                  }
+
+                  for (; i < length && pattern[i] != ']'; ++i)
+                  {
+                     // Range: Check lower bound
+                     if (pattern[i] == '-' && i > first && escaped)
+                        WithinLine = false;
+
+                     escaped = false;
+                     if (pattern[i] == '\\')
+                     {
+                        if (++i == length)
+                           return false;
+
+                        escaped = iswalnum(pattern[i]) != 0;
+                        if (escaped && wcschr(L"sWDnrvfcxu0", pattern[i]))
+                           WithinLine = false;
+                     }
+                     // Unsupported: Character class names, collating elements, equivalence classes
+                     else if (pattern[i] == '[' && i+1 < length && wcschr(L":.=", pattern[i+1]))
+                        return false;
+                     else if (pattern[i] < 0x20 && pattern[i] != '\t')
+                        WithinLine = false;
+                  }
+
+                  // Unsupported: Empty class
+                  if (i == first || i == length)
+                     return false;
+               }
+               commit();
+               continue;
+
+            // Group: Skip prefix of non-capturing groups and assertions
+            case '(':
+               if (i+1 < length && pattern[i+1] == '?')
+               {
+                  if (i+2 == length || !wcschr(L":=!", pattern[i+2]))
+                     return false;
+                  i += 2;
+               }
+               ++depth;
+               commit();
+               continue;
+
+            case ')':
+               if (depth-- == 0)
+                  return false;
+               commit();
+               continue;
+
+            // Alternation: No literal is required
+            case '|':
+               if (depth == 0)
+                  alternation = true;
+               commit();
+               continue;
+
+            // Wildcard/Anchors: End literal
+            case '.':
+            case '^':
+            case '$':
+               commit();
+               continue;
+
+            // Optional: Remove previous character from literal
+            case '*':
+            case '?':
+               if (literal)
+                  run.pop_back();
+               commit();
+
+               // Skip lazy modifier
+               if (i+1 < length && pattern[i+1] == '?')
+                  ++i;
+               continue;
+
+            // Repeated: End literal after previous character
+            case '+':
+               commit();
+
+               if (i+1 < length && pattern[i+1] == '?')
+                  ++i;
+               continue;
+
+            // Bounded: Optional if minimum is zero
+            case '{':
+               {
+                  bool required = false;
+                  UINT digits = 0;
+
+                  for (++i; i < length && iswdigit(pattern[i]); ++i, ++digits)
+                     required |= (pattern[i] != '0');
+                  if (i < length && pattern[i] == ',')
+                     while (++i < length && iswdigit(pattern[i]))
+                        ;
+
+                  // Unsupported: Malformed bounds
+                  if (digits == 0 || i == length || pattern[i] != '}')
+                     return false;
+
+                  if (!required && literal)
+                     run.pop_back();
+                  commit();
+
+                  if (i+1 < length && pattern[i+1] == '?')
+                     ++i;
+               }
+               continue;
+
+            // Unsupported: Unbalanced brackets
+            case ']':
+            case '}':
+               return false;
+
+            // Control characters: May be a line break
+            default:
+               if (ch < 0x20 && ch != '\t')
+                  WithinLine = false;
+               break;
+            }
+
+            // Literal: Append unless within a group
+            if (depth == 0)
+            {
+               run += ch;
+               literal = true;
+            }
+         }
+
+         // Unsupported: Unbalanced groups
+         if (depth != 0)
+            return false;
+
+         // Keep longest literal, unless there are alternatives
+         commit();
+         if (alternation)
+            RequiredLiteral.clear();
+
+         return true;
+      }
+
+      /// <summary>Searches part of the text</summary>
+      /// <param name="text">Text to search</param>
+      /// <param name="start">Offset to search from</param>
+      /// <param name="end">Offset to search until, exclusive</param>
+      /// <param name="prevAvailable">Whether the character preceding 'start' is considered by assertions</param>
+      /// <param name="regex">Expression</param>
+      /// <param name="pos">On return, offset of match</param>
+      /// <param name="length">On return, length of match</param>
+      /// <returns>True if found, otherwise false</returns>
+      bool  RegExPrefilter::Search(const wstring& text, UINT start, UINT end, bool prevAvailable, const wregex& regex, UINT& pos, UINT& length) const
+      {
+         // Supported: Match without backtracking
+         if (Automaton.IsCompiled())
+            return Automaton.Search(text, start, end, prevAvailable, pos, length);
+
+         auto flags = regex_constants::match_default;
+         wsmatch matches;
+
+         // Preserve the meaning of anchors at the boundaries
+         if (prevAvailable)
+            flags |= regex_constants::match_prev_avail;
+         if (end < text.length())
+            flags |= regex_constants::match_not_eol;
+
+         if (!regex_search(text.cbegin()+start, text.cbegin()+end, matches, regex, flags))
+            return false;
+
+         pos = matches[0].first - text.cbegin();
+         length = matches[0].length();
+         return true;
+      }
+
+      // ------------------------------- PRIVATE METHODS ------------------------------
+
+		// -------------------------------- NESTED CLASSES ------------------------------
+
+      /// <summary>Compiles an expression, if supported</summary>
+      /// <param name="pattern">ECMAScript expression, already known to be valid.  May be empty</param>
+      RegExPrefilter::Matcher::Matcher(const wstring& pattern)
+      {
+         Program code;
+         UINT    i = 0;
+
+         // Unsupported/Empty: Leave uncompiled
+         if (pattern.empty() || !ParseAlternation(pattern, i, code) || i != pattern.length())
+         {
+            Classes.clear();
+            return;
+         }
+
+         code.push_back(Instruction(OpCode::Match));
+         Code.swap(code);
+      }
+
+      /// <summary>Appends one program to another, relocating its targets</summary>
+      /// <param name="dest">Program to append to</param>
+      /// <param name="src">Program to append</param>
+      void  RegExPrefilter::Matcher::Append(Program& dest, const Program& src)
+      {
+         UINT base = dest.size();
+
+         for (auto in : src)
+         {
+            if (in.Op == OpCode::Jump || in.Op == OpCode::Split)
+            {
+               in.X += base;
+               in.Y += base;
+            }
+            dest.push_back(in);
+         }
+      }
+
+      /// <summary>Gets the flag for a class escape</summary>
+      /// <param name="ch">Escaped character</param>
+      /// <returns>ClassEscape flag, or zero if not a class escape</returns>
+      UINT  RegExPrefilter::Matcher::GetEscape(wchar ch)
+      {
+         switch (ch)
+         {
+         case 'd':  return Digit;
+         case 'D':  return NotDigit;
+         case 'w':  return Word;
+         case 'W':  return NotWord;
+         case 's':  return Space;
+         case 'S':  return NotSpace;
+         }
+         return 0;
+      }
+
+      /// <summary>Query whether a character ends a line, and so is not matched by '.'</summary>
+      /// <param name="ch">Character</param>
+      /// <returns></returns>
+      bool  RegExPrefilter::Matcher::IsLineTerminator(wchar ch)
+      {
+         return ch == '\n' || ch == '\r' || ch == 0x2028 || ch == 0x2029;
+      }
+
+      /// <summary>Query whether a character is matched by \w</summary>
+      /// <param name="ch">Character</param>
+      /// <returns></returns>
+      bool  RegExPrefilter::Matcher::IsWordChar(wchar ch)
+      {
+         return iswalnum(ch) || ch == '_';
+      }
+
+      /// <summary>Query whether a character is matched by the class</summary>
+      /// <param name="ch">Character</param>
+      /// <returns></returns>
+      bool  RegExPrefilter::Matcher::CharClass::Matches(wchar ch) const
+      {
+         bool match = any_of(Ranges.begin(), Ranges.end(), [ch](const pair<wchar,wchar>& r) {return ch >= r.first && ch <= r.second;});
+
+         // Class escapes
+         if (!match && Escapes)
+            match = ((Escapes & Digit) && iswdigit(ch))     || ((Escapes & NotDigit) && !iswdigit(ch))
+                 || ((Escapes & Word) && IsWordChar(ch))    || ((Escapes & NotWord) && !IsWordChar(ch))
+                 || ((Escapes & Space) && iswspace(ch))     || ((Escapes & NotSpace) && !iswspace(ch));
+
+         return match != Negated;
+      }
+
+      /// <summary>Query whether the expression was compiled</summary>
+      /// <returns>False if the expression uses unsupported syntax</returns>
+      bool  RegExPrefilter::Matcher::IsCompiled() const
+      {
+         return !Code.empty();
+      }
+
+      /// <summary>Finds the first match within part of the text</summary>
+      /// <param name="text">Text to search</param>
+      /// <param name="start">Offset to search from</param>
+      /// <param name="end">Offset to search until, exclusive</param>
+      /// <param name="prevAvailable">Whether the character preceding 'start' is considered by assertions</param>
+      /// <param name="pos">On return, offset of match</param>
+      /// <param name="length">On return, length of match</param>
+      /// <returns>True if found, otherwise false</returns>
+      /// <remarks>Threads are kept in order of preference, so the match found is the one regex_search would find.  '^' and '$' match 
+      /// only at the beginning and end of the text, as ECMAScript without the multiline flag</remarks>
+      bool  RegExPrefilter::Matcher::Search(const wstring& text, UINT start, UINT end, bool prevAvailable, UINT& pos, UINT& length) const
+      {
+         typedef pair<UINT,UINT>  Thread;       // Instruction, and offset the thread started at
+
+         vector<Thread>  current, next;
+         vector<UINT>    marks(Code.size(), 0),  // Offset+1 at which each instruction was last added
+                         stack;
+         bool            matched = false;
+
+         // Adds the threads reached from an instruction without consuming input, in order of preference
+         auto add = [&](vector<Thread>& list, UINT pc, UINT from, UINT at)
+         {
+            stack.push_back(pc);
+            while (!stack.empty())
+            {
+               pc = stack.back();
+               stack.pop_back();
+
+               // Skip instructions already reached at this offset by a preferred thread
+               if (marks[pc] == at+1)
+                  continue;
+               marks[pc] = at+1;
+
+               const Instruction& in = Code[pc];
+               switch (in.Op)
+               {
+               case OpCode::Jump:   
+                  stack.push_back(in.X);  
+                  break;
+
+               case OpCode::Split:  
+                  stack.push_back(in.Y);
+                  stack.push_back(in.X);
+                  break;
+
+               case OpCode::Begin:
+                  if (at == start && !prevAvailable)
+                     stack.push_back(pc+1);
+                  break;
+
+               case OpCode::End:
+                  if (at == end && end == text.length())
+                     stack.push_back(pc+1);
+                  break;
+
+               case OpCode::WordBoundary:
+               case OpCode::NotWordBoundary:
+                  {
+                     bool before = (at > start || prevAvailable) && at > 0 && IsWordChar(text[at-1]),
+                          after = at < end && IsWordChar(text[at]);
+                     if ((before != after) == (in.Op == OpCode::WordBoundary))
+                        stack.push_back(pc+1);
+                  }
+                  break;
+
+               // Consuming/Match: Await next character
+               default:
+                  list.push_back(Thread(pc, from));
+                  break;
+               }
+            }
+         };
+
+         for (UINT i = start; ; ++i)
+         {
+            // Unmatched: Begin a new thread at each offset, least preferred
+            if (!matched)
+               add(current, 0, i, i);
+
+            // Advance each thread over the next character
+            for (auto& t : current)
+            {
+               const Instruction& in = Code[t.first];
+
+               // Match: Discard less preferred threads
+               if (in.Op == OpCode::Match)
+               {
+                  matched = true;
+                  pos = t.second;
+                  length = i - t.second;
+                  break;
+               }
+
+               if (i < end && (in.Op == OpCode::Any   ? !IsLineTerminator(text[i])
+                             : in.Op == OpCode::Char  ? in.Char == text[i]
+                             :                          Classes[in.X].Matches(text[i])))
+                  add(next, t.first+1, t.second, i+1);
+            }
+
+            current.swap(next);
+            next.clear();
+
+            // Stop at end, or once no thread can improve upon the match
+            if (i == end || (matched && current.empty()))
+               break;
+         }
+
+         return matched;
+      }
+
+      /// <summary>Compiles alternatives</summary>
+      /// <param name="p">Pattern</param>
+      /// <param name="i">Offset of first alternative.  On return, offset following the last</param>
+      /// <param name="out">Program to append to</param>
+      /// <returns>False if unsupported</returns>
+      bool  RegExPrefilter::Matcher::ParseAlternation(const wstring& p, UINT& i, Program& out)
+      {
+         Program first, rest;
+
+         // Single: Append
+         if (!ParseSequence(p, i, first))
+            return false;
+         if (i == p.length() || p[i] != '|')
+         {
+            Append(out, first);
+            return true;
+         }
+
+         // Alternatives: Prefer the first
+         if (!ParseAlternation(p, ++i, rest))
+            return false;
+
+         UINT base = out.size();
+         out.push_back(Instruction(OpCode::Split, base+1, base+first.size()+2));
+         Append(out, first);
+         out.push_back(Instruction(OpCode::Jump, base+first.size()+rest.size()+2));
+         Append(out, rest);
+         return out.size() <= MAX_INSTRUCTIONS;
+      }
+
+      /// <summary>Compiles a group, class, escape, anchor or literal</summary>
+      /// <param name="p">Pattern</param>
+      /// <param name="i">Offset of atom.  On return, offset following it</param>
+      /// <param name="out">Program to append to</param>
+      /// <param name="quantifiable">On return, whether the atom may be followed by a quantifier</param>
+      /// <returns>False if unsupported</returns>
+      bool  RegExPrefilter::Matcher::ParseAtom(const wstring& p, UINT& i, Program& out, bool& quantifiable)
+      {
+         wchar ch = p[i++];
+         quantifiable = true;
+
+         switch (ch)
+         {
+         // Group: Capturing or non-capturing.  Unsupported: Assertions
+         case '(':
+            if (i < p.length() && p[i] == '?')
+            {
+               if (i+1 == p.length() || p[i+1] != ':')
+                  return false;
+               i += 2;
+            }
+            if (!ParseAlternation(p, i, out) || i == p.length() || p[i] != ')')
+               return false;
+            ++i;
+            return true;
+
+         case '[':   
+            return ParseClass(p, i, out);
+
+         case '\\':  
+            return ParseEscape(p, i, out, quantifiable);
+
+         case '.':
+            out.push_back(Instruction(OpCode::Any));
+            return true;
+
+         // Anchors: Cannot be repeated
+         case '^':
+         case '$':
+            out.push_back(Instruction(ch == '^' ? OpCode::Begin : OpCode::End));
+            quantifiable = false;
+            return true;
+
+         // Unsupported: Unbalanced brackets, quantifier without atom
+         case ']':
+         case '{':
+         case '}':
+         case '*':
+         case '+':
+         case '?':
+            return false;
+         }
+
+         out.push_back(Instruction(ch));
+         return true;
+      }
+
+      /// <summary>Compiles a bracket expression</summary>
+      /// <param name="p">Pattern</param>
+      /// <param name="i">Offset following the opening bracket.  On return, offset following the closing bracket</param>
+      /// <param name="out">Program to append to</param>
+      /// <returns>False if unsupported</returns>
+      bool  RegExPrefilter::Matcher::ParseClass(const wstring& p, UINT& i, Program& out)
+      {
+         CharClass cls;
+         wchar     lo, hi;
+         UINT      escape;
+
+         // Negated
+         if (i < p.length() && p[i] == '^')
+         {
+            cls.Negated = true;
+            ++i;
+         }
+
+         UINT first = i;
+         while (i < p.length() && p[i] != ']')
+         {
+            if (!ParseClassAtom(p, i, lo, escape))
+               return false;
+
+            // Class escape: Cannot bound a range
+            if (escape)
+               cls.Escapes |= escape;
+
+            // Range: Require characters in order
+            else if (i+1 < p.length() && p[i] == '-' && p[i+1] != ']')
+            {
+               if (!ParseClassAtom(p, ++i, hi, escape) || escape || hi < lo)
+                  return false;
+               cls.Ranges.push_back(make_pair(lo, hi));
+            }
+            else
+               cls.Ranges.push_back(make_pair(lo, lo));
+         }
+
+         // Unsupported: Empty/Unterminated class
+         if (i == first || i++ == p.length())
+            return false;
+
+         Classes.push_back(cls);
+         out.push_back(Instruction(OpCode::Class, Classes.size()-1));
+         return true;
+      }
+
+      /// <summary>Reads a character or class escape within a bracket expression</summary>
+      /// <param name="p">Pattern</param>
+      /// <param name="i">Offset of atom.  On return, offset following it</param>
+      /// <param name="ch">On return, the character, if not a class escape</param>
+      /// <param name="escape">On return, the ClassEscape flag, or zero if a character</param>
+      /// <returns>False if unsupported</returns>
+      bool  RegExPrefilter::Matcher::ParseClassAtom(const wstring& p, UINT& i, wchar& ch, UINT& escape)
+      {
+         escape = 0;
+         ch = p[i++];
+
+         // Unsupported: Character class names, collating elements, equivalence classes
+         if (ch == '[' && i < p.length() && p[i] && wcschr(L":.=", p[i]))
+            return false;
+         if (ch != '\\')
+            return true;
+
+         if (i == p.length())
+            return false;
+
+         switch (ch = p[i++])
+         {
+         case 'b':  ch = '\b';  return true;
+         case 't':  ch = '\t';  return true;
+         case 'n':  ch = '\n';  return true;
+         case 'r':  ch = '\r';  return true;
+         case 'v':  ch = '\v';  return true;
+         case 'f':  ch = '\f';  return true;
+         }
+
+         // Class escape/Punctuation.  Unsupported: Character codes
+         escape = GetEscape(ch);
+         return escape || (ch < 0x80 && !iswalnum(ch));
+      }
+
+      /// <summary>Compiles an escape outside a bracket expression</summary>
+      /// <param name="p">Pattern</param>
+      /// <param name="i">Offset following the backslash.  On return, offset following the escape</param>
+      /// <param name="out">Program to append to</param>
+      /// <param name="quantifiable">On return, whether the escape may be followed by a quantifier</param>
+      /// <returns>False if unsupported</returns>
+      bool  RegExPrefilter::Matcher::ParseEscape(const wstring& p, UINT& i, Program& out, bool& quantifiable)
+      {
+         if (i == p.length())
+            return false;
+
+         wchar ch = p[i++];
+         switch (ch)
+         {
+         // Word boundaries: Cannot be repeated
+         case 'b':
+         case 'B':
+            out.push_back(Instruction(ch == 'b' ? OpCode::WordBoundary : OpCode::NotWordBoundary));
+            quantifiable = false;
+            return true;
+
+         case 't':  ch = '\t';  break;
+         case 'n':  ch = '\n';  break;
+         case 'r':  ch = '\r';  break;
+         case 'v':  ch = '\v';  break;
+         case 'f':  ch = '\f';  break;
+
+         default:
+            // Class escape
+            if (UINT escape = GetEscape(ch))
+            {
+               Classes.push_back(CharClass());
+               Classes.back().Escapes = escape;
+               out.push_back(Instruction(OpCode::Class, Classes.size()-1));
+               return true;
+            }
+            // Unsupported: Back-references, character codes
+            else if (ch >= 0x80 || iswalnum(ch))
+               return false;
+            break;
+         }
+
+         out.push_back(Instruction(ch));
+         return true;
+      }
+
+      /// <summary>Repeats an atom if followed by a quantifier</summary>
+      /// <param name="p">Pattern</param>
+      /// <param name="i">Offset following the atom.  On return, offset following the quantifier, if any</param>
+      /// <param name="atom">Program for the atom.  On return, the repeated program</param>
+      /// <param name="quantifiable">Whether the atom may be repeated</param>
+      /// <returns>False if unsupported</returns>
+      bool  RegExPrefilter::Matcher::ParseQuantifier(const wstring& p, UINT& i, Program& atom, bool quantifiable)
+      {
+         UINT min = 0, 
+              max = UINT_MAX;   // Unbounded
+
+         // None: Use atom
+         if (i == p.length() || !p[i] || !wcschr(L"*+?{", p[i]))
+            return true;
+
+         // Unsupported: Repeated assertion
+         if (!quantifiable)
+            return false;
+
+         switch (p[i++])
+         {
+         case '+':  min = 1;  break;
+         case '?':  max = 1;  break;
+         case '{':
+            {
+               UINT digits = 0;
+               for (; i < p.length() && iswdigit(p[i]); ++i, ++digits)
+                  min = min*10 + (p[i]-'0');
+               max = min;
+
+               // Minimum only, or range
+               if (i < p.length() && p[i] == ',')
+               {
+                  max = UINT_MAX;
+                  if (++i < p.length() && iswdigit(p[i]))
+                     for (max = 0; i < p.length() && iswdigit(p[i]); ++i)
+                        max = max*10 + (p[i]-'0');
+               }
+
+               // Unsupported: Malformed/Reversed bounds, excessive repetition
+               if (digits == 0 || digits > 4 || i == p.length() || p[i++] != '}' || max < min)
+                  return false;
+            }
+            break;
+         }
+
+         bool    lazy = (i < p.length() && p[i] == '?');
+         Program body;
+         body.swap(atom);
+         if (lazy)
+            ++i;
+
+         // Required repetitions
+         for (UINT n = 0; n < min; ++n)
+         {
+            Append(atom, body);
+            if (atom.size() > MAX_INSTRUCTIONS)
+               return false;
+         }
+
+         // Unbounded: Loop.  Prefer another repetition unless lazy
+         if (max == UINT_MAX)
+         {
+            UINT loop = atom.size();
+            atom.push_back(Instruction(OpCode::Split, loop+1, loop+body.size()+2));
+            Append(atom, body);
+            atom.push_back(Instruction(OpCode::Jump, loop));
+
+            if (lazy)
+               swap(atom[loop].X, atom[loop].Y);
+         }
+         // Bounded: Optional repetitions, each skipping to the end
+         else
+         {
+            vector<UINT> optional;
+            for (UINT n = min; n < max; ++n)
+            {
+               optional.push_back(atom.size());
+               atom.push_back(Instruction(OpCode::Split, atom.size()+1));
+               Append(atom, body);
+
+               if (atom.size() > MAX_INSTRUCTIONS)
+                  return false;
+            }
+
+            for (UINT split : optional)
+               if (lazy)
+                  atom[split].Y = split+1, atom[split].X = atom.size();
+               else
+                  atom[split].Y = atom.size();
+         }
+
+         return atom.size() <= MAX_INSTRUCTIONS;
+      }
+
+      /// <summary>Compiles a sequence of atoms, up to the next alternative or the end of the group</summary>
+      /// <param name="p">Pattern</param>
+      /// <param name="i">Offset of first atom.  On return, offset following the sequence</param>
+      /// <param name="out">Program to append to</param>
+      /// <returns>False if unsupported</returns>
+      bool  RegExPrefilter::Matcher::ParseSequence(const wstring& p, UINT& i, Program& out)
+      {
+         while (i < p.length() && p[i] != '|' && p[i] != ')')
+         {
+            Program atom;
+            bool    quantifiable;
+
+            if (!ParseAtom(p, i, atom, quantifiable) || !ParseQuantifier(p, i, atom, quantifiable))
+               return false;
+
+            Append(out, atom);
+            if (out.size() > MAX_INSTRUCTIONS)
+               return false;
+         }
+
+         return true;
+      }
+   }
+}
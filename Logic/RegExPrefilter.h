@@ -0,0 +1,135 @@
+#pragma once
+
+#include <regex>
+
+namespace Logic
+{
+   namespace Utils
+   {
+      /// <summary>Narrows a regular expression search to the lines that could contain a match</summary>
+      /// <remarks>The pattern is examined once, when the search is created, to find the longest literal that every match must contain
+      /// and whether any match could span a line break.  Lines without the literal are skipped using a plain substring search, and
+      /// the expression is only run over the remaining lines, which bounds backtracking by the length of a line.  Patterns that cannot
+      /// be analysed safely are searched exactly as before.  Patterns built only from literals, classes, groups, alternatives, 
+      /// quantifiers and anchors are matched by a Thompson NFA, which never backtracks and runs in time linear in the length of the text.</remarks>
+      class LogicExport RegExPrefilter
+      {
+         // ------------------------ TYPES --------------------------
+      protected:
+         /// <summary>Matches a regular expression by simulating a Thompson NFA, in ECMAScript (leftmost, by preference) order</summary>
+         /// <remarks>Each position of the text is visited once with at most one thread per instruction, so matching is O(text * pattern).
+         /// Back-references, look-ahead assertions and character codes are not supported, leaving the matcher uncompiled</remarks>
+         class Matcher
+         {
+            // ------------------------ TYPES --------------------------
+         protected:
+            /// <summary>Instruction opcodes</summary>
+            enum class OpCode : BYTE { Char, Class, Any, Split, Jump, Begin, End, WordBoundary, NotWordBoundary, Match };
+
+            /// <summary>Class escapes matched by a character class</summary>
+            enum ClassEscape : UINT { Digit = 1, NotDigit = 2, Word = 4, NotWord = 8, Space = 16, NotSpace = 32 };
+
+            /// <summary>Program instruction</summary>
+            class Instruction
+            {
+            public:
+               Instruction(OpCode op, UINT x = 0, UINT y = 0) : Op(op), Char(0), X(x), Y(y)
+               {}
+               Instruction(wchar ch) : Op(OpCode::Char), Char(ch), X(0), Y(0)
+               {}
+
+               OpCode  Op;
+               wchar   Char;    // Character matched by 'Char'
+               UINT    X,       // Preferred target of 'Split', target of 'Jump', class matched by 'Class'
+                       Y;       // Alternate target of 'Split'
+            };
+
+            /// <summary>Characters matched by a bracket expression or class escape</summary>
+            class CharClass
+            {
+            public:
+               CharClass() : Escapes(0), Negated(false)
+               {}
+
+               bool  Matches(wchar ch) const;
+
+               vector<pair<wchar,wchar>>  Ranges;    // Inclusive ranges
+               UINT                       Escapes;   // Combination of ClassEscape flags
+               bool                       Negated;   // Whether characters NOT matched are matched
+            };
+
+            /// <summary>Instruction sequence, whose targets are relative to its first instruction</summary>
+            typedef vector<Instruction>  Program;
+
+            // --------------------- CONSTRUCTION ----------------------
+         public:
+            Matcher(const wstring& pattern);
+
+            // ------------------------ STATIC -------------------------
+         protected:
+            static void  Append(Program& dest, const Program& src);
+            static UINT  GetEscape(wchar ch);
+            static bool  IsLineTerminator(wchar ch);
+            static bool  IsWordChar(wchar ch);
+
+            // ---------------------- ACCESSORS ------------------------
+         public:
+            bool  IsCompiled() const;
+            bool  Search(const wstring& text, UINT start, UINT end, bool prevAvailable, UINT& pos, UINT& length) const;
+
+            // ----------------------- MUTATORS ------------------------
+         protected:
+            bool  ParseAlternation(const wstring& p, UINT& i, Program& out);
+            bool  ParseAtom(const wstring& p, UINT& i, Program& out, bool& quantifiable);
+            bool  ParseClass(const wstring& p, UINT& i, Program& out);
+            bool  ParseClassAtom(const wstring& p, UINT& i, wchar& ch, UINT& escape);
+            bool  ParseEscape(const wstring& p, UINT& i, Program& out, bool& quantifiable);
+            bool  ParseQuantifier(const wstring& p, UINT& i, Program& atom, bool quantifiable);
+            bool  ParseSequence(const wstring& p, UINT& i, Program& out);
+
+            // -------------------- REPRESENTATION ---------------------
+         protected:
+            static const UINT  MAX_INSTRUCTIONS = 8192;   // Limits the expansion of bounded quantifiers
+
+            Program            Code;       // Compiled program, or empty if unsupported
+            vector<CharClass>  Classes;    // Character classes referenced by the program
+         };
+
+         // --------------------- CONSTRUCTION ----------------------
+      public:
+         RegExPrefilter(const wstring& pattern);
+
+         DEFAULT_COPY(RegExPrefilter);	// Default copy semantics
+         DEFAULT_MOVE(RegExPrefilter);	// Default move semantics
+
+         // --------------------- PROPERTIES ------------------------
+      public:
+         PROPERTY_GET(wstring,Literal,GetLiteral);
+         PROPERTY_GET(bool,Linear,IsLinear);
+         PROPERTY_GET(bool,SingleLine,IsSingleLine);
+
+         // ---------------------- ACCESSORS ------------------------
+      public:
+         bool     Find(const wstring& text, UINT start, const wregex& regex, UINT& pos, UINT& length) const;
+         wstring  GetLiteral() const;
+         bool     IsLinear() const;
+         bool     IsSingleLine() const;
+
+      protected:
+         bool     Search(const wstring& text, UINT start, UINT end, bool prevAvailable, const wregex& regex, UINT& pos, UINT& length) const;
+
+         // ----------------------- MUTATORS ------------------------
+      protected:
+         bool     Parse(const wstring& pattern);
+
+         // -------------------- REPRESENTATION ---------------------
+      protected:
+         wstring  RequiredLiteral;     // Longest literal present in every match, or empty if none
+         bool     WithinLine;          // Whether no match can contain a line break
+         Matcher  Automaton;           // Matches the expression without backtracking, if supported
+      };
+
+   }
+}
+
+using namespace Logic::Utils;
@@ -203,7 +203,7 @@ namespace Logic
       /// <returns></returns>
       wstring  ScriptFileReader::ScriptCommandReader::ReadStringNode(const wchar* help)
       { 
-         return Reader.ReadString(Command, NodeIndex++, help);   
+         return CodeArrayReader::ToString(ReadNode(help), help);   
       }
 
       /// <summary>Reads the next node as an int.</summary>
@@ -211,7 +211,7 @@ namespace Logic
       /// <returns></returns>
       int  ScriptFileReader::ScriptCommandReader::ReadIntNode(const wchar* help)
       { 
-         return Reader.ReadInt(Command, NodeIndex++, help);
+         return CodeArrayReader::ToInt(ReadNode(help), help);
       }
 
       /// <summary>Reads the next node as an int/string.</summary>
@@ -219,7 +219,7 @@ namespace Logic
       /// <returns></returns>
       ParameterValue  ScriptFileReader::ScriptCommandReader::ReadValueNode(const wchar* help)
       { 
-         return Reader.ReadValue(Command, NodeIndex++, help);
+         return CodeArrayReader::ToValue(ReadNode(help), help);
       }
 
       /// <summary>Reads the next node as a datatype.</summary>
@@ -232,5 +232,17 @@ namespace Logic
 
 		// ------------------------------- PRIVATE METHODS ------------------------------
       
+      /// <summary>Gets the next node of the command.</summary>
+      /// <param name="help">error text</param>
+      /// <returns></returns>
+      /// <exception cref="Logic::FileFormatException">No further nodes</exception>
+      const ScriptValue&  ScriptFileReader::ScriptCommandReader::ReadNode(const wchar* help)
+      {
+         if (NodeIndex >= Command.size())
+            throw FileFormatException(HERE, VString(L"Cannot read %s from node %d of %d", help, NodeIndex+1, Command.size()));
+
+         return Command[NodeIndex++];
+      }
+      
    }
 }
@@ -2,6 +2,7 @@
 #include "ScriptFile.h"
 #include "RtfWriter.h"
 #include "ScriptObjectLibrary.h"
+#include "GameDataSet.h"
 
 namespace Logic
 {
@@ -75,13 +76,13 @@ namespace Logic
          // RegEx: Find + determine match length
          else if (m.UseRegEx)
          {
-            wsmatch matches;
+            UINT at, length;
 
-            // Search remainder of text
-            if (regex_search(OfflineBuffer.cbegin()+start, OfflineBuffer.cend(), matches, m.RegEx))  //, regex_constants::match_default))
+            // Search remainder of text, skipping lines that cannot match
+            if (m.Filter.Find(OfflineBuffer, start, m.RegEx, at, length))
             {
-               pos = matches[0].first - OfflineBuffer.cbegin();
-               len = matches[0].length();
+               pos = at;
+               len = length;
             }
          }
          // Basic: Linear search
@@ -129,6 +130,7 @@ namespace Logic
       /// <returns>Name of command if any, otherwise empty string</returns>
       wstring  ScriptFile::GetCommandName() const
       {
+         GameDataSet::Scope  game(GameDataSet::Find(Game));
          const ScriptObject* cmd;
 
          if (CommandID.Type == ValueType::String)
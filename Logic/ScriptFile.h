@@ -125,6 +125,22 @@ namespace Logic
       LogicExport ConsoleWnd& operator<<(ConsoleWnd& c, const VariableArray& arr);
 
 
+      /// <summary>Orders label/variable names as they are listed to the user: case-insensitively, then case-sensitively</summary>
+      /// <param name="a">Name</param>
+      /// <param name="b">Name</param>
+      /// <returns>True if a precedes b</returns>
+      inline bool  CompareNames(const wstring& a, const wstring& b)
+      {
+         // Compare lower case characters
+         for (auto x = a.begin(), y = b.begin(); x != a.end() && y != b.end(); ++x, ++y)
+            if (towlower(*x) != towlower(*y))
+               return towlower(*x) < towlower(*y);
+
+         // Equal prefix: Shorter first, then case-sensitive
+         return a.length() != b.length() ? a.length() < b.length() : a < b;
+      }
+
+
       /// <summary>Occurs when a script label is missing</summary>
       class LogicExport LabelNotFoundException : public ExceptionBase
       {
@@ -176,20 +192,35 @@ namespace Logic
             typedef MapIterator<ScriptLabel, LabelCollection, LabelCollection::iterator> LabelIterator;
             typedef MapIterator<const ScriptLabel, LabelCollection, LabelCollection::const_iterator> ConstIterator;
 
+            /// <summary>Labels in the order they are listed to the user</summary>
+            typedef vector<const ScriptLabel*>  SortedArray;
+
             // --------------------- CONSTRUCTION ----------------------
 
          public:
             LabelCollection()
             {}
 
-            DEFAULT_COPY(LabelCollection);	// Default copy semantics
-            DEFAULT_MOVE(LabelCollection);	// Default move semantics
+            /// <summary>Copies labels, sorting the copies</summary>
+            LabelCollection(const LabelCollection& r) : base(r)
+            {
+               Reindex();
+            }
+
+            /// <summary>Copies labels, sorting the copies</summary>
+            LabelCollection& operator=(const LabelCollection& r)
+            {
+               base::operator=(r);
+               Reindex();
+               return *this;
+            }
 
             // ------------------------ STATIC -------------------------
 
             // --------------------- PROPERTIES ------------------------
          public:
             PROPERTY_GET(size_type,Count,GetCount);
+            PROPERTY_GET(const SortedArray&,Sorted,GetSorted);
 
             // ---------------------- ACCESSORS ------------------------			
             
@@ -216,6 +247,13 @@ namespace Logic
                return base::size();
             }
 
+            /// <summary>Get labels sorted by name, case-insensitive</summary>
+            /// <returns></returns>
+            const SortedArray&  GetSorted() const
+            {
+               return SortedLabels;
+            }
+
             /// <summary>Get label by name</summary>
             /// <param name="name">name without ':' operator</param>
             /// <returns></returns>
@@ -257,18 +295,42 @@ namespace Logic
             /// <returns>True if inserted, False if already present</returns>
             bool  Add(const wstring& name, UINT line)
             {
-               return insert( value_type(name, ScriptLabel(name, line)) ).second;
+               auto res = insert( value_type(name, ScriptLabel(name, line)) );
+
+               // Insert into sorted labels
+               if (res.second)
+                  SortedLabels.insert(upper_bound(SortedLabels.begin(), SortedLabels.end(), &res.first->second, byName), &res.first->second);
+
+               return res.second;
             }
 
             /// <summary>Clears all labels</summary>
             void  clear()
             {
+               SortedLabels.clear();
                base::clear();
             }
 
+         private:
+            /// <summary>Orders labels by name</summary>
+            static bool  byName(const ScriptLabel* a, const ScriptLabel* b)
+            {
+               return CompareNames(a->Name, b->Name);
+            }
+
+            /// <summary>Sorts all labels</summary>
+            void  Reindex()
+            {
+               SortedLabels.clear();
+               for (auto& l : *this)
+                  SortedLabels.push_back(&l);
+               sort(SortedLabels.begin(), SortedLabels.end(), byName);
+            }
+
             // -------------------- REPRESENTATION ---------------------
 
          private:
+            SortedArray  SortedLabels;    // Labels sorted by name, maintained as labels are added
          };
 
          /// <summary></summary>
@@ -276,20 +338,35 @@ namespace Logic
          {
             // ------------------------ TYPES --------------------------
          private:
-            typedef pair<const wstring,ScriptVariable>  element;
+            typedef pair<const wstring,ScriptVariable>           element;
+            typedef map<wstring, ScriptVariable, less<wstring>>  base;
 
          public:
             typedef MapIterator<ScriptVariable, VariableCollection, VariableCollection::iterator>              VarIterator;
             typedef MapIterator<const ScriptVariable, VariableCollection, VariableCollection::const_iterator>  ConstIterator;
 
+            /// <summary>Arguments and variables in the order they are listed to the user</summary>
+            typedef vector<const ScriptVariable*>  SortedArray;
+
             // --------------------- CONSTRUCTION ----------------------
 
          public:
             VariableCollection()
             {}
 
-            DEFAULT_COPY(VariableCollection);	// Default copy semantics
-            DEFAULT_MOVE(VariableCollection);	// Default move semantics
+            /// <summary>Copies variables, sorting the copies</summary>
+            VariableCollection(const VariableCollection& r) : base(r)
+            {
+               Reindex();
+            }
+
+            /// <summary>Copies variables, sorting the copies</summary>
+            VariableCollection& operator=(const VariableCollection& r)
+            {
+               base::operator=(r);
+               Reindex();
+               return *this;
+            }
 
             // ------------------------ STATIC -------------------------
 
@@ -298,6 +375,7 @@ namespace Logic
             PROPERTY_GET(VariableArray,All,GetAll);
             PROPERTY_GET(VariableArray,Arguments,GetArguments);
             PROPERTY_GET(size_type,Count,GetCount);
+            PROPERTY_GET(const SortedArray&,Sorted,GetSorted);
             
             // ---------------------- ACCESSORS ------------------------			
          public:
@@ -331,6 +409,13 @@ namespace Logic
             { 
                return __super::size(); 
             }
+
+            /// <summary>Get arguments and variables sorted by name, case-insensitive</summary>
+            /// <returns></returns>
+            const SortedArray&  GetSorted() const
+            {
+               return SortedVariables;
+            }
             
             /// <summary>Get arguments and variables</summary>
             /// <returns></returns>
@@ -389,12 +474,21 @@ namespace Logic
             ScriptVariable& Add(const wstring& name)
             {
                auto res = insert( value_type(name, ScriptVariable(name, GetNextID())) );
+
+               // Insert into sorted variables
+               if (res.second)
+                  SortedVariables.insert(upper_bound(SortedVariables.begin(), SortedVariables.end(), &res.first->second, byName), &res.first->second);
+
                return res.first->second;
             }
 
             /// <summary>Clears all variables, but leaves arguments</summary>
             void  clear()
             {
+               // Remove from sorted variables, preserving order of arguments
+               auto isVariable = [](const ScriptVariable* v) {return v->Type == VariableType::Variable;};
+               SortedVariables.erase(remove_if(SortedVariables.begin(), SortedVariables.end(), isVariable), SortedVariables.end());
+
                // Remove all variables
                for (iterator it = __super::begin(); it != __super::end(); )
                   if (it->second.Type == VariableType::Variable)
@@ -478,11 +572,29 @@ namespace Logic
                   v.ID = id++;
                   insert(value_type(v.Name, v));
                }
+
+               Reindex();
+            }
+
+            /// <summary>Orders variables by name</summary>
+            static bool  byName(const ScriptVariable* a, const ScriptVariable* b)
+            {
+               return CompareNames(a->Name, b->Name);
+            }
+
+            /// <summary>Sorts all arguments and variables</summary>
+            void  Reindex()
+            {
+               SortedVariables.clear();
+               for (auto& v : *this)
+                  SortedVariables.push_back(&v);
+               sort(SortedVariables.begin(), SortedVariables.end(), byName);
             }
 
             // -------------------- REPRESENTATION ---------------------
 
          private:
+            SortedArray  SortedVariables;    // Arguments and variables sorted by name, maintained as they are added/removed
          };
 
          /// <summary></summary>
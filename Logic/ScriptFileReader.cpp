@@ -6,6 +6,7 @@
 #include "XFileSystem.h"
 #include "PreferencesLibrary.h"
 #include "SyntaxLibrary.h"
+#include "GameDataSet.h"
 
 namespace Logic
 {
@@ -17,14 +18,19 @@ namespace Logic
       /// <param name="src">The input stream</param>
       /// <exception cref="Logic::ArgumentException">Stream is not readable</exception>
       /// <exception cref="Logic::ArgumentNullException">Stream is null</exception>
-      /// <exception cref="Logic::ComException">COM Error</exception>
-      ScriptFileReader::ScriptFileReader(StreamPtr in) : ScriptValueReader(in)
+      ScriptFileReader::ScriptFileReader(StreamPtr in) : Input(in)
       {
+         REQUIRED(in);
+
+         // Ensure stream has read access
+         if (!Input->CanRead())
+            throw ArgumentException(HERE, L"in", GuiString(ERR_NO_READ_ACCESS));
       }
 
-      /// <summary>Nothing</summary>
+      /// <summary>Closes the input stream</summary>
       ScriptFileReader::~ScriptFileReader()
       {
+         Input->SafeClose();
       }
       
       /// <summary>Resolves the path of a script-call. If script cannot found the path is empty</summary>
@@ -93,123 +99,153 @@ namespace Logic
 
       // ------------------------------- PUBLIC METHODS -------------------------------
 
-      /// <summary>Reads the entire script file</summary>
+      /// <summary>Reads the entire script file, or just its signature</summary>
       /// <param name="path">Full file path</param>
-      /// <param name="justProperties">True for properties only, False for commands</param>
+      /// <param name="justProperties">True for properties, arguments and command ID only, False for commands.  Command branches are then scanned without being decoded, and reading stops at the command ID</param>
       /// <param name="rawTranslate">Whether to preserve script exactly - retain JMP commands and skip macro insertion</param>
       /// <returns>New script file</returns>
-      /// <exception cref="Logic::ArgumentNullException">Missing node</exception>
-      /// <exception cref="Logic::ComException">COM Error</exception>
+      /// <remarks>Commands are decoded using the resident game data for the game named in the header, without activating it</remarks>
       /// <exception cref="Logic::FileFormatException">Corrupt XML / Missing elements / missing attributes</exception>
       /// <exception cref="Logic::InvalidValueException">Invalid script command</exception>
       /// <exception cref="Logic::InvalidOperationException">Invalid goto/gosub command</exception>
       /// <exception cref="Logic::IOException">An I/O error occurred</exception>
       ScriptFile ScriptFileReader::ReadFile(Path path, bool justProperties, bool rawTranslate /*= false*/)
       {
-         try
-         {
-            ScriptFile file(path);
+         ScriptFile       file(path);
+         CommandArray     std, aux;
+         VariablePtrArray vars;
 
-            // Read file
-            LoadDocument();
+         // Read file
+         LoadDocument();
 
-            // Read properties
-            file.Name        = ReadString(CodeArray, 0, L"script name");
-            file.Game        = EngineVersionConverter::ToGame(ReadInt(CodeArray, 1, L"script engine version"));
-            file.Description = ReadString(CodeArray, 2, L"script description");
-            file.Version     = (UINT)ReadInt(CodeArray, 3, L"script version");
-            file.LiveData    = (UINT)ReadInt(CodeArray, 4, L"script live data flag") != 0;
+         // Read properties
+         file.Name        = ReadString(L"script name");
+         file.Game        = EngineVersionConverter::ToGame(ReadInt(L"script engine version"));
+         file.Description = ReadString(L"script description");
+         file.Version     = (UINT)ReadInt(L"script version");
+         file.LiveData    = (UINT)ReadInt(L"script live data flag") != 0;
 
-            // Arguments/Variables
-            ReadVariables(file, GetChild(CodeArray, 5, L"variables branch"), GetChild(CodeArray, 7, L"codearray arguments branch")); 
+         // Decode using the game data of the script's game, if resident
+         GameDataSet::Scope game(GameDataSet::Find(file.Game));
 
-            // Commands
-            if (!justProperties)
-               ReadCommands(file, GetChild(CodeArray, 6, L"standard commands branch"), GetChild(CodeArray, 8, L"auxiliary commands branch"), rawTranslate);
+         // Read branches in document order: Variables, Standard commands, Arguments, Auxiliary commands
+         ReadVariables(file, vars);
 
-            // Command ID
-            file.CommandID = ReadValue(CodeArray, 9, L"script command ID");
+         if (!justProperties)
+            ReadCommands(file, CommandType::Standard, std);
+         else
+            Skip(L"standard commands branch");
+
+         ReadArguments(vars);
 
-            // Return file
+         if (!justProperties)
+            ReadCommands(file, CommandType::Auxiliary, aux);
+         else
+            Skip(L"auxiliary commands branch");
+
+         // Command ID
+         file.CommandID = ReadValue(L"script command ID");
+
+         // Properties: Abandon remainder of input
+         if (justProperties)
             return file;
-         }
-         catch (_com_error& ex) {
-            throw ComException(HERE, ex);
-         }
+
+         // Commands
+         EndArray();
+         TranslateCommands(file, std, aux, rawTranslate);
+
+         // Return file
+         return file;
       }
 
 		// ------------------------------ PROTECTED METHODS -----------------------------
 
+      /// <summary>Enters the codearray branch.  The input stream is decoded incrementally, as it is read</summary>
+      /// <exception cref="Logic::FileFormatException">File is empty / Missing or invalid codearray node</exception>
+      /// <exception cref="Logic::IOException">An I/O error occurred</exception>
+      void  ScriptFileReader::LoadDocument()
+      {
+         // Sanity check
+         if (!Input->GetLength())
+            throw FileFormatException(HERE, L"The file is empty");
+
+         // Locate codearray, verify size
+         Load(Input);
+         if (ReadArray(L"codearray branch") != 10)
+            throw FileFormatException(HERE, L"Invalid codearray node");
+      }
+
 		// ------------------------------- PRIVATE METHODS ------------------------------
       
-      /// <summary>Gets an appropriate reader for a given command</summary>
+      /// <summary>Reads a standard or auxiliary commands branch</summary>
       /// <param name="script">The script.</param>
-      /// <param name="type">The type of command</param>
-      /// <param name="cmdBranch">The branch containing the command</param>
-      /// <returns>Appropriate command reader</returns>
-      /// <exception cref="Logic::ArgumentNullException">Missing node</exception>
+      /// <param name="type">The type of commands</param>
+      /// <param name="commands">On return, contains the commands</param>
       /// <exception cref="Logic::FileFormatException">Invalid file format</exception>
-      /// <exception cref="Logic::ComException">COM Error</exception>
-      ScriptFileReader::ReaderPtr  ScriptFileReader::GetCommandReader(ScriptFile& script, CommandType type, XmlNodePtr& cmdBranch)
+      /// <exception cref="Logic::InvalidValueException">Invalid script command</exception>
+      void  ScriptFileReader::ReadCommands(ScriptFile& script, CommandType type, CommandArray& commands)
       {
-         // Verify node is an array
-         //int size = ReadArray(cmdBranch, L"script command branch");
+         // Create readers once. Each reads the current command from the shared value array
+         AuxiliaryCommandReader   auxiliary(script, Values);
+         CommentedCommandReader   commented(script, Values);
+         ScriptCallCommandReader  scriptCall(script, Values);
+         ExpressionCommandReader  expression(script, Values);
+         StandardCommandReader    standard(script, Values);
+
+         const wchar* help = (type == CommandType::Standard ? L"standard command" : L"auxiliary command");
+         UINT         index = (type == CommandType::Standard ? 0 : 1);
+
+         // Read commands
+         ReadArray(type == CommandType::Standard ? L"standard commands branch" : L"auxiliary commands branch");
+         while (HasNext())
+         {
+            ScriptCommandReader* reader;
+            ReadValues(Values, help);
 
-         // Examine command ID (from first/second node)
-         int id = ReadInt(cmdBranch, (type == CommandType::Standard ? 0 : 1), L"script command ID");
+            // Examine command ID (from first/second node)
+            if (index >= Values.size())
+               throw FileFormatException(HERE, VString(L"Cannot read script command ID from node %d of %d", index+1, Values.size()));
 
-         // Create appropriate reader
-         switch (id)
-         {
-         // Simple Auxiliary: 
-         case CMD_ELSE:
-         case CMD_BREAK:
-         case CMD_CONTINUE:
-         case CMD_END:
-         case CMD_NOP:
-         case CMD_COMMENT:           return ReaderPtr(new AuxiliaryCommandReader(*this, script, cmdBranch));
-
-         case CMD_COMMAND_COMMENT:   return ReaderPtr(new CommentedCommandReader(*this, script, cmdBranch));
-         case CMD_CALL_SCRIPT:       return ReaderPtr(new ScriptCallCommandReader(*this, script, cmdBranch));
-         case CMD_EXPRESSION:        return ReaderPtr(new ExpressionCommandReader(*this, script, cmdBranch));
-
-         default:                    return ReaderPtr(new StandardCommandReader(*this, script, cmdBranch));
+            // Choose appropriate reader
+            switch (ToInt(Values[index], L"script command ID"))
+            {
+            // Simple Auxiliary: 
+            case CMD_ELSE:
+            case CMD_BREAK:
+            case CMD_CONTINUE:
+            case CMD_END:
+            case CMD_NOP:
+            case CMD_COMMENT:           reader = &auxiliary;   break;
+
+            case CMD_COMMAND_COMMENT:   reader = &commented;   break;
+            case CMD_CALL_SCRIPT:       reader = &scriptCall;  break;
+            case CMD_EXPRESSION:        reader = &expression;  break;
+
+            default:                    reader = &standard;    break;
+            }
+
+            commands.push_back(reader->Reset().ReadCommand());
          }
+         EndArray();
       }
 
-      
-      /// <summary>Reads both the standard and auxiliary commands, then interlaces them in the correct order</summary>
+      /// <summary>Interlaces the standard and auxiliary commands in the correct order, then translates them</summary>
       /// <param name="script">The script.</param>
-      /// <param name="stdBranch">The standard commands branch.</param>
-      /// <param name="auxBranch">The auxiliary commands branch.</param>
+      /// <param name="std">The standard commands.</param>
+      /// <param name="aux">The auxiliary commands.</param>
       /// <param name="rawTranslate">Whether to preserve script exactly - retain JMP commands and skip macro insertion</param>
-      /// <exception cref="Logic::ArgumentNullException">Missing node</exception>
-      /// <exception cref="Logic::FileFormatException">Invalid file format</exception>
       /// <exception cref="Logic::InvalidOperationException">Invalid goto/gosub command</exception>
       /// <exception cref="Logic::InvalidValueException">Invalid goto/gosub command</exception>
-      /// <exception cref="Logic::ComException">COM Error</exception>
-      void  ScriptFileReader::ReadCommands(ScriptFile&  script, XmlNodePtr& stdBranch, XmlNodePtr& auxBranch, bool rawTranslate)
+      void  ScriptFileReader::TranslateCommands(ScriptFile& script, CommandArray& std, CommandArray& aux, bool rawTranslate)
       {
-         CommandArray  std;
-         CommandList   aux; 
-
-         // Read standard commands
-         for (int i = 0; i < stdBranch->childNodes->length; i++)
-            std.push_back( GetCommandReader(script, CommandType::Standard, GetChild(stdBranch, i, L"standard command"))->ReadCommand() );
-
-         // Read auxiliary commands
-         for (int i = 0; i < auxBranch->childNodes->length; i++)
-            aux.push_back( GetCommandReader(script, CommandType::Auxiliary, GetChild(auxBranch, i, L"auxiliary command"))->ReadCommand() );
+         auto nextAux = aux.begin();
 
          // Interlace in correct order
          for (UINT i = 0; i < std.size(); i++)
          {
             // Insert any/all auxiliary commands preceeding next standard command
-            while (!aux.empty() && aux.front().RefIndex <= i)
-            {
-               script.Commands.AddInput(aux.front());
-               aux.pop_front();
-            }
+            for (; nextAux != aux.end() && nextAux->RefIndex <= i; ++nextAux)
+               script.Commands.AddInput(*nextAux);
 
             // Drop/Keep JMP commands
             if (rawTranslate || !std[i].Syntax.Is(CMD_HIDDEN_JUMP))
@@ -217,8 +253,8 @@ namespace Logic
                script.Commands.AddInput(std[i]);
          }
          // Insert any trailing comments
-         for (auto& c : aux)
-            script.Commands.AddInput(c);
+         for (; nextAux != aux.end(); ++nextAux)
+            script.Commands.AddInput(*nextAux);
 
 
          // Translate all commands/parameters
@@ -499,34 +535,41 @@ namespace Logic
       }
 
 
+      /// <summary>Reads the arguments codearray branch</summary>
+      /// <param name="vars">The variables, in branch order.</param>
+      /// <exception cref="Logic::FileFormatException">Invalid file format</exception>
+      void  ScriptFileReader::ReadArguments(const VariablePtrArray& vars)
+      {
+         ReadArray(L"codearray arguments branch");
+
+         // Argument: Read extra properties of matching variable
+         for (UINT i = 0; i < vars.size() && HasNext(); i++)
+         {
+            ScriptVariable& var = *vars[i];
+
+            ReadArray(L"script argument branch");
+            var.Type = VariableType::Argument;
+            var.ParamType = (ParameterType)ReadInt(L"script argument type");
+            var.Description = ReadString(L"script argument description");
+            EndArray();
+         }
+
+         EndArray();
+      }
+
       /// <summary>Reads the variables codearray branch</summary>
       /// <param name="script">The script.</param>
-      /// <param name="varBranch">The variable branch.</param>
-      /// <param name="argBranch">The argument branch.</param>
-      /// <exception cref="Logic::ArgumentNullException">Missing node</exception>
+      /// <param name="vars">On return, contains the variables in branch order.</param>
       /// <exception cref="Logic::FileFormatException">Invalid file format</exception>
-      /// <exception cref="Logic::ComException">COM Error</exception>
-      void  ScriptFileReader::ReadVariables(ScriptFile&  script, XmlNodePtr& varBranch, XmlNodePtr& argBranch)
+      void  ScriptFileReader::ReadVariables(ScriptFile& script, VariablePtrArray& vars)
       {
-         wstring name;
+         ReadArray(L"variables branch");
 
          // Read ScriptVariables from {name,id} pair
-         for (int i = 0; i < varBranch->childNodes->length; i++)
-         {
-            // Variable
-            name = ReadString(varBranch, i, L"script variable name");
-            ScriptVariable& var = script.Variables.Add(name);
-
-            // Argument: Read extra properties
-            if (i < argBranch->childNodes->length)
-            {
-               XmlNodePtr arg = GetChild(argBranch, i, L"script argument branch");
+         while (HasNext())
+            vars.push_back(&script.Variables.Add(ReadString(L"script variable name")));
 
-               var.Type = VariableType::Argument;
-               var.ParamType = (ParameterType)ReadInt(arg, 0, L"script argument type");
-               var.Description = ReadString(arg, 1, L"script argument description");
-            }
-         }
+         EndArray();
       }
 
    }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "XmlReader.h"
+#include "CodeArrayReader.h"
 #include "ScriptFile.h"
 
 namespace Logic
@@ -71,20 +72,29 @@ namespace Logic
       };
 
       /// <summary>Reader for MSCI scripts</summary>
-      class LogicExport ScriptFileReader : protected ScriptValueReader
+      /// <remarks>The codearray is read in a single forward-only pass, without building a document</remarks>
+      class LogicExport ScriptFileReader : protected CodeArrayReader
       {
       protected:
          /// <summary>Base class LogicExport for MSCI script command readers</summary>
+         /// <remarks>Each reader is created once per branch and reused for every command, which are read into a shared value array</remarks>
          class LogicExport ScriptCommandReader
          {
             // --------------------- CONSTRUCTION ----------------------
          protected:
-            ScriptCommandReader(ScriptFileReader& r, ScriptFile& s, XmlNodePtr& cmd) : Reader(r), Script(s), Command(cmd), NodeIndex(0) {}
+            ScriptCommandReader(ScriptFile& s, const ScriptValueArray& cmd) : Script(s), Command(cmd), NodeIndex(0) {}
          
             // ----------------------- MUTATORS ------------------------
          public:
             virtual ScriptCommand  ReadCommand() PURE;
 
+            /// <summary>Rewinds to the first value of the current command</summary>
+            ScriptCommandReader&  Reset() 
+            { 
+               NodeIndex = 0; 
+               return *this; 
+            }
+
          protected:
             wstring         ReadStringNode(const wchar* help);
             int             ReadIntNode(const wchar* help);
@@ -93,14 +103,16 @@ namespace Logic
 
             ScriptParameter ReadParameter(ParameterSyntax s, const wchar* help);
 
+         private:
+            const ScriptValue&  ReadNode(const wchar* help);
+
             // -------------------- REPRESENTATION ---------------------
          protected:
-            ScriptFileReader&  Reader;
-            ScriptFile&        Script;
-            XmlNodePtr&        Command;
+            ScriptFile&              Script;
+            const ScriptValueArray&  Command;
 
          private:
-            int   NodeIndex;
+            UINT  NodeIndex;
          };
 
          /// <summary>Reads typical auxiliary commands</summary>
@@ -108,7 +120,7 @@ namespace Logic
          {
             // --------------------- CONSTRUCTION ----------------------
          public:
-            AuxiliaryCommandReader(ScriptFileReader& r, ScriptFile& s, XmlNodePtr& cmd) : ScriptCommandReader(r, s, cmd) {}
+            AuxiliaryCommandReader(ScriptFile& s, const ScriptValueArray& cmd) : ScriptCommandReader(s, cmd) {}
 
             // ----------------------- MUTATORS ------------------------
 
@@ -120,7 +132,7 @@ namespace Logic
          {
             // --------------------- CONSTRUCTION ----------------------
          public:
-            CommentedCommandReader(ScriptFileReader& r, ScriptFile& s, XmlNodePtr& cmd) : ScriptCommandReader(r, s, cmd) {}
+            CommentedCommandReader(ScriptFile& s, const ScriptValueArray& cmd) : ScriptCommandReader(s, cmd) {}
 
             // ----------------------- MUTATORS ------------------------
 
@@ -132,7 +144,7 @@ namespace Logic
          {
             // --------------------- CONSTRUCTION ----------------------
          public:
-            ScriptCallCommandReader(ScriptFileReader& r, ScriptFile& s, XmlNodePtr& cmd) : ScriptCommandReader(r, s, cmd) {}
+            ScriptCallCommandReader(ScriptFile& s, const ScriptValueArray& cmd) : ScriptCommandReader(s, cmd) {}
 
             // ----------------------- MUTATORS ------------------------
 
@@ -144,7 +156,7 @@ namespace Logic
          {
             // --------------------- CONSTRUCTION ----------------------
          public:
-            ExpressionCommandReader(ScriptFileReader& r, ScriptFile& s, XmlNodePtr& cmd) : ScriptCommandReader(r, s, cmd) {}
+            ExpressionCommandReader(ScriptFile& s, const ScriptValueArray& cmd) : ScriptCommandReader(s, cmd) {}
 
             // ----------------------- MUTATORS ------------------------
 
@@ -156,22 +168,24 @@ namespace Logic
          {
             // --------------------- CONSTRUCTION ----------------------
          public:
-            StandardCommandReader(ScriptFileReader& r, ScriptFile& s, XmlNodePtr& cmd) : ScriptCommandReader(r, s, cmd) {}
+            StandardCommandReader(ScriptFile& s, const ScriptValueArray& cmd) : ScriptCommandReader(s, cmd) {}
 
             // ----------------------- MUTATORS ------------------------
 
             ScriptCommand  ReadCommand();
          };
 
-      protected:
-         /// <summary>Unique command reader pointer</summary>
-         typedef unique_ptr<ScriptCommandReader>  ReaderPtr;
+         /// <summary>Vector of script variables, in ID order</summary>
+         typedef vector<ScriptVariable*>  VariablePtrArray;
 
          // --------------------- CONSTRUCTION ----------------------
       public:
          ScriptFileReader(StreamPtr in);
          virtual ~ScriptFileReader();
 
+         NO_COPY(ScriptFileReader);	// No copy semantics
+         NO_MOVE(ScriptFileReader);	// No move semantics
+
          // ------------------------ STATIC -------------------------
       public:
          static ScriptFile  ReadExternalScript(Path folder, const wstring& script, bool silent = true);
@@ -192,14 +206,17 @@ namespace Logic
          ScriptFile  ReadFile(Path path, bool justProperties, bool rawTranslate = false);
 
       protected:
-         ReaderPtr GetCommandReader(ScriptFile& script, CommandType type, XmlNodePtr& cmdBranch);
-         void      ReadCommands(ScriptFile&  script, XmlNodePtr& stdBranch, XmlNodePtr& auxBranch, bool rawTranslate);
-         void      ReadVariables(ScriptFile&  script, XmlNodePtr& varBranch, XmlNodePtr& argBranch);
+         void      LoadDocument();
+         void      ReadArguments(const VariablePtrArray& vars);
+         void      ReadCommands(ScriptFile& script, CommandType type, CommandArray& commands);
+         void      ReadVariables(ScriptFile& script, VariablePtrArray& vars);
+         void      TranslateCommands(ScriptFile& script, CommandArray& std, CommandArray& aux, bool rawTranslate);
          void      TranslateMacros(ScriptFile& script);
 
 		   // -------------------- REPRESENTATION ---------------------
       protected:
-
+         StreamPtr         Input;      // Input stream
+         ScriptValueArray  Values;     // Values of the command being read
       };
 
       
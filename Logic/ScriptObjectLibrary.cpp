@@ -1,5 +1,7 @@
 #include "stdafx.h"
 #include "ScriptObjectLibrary.h"
+#include "GameDataSet.h"
+#include "Profiler.h"
 
 
 namespace Logic
@@ -8,6 +10,9 @@ namespace Logic
    {
       ScriptObjectLibrary  ScriptObjectLibrary::Instance;
 
+      /// <summary>Library of the active game data set, or the default instance if none</summary>
+      ScriptObjectLibrary*  ScriptObjectLibrary::Active = &ScriptObjectLibrary::Instance;
+
       // -------------------------------- CONSTRUCTION --------------------------------
 
       ScriptObjectLibrary::ScriptObjectLibrary()
@@ -21,6 +26,14 @@ namespace Logic
 
       // ------------------------------- STATIC METHODS -------------------------------
 
+      /// <summary>Gets the library of the game data set in scope upon the calling thread, otherwise the active set</summary>
+      /// <returns></returns>
+      ScriptObjectLibrary&  ScriptObjectLibrary::GetCurrent()
+      {
+         auto set = GameDataSet::GetScoped();
+         return set ? set->ScriptObjects : *Active;
+      }
+
       
       // ------------------------------- PUBLIC METHODS -------------------------------
 
@@ -69,6 +82,7 @@ namespace Logic
       /// <exception cref="Logic::InvalidOperationException">String library is empty</exception>
       UINT  ScriptObjectLibrary::Enumerate(WorkerData* data)
       {
+         PROFILE_FUNCTION();
          REQUIRED(data);
 
          // Ensure string library exists
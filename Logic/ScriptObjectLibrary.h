@@ -188,6 +188,8 @@ namespace Logic
 		   DEFAULT_MOVE(ScriptObjectLibrary);	// Default move semantics
 
          // ------------------------ STATIC -------------------------
+      public:
+         static ScriptObjectLibrary&  GetCurrent();
 
          // --------------------- PROPERTIES ------------------------
 			
@@ -224,6 +226,7 @@ namespace Logic
          // -------------------- REPRESENTATION ---------------------
       public:
          static ScriptObjectLibrary  Instance;
+         static ScriptObjectLibrary* Active;
          
       private:
          ObjectCollection  Objects;
@@ -231,8 +234,8 @@ namespace Logic
       };
    }
 
-   /// <summary>Access to the script object library singleton</summary>
-   #define ScriptObjectLib  ScriptObjectLibrary::Instance
+   /// <summary>Access to the script object library of the game data set in scope, otherwise the active set</summary>
+   #define ScriptObjectLib  (ScriptObjectLibrary::GetCurrent())
 }
 
 using namespace Logic::Scripts;
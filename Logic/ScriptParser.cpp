@@ -6,6 +6,7 @@
 #include "SyntaxLibrary.h"
 #include "CommandHash.h"
 #include "ScriptFile.h"
+#include "Profiler.h"
 
 /// <summary>Prints the parse tree post-verification and post-compilation</summary>
 //#define DEBUG_PRINT
@@ -21,12 +22,15 @@ namespace Logic
          /// <summary>Creates a parser for an entire script</summary>
          /// <param name="file">Script</param>
          /// <param name="lines">The lines to parse</param>
-         /// <param name="v">The game version</param>
+         /// <param name="v">The game version, whose resident game data is used to parse the script</param>
          /// <exception cref="Logic::ArgumentException">Line array is empty</exception>
          /// <exception cref="Logic::AlgorithmException">Error in parsing algorithm</exception>
          ScriptParser::ScriptParser(ScriptFile& file, const LineArray& lines, GameVersion  v) 
-            : Input(lines), Version(v), Script(file)
+            : Input(lines), Version(v), Script(file), GameData(GameDataSet::Find(v)), Arena(new MemoryArena()), Tree(Arena)
          {
+            PROFILE_ZONE("ScriptParser::Parse");
+            GameDataSet::Scope game(GameData);
+
             if (lines.size() == 0)
                throw ArgumentException(HERE, L"lines", L"Line count cannot be zero");
 
@@ -103,9 +107,9 @@ namespace Logic
 
                // Generate command
                if (!node->Is(CMD_EXPRESSION))
-                  return ScriptCommand(node->LineText, node->Syntax, node->Parameters, node->CmdComment);
+                  return ScriptCommand(node->LineText.c_str(), node->Syntax, node->Parameters, node->CmdComment);
                else
-                  return ScriptCommand(node->LineText, node->Syntax, node->Parameters, node->Postfix, node->CmdComment);
+                  return ScriptCommand(node->LineText.c_str(), node->Syntax, node->Parameters, node->Postfix, node->CmdComment);
             }
             catch (ExceptionBase& e) {
                Console.Log(HERE, e);
@@ -137,6 +141,9 @@ namespace Logic
          /// <exception cref="Logic::InvalidOperationException">Script contains errors</exception>
          void  ScriptParser::Compile()
          {
+            PROFILE_FUNCTION();
+            GameDataSet::Scope game(GameData);
+
             // Ensure error free
             if (!Errors.empty())
                throw InvalidOperationException(HERE, L"Cannot compile a script with errors");
@@ -639,12 +646,12 @@ namespace Logic
          /// <returns>New NOP/Comment/CmdComment command node</returns>
          CommandNodePtr ScriptParser::ReadComment(const CommandLexer& lex)
          {
-            ParameterArray params;
+            ParameterArray params(*Arena);
             CommandNodePtr node;
 
             // NOP: No processing required
             if (lex.count() == 0)
-               return new CommandNode(Conditional::NONE, SyntaxLib.Find(CMD_NOP, Version), params, lex, LineNumber, false);
+               return CommandNode::Create(*Arena, Conditional::NONE, SyntaxLib.Find(CMD_NOP, Version), params, lex, LineNumber, false);
 
             // Re-lex line without the '*' operator
             CommentLexer lex2(lex.Input);
@@ -664,7 +671,7 @@ namespace Logic
             params += ScriptParameter(syntax.Parameters[0], lex.count()==2 ? lex.Tokens[1] : ScriptToken(TokenType::Comment, 1,1, L""));
 
             // Return comment
-            return new CommandNode(Conditional::NONE, syntax, params, lex, LineNumber, false);
+            return CommandNode::Create(*Arena, Conditional::NONE, syntax, params, lex, LineNumber, false);
          }
 
          /// <summary>Reads an entire non-expression command</summary>
@@ -701,7 +708,7 @@ namespace Logic
             // Match remaining tokens against a command
             TokenList tokens;
             CommandSyntaxRef syntax = SyntaxLib.Identify(pos, lex.end(), Version, tokens);  
-            ParameterArray params;
+            ParameterArray params(*Arena);
             
             // Unrecognised: Highlight offending token / entire line
             if (syntax == CommandSyntax::Unrecognised)
@@ -786,7 +793,7 @@ namespace Logic
             }
 
             // Return new command / commented-command
-            return new CommandNode(condition, syntax, params, lex, LineNumber, comment);
+            return CommandNode::Create(*Arena, condition, syntax, params, lex, LineNumber, comment);
          }
 
          /// <summary>Reads an entire expression command</summary>
@@ -808,8 +815,8 @@ namespace Logic
             ErrorArray&    errQueue = (comment ? CommentErrors : Errors);  // Set appropriate error queue
             Conditional    condition = Conditional::DISCARD;
             TokenIterator  pos = lex.begin();
-            ParameterArray params, 
-                           postfix;
+            ParameterArray params(*Arena), 
+                           postfix(*Arena);
             
             // Lookup syntax
             CommandSyntaxRef syntax = SyntaxLib.Find(CMD_EXPRESSION, Version);
@@ -851,7 +858,7 @@ namespace Logic
             }
 
             // Return new expression / commented-expression
-            return new CommandNode(condition, syntax, params, postfix, lex, LineNumber, comment);
+            return CommandNode::Create(*Arena, condition, syntax, params, postfix, lex, LineNumber, comment);
          }
          
          
@@ -898,8 +905,9 @@ namespace Logic
             else
             {
                // UNRECOGNISED: Generate empty node
+               ParameterArray none(*Arena);
                Errors += MakeError(L"Unable to parse command", lex);
-               node = new CommandNode(Conditional::NONE, CommandSyntax::Unrecognised, ParameterArray(), lex, LineNumber, false);
+               node = CommandNode::Create(*Arena, Conditional::NONE, CommandSyntax::Unrecognised, none, lex, LineNumber, false);
             }
 
             // Consume line + return node
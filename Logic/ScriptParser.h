@@ -1,6 +1,7 @@
 #pragma once
 
 #include "CommandTree.h"
+#include "GameDataSet.h"
 #include <algorithm>
 
 namespace Testing
@@ -115,7 +116,9 @@ namespace Logic
          protected:
             const LineArray&  Input;         // Input text
             const GameVersion Version;       // Script version
+            GameDataSetPtr    GameData;      // Game data for the script version, or nullptr to use the active set
 
+            MemoryArenaPtr  Arena;           // Storage for parsed nodes, their parameters and text.  Released with the last node
             CommandTree     Tree;            // Parse tree
             LineIterator    CurrentLine;     // Line being parsed
             CommandNodePtr  CurrentNode;     // Most recently parsed node
@@ -4,6 +4,7 @@
 #include "XFileInfo.h"
 #include "ScriptFileReader.h"
 #include "PreferencesLibrary.h"
+#include "Profiler.h"
 
 namespace Logic
 {
@@ -17,8 +18,10 @@ namespace Logic
       }
 
 
+      /// <summary>Aborts the operation if still running</summary>
       SearchWorker::~SearchWorker()
       {
+         Shutdown();
       }
 
       // ------------------------------- STATIC METHODS -------------------------------
@@ -41,7 +44,9 @@ namespace Logic
       /// <exception cref="Logic::InvalidOperationException">Target not project or script folder</exception>
       void  SearchWorker::BuildFileList(SearchWorkerData* data)
       {
-         XFileSystem vfs;
+         GameDataSetPtr  game = GameDataSet::GetActive();
+         XFileSystem     vfs;
+         XFileList       files;
 
          switch (data->Target)
          {
@@ -53,10 +58,17 @@ namespace Logic
 
          // ScriptFolder: Enumerate scripts
          case SearchTarget::ScriptFolder:
-            vfs.Enumerate(PrefsLib.GameDataFolder, PrefsLib.GameDataVersion);
+            // Use the file system of the active game data, if loaded from the game folder, otherwise enumerate
+            if (game && game->Loaded && game->Folder == PrefsLib.GameDataFolder && game->Version == PrefsLib.GameDataVersion)
+               files.splice(files.end(), game->FileSystem.Browse(XFolder::Scripts));
+            else
+            {
+               vfs.Enumerate(PrefsLib.GameDataFolder, PrefsLib.GameDataVersion);
+               files.splice(files.end(), vfs.Browse(XFolder::Scripts));
+            }
 
             // Use any XML/PCK file
-            for (auto& f : vfs.Browse(XFolder::Scripts))
+            for (auto& f : files)
                if (f.FullPath.HasExtension(L".pck") || f.FullPath.HasExtension(L".xml"))
                   data->Files.push_back( f.FullPath );
             break;
@@ -79,6 +91,9 @@ namespace Logic
       /// <returns></returns>
       DWORD WINAPI  SearchWorker::ThreadMain(SearchWorkerData* data)
       {
+         PROFILE_FUNCTION();
+         auto reading = move(data->Reading);    // Release game data upon exit
+
          try
          {
             HRESULT  hr;
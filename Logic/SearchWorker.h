@@ -1,6 +1,7 @@
 #pragma once
 
 #include "BackgroundWorker.h"
+#include "GameDataSet.h"
 #include "MatchData.h"
 #include "ProjectFile.h"
 
@@ -99,6 +100,7 @@ namespace Logic
          bool         Initialized;
          ProjectFile* Project;
          list<Path>   Files;
+         GameDataSet::ReadLockPtr  Reading;    // Held from Start until the thread exits
       };
 
       /// <summary>Worker thread for performing Find&Replace on script files that are not currently open as documents</summary>
@@ -135,9 +137,23 @@ namespace Logic
          {
             REQUIRED(param);
 
+            if (IsRunning())
+               throw InvalidOperationException(HERE, L"Thread already running");
+
+            // Prevent game data being switched until thread exits
+            param->Reading.reset(new GameDataSet::ReadLock);
+
             // Set command + Start.
             param->Command = cmd;
-            BackgroundWorker::Start(param);
+            try
+            {
+               BackgroundWorker::Start(param);
+            }
+            catch (ExceptionBase&)
+            {
+               param->Reading.reset();
+               throw;
+            }
          }
 
          // -------------------- REPRESENTATION ---------------------
@@ -0,0 +1,115 @@
+#pragma once
+
+namespace Logic
+{
+   namespace Utils
+   {
+
+      /// <summary>High resolution timer for measuring elapsed time</summary>
+      class Stopwatch
+      {
+         // ------------------------ TYPES --------------------------
+      protected:
+         // --------------------- CONSTRUCTION ----------------------
+      public:
+         /// <summary>Creates a stopwatch, optionally starting it</summary>
+         /// <param name="start">Whether to start immediately</param>
+         Stopwatch(bool start = true) : Running(false)
+         {
+            Frequency.QuadPart = Started.QuadPart = Elapsed.QuadPart = 0LL;
+            QueryPerformanceFrequency(&Frequency);
+
+            if (start)
+               Start();
+         }
+
+         DEFAULT_COPY(Stopwatch);	// Default copy semantics
+         DEFAULT_MOVE(Stopwatch);	// Default move semantics
+
+         // ------------------------ STATIC -------------------------
+      public:
+         /// <summary>Gets the current value of the performance counter</summary>
+         /// <returns></returns>
+         static LONGLONG  Now()
+         {
+            LARGE_INTEGER now;
+            QueryPerformanceCounter(&now);
+            return now.QuadPart;
+         }
+
+         // --------------------- PROPERTIES ------------------------
+      public:
+         PROPERTY_GET(double,ElapsedMilliseconds,GetElapsedMilliseconds);
+         PROPERTY_GET(LONGLONG,ElapsedTicks,GetElapsedTicks);
+
+         // ---------------------- ACCESSORS ------------------------
+      public:
+         /// <summary>Gets the total elapsed time in milliseconds</summary>
+         /// <returns></returns>
+         double  GetElapsedMilliseconds() const
+         {
+            return Frequency.QuadPart ? (GetElapsedTicks() * 1000.0) / Frequency.QuadPart : 0.0;
+         }
+
+         /// <summary>Gets the total elapsed time in performance counter ticks</summary>
+         /// <returns></returns>
+         LONGLONG  GetElapsedTicks() const
+         {
+            return Elapsed.QuadPart + (Running ? Now() - Started.QuadPart : 0LL);
+         }
+
+         /// <summary>Query whether stopwatch is running</summary>
+         /// <returns></returns>
+         bool  IsRunning() const
+         {
+            return Running;
+         }
+
+         // ----------------------- MUTATORS ------------------------
+      public:
+         /// <summary>Stops the stopwatch and clears the elapsed time</summary>
+         void  Reset()
+         {
+            Elapsed.QuadPart = 0LL;
+            Running = false;
+         }
+
+         /// <summary>Clears the elapsed time and starts the stopwatch</summary>
+         void  Restart()
+         {
+            Reset();
+            Start();
+         }
+
+         /// <summary>Starts or resumes measuring elapsed time</summary>
+         void  Start()
+         {
+            if (!Running)
+            {
+               Started.QuadPart = Now();
+               Running = true;
+            }
+         }
+
+         /// <summary>Stops measuring elapsed time</summary>
+         void  Stop()
+         {
+            if (Running)
+            {
+               Elapsed.QuadPart += Now() - Started.QuadPart;
+               Running = false;
+            }
+         }
+
+         // -------------------- REPRESENTATION ---------------------
+      protected:
+         LARGE_INTEGER  Frequency,     // Counter frequency
+                        Started,       // Counter value when last started
+                        Elapsed;       // Accumulated ticks
+         bool           Running;       // Whether running
+      };
+
+   }
+}
+
+using namespace Logic::Utils;
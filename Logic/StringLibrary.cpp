@@ -1,8 +1,10 @@
 #include "stdafx.h"
 #include "StringLibrary.h"
+#include "GameDataSet.h"
 #include "LanguageFileReader.h"
 #include "StringResolver.h"
 #include "PreferencesLibrary.h"
+#include "Profiler.h"
 
 namespace Logic
 {
@@ -10,6 +12,9 @@ namespace Logic
    {
       StringLibrary  StringLibrary::Instance;
 
+      /// <summary>Library of the active game data set, or the default instance if none</summary>
+      StringLibrary*  StringLibrary::Active = &StringLibrary::Instance;
+
       // -------------------------------- CONSTRUCTION --------------------------------
 
       StringLibrary::StringLibrary()
@@ -23,6 +28,14 @@ namespace Logic
 
       // ------------------------------- STATIC METHODS -------------------------------
 
+      /// <summary>Gets the library of the game data set in scope upon the calling thread, otherwise the active set</summary>
+      /// <returns></returns>
+      StringLibrary&  StringLibrary::GetCurrent()
+      {
+         auto set = GameDataSet::GetScoped();
+         return set ? set->Strings : *Active;
+      }
+
       // ------------------------------- PUBLIC METHODS -------------------------------
 
       /// <summary>Populates the library with all the language files in the 't' subfolder</summary>
@@ -32,7 +45,9 @@ namespace Logic
       /// <returns>Number of files found</returns>
       UINT  StringLibrary::Enumerate(XFileSystem& vfs, GameLanguage lang, WorkerData* data)
       {
+         PROFILE_FUNCTION();
          list<XFileInfo> results;
+         list<LanguageFile> loaded;
 
          // Clear previous contents
          Clear();
@@ -65,7 +80,7 @@ namespace Logic
                // check language tag matches filename
                if (file.Language == lang)
                {
-                  Files.insert(move(file));
+                  loaded.push_back(move(file));
                   Console << Cons::Success << ENDL;
                }
                else
@@ -83,6 +98,22 @@ namespace Logic
             }
          }
 
+         // Order by precedence, highest first
+         loaded.sort(greater<LanguageFile>());
+
+         // Release strings overridden by a higher priority file, unless the string library editor should display them
+         UINT released = PrefsLib.RetainShadowedStrings ? 0 : ReleaseShadowed(loaded);
+
+         // Measure memory saved by sharing text between the strings of these files
+         UINT strings, distinct;
+         INT64 saved = MeasureSharing(loaded, strings, distinct);
+
+         for (auto& f : loaded)
+            Files.insert(move(f));
+
+         // Feedback
+         data->SendFeedback(ProgressType::Info, 2, VString(L"Shared %d language strings as %d distinct strings, saving %d KB. Released %d overridden strings", 
+                                                           strings, distinct, (int)(saved / 1024), released));
          return Files.size();
       }
 
@@ -158,6 +189,61 @@ namespace Logic
 
 		// ------------------------------ PROTECTED METHODS -----------------------------
 
+      /// <summary>Measures the memory saved by pooling the text of a set of files, compared to each string holding its own copy</summary>
+      /// <param name="files">Files</param>
+      /// <param name="strings">On return, the number of non-empty strings</param>
+      /// <param name="distinct">On return, the number of distinct strings</param>
+      /// <returns>Bytes saved, which is negative when the pool overhead exceeds the duplicates removed</returns>
+      INT64  StringLibrary::MeasureSharing(const list<LanguageFile>& files, UINT& strings, UINT& distinct) const
+      {
+         const size_t inline_chars = wstring().capacity();    // Characters stored without a heap buffer
+         set<const wstring*> pooled;
+         INT64 duplicates = 0;
+
+         // Identify pooled strings by address, and count the heap buffer of every repeat
+         strings = 0;
+         for (auto& file : files)
+            for (auto& page : file.Pages)
+               for (auto& str : page.second.Strings)
+                  if (!str.second.Text.empty())
+                  {
+                     ++strings;
+                     if (!pooled.insert(&str.second.Text).second && str.second.Text.length() > inline_chars)
+                        duplicates += (str.second.Text.length() + 1) * sizeof(wchar);
+                  }
+
+         distinct = pooled.size();
+
+         // Saving: Duplicate text, plus handles smaller than strings, less one pool entry per distinct string
+         return duplicates + (INT64)strings * (sizeof(wstring) - sizeof(PooledString)) - (INT64)distinct * StringPool::GetEntryOverhead();
+      }
+
+      /// <summary>Removes strings that are overridden by a file of higher precedence</summary>
+      /// <param name="files">Files sorted with highest priority first</param>
+      /// <returns>Number of strings removed</returns>
+      UINT  StringLibrary::ReleaseShadowed(list<LanguageFile>& files)
+      {
+         UINT count = 0;
+
+         // Search higher priority files for each string
+         for (auto file = files.begin(); file != files.end(); ++file)
+            for (auto& page : file->Pages)
+               for (auto str = page.second.Strings.begin(); str != page.second.Strings.end(); )
+               {
+                  UINT id = str->first;
+
+                  if (any_of(files.begin(), file, [&](const LanguageFile& f) { return f.Contains(page.first, id); }))
+                  {
+                     str = page.second.Strings.erase(str);
+                     ++count;
+                  }
+                  else
+                     ++str;
+               }
+
+         return count;
+      }
+
 		// ------------------------------- PRIVATE METHODS ------------------------------
 
    }
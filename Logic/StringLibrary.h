@@ -20,12 +20,13 @@ namespace Logic
          };
 
          // --------------------- CONSTRUCTION ----------------------
-      private:
-         StringLibrary();
       public:
+         StringLibrary();
          virtual ~StringLibrary();
 
          // ------------------------ STATIC -------------------------
+      public:
+         static StringLibrary&  GetCurrent();
 
          // --------------------- PROPERTIES ------------------------
          
@@ -45,15 +46,20 @@ namespace Logic
          void  Clear();
          UINT  Enumerate(XFileSystem& vfs, GameLanguage lang, WorkerData* data);
 
+      protected:
+         INT64   MeasureSharing(const list<LanguageFile>& files, UINT& strings, UINT& distinct) const;
+         UINT    ReleaseShadowed(list<LanguageFile>& files);
+
 		   // -------------------- REPRESENTATION ---------------------
       public:
          static StringLibrary  Instance;
+         static StringLibrary* Active;
 
          FileCollection  Files;
       };
 
-      // The string library singleton
-      #define StringLib  StringLibrary::Instance
+      // The string library of the game data set in scope, otherwise the active set
+      #define StringLib  (StringLibrary::GetCurrent())
    }
 }
 
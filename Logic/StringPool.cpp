@@ -0,0 +1,170 @@
+#include "stdafx.h"
+#include "StringPool.h"
+
+namespace Logic
+{
+   namespace Utils
+   {
+      /// <summary>Guards creation of the string pool</summary>
+      static std::once_flag  PoolCreated;
+
+      /// <summary>String pool.  Never destroyed, so handles held by other statics remain valid during shutdown</summary>
+      static StringPool*  Pool = nullptr;
+
+      /// <summary>Text of empty handles</summary>
+      const wstring  PooledString::Empty;
+
+      // -------------------------------- CONSTRUCTION --------------------------------
+
+      StringPool::StringPool() : Handles(0), Duplicates(0)
+      {
+      }
+
+      StringPool::~StringPool()
+      {
+      }
+
+      /// <summary>Creates an empty handle</summary>
+      PooledString::PooledString() : Value(nullptr)
+      {
+      }
+
+      /// <summary>Creates a handle to the pooled copy of a string, adding it to the pool if necessary</summary>
+      /// <param name="str">String</param>
+      PooledString::PooledString(const wstring& str) : Value(str.empty() ? nullptr : StringPool::GetInstance().Acquire(str))
+      {
+      }
+
+      /// <summary>Creates another handle to the same string</summary>
+      /// <param name="r">Other handle</param>
+      PooledString::PooledString(const PooledString& r) : Value(r.Value)
+      {
+         if (Value)
+            StringPool::GetInstance().AddRef(Value);
+      }
+
+      /// <summary>Takes ownership of another handle</summary>
+      /// <param name="r">Other handle, emptied on return</param>
+      PooledString::PooledString(PooledString&& r) : Value(r.Value)
+      {
+         r.Value = nullptr;
+      }
+
+      /// <summary>Releases the string</summary>
+      PooledString::~PooledString()
+      {
+         if (Value)
+            StringPool::GetInstance().Release(Value);
+      }
+
+      // ------------------------------- STATIC METHODS -------------------------------
+
+      /// <summary>Gets the pool shared by the whole application</summary>
+      /// <returns></returns>
+      StringPool&  StringPool::GetInstance()
+      {
+         std::call_once(PoolCreated, [] { Pool = new StringPool(); });
+         return *Pool;
+      }
+
+      /// <summary>Gets the approximate memory used by the pool to hold each distinct string, excluding its characters</summary>
+      /// <returns>Size of the hash table node (string, reference count and list links) plus its bucket</returns>
+      size_t  StringPool::GetEntryOverhead()
+      {
+         return sizeof(Entry) + 2 * sizeof(void*)     // Node: entry + next/prev links
+                              + 2 * sizeof(void*);    // Bucket: first/last node of ~1 bucket per string
+      }
+
+      // ------------------------------- PUBLIC METHODS -------------------------------
+
+      /// <summary>Gets the number of distinct strings</summary>
+      /// <returns></returns>
+      UINT  StringPool::GetCount() const
+      {
+         std::lock_guard<std::mutex> lock(Lock);
+         return Entries.size();
+      }
+
+      /// <summary>Gets the number of handles</summary>
+      /// <returns></returns>
+      UINT  StringPool::GetReferences() const
+      {
+         std::lock_guard<std::mutex> lock(Lock);
+         return Handles;
+      }
+
+      /// <summary>Gets the number of bytes of character data saved by sharing identical strings</summary>
+      /// <returns></returns>
+      size_t  StringPool::GetSharedBytes() const
+      {
+         std::lock_guard<std::mutex> lock(Lock);
+         return Duplicates;
+      }
+
+      /// <summary>Replaces the string referenced by this handle</summary>
+      /// <param name="r">Other handle</param>
+      /// <returns></returns>
+      PooledString&  PooledString::operator=(const PooledString& r)
+      {
+         PooledString copy(r);
+         swap(Value, copy.Value);
+         return *this;
+      }
+
+      /// <summary>Replaces the string referenced by this handle</summary>
+      /// <param name="r">Other handle, emptied on return</param>
+      /// <returns></returns>
+      PooledString&  PooledString::operator=(PooledString&& r)
+      {
+         swap(Value, r.Value);
+         return *this;
+      }
+
+      // ------------------------------ PROTECTED METHODS -----------------------------
+
+      /// <summary>Finds or adds a string, adding a reference</summary>
+      /// <param name="str">String</param>
+      /// <returns>Pooled string</returns>
+      StringPool::Entry*  StringPool::Acquire(const wstring& str)
+      {
+         std::lock_guard<std::mutex> lock(Lock);
+
+         // Share existing copy, or insert
+         auto pos = Entries.find(str);
+         if (pos != Entries.end())
+            Duplicates += (str.length() + 1) * sizeof(wchar);
+         else
+            pos = Entries.insert(Entry(str, 0)).first;
+
+         ++pos->second;
+         ++Handles;
+         return &*pos;
+      }
+
+      /// <summary>Adds a reference to a pooled string</summary>
+      /// <param name="e">Pooled string</param>
+      void  StringPool::AddRef(Entry* e)
+      {
+         std::lock_guard<std::mutex> lock(Lock);
+
+         ++e->second;
+         ++Handles;
+         Duplicates += (e->first.length() + 1) * sizeof(wchar);
+      }
+
+      /// <summary>Removes a reference to a pooled string, removing the string once unreferenced</summary>
+      /// <param name="e">Pooled string</param>
+      void  StringPool::Release(Entry* e)
+      {
+         std::lock_guard<std::mutex> lock(Lock);
+
+         --Handles;
+         if (--e->second > 0)
+            Duplicates -= (e->first.length() + 1) * sizeof(wchar);
+         else
+            Entries.erase(Entries.find(e->first));
+      }
+
+      // ------------------------------- PRIVATE METHODS ------------------------------
+   }
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <mutex>
+#include <unordered_map>
+
+namespace Logic
+{
+   namespace Utils
+   {
+      class PooledString;
+
+      /// <summary>Stores a single copy of each distinct string, shared by reference counted handles</summary>
+      /// <remarks>Thread safe.  Each string is released when its last handle is destroyed.</remarks>
+      class LogicExport StringPool
+      {
+         friend class PooledString;
+
+         // ------------------------ TYPES --------------------------
+      protected:
+         /// <summary>Distinct strings and the number of handles referencing each</summary>
+         typedef unordered_map<wstring, UINT>  EntryMap;
+
+         /// <summary>Pooled string</summary>
+         typedef EntryMap::value_type  Entry;
+
+         // --------------------- CONSTRUCTION ----------------------
+      private:
+         StringPool();
+      public:
+         virtual ~StringPool();
+
+         NO_COPY(StringPool);	// Cannot copy semantics
+         NO_MOVE(StringPool);	// Cannot move semantics
+
+         // ------------------------ STATIC -------------------------
+      public:
+         static StringPool&  GetInstance();
+         static size_t       GetEntryOverhead();
+
+         // --------------------- PROPERTIES ------------------------
+      public:
+         PROPERTY_GET(UINT,Count,GetCount);
+         PROPERTY_GET(UINT,References,GetReferences);
+         PROPERTY_GET(size_t,SharedBytes,GetSharedBytes);
+
+         // ---------------------- ACCESSORS ------------------------
+      public:
+         UINT    GetCount() const;
+         UINT    GetReferences() const;
+         size_t  GetSharedBytes() const;
+
+         // ----------------------- MUTATORS ------------------------
+      protected:
+         Entry*  Acquire(const wstring& str);
+         void    AddRef(Entry* e);
+         void    Release(Entry* e);
+
+         // -------------------- REPRESENTATION ---------------------
+      protected:
+         mutable std::mutex  Lock;           // Guards all members
+         EntryMap            Entries;        // Distinct strings
+         UINT                Handles;        // Number of handles referencing any string
+         size_t              Duplicates;     // Bytes of character data not stored because an identical string is shared
+      };
+
+
+      /// <summary>Handle to an immutable string held within the string pool</summary>
+      /// <remarks>The size of a pointer.  Empty strings are not pooled.</remarks>
+      class LogicExport PooledString
+      {
+         // --------------------- CONSTRUCTION ----------------------
+      public:
+         PooledString();
+         PooledString(const wstring& str);
+         PooledString(const PooledString& r);
+         PooledString(PooledString&& r);
+         ~PooledString();
+
+         // ------------------------ STATIC -------------------------
+      protected:
+         static const wstring  Empty;
+
+         // --------------------- PROPERTIES ------------------------
+      public:
+         PROPERTY_GET(const wstring&,Text,GetText);
+
+         // ---------------------- ACCESSORS ------------------------
+      public:
+         /// <summary>Gets the string</summary>
+         /// <returns>Pooled string, valid for the lifetime of this handle</returns>
+         const wstring&  GetText() const
+         {
+            return Value ? Value->first : Empty;
+         }
+
+         // ----------------------- MUTATORS ------------------------
+      public:
+         PooledString&  operator=(const PooledString& r);
+         PooledString&  operator=(PooledString&& r);
+
+         // -------------------- REPRESENTATION ---------------------
+      protected:
+         StringPool::Entry*  Value;    // Pooled string, or nullptr if empty
+      };
+
+   }
+}
+
+using namespace Logic::Utils;
@@ -1,6 +1,7 @@
 #include "stdafx.h"
 #include "StringReader.h"
 #include "FileStream.h"
+#include "TextDecoder.h"
 
 namespace Logic
 {
@@ -50,13 +51,8 @@ namespace Logic
       /// <exception cref="Logic::IOException">An I/O error occurred</exception>
       bool  StringReader::ReadChar(WCHAR&  c)
       {
-         // Ensure stream has not been moved
-         if (Input == nullptr)
-            throw InvalidOperationException(HERE, L"Underlying stream has been closed");
-
-         // First Call: Read entire file 
-         else if (Buffer == nullptr)
-            Buffer = FileStream::ConvertFileBuffer(Input, Length);
+         // Ensure file has been read
+         LoadBuffer();
 
          // EOF: Return false
          if (IsEOF())
@@ -81,56 +77,79 @@ namespace Logic
       /// <exception cref="Logic::IOException">An I/O error occurred</exception>
       bool  StringReader::ReadLine(wstring&  line)
       {
-         DWORD start = Position,    // Start of line
-               end   = Length;      // End of characters on line
-         WCHAR ch;
+         LineView view;
+
+         // Copy line text, if any
+         bool found = ReadLine(view);
+         line.assign(view.Text, view.Text + view.Length);
+         return found;
+      }
+
+      /// <summary>Reads the next line, if any, without copying it</summary>
+      /// <param name="line">On return, the characters of the line excluding the line break</param>
+      /// <returns>True if read, false if EOF</returns>
+      /// <exception cref="Logic::InvalidOperationException">Stream has been closed (reader has been move-copied)</exception>
+      /// <exception cref="Logic::IOException">An I/O error occurred</exception>
+      bool  StringReader::ReadLine(LineView&  line)
+      {
+         // Ensure file has been read
+         LoadBuffer();
 
          // EOF: Return false
          if (IsEOF())
          {
-            line.clear();
+            line = LineView();
             return false;
          }
 
-         // Search for EOF/CRLF/CR
-         while (ReadChar(ch))
+         // Search for CR/LF/EOF
+         const WCHAR *start = Buffer.get() + Position,
+                     *end = Buffer.get() + Length,
+                     *brk = TextDecoder::FindLineBreak(start, end);
+
+         // Return line text without CRLF
+         line.Text = start;
+         line.Length = brk - start;
+
+         // Consume CR/LF/CRLF
+         if (brk < end)
          {
-            // CR/LF/CRLF: Set of chars marker, 
-            if (ch == '\r' || ch == '\n')
-            {
-               // Mark end-of-text
-               end = Position-1;
-
-               // Consume entire CRLF if present
-               if (ch == '\r' && PeekChar(ch) && ch == '\n')
-                  ReadChar(ch);
-
-               // Position marker now at start of new line, end-of-char marker at last character
-               break;
-            }
+            if (*brk == L'\r' && brk+1 < end && brk[1] == L'\n')
+               ++brk;
+            ++brk;
+            ++LineNum;
          }
 
-         // Return line text without CRLF
-         line = wstring(Buffer.get() + start, Buffer.get() + end);
+         // Position marker now at start of new line
+         Position = brk - Buffer.get();
          return true;
       }
 
       // ------------------------------ PROTECTED METHODS -----------------------------
 
-      /// <summary>Peeks the next character</summary>
-      /// <param name="c">Next character</param>
-      /// <returns>True if read, false if EOF</returns>
+      /// <summary>Reads and decodes the entire file upon first call</summary>
       /// <exception cref="Logic::InvalidOperationException">Stream has been closed (reader has been move-copied)</exception>
       /// <exception cref="Logic::IOException">An I/O error occurred</exception>
-      bool  StringReader::PeekChar(WCHAR&  c)
+      void  StringReader::LoadBuffer()
       {
          // Ensure stream has not been moved
          if (Input == nullptr)
             throw InvalidOperationException(HERE, L"Underlying stream has been closed");
-         
+
          // First Call: Read entire file 
          else if (Buffer == nullptr)
             Buffer = FileStream::ConvertFileBuffer(Input, Length);
+      }
+
+      /// <summary>Peeks the next character</summary>
+      /// <param name="c">Next character</param>
+      /// <returns>True if read, false if EOF</returns>
+      /// <exception cref="Logic::InvalidOperationException">Stream has been closed (reader has been move-copied)</exception>
+      /// <exception cref="Logic::IOException">An I/O error occurred</exception>
+      bool  StringReader::PeekChar(WCHAR&  c)
+      {
+         // Ensure file has been read
+         LoadBuffer();
 
          // EOF: Return false
          if (IsEOF())
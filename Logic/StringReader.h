@@ -10,6 +10,20 @@ namespace Logic
    {
       enum class TextEncoding { UTF8, UTF16 };
 
+      /// <summary>Characters of a line within a reader's buffer, excluding the line break.  Valid for the lifetime of the reader</summary>
+      class LineView
+      {
+      public:
+         LineView() : Text(nullptr), Length(0)
+         {}
+
+         /// <summary>Copies the characters into a string</summary>
+         wstring  ToString() const  { return wstring(Text, Text + Length); }
+
+         const WCHAR*  Text;     // First character
+         DWORD         Length;   // Number of characters
+      };
+
       /// <summary>Reads strings from a stream in lines</summary>
       class LogicExport StringReader
       {
@@ -47,8 +61,10 @@ namespace Logic
 
          virtual bool  ReadChar(WCHAR&  c);
          virtual bool  ReadLine(wstring&  line);
+         virtual bool  ReadLine(LineView&  line);
 
       protected:
+         void  LoadBuffer();
          bool  PeekChar(WCHAR&  c);
          
          // -------------------- REPRESENTATION ---------------------
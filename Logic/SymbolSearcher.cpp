@@ -41,14 +41,14 @@ namespace Logic
             // Label: Search for 'define label', 'goto label', 'gosub label'
             case SymbolType::Label:
                if ((n->Is(CMD_DEFINE_LABEL) || n->Is(CMD_GOTO_LABEL) || n->Is(CMD_GOTO_SUB)) && !n->Parameters.empty()) 
-                  Results.push_back(Symbol(n->Parameters[0].Token, SymbolType::Label, n->LineNumber, n->LineText, comment));
+                  Results.push_back(Symbol(n->Parameters[0].Token, SymbolType::Label, n->LineNumber, n->LineText.c_str(), comment));
                break;
 
             // Variable: Search all commands
             case SymbolType::Variable:
                for (const auto& p : n->Parameters)
                   if (p.Type == DataType::VARIABLE && p.Value.Type == ValueType::String && p.Token.ValueText == Name)
-                     Results.push_back(Symbol(p.Token, SymbolType::Variable, n->LineNumber, n->LineText, comment));
+                     Results.push_back(Symbol(p.Token, SymbolType::Variable, n->LineNumber, n->LineText.c_str(), comment));
                break;
             }
          }
@@ -5,6 +5,7 @@
 #include "LegacySyntaxFileReader.h"
 #include "SyntaxFileReader.h"
 #include "SyntaxFileWriter.h"
+#include "Profiler.h"
 
 namespace Logic
 {
@@ -44,6 +45,7 @@ namespace Logic
       /// <exception cref="Logic::IOException">An I/O error occurred</exception>
       UINT  SyntaxLibrary::Enumerate(WorkerData* data)
       {
+         PROFILE_FUNCTION();
          try
          {
             SyntaxFile file;
@@ -0,0 +1,446 @@
+#include "stdafx.h"
+#include "TaskScheduler.h"
+
+namespace Logic
+{
+   namespace Threads
+   {
+      /// <summary>Guards creation of the default scheduler</summary>
+      static std::once_flag  DefaultCreated;
+
+      /// <summary>Default scheduler.  Never destroyed, workers are terminated with the process</summary>
+      static TaskScheduler*  DefaultScheduler = nullptr;
+
+      // -------------------------------- CONSTRUCTION --------------------------------
+
+      /// <summary>Creates a task</summary>
+      /// <param name="s">Owner</param>
+      /// <param name="fn">Task function</param>
+      /// <param name="token">Cancels the task</param>
+      /// <param name="dedicated">Whether task runs on its own thread</param>
+      Task::Task(TaskScheduler& s, const TaskFunction& fn, const CancellationToken& token, bool dedicated)
+         : Scheduler(s), Function(fn), Token(token), Dedicated(dedicated), Dependencies(1), DependencyFailed(false), 
+           CurrentState(TaskState::Waiting), ExitCode(0)
+      {
+      }
+
+      Task::~Task()
+      {
+      }
+
+      /// <summary>Creates a scheduler and starts its workers</summary>
+      /// <param name="threads">Number of workers, or zero to use one per logical processor</param>
+      TaskScheduler::TaskScheduler(UINT threads) : Pending(0), Started(0), Stopping(false)
+      {
+         // Default: One worker per processor, at least two
+         if (threads == 0)
+            threads = max(2U, std::thread::hardware_concurrency());
+
+         // Create a queue per worker, plus the queue for external threads
+         ThreadIDs.resize(threads);
+         for (UINT i = 0; i <= threads; ++i)
+            Queues.push_back(WorkQueuePtr(new WorkQueue));
+
+         // Start workers
+         for (UINT i = 0; i < threads; ++i)
+            Workers.push_back(std::thread(&TaskScheduler::WorkerMain, this, i));
+
+         // Wait until every worker has recorded its ID
+         std::unique_lock<std::mutex> lock(IdleLock);
+         WorkAvailable.wait(lock, [this] { return Started == Workers.size(); });
+      }
+
+      /// <summary>Stops the workers once all queued tasks have executed</summary>
+      TaskScheduler::~TaskScheduler()
+      {
+         {
+            std::lock_guard<std::mutex> lock(IdleLock);
+            Stopping = true;
+         }
+         WorkAvailable.notify_all();
+
+         for (auto& w : Workers)
+            w.join();
+      }
+
+      // ------------------------------- STATIC METHODS -------------------------------
+
+      /// <summary>Gets the scheduler shared by the whole application</summary>
+      /// <returns></returns>
+      TaskScheduler&  TaskScheduler::GetDefault()
+      {
+         // Create upon first use: Workers cannot be started while the DLL is being loaded
+         std::call_once(DefaultCreated, [] { DefaultScheduler = new TaskScheduler(); });
+         return *DefaultScheduler;
+      }
+
+      // ------------------------------- PUBLIC METHODS -------------------------------
+
+      /// <summary>Gets the result of the task, waiting for it to complete</summary>
+      /// <returns>Value returned by the task function</returns>
+      /// <exception cref="Logic::InvalidOperationException">Task was cancelled</exception>
+      /// <exception cref="std::exception">Exception thrown by the task function</exception>
+      DWORD  Task::GetResult() const
+      {
+         Wait();
+
+         std::lock_guard<std::mutex> lock(Lock);
+         // Rethrow failure
+         if (CurrentState == TaskState::Faulted)
+            std::rethrow_exception(Error);
+
+         // Ensure not cancelled
+         if (CurrentState == TaskState::Cancelled)
+            throw InvalidOperationException(HERE, L"Task was cancelled");
+
+         return ExitCode;
+      }
+
+      /// <summary>Gets the current state</summary>
+      /// <returns></returns>
+      TaskState  Task::GetState() const
+      {
+         std::lock_guard<std::mutex> lock(Lock);
+         return CurrentState;
+      }
+
+      /// <summary>Query whether task has completed, been cancelled or faulted</summary>
+      /// <returns></returns>
+      bool  Task::IsComplete() const
+      {
+         std::lock_guard<std::mutex> lock(Lock);
+         return CurrentState >= TaskState::Completed;
+      }
+
+      /// <summary>Waits for the task to complete.  Workers execute other queued tasks meanwhile</summary>
+      void  Task::Wait() const
+      {
+         Scheduler.WaitFor(*this);
+      }
+
+      /// <summary>Creates progress feedback for a set of tasks</summary>
+      /// <param name="data">Receives feedback</param>
+      /// <param name="name">Operation name</param>
+      /// <param name="total">Number of items</param>
+      /// <param name="indent">Feedback indentation</param>
+      /// <param name="step">Reporting step, as a percentage</param>
+      /// <exception cref="Logic::ArgumentNullException">Data is nullptr</exception>
+      TaskProgress::TaskProgress(const WorkerData* data, const wstring& name, UINT total, UINT indent, UINT step)
+         : Data(data), Name(name), Key(FeedbackQueue::NewKey()), Total(total), Indent(indent), Step(max(1U, step)), Done(0), Reported(0)
+      {
+         REQUIRED(data);
+      }
+
+      /// <summary>Gets the number of items completed</summary>
+      /// <returns></returns>
+      UINT  TaskProgress::GetCompleted() const
+      {
+         return Done.load();
+      }
+
+      /// <summary>Records completed items, sending feedback if a reporting step has been crossed</summary>
+      /// <param name="count">Number of items completed</param>
+      void  TaskProgress::Advance(UINT count)
+      {
+         UINT done = (Done += count);
+         if (Total == 0)
+            return;
+
+         // Round down to reporting step
+         UINT percent = min(100U, done * 100 / Total) / Step * Step,
+              previous = Reported.load();
+
+         // Claim the step, so each is reported once by one thread
+         while (percent > previous)
+            if (Reported.compare_exchange_weak(previous, percent))
+            {
+               Data->SendProgress(Key, Indent, VString(L"%s: %d of %d complete (%d%%)", Name.c_str(), min(done, Total), Total, percent));
+               break;
+            }
+      }
+
+      /// <summary>Gets the number of worker threads</summary>
+      /// <returns></returns>
+      UINT  TaskScheduler::GetThreadCount() const
+      {
+         return Workers.size();
+      }
+
+      /// <summary>Queues a task upon the worker pool</summary>
+      /// <param name="fn">Task function</param>
+      /// <param name="token">Cancels the task.  Dependencies that are cancelled or fault also cancel the task</param>
+      /// <param name="deps">Tasks that must complete first</param>
+      /// <returns>Task</returns>
+      /// <exception cref="Logic::ArgumentNullException">Function is empty</exception>
+      TaskPtr  TaskScheduler::Run(const TaskFunction& fn, const CancellationToken& token, const TaskArray& deps)
+      {
+         REQUIRED(fn);
+
+         TaskPtr t(new Task(*this, fn, token, false));
+         t->Dependencies += (UINT)deps.size();
+
+         // Register with dependencies.  Those already complete are released immediately
+         for (auto& d : deps)
+            if (!d->AddDependent(t))
+               Release(t, d->State != TaskState::Completed);
+
+         // Release initial reference
+         Release(t, false);
+         return t;
+      }
+
+      /// <summary>Executes a long-running task upon its own thread, so it does not occupy a worker</summary>
+      /// <param name="fn">Task function</param>
+      /// <param name="token">Cancels the task</param>
+      /// <returns>Task</returns>
+      /// <exception cref="Logic::ArgumentNullException">Function is empty</exception>
+      TaskPtr  TaskScheduler::RunDedicated(const TaskFunction& fn, const CancellationToken& token)
+      {
+         REQUIRED(fn);
+
+         TaskPtr t(new Task(*this, fn, token, true));
+         Release(t, false);
+         return t;
+      }
+
+      /// <summary>Waits for a set of tasks to complete</summary>
+      /// <param name="tasks">Tasks</param>
+      /// <exception cref="Logic::InvalidOperationException">A task was cancelled</exception>
+      /// <exception cref="std::exception">First exception thrown by a task function</exception>
+      void  TaskScheduler::WaitAll(const TaskArray& tasks)
+      {
+         // Wait for all before reporting any failure
+         for (auto& t : tasks)
+            t->Wait();
+
+         for (auto& t : tasks)
+            t->GetResult();
+      }
+
+      // ------------------------------ PROTECTED METHODS -----------------------------
+
+      /// <summary>Registers a task to be released once this task completes</summary>
+      /// <param name="t">Dependent task</param>
+      /// <returns>False if this task has already completed</returns>
+      bool  Task::AddDependent(TaskPtr t)
+      {
+         std::lock_guard<std::mutex> lock(Lock);
+         if (CurrentState >= TaskState::Completed)
+            return false;
+
+         Dependents.push_back(t);
+         return true;
+      }
+
+      /// <summary>Sets the state.  Completion wakes any waiting threads</summary>
+      /// <param name="s">New state</param>
+      /// <returns>Dependents to be released, if complete</returns>
+      TaskArray  Task::Finish(TaskState s)
+      {
+         TaskArray dependents;
+         {
+            std::lock_guard<std::mutex> lock(Lock);
+            CurrentState = s;
+
+            if (s < TaskState::Completed)
+               return dependents;
+
+            dependents.swap(Dependents);
+         }
+         Finished.notify_all();
+         return dependents;
+      }
+
+      /// <summary>Gets the index of the calling worker</summary>
+      /// <returns>Worker index, or -1 if called by an external thread</returns>
+      int  TaskScheduler::GetWorkerIndex() const
+      {
+         auto id = std::this_thread::get_id();
+
+         for (UINT i = 0; i < ThreadIDs.size(); ++i)
+            if (ThreadIDs[i] == id)
+               return i;
+
+         return -1;
+      }
+
+      /// <summary>Queues a task whose dependencies have completed</summary>
+      /// <param name="t">Task</param>
+      void  TaskScheduler::Enqueue(TaskPtr t)
+      {
+         t->Finish(TaskState::Queued);
+
+         // Dedicated: Execute upon new thread
+         if (t->Dedicated)
+         {
+            std::thread(&TaskScheduler::Execute, this, t).detach();
+            return;
+         }
+
+         // Queue upon calling worker, or the external queue
+         int index = GetWorkerIndex();
+         auto& q = *Queues[index != -1 ? index : Workers.size()];
+         {
+            std::lock_guard<std::mutex> lock(q.Lock);
+            q.Tasks.push_back(t);
+         }
+
+         // Wake an idle worker
+         {
+            std::lock_guard<std::mutex> lock(IdleLock);
+            ++Pending;
+         }
+         WorkAvailable.notify_one();
+      }
+
+      /// <summary>Executes a task, unless cancelled</summary>
+      /// <param name="t">Task</param>
+      void  TaskScheduler::Execute(TaskPtr t)
+      {
+         // Cancelled while queued
+         if (t->Token.Cancelled)
+         {
+            Finish(t, TaskState::Cancelled);
+            return;
+         }
+
+         t->Finish(TaskState::Running);
+
+         try
+         {
+            t->ExitCode = t->Function(t->Token);
+            t->Function = nullptr;
+            Finish(t, TaskState::Completed);
+         }
+         catch (...)
+         {
+            t->Error = std::current_exception();
+            t->Function = nullptr;
+            Finish(t, TaskState::Faulted);
+         }
+      }
+
+      /// <summary>Completes a task and releases its dependents</summary>
+      /// <param name="t">Task</param>
+      /// <param name="s">Final state</param>
+      void  TaskScheduler::Finish(TaskPtr t, TaskState s)
+      {
+         for (auto& d : t->Finish(s))
+            Release(d, s != TaskState::Completed);
+      }
+
+      /// <summary>Releases one dependency of a task, queuing the task once none remain</summary>
+      /// <param name="t">Task</param>
+      /// <param name="failed">Whether the dependency was cancelled or faulted</param>
+      void  TaskScheduler::Release(TaskPtr t, bool failed)
+      {
+         if (failed)
+            t->DependencyFailed = true;
+
+         if (--t->Dependencies > 0)
+            return;
+
+         // Cancel if any dependency failed, otherwise queue
+         if (t->DependencyFailed || t->Token.Cancelled)
+            Finish(t, TaskState::Cancelled);
+         else
+            Enqueue(t);
+      }
+
+      /// <summary>Removes the next task to execute</summary>
+      /// <param name="index">Worker index, or -1 for an external thread</param>
+      /// <param name="t">On return, the task</param>
+      /// <returns>True if a task was found</returns>
+      bool  TaskScheduler::TryDequeue(int index, TaskPtr& t)
+      {
+         UINT count = Queues.size();
+
+         // Own queue: Newest first
+         if (index != -1)
+         {
+            auto& q = *Queues[index];
+            std::lock_guard<std::mutex> lock(q.Lock);
+            if (!q.Tasks.empty())
+            {
+               t = q.Tasks.back();
+               q.Tasks.pop_back();
+            }
+         }
+
+         // Steal: Oldest first, starting with the external queue
+         for (UINT i = 0; !t && i < count; ++i)
+         {
+            auto& q = *Queues[(count - 1 + i) % count];
+            std::lock_guard<std::mutex> lock(q.Lock);
+            if (!q.Tasks.empty())
+            {
+               t = q.Tasks.front();
+               q.Tasks.pop_front();
+            }
+         }
+
+         if (t)
+            --Pending;
+         return t != nullptr;
+      }
+
+      /// <summary>Waits for a task to complete.  Workers execute queued tasks meanwhile</summary>
+      /// <param name="t">Task</param>
+      void  TaskScheduler::WaitFor(const Task& t)
+      {
+         int index = GetWorkerIndex();
+         auto complete = [&t] { return t.CurrentState >= TaskState::Completed; };
+
+         while (!t.IsComplete())
+         {
+            TaskPtr next;
+
+            // Worker: Help execute queued tasks
+            if (index != -1 && TryDequeue(index, next))
+               Execute(next);
+            else
+            {
+               // Block.  Workers re-check the queues periodically
+               std::unique_lock<std::mutex> lock(t.Lock);
+               if (index == -1)
+                  t.Finished.wait(lock, complete);
+               else
+                  t.Finished.wait_for(lock, std::chrono::milliseconds(5), complete);
+            }
+         }
+      }
+
+      /// <summary>Executes queued tasks until the scheduler is destroyed</summary>
+      /// <param name="index">Worker index</param>
+      void  TaskScheduler::WorkerMain(UINT index)
+      {
+         // Record ID
+         {
+            std::lock_guard<std::mutex> lock(IdleLock);
+            ThreadIDs[index] = std::this_thread::get_id();
+            ++Started;
+         }
+         WorkAvailable.notify_all();
+
+         for (;;)
+         {
+            TaskPtr t;
+            if (TryDequeue(index, t))
+            {
+               Execute(t);
+               continue;
+            }
+
+            // Sleep until work is queued
+            std::unique_lock<std::mutex> lock(IdleLock);
+            WorkAvailable.wait(lock, [this] { return Pending > 0 || Stopping; });
+
+            if (Stopping && Pending == 0)
+               return;
+         }
+      }
+
+      // ------------------------------- PRIVATE METHODS ------------------------------
+
+   }
+}
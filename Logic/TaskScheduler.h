@@ -0,0 +1,203 @@
+#pragma once
+#include "CancellationToken.h"
+#include "WorkerData.h"
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+namespace Logic
+{
+   namespace Threads
+   {
+      class Task;
+      class TaskScheduler;
+
+      // ------------------------- TYPES -------------------------
+
+      /// <summary>Shared task pointer</summary>
+      typedef shared_ptr<Task>  TaskPtr;
+
+      /// <summary>Collection of tasks</summary>
+      typedef vector<TaskPtr>   TaskArray;
+
+      /// <summary>Task function.  Receives the token that cancels the task</summary>
+      typedef function<DWORD (const CancellationToken&)>  TaskFunction;
+
+      // ------------------------- ENUMS -------------------------
+
+      /// <summary>Defines the lifetime of a task</summary>
+      enum class TaskState : UINT 
+      { 
+         Waiting,       // Awaiting dependencies
+         Queued,        // Awaiting a worker
+         Running,       // Executing
+         Completed,     // Executed successfully
+         Cancelled,     // Cancelled, or a dependency did not complete
+         Faulted        // Threw an exception
+      };
+
+      // ------------------------ CLASSES ------------------------
+
+      /// <summary>Unit of work executed by a task scheduler</summary>
+      class LogicExport Task
+      {
+         friend class TaskScheduler;
+
+         // --------------------- CONSTRUCTION ----------------------
+      public:
+         Task(TaskScheduler& s, const TaskFunction& fn, const CancellationToken& token, bool dedicated);
+         virtual ~Task();
+
+         NO_COPY(Task);	// No copy semantics
+         NO_MOVE(Task);	// No move semantics
+
+         // --------------------- PROPERTIES ------------------------
+      public:
+         PROPERTY_GET(bool,Complete,IsComplete);
+         PROPERTY_GET(DWORD,Result,GetResult);
+         PROPERTY_GET(TaskState,State,GetState);
+
+         // ---------------------- ACCESSORS ------------------------
+      public:
+         DWORD      GetResult() const;
+         TaskState  GetState() const;
+         bool       IsComplete() const;
+         void       Wait() const;
+
+         // ----------------------- MUTATORS ------------------------
+      protected:
+         bool       AddDependent(TaskPtr t);
+         TaskArray  Finish(TaskState s);
+
+         // -------------------- REPRESENTATION ---------------------
+      protected:
+         TaskScheduler&           Scheduler;        // Owner
+         TaskFunction             Function;         // Task body, released once executed
+         CancellationToken        Token;            // Cancels task
+         const bool               Dedicated;        // Whether task runs on its own thread
+         std::atomic<UINT>        Dependencies;     // Number of incomplete dependencies
+         std::atomic<bool>        DependencyFailed; // Whether a dependency did not complete successfully
+         TaskArray                Dependents;       // Tasks awaiting this task
+         TaskState                CurrentState;     // Current state
+         DWORD                    ExitCode;         // Value returned by task function
+         std::exception_ptr       Error;            // Exception thrown by task function
+
+         mutable std::mutex               Lock;       // Guards state and dependents
+         mutable std::condition_variable  Finished;   // Signalled upon completion
+      };
+
+
+      /// <summary>Aggregates the progress of a set of tasks into occasional worker feedback</summary>
+      /// <remarks>Thread-safe.  Feedback is only sent when progress crosses a reporting step, so many small tasks produce few messages</remarks>
+      class LogicExport TaskProgress
+      {
+         // --------------------- CONSTRUCTION ----------------------
+      public:
+         TaskProgress(const WorkerData* data, const wstring& name, UINT total, UINT indent = 2, UINT step = 25);
+
+         NO_COPY(TaskProgress);	// No copy semantics
+         NO_MOVE(TaskProgress);	// No move semantics
+
+         // --------------------- PROPERTIES ------------------------
+      public:
+         PROPERTY_GET(UINT,Completed,GetCompleted);
+
+         // ---------------------- ACCESSORS ------------------------
+      public:
+         UINT  GetCompleted() const;
+
+         // ----------------------- MUTATORS ------------------------
+      public:
+         void  Advance(UINT count = 1);
+
+         // -------------------- REPRESENTATION ---------------------
+      protected:
+         const WorkerData*  Data;         // Receives feedback
+         const wstring      Name;         // Operation name
+         const UINT         Key,          // Identifies reports in the feedback queue
+                            Total,        // Number of items
+                            Indent,       // Feedback indentation
+                            Step;         // Reporting step, as a percentage
+         std::atomic<UINT>  Done,         // Number of items completed
+                            Reported;     // Last percentage reported
+      };
+
+
+      /// <summary>Executes tasks upon a fixed pool of work-stealing worker threads</summary>
+      /// <remarks>Each worker has its own queue, executing the most recently queued task first and stealing the oldest task from 
+      /// other workers when idle.  Tasks waited upon by a worker are helped along by executing queued tasks meanwhile, so nested 
+      /// parallelism cannot exhaust the pool.  Long-running tasks should be dedicated, which executes them upon their own thread.</remarks>
+      class LogicExport TaskScheduler
+      {
+         friend class Task;
+
+         // ------------------------ TYPES --------------------------
+      protected:
+         /// <summary>Task queue of a single worker</summary>
+         class WorkQueue
+         {
+         public:
+            std::mutex     Lock;
+            deque<TaskPtr> Tasks;
+         };
+
+         /// <summary>Worker queue pointer</summary>
+         typedef unique_ptr<WorkQueue>  WorkQueuePtr;
+
+         // --------------------- CONSTRUCTION ----------------------
+      public:
+         TaskScheduler(UINT threads = 0);
+         virtual ~TaskScheduler();
+
+         NO_COPY(TaskScheduler);	// No copy semantics
+         NO_MOVE(TaskScheduler);	// No move semantics
+
+         // ------------------------ STATIC -------------------------
+      public:
+         static TaskScheduler&  GetDefault();
+
+         // --------------------- PROPERTIES ------------------------
+      public:
+         PROPERTY_GET(UINT,ThreadCount,GetThreadCount);
+
+         // ---------------------- ACCESSORS ------------------------
+      public:
+         UINT  GetThreadCount() const;
+
+      protected:
+         int   GetWorkerIndex() const;
+
+         // ----------------------- MUTATORS ------------------------
+      public:
+         TaskPtr  Run(const TaskFunction& fn, const CancellationToken& token = CancellationToken(), const TaskArray& deps = TaskArray());
+         TaskPtr  RunDedicated(const TaskFunction& fn, const CancellationToken& token = CancellationToken());
+         void     WaitAll(const TaskArray& tasks);
+
+      protected:
+         void  Enqueue(TaskPtr t);
+         void  Execute(TaskPtr t);
+         void  Finish(TaskPtr t, TaskState s);
+         void  Release(TaskPtr t, bool failed);
+         bool  TryDequeue(int index, TaskPtr& t);
+         void  WaitFor(const Task& t);
+         void  WorkerMain(UINT index);
+
+         // -------------------- REPRESENTATION ---------------------
+      protected:
+         vector<std::thread>      Workers;     // Worker threads
+         vector<std::thread::id>  ThreadIDs;   // Worker thread IDs, by index
+         vector<WorkQueuePtr>     Queues;      // Worker queues, by index, followed by the queue for external threads
+
+         std::mutex               IdleLock;    // Guards idle workers
+         std::condition_variable  WorkAvailable;
+         std::atomic<UINT>        Pending;     // Number of queued tasks
+         UINT                     Started;     // Number of workers started
+         bool                     Stopping;    // Whether workers should exit
+      };
+
+   }
+}
+
+using namespace Logic::Threads;
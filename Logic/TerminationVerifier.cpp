@@ -45,7 +45,7 @@ namespace Logic
                {
                // If: Verify branch and any alternates all lead to RETURN
                case BranchLogic::If:
-                  VisitNode(last.get());
+                  VisitNode(last);
 
                   // Verify following Else/ElseIf
                   for (auto m = last->FindNextSibling(); m != nullptr && (m->Logic == BranchLogic::Else || m->Logic == BranchLogic::ElseIf); m = m->FindPrevSibling())
@@ -0,0 +1,267 @@
+#include "stdafx.h"
+#include "TextDecoder.h"
+#include <cstring>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+   #include <emmintrin.h>
+   #define TEXT_DECODER_SSE2
+#endif
+
+namespace Logic
+{
+   namespace IO
+   {
+      // -------------------------------- CONSTRUCTION --------------------------------
+
+      /// <summary>Creates a decoder</summary>
+      /// <param name="enc">Source encoding</param>
+      TextDecoder::TextDecoder(Encoding enc) : Source(enc), PendingLength(0)
+      {
+      }
+
+      // ------------------------------- STATIC METHODS -------------------------------
+
+      /// <summary>Upper half of code page 1250.  Undefined characters map to the matching C1 control, as Windows does</summary>
+      const wchar_t  TextDecoder::Windows1250[128] =
+      {
+         0x20AC, 0x0081, 0x201A, 0x0083, 0x201E, 0x2026, 0x2020, 0x2021,
+         0x0088, 0x2030, 0x0160, 0x2039, 0x015A, 0x0164, 0x017D, 0x0179,
+         0x0090, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014,
+         0x0098, 0x2122, 0x0161, 0x203A, 0x015B, 0x0165, 0x017E, 0x017A,
+         0x00A0, 0x02C7, 0x02D8, 0x0141, 0x00A4, 0x0104, 0x00A6, 0x00A7,
+         0x00A8, 0x00A9, 0x015E, 0x00AB, 0x00AC, 0x00AD, 0x00AE, 0x017B,
+         0x00B0, 0x00B1, 0x02DB, 0x0142, 0x00B4, 0x00B5, 0x00B6, 0x00B7,
+         0x00B8, 0x0105, 0x015F, 0x00BB, 0x013D, 0x02DD, 0x013E, 0x017C,
+         0x0154, 0x00C1, 0x00C2, 0x0102, 0x00C4, 0x0139, 0x0106, 0x00C7,
+         0x010C, 0x00C9, 0x0118, 0x00CB, 0x011A, 0x00CD, 0x00CE, 0x010E,
+         0x0110, 0x0143, 0x0147, 0x00D3, 0x00D4, 0x0150, 0x00D6, 0x00D7,
+         0x0158, 0x016E, 0x00DA, 0x0170, 0x00DC, 0x00DD, 0x0162, 0x00DF,
+         0x0155, 0x00E1, 0x00E2, 0x0103, 0x00E4, 0x013A, 0x0107, 0x00E7,
+         0x010D, 0x00E9, 0x0119, 0x00EB, 0x011B, 0x00ED, 0x00EE, 0x010F,
+         0x0111, 0x0144, 0x0148, 0x00F3, 0x00F4, 0x0151, 0x00F6, 0x00F7,
+         0x0159, 0x016F, 0x00FA, 0x0171, 0x00FC, 0x00FD, 0x0163, 0x02D9,
+      };
+
+      /// <summary>Finds the next carriage return or line feed</summary>
+      /// <param name="pos">Position to search from</param>
+      /// <param name="end">End of text</param>
+      /// <returns>Position of line break, or 'end' if none</returns>
+      const wchar_t*  TextDecoder::FindLineBreak(const wchar_t* pos, const wchar_t* end)
+      {
+#ifdef TEXT_DECODER_SSE2
+         const size_t STEP = 16 / sizeof(wchar_t);
+
+         // Compare a block of characters at a time.  Locate the exact character by scanning the block
+         if (sizeof(wchar_t) == 2)
+         {
+            const __m128i cr = _mm_set1_epi16(L'\r'), lf = _mm_set1_epi16(L'\n');
+            for (; end - pos >= (ptrdiff_t)STEP; pos += STEP)
+            {
+               __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pos));
+               if (_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi16(block, cr), _mm_cmpeq_epi16(block, lf))))
+                  break;
+            }
+         }
+         else
+         {
+            const __m128i cr = _mm_set1_epi32(L'\r'), lf = _mm_set1_epi32(L'\n');
+            for (; end - pos >= (ptrdiff_t)STEP; pos += STEP)
+            {
+               __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pos));
+               if (_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi32(block, cr), _mm_cmpeq_epi32(block, lf))))
+                  break;
+            }
+         }
+#endif
+         // Scan remainder
+         while (pos < end && *pos != L'\r' && *pos != L'\n')
+            ++pos;
+
+         return pos;
+      }
+
+      /// <summary>Widens a run of ASCII characters</summary>
+      /// <param name="in">Input position</param>
+      /// <param name="end">End of input</param>
+      /// <param name="out">Output position.  On return, the position following the last character written</param>
+      /// <returns>Position of the first non-ASCII byte, or 'end' if none</returns>
+      const uint8_t*  TextDecoder::DecodeASCII(const uint8_t* in, const uint8_t* end, wchar_t*& out)
+      {
+#ifdef TEXT_DECODER_SSE2
+         const __m128i zero = _mm_setzero_si128();
+
+         // Widen 16 bytes at a time until a non-ASCII byte is found
+         for (; end - in >= 16; in += 16, out += 16)
+         {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+            if (_mm_movemask_epi8(block))
+               break;
+
+            __m128i lo = _mm_unpacklo_epi8(block, zero),
+                    hi = _mm_unpackhi_epi8(block, zero);
+
+            if (sizeof(wchar_t) == 2)
+            {
+               _mm_storeu_si128(reinterpret_cast<__m128i*>(out), lo);
+               _mm_storeu_si128(reinterpret_cast<__m128i*>(out+8), hi);
+            }
+            else
+            {
+               _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi16(lo, zero));
+               _mm_storeu_si128(reinterpret_cast<__m128i*>(out+4), _mm_unpackhi_epi16(lo, zero));
+               _mm_storeu_si128(reinterpret_cast<__m128i*>(out+8), _mm_unpacklo_epi16(hi, zero));
+               _mm_storeu_si128(reinterpret_cast<__m128i*>(out+12), _mm_unpackhi_epi16(hi, zero));
+            }
+         }
+#endif
+         // Widen remainder
+         while (in < end && *in < 0x80)
+            *out++ = *in++;
+
+         return in;
+      }
+
+      /// <summary>Decodes a single UTF-8 sequence</summary>
+      /// <param name="in">Input position</param>
+      /// <param name="end">End of input</param>
+      /// <param name="out">Output position.  On return, the position following the characters written</param>
+      /// <returns>Number of bytes consumed, or zero if the input ends within a valid sequence</returns>
+      size_t  TextDecoder::DecodeSequence(const uint8_t* in, const uint8_t* end, wchar_t*& out)
+      {
+         uint8_t  lead = in[0],
+                  lower = 0x80,     // Range of valid second byte
+                  upper = 0xBF;
+         uint32_t ch;
+         size_t   trail;
+
+         // ASCII
+         if (lead < 0x80)
+         {
+            *out++ = lead;
+            return 1;
+         }
+         // Identify length, exclude overlong encodings, surrogates and characters beyond U+10FFFF
+         else if (lead >= 0xC2 && lead <= 0xDF)
+         {
+            trail = 1;
+            ch = lead & 0x1F;
+         }
+         else if (lead >= 0xE0 && lead <= 0xEF)
+         {
+            trail = 2;
+            ch = lead & 0x0F;
+            lower = (lead == 0xE0 ? 0xA0 : 0x80);
+            upper = (lead == 0xED ? 0x9F : 0xBF);
+         }
+         else if (lead >= 0xF0 && lead <= 0xF4)
+         {
+            trail = 3;
+            ch = lead & 0x07;
+            lower = (lead == 0xF0 ? 0x90 : 0x80);
+            upper = (lead == 0xF4 ? 0x8F : 0xBF);
+         }
+         // Invalid lead byte
+         else
+         {
+            *out++ = 0xFFFD;
+            return 1;
+         }
+
+         // Decode trail bytes
+         for (size_t i = 1; i <= trail; ++i, lower = 0x80, upper = 0xBF)
+         {
+            // Incomplete: Wait for more input
+            if (in + i == end)
+               return 0;
+
+            // Invalid: Replace bytes consumed so far
+            if (in[i] < lower || in[i] > upper)
+            {
+               *out++ = 0xFFFD;
+               return i;
+            }
+
+            ch = (ch << 6) | (in[i] & 0x3F);
+         }
+
+         // Supplementary: Encode as surrogate pair
+         if (ch >= 0x10000)
+         {
+            ch -= 0x10000;
+            *out++ = static_cast<wchar_t>(0xD800 + (ch >> 10));
+            *out++ = static_cast<wchar_t>(0xDC00 + (ch & 0x3FF));
+         }
+         else
+            *out++ = static_cast<wchar_t>(ch);
+
+         return trail + 1;
+      }
+
+      // ------------------------------- PUBLIC METHODS -------------------------------
+
+      /// <summary>Decodes the next chunk of input</summary>
+      /// <param name="input">Input chunk</param>
+      /// <param name="length">Length of input, in bytes</param>
+      /// <param name="output">Output buffer.  At most one character is written per byte of input, including any held from the previous chunk</param>
+      /// <param name="final">Whether this is the last chunk.  An incomplete sequence at the end is replaced rather than held</param>
+      /// <returns>Number of characters written</returns>
+      size_t  TextDecoder::Decode(const uint8_t* input, size_t length, wchar_t* output, bool final)
+      {
+         const uint8_t *in = input,
+                       *end = input + length;
+         wchar_t       *out = output;
+
+         // Windows-1250: ASCII runs, then table lookup
+         if (Source == Encoding::Windows1250)
+         {
+            while ((in = DecodeASCII(in, end, out)) < end)
+               *out++ = Windows1250[*in++ - 0x80];
+
+            return out - output;
+         }
+
+         // UTF-8: Complete sequence held from previous chunk
+         while (PendingLength > 0)
+         {
+            if (size_t used = DecodeSequence(Pending, Pending + PendingLength, out))
+            {
+               memmove(Pending, Pending + used, PendingLength - used);
+               PendingLength -= used;
+            }
+            else if (in < end)
+               Pending[PendingLength++] = *in++;
+            else
+               break;
+         }
+
+         // UTF-8: ASCII runs, then individual sequences
+         while ((in = DecodeASCII(in, end, out)) < end)
+         {
+            size_t used = DecodeSequence(in, end, out);
+
+            // Incomplete: Hold until next chunk
+            if (!used)
+            {
+               memcpy(Pending, in, end - in);
+               PendingLength = end - in;
+               break;
+            }
+            in += used;
+         }
+
+         // Final: Replace incomplete sequence
+         if (final && PendingLength > 0)
+         {
+            *out++ = 0xFFFD;
+            PendingLength = 0;
+         }
+
+         return out - output;
+      }
+
+      // ------------------------------ PROTECTED METHODS -----------------------------
+
+      // ------------------------------- PRIVATE METHODS ------------------------------
+
+   }
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Logic
+{
+   namespace IO
+   {
+
+      /// <summary>Decodes UTF-8 or Windows-1250 text into UTF-16, in chunks of any size</summary>
+      /// <remarks>Runs of ASCII are widened 16 bytes at a time using SSE2, where available.  Has no dependency upon the Win32 API.
+      /// Invalid UTF-8 is replaced by U+FFFD, one per maximal invalid subsequence.</remarks>
+      class LogicExport TextDecoder
+      {
+         // ------------------------ TYPES --------------------------
+      public:
+         /// <summary>Supported source encodings</summary>
+         enum class Encoding { UTF8, Windows1250 };
+
+         // --------------------- CONSTRUCTION ----------------------
+      public:
+         TextDecoder(Encoding enc);
+
+         // ------------------------ STATIC -------------------------
+      public:
+         static const wchar_t*  FindLineBreak(const wchar_t* pos, const wchar_t* end);
+
+      protected:
+         static const uint8_t*  DecodeASCII(const uint8_t* in, const uint8_t* end, wchar_t*& out);
+         static size_t          DecodeSequence(const uint8_t* in, const uint8_t* end, wchar_t*& out);
+
+         // --------------------- PROPERTIES ------------------------
+
+         // ---------------------- ACCESSORS ------------------------
+
+         // ----------------------- MUTATORS ------------------------
+      public:
+         size_t  Decode(const uint8_t* input, size_t length, wchar_t* output, bool final);
+
+         // -------------------- REPRESENTATION ---------------------
+      protected:
+         static const wchar_t  Windows1250[128];   // Upper half of code page 1250
+
+         Encoding  Source;          // Source encoding
+         uint8_t   Pending[4];      // Incomplete UTF-8 sequence from the end of the previous chunk
+         size_t    PendingLength;   // Length of incomplete sequence
+      };
+
+   }
+}
+
+using namespace Logic::IO;
@@ -24,16 +24,16 @@ namespace Logic
                /// <summary>Adds successors nodes to the traversal</summary>
                /// <param name="n">Node to visit</param>
                /// <exception cref="Logic::ArgumentNullException">Node is nullptr</exception>
-               void AddSuccessors(CommandNodePtr& n);
+               void AddSuccessors(CommandNode* n);
 
                /// <summary>Gets the next node in the traversal</summary>
                /// <returns></returns>
                /// <exception cref="Logic::AlgorithmException">Traversal is empty</exception>
-               CommandNodePtr GetSuccessor();
+               CommandNode* GetSuccessor();
             };
 
             /// <summary>Provides the iterator with a breadth first traversal</summary>
-            class BreadthTraversal : public ITraversal, public std::deque<CommandNodePtr>
+            class BreadthTraversal : public ITraversal, public std::deque<CommandNode*>
             {
                // --------------------- CONSTRUCTION ----------------------
 
@@ -48,16 +48,16 @@ namespace Logic
                /// <summary>Adds successors nodes to the traversal</summary>
                /// <param name="n">Node to visit</param>
                /// <exception cref="Logic::ArgumentNullException">Node is nullptr</exception>
-               void AddSuccessors(CommandNodePtr& n);
+               void AddSuccessors(CommandNode* n);
 
                /// <summary>Gets the next node in the traversal</summary>
                /// <returns></returns>
                /// <exception cref="Logic::AlgorithmException">Traversal is empty</exception>
-               CommandNodePtr GetSuccessor();
+               CommandNode* GetSuccessor();
             };
                
             /// <summary>Provides the iterator with a depth first traversal</summary>
-            class DepthTraversal : public ITraversal, public std::deque<CommandNodePtr>
+            class DepthTraversal : public ITraversal, public std::deque<CommandNode*>
             {
                // --------------------- CONSTRUCTION ----------------------
 
@@ -72,12 +72,12 @@ namespace Logic
                /// <summary>Adds successors nodes to the traversal</summary>
                /// <param name="n">Node to visit</param>
                /// <exception cref="Logic::ArgumentNullException">Node is nullptr</exception>
-               void AddSuccessors(CommandNodePtr& n);
+               void AddSuccessors(CommandNode* n);
 
                /// <summary>Gets the next node in the traversal</summary>
                /// <returns></returns>
                /// <exception cref="Logic::AlgorithmException">Traversal is empty</exception>
-               CommandNodePtr GetSuccessor();
+               CommandNode* GetSuccessor();
             };
 
          }
@@ -1,6 +1,8 @@
 #pragma once
 #include "CommandNode.h"
 
+FORWARD_DECLARATION(Logic,class GameDataSet)
+
 namespace Logic
 {
    namespace Scripts
@@ -84,8 +86,9 @@ namespace Logic
 
             // -------------------- REPRESENTATION ---------------------
          protected:
-            ErrorArray& Errors;     // Errors collection
-            ScriptFile& Script;     // Script file
+            ErrorArray&              Errors;     // Errors collection
+            ScriptFile&              Script;     // Script file
+            shared_ptr<GameDataSet>  GameData;   // Game data of the script's game, or nullptr to use the active set
          };
 
          /// <summary>Finalizes linkage between nodes</summary>
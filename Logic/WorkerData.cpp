@@ -7,11 +7,25 @@ namespace Logic
    {
       // -------------------------------- STATIC DATA  --------------------------------
 
+      /// <summary>Feedback from all operations, awaiting display</summary>
+      FeedbackQueue      WorkerData::Feedback;
+
       /// <summary>No operation feedback sentinel</summary>
       const WorkerData   WorkerData::NoFeedback;
 
       // -------------------------------- CONSTRUCTION --------------------------------
 
+      /// <summary>Creates an empty queue</summary>
+      /// <param name="capacity">Maximum number of items awaiting display</param>
+      FeedbackQueue::FeedbackQueue(UINT capacity) 
+         : Slots(max(1U, capacity)), Head(0), Count(0), Discarded(0), LastDiscarded(Operation::NoFeedback), WakePending(false)
+      {
+      }
+
+      FeedbackQueue::~FeedbackQueue()
+      {
+      }
+
       /// <summary>Creates 'No Feedback' sentinel data</summary>
       WorkerData::WorkerData() : ParentWnd(nullptr), Operation(Operation::NoFeedback), Aborted(false)
       {
@@ -48,6 +62,14 @@ namespace Logic
          throw ArgumentException(HERE, L"op", VString(L"Unrecognised operation: %d", op));
       }
 
+      /// <summary>Issues a progress report key, unique for the lifetime of the process</summary>
+      /// <returns>Non-zero key</returns>
+      UINT  FeedbackQueue::NewKey()
+      {
+         static volatile LONG  LastKey = 0;
+         return (UINT)InterlockedIncrement(&LastKey);
+      }
+
       // ------------------------------- PUBLIC METHODS -------------------------------
 
       /// <summary>Command worker to stop</summary>
@@ -55,6 +77,7 @@ namespace Logic
       void WorkerData::Abort()
       {
          Aborted.Signal(); // Signal abort event
+         Token.Cancel();   // Cancel scheduled tasks
       }
 
       /// <summary>Resets to initial state.</summary>
@@ -64,6 +87,121 @@ namespace Logic
          // Reset parent window + abort event
          ParentWnd = AfxGetApp()->m_pMainWnd;
          Aborted.Reset();
+
+         // Replace token: Tasks of the previous operation remain cancelled
+         Token = CancellationToken();
+      }
+
+      /// <summary>Removes all queued feedback</summary>
+      /// <param name="batch">On return, the first elements contain the feedback in order of arrival.  Existing elements are reused</param>
+      /// <returns>Number of items drained</returns>
+      UINT  FeedbackQueue::Drain(vector<WorkerProgress>& batch)
+      {
+         std::lock_guard<std::mutex> lock(Lock);
+         UINT count = Count;
+
+         // Make room, including a discard warning
+         if (batch.size() < Count+1)
+            batch.resize(Count+1);
+
+         // Exchange text buffers, so the slots reuse those of the previous batch
+         for (UINT i = 0; i < Count; ++i)
+         {
+            WorkerProgress& src = Slots[(Head + i) % Slots.size()].Progress;
+            batch[i].Operation = src.Operation;
+            batch[i].Type = src.Type;
+            batch[i].Indent = src.Indent;
+            batch[i].Text.swap(src.Text);
+         }
+
+         // Report items discarded while full
+         if (Discarded)
+         {
+            batch[count].Operation = LastDiscarded;
+            batch[count].Type = ProgressType::Warning;
+            batch[count].Indent = 1;
+            batch[count++].Text = VString(L"%d further messages were discarded", Discarded);
+         }
+
+         // Reset
+         Head = Count = Discarded = 0;
+         WakePending = false;
+         SpaceFreed.notify_all();
+         return count;
+      }
+
+      /// <summary>Queues feedback for display</summary>
+      /// <param name="op">Operation type</param>
+      /// <param name="t">Type of progress to report</param>
+      /// <param name="indent">Amount of identation.</param>
+      /// <param name="sz">Message</param>
+      /// <param name="key">Progress report key issued by NewKey, or zero</param>
+      /// <param name="cancel">Token cancelled if the operation is aborted while waiting</param>
+      /// <param name="wait">True to wait for space when full, false if called by the thread that drains the queue</param>
+      /// <returns>True if the caller must post a wake-up message</returns>
+      bool  FeedbackQueue::Push(Threads::Operation op, ProgressType t, UINT indent, const wstring& sz, UINT key, const CancellationToken& cancel, bool wait)
+      {
+         std::unique_lock<std::mutex> lock(Lock);
+
+         // Progress: Replace undisplayed report with same key
+         if (key)
+            for (UINT i = Count; i > 0; --i)
+            {
+               Slot& s = Slots[(Head + i-1) % Slots.size()];
+               if (s.Key == key)
+               {
+                  s.Progress.Type = t;
+                  s.Progress.Indent = indent;
+                  s.Progress.Text.assign(sz);
+                  return false;
+               }
+            }
+
+         // Full: Wait for main window to drain, polling for abort.  Progress reports only wait briefly
+         for (DWORD waited = 0; wait && Count == Slots.size() && !cancel.Cancelled && (!key || waited < PROGRESS_TIMEOUT); waited += 50)
+            SpaceFreed.wait_for(lock, std::chrono::milliseconds(50));
+
+         // Still full: Main window cannot wait upon itself, so grow rather than lose its feedback
+         if (Count == Slots.size() && !key && !cancel.Cancelled)
+            Grow();
+
+         // Still full: Discard progress report or feedback of an aborted operation
+         if (Count == Slots.size())
+         {
+            ++Discarded;
+            LastDiscarded = op;
+         }
+         else
+         {
+            // Copy into next slot, reusing its buffer
+            Slot& s = Slots[(Head + Count++) % Slots.size()];
+            s.Progress.Operation = op;
+            s.Progress.Type = t;
+            s.Progress.Indent = indent;
+            s.Progress.Text.assign(sz);
+            s.Key = key;
+         }
+
+         // Wake main window once per batch
+         if (WakePending)
+            return false;
+
+         return WakePending = true;
+      }
+
+      /// <summary>Called when the wake-up message could not be posted, so the next push posts another</summary>
+      void  FeedbackQueue::WakeFailed()
+      {
+         std::lock_guard<std::mutex> lock(Lock);
+         WakePending = false;
+      }
+
+      /// <summary>Doubles the capacity, preserving the order of queued feedback.  Lock must be held</summary>
+      void  FeedbackQueue::Grow()
+      {
+         rotate(Slots.begin(), Slots.begin() + Head, Slots.end());
+         Slots.resize(Slots.size() * 2);
+         Head = 0;
       }
 
       /// <summary>Inform main window of progress</summary>
@@ -74,7 +212,7 @@ namespace Logic
             return;
 
          // Output to GUI
-         ParentWnd->PostMessageW(WM_FEEDBACK, NULL, (LPARAM)new WorkerProgress(Operation, t, indent, sz));
+         Post(t, indent, sz, 0);
       }
 
       /// <summary>Inform main window of progress and print message to console</summary>
@@ -88,12 +226,42 @@ namespace Logic
          Console << c << sz << ENDL;
 
          // Output to GUI
-         ParentWnd->PostMessageW(WM_FEEDBACK, NULL, (LPARAM)new WorkerProgress(Operation, t, indent, sz));
+         Post(t, indent, sz, 0);
+      }
+
+      /// <summary>Inform main window of progress, replacing any earlier report with the same key that has not been displayed</summary>
+      /// <param name="key">Identifies the progress counter, issued by FeedbackQueue::NewKey</param>
+      /// <param name="indent">Amount of identation.</param>
+      /// <param name="sz">Message</param>
+      void WorkerData::SendProgress(UINT key, UINT indent, const wstring& sz) const
+      {
+         // Dummy: NOP
+         if (Operation == Operation::NoFeedback || !ParentWnd)
+            return;
+
+         // Output to GUI
+         Post(ProgressType::Info, indent, sz, key);
       }
 
       // ------------------------------ PROTECTED METHODS -----------------------------
 
       // ------------------------------- PRIVATE METHODS ------------------------------
+
+      /// <summary>Queues feedback and wakes the main window if necessary</summary>
+      /// <param name="t">Type of progress to report</param>
+      /// <param name="indent">Amount of identation.</param>
+      /// <param name="sz">Message</param>
+      /// <param name="key">Progress report key, or zero</param>
+      void WorkerData::Post(ProgressType t, UINT indent, const wstring& sz, UINT key) const
+      {
+         // Never wait on the thread that drains the queue
+         bool isMainThread = (GetWindowThreadProcessId(ParentWnd->GetSafeHwnd(), nullptr) == GetCurrentThreadId());
+
+         // Wake main window.  Failed: Retry upon next feedback
+         if (Feedback.Push(Operation, t, indent, sz, key, Token, !isMainThread))
+            if (!ParentWnd->PostMessageW(WM_FEEDBACK, NULL, NULL))
+               Feedback.WakeFailed();
+      }
    
    }
 }
@@ -1,6 +1,9 @@
 #pragma once
 #include "Event.h"
 #include "SyncEvent.h"
+#include "CancellationToken.h"
+#include <condition_variable>
+#include <mutex>
 
 namespace Logic
 {
@@ -9,7 +12,7 @@ namespace Logic
       class WorkerProgress;
       class WorkerData;
 
-      /// <summary>Feedback message</summary>
+      /// <summary>Feedback wake-up message, posted once per batch of queued feedback</summary>
       #define WM_FEEDBACK     (WM_USER+1)
 
       // ------------------------- TYPES -------------------------
@@ -60,6 +63,10 @@ namespace Logic
       {
          // --------------------- CONSTRUCTION ----------------------
       public:
+         /// <summary>Creates empty feedback, used to preallocate queue slots</summary>
+         WorkerProgress() : Operation(Threads::Operation::NoFeedback), Type(ProgressType::Info), Indent(0)
+         {}
+
          /// <summary>Create worker feedback.</summary>
          /// <param name="op">Operation type</param>
          /// <param name="t">Type of progress to report</param>
@@ -70,10 +77,72 @@ namespace Logic
 
          // -------------------- REPRESENTATION ---------------------
 
-         const Operation     Operation;      // Operation type
-         const ProgressType  Type;           // Progress report type
-         const wstring       Text;           // Report text
-         const UINT          Indent;         // Amount of Indentation 
+         Threads::Operation  Operation;      // Operation type
+         ProgressType        Type;           // Progress report type
+         wstring             Text;           // Report text
+         UINT                Indent;         // Amount of Indentation 
+      };
+
+
+      /// <summary>Bounded queue of feedback shared by all workers, drained by the main window in batches</summary>
+      /// <remarks>Feedback is copied into preallocated slots, whose text buffers are recycled, so pushing does not allocate once the slots have grown.
+      /// Only one wake-up message is posted per batch.  Progress reports pushed with a key replace any earlier report with the same key that has not been drained.
+      /// When full, producers of other feedback wait until the main window catches up or their operation is aborted.  Progress reports are only
+      /// waited upon briefly, then discarded.  The main window cannot wait upon itself, so its own feedback grows the queue instead.</remarks>
+      class LogicExport FeedbackQueue
+      {
+         // ------------------------ TYPES --------------------------
+      protected:
+         /// <summary>Queued feedback</summary>
+         class Slot
+         {
+         public:
+            Slot() : Key(0)
+            {}
+
+            WorkerProgress  Progress;    // Feedback
+            UINT            Key;         // Progress report key, or zero
+         };
+
+      public:
+         static const UINT  CAPACITY = 1024;
+
+      protected:
+         static const DWORD  PROGRESS_TIMEOUT = 1000;
+
+         // --------------------- CONSTRUCTION ----------------------
+      public:
+         FeedbackQueue(UINT capacity = CAPACITY);
+         virtual ~FeedbackQueue();
+
+         NO_COPY(FeedbackQueue);	// No copy semantics
+         NO_MOVE(FeedbackQueue);	// No move semantics
+
+         // ------------------------ STATIC -------------------------
+      public:
+         static UINT  NewKey();
+
+         // ---------------------- ACCESSORS ------------------------			
+
+         // ----------------------- MUTATORS ------------------------
+      public:
+         UINT  Drain(vector<WorkerProgress>& batch);
+         bool  Push(Threads::Operation op, ProgressType t, UINT indent, const wstring& sz, UINT key, const CancellationToken& cancel, bool wait);
+         void  WakeFailed();
+
+      private:
+         void  Grow();
+
+         // -------------------- REPRESENTATION ---------------------
+      private:
+         std::mutex               Lock;         // Guards all state
+         std::condition_variable  SpaceFreed;   // Signalled when drained
+         vector<Slot>             Slots;        // Circular buffer
+         UINT                     Head,         // Index of oldest feedback
+                                  Count,        // Number of queued items
+                                  Discarded;    // Number of items discarded since last drain
+         Threads::Operation       LastDiscarded;   // Operation of last discarded item
+         bool                     WakePending;  // Whether a wake-up has been posted and not yet answered
       };
 
 
@@ -96,10 +165,12 @@ namespace Logic
          // ------------------------ STATIC -------------------------
       public:
          const static WorkerData   NoFeedback;
+         static FeedbackQueue      Feedback;      // Feedback from all operations, awaiting display
 
          // --------------------- PROPERTIES ------------------------
 		public:
          PROPERTY_GET(ManualEvent,AbortEvent,GetAbortEvent);
+         PROPERTY_GET(CancellationToken,Cancellation,GetCancellation);
 
          // ---------------------- ACCESSORS ------------------------			
       public:
@@ -111,6 +182,13 @@ namespace Logic
             return Aborted;
          }
 
+         /// <summary>Gets the token cancelled by an abort, used to cancel any tasks scheduled by the operation</summary>
+         /// <returns></returns>
+         CancellationToken GetCancellation() const
+         {
+            return Token;
+         }
+
          /// <summary>Gets the parent window that received notifications.</summary>
          /// <returns></returns>
          CWnd* GetParent() const
@@ -130,6 +208,9 @@ namespace Logic
          /// <summary>Inform main window of progress and print message to console</summary>
          void  SendFeedback(Cons c, ProgressType t, UINT indent, const wstring& sz) const;
 
+         /// <summary>Inform main window of progress, replacing any earlier report with the same key that has not been displayed</summary>
+         void  SendProgress(UINT key, UINT indent, const wstring& sz) const;
+
          // ----------------------- MUTATORS ------------------------
       public:
          /// <summary>Command worker to stop</summary>
@@ -146,7 +227,11 @@ namespace Logic
 
       protected:
          ManualEvent      Aborted;      // Used to signal operation should be aborted
+         CancellationToken Token;       // Cancelled alongside the abort event
          CWnd*            ParentWnd;    // Window that received feedback notifications
+
+      private:
+         void  Post(ProgressType t, UINT indent, const wstring& sz, UINT key) const;
       };
 
       
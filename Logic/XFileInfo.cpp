@@ -119,12 +119,23 @@ namespace Logic
          return s;
       }
 
-      /// <summary>Opens a stream for writing</summary>
+      /// <summary>Opens a stream for writing, compressing .pck files at maximum compression</summary>
       /// <param name="filename">Optional: Name of file within GZip archive, if desired</param>
       /// <returns></returns>
       /// <exception cref="Logic::GZipException">Unable to inititalise stream</exception>
       /// <exception cref="Logic::IOException">Unable to create file</exception>
       StreamPtr  XFileInfo::OpenWrite(const wstring& filename) const
+      {
+         return OpenWrite(filename, CompressionOptions());
+      }
+
+      /// <summary>Opens a stream for writing</summary>
+      /// <param name="filename">Name of file within GZip archive, if desired, otherwise empty</param>
+      /// <param name="opt">Compression options for .pck files</param>
+      /// <returns></returns>
+      /// <exception cref="Logic::GZipException">Unable to inititalise stream</exception>
+      /// <exception cref="Logic::IOException">Unable to create file</exception>
+      StreamPtr  XFileInfo::OpenWrite(const wstring& filename, const CompressionOptions& opt) const
       {
          // Ensure physical
          if (Source == FileSource::Catalog)
@@ -136,7 +147,7 @@ namespace Logic
          // PCK: Wrap in GZip compression stream
          if (FullPath.HasExtension(L".pck") || FullPath.HasExtension(L".zip"))
          {
-            shared_ptr<GZipStream> gzip(new GZipStream(s, GZipStream::Operation::Compression));
+            shared_ptr<GZipStream> gzip(new GZipStream(s, GZipStream::Operation::Compression, opt));
 
             // Set filename within archive
             gzip->SetFileName(!filename.empty() ? filename : FullPath.RemoveExtension().FileName);
@@ -5,11 +5,16 @@
 
 namespace Logic
 {
+   namespace IO
+   {
+      class CompressionOptions;
+   }
    
    namespace FileSystem
    {
       class XFileSystem;
       class XCatalog;
+      class XFileTable;
       
       /// <summary>Identifies whether a file is on disk or within a catalog</summary>
       enum class FileSource  { Catalog, Physical };
@@ -17,6 +22,8 @@ namespace Logic
       /// <summary>Represents a file descriptor for any physical or catalog based file</summary>
       class LogicExport XFileInfo
       {
+         friend class XFileTable;
+
          // --------------------- CONSTRUCTION ----------------------
       public:
          XFileInfo(const Path& p);
@@ -41,6 +48,7 @@ namespace Logic
          bool       Matches(Path path, bool checkExtension) const;
          StreamPtr  OpenRead() const;
          StreamPtr  OpenWrite(const wstring& filename = L"") const;
+         StreamPtr  OpenWrite(const wstring& filename, const IO::CompressionOptions& opt) const;
 
 			// ----------------------- MUTATORS ------------------------
 
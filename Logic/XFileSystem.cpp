@@ -1,6 +1,9 @@
 #include "stdafx.h"
 #include "XFileSystem.h"
 #include "FileSearch.h"
+#include "PreferencesLibrary.h"
+#include "Profiler.h"
+#include <Shlwapi.h>
 #include <algorithm>
 #include <functional>
 
@@ -15,13 +18,16 @@ namespace Logic
       /// <summary>Initializes a new instance of the <see cref="XFileSystem"/> class.</summary>
       XFileSystem::XFileSystem() : Version(GameVersion::Threat)
       {
+         // Search only the folders containing game data, unless overridden by the user
+         list<wstring> folders = PrefsLib.GameDataIncludeFolders;
+         SetIncludeFolders(!folders.empty() ? folders : list<wstring>({ L"director", L"scripts", L"t", L"types" }));
       }
 
       /// <summary>Releases the locks on the catalogs</summary>
       XFileSystem::~XFileSystem()
       {
          Catalogs.clear();
-         Files.clear();
+         Files.Clear();
       }
       
       // ------------------------------- STATIC METHODS -------------------------------
@@ -51,6 +57,35 @@ namespace Logic
          throw ArgumentException(HERE, L"f", L"Unknown XFolder constant");
       }
 
+      /// <summary>Determines whether a file is a catalog or data file</summary>
+      /// <param name="p">Full path</param>
+      /// <returns></returns>
+      bool  XFileSystem::IsCatalogFile(const Path& p)
+      {
+         return p.HasExtension(L".cat") || p.HasExtension(L".dat");
+      }
+
+      /// <summary>Searches a folder for physical files</summary>
+      /// <param name="folder">Full path of folder</param>
+      /// <param name="results">On return, contains the full paths of files found, in depth-first order</param>
+      /// <param name="recurse">Whether to search sub-folders</param>
+      void  XFileSystem::SearchFolder(const Path& folder, list<wstring>& results, bool recurse)
+      {
+         for (FileSearch fs(folder.AppendBackslash() + L"*.*"); fs.HasResult(); fs.Next())
+         {
+            // Skip catalogs/datafiles
+            if (fs.FileName == L"." || fs.FileName == L".." || IsCatalogFile(fs.FullPath))
+               continue;
+
+            // Add files, recurse into folders
+            if (!fs.IsDirectory())
+               results.push_back(fs.FullPath.c_str());
+            else if (recurse)
+               SearchFolder(fs.FullPath, results, true);
+         }
+      }
+
+
 		// ------------------------------- PUBLIC METHODS -------------------------------
       
       /// <summary>Searches for all files within a known folder</summary>
@@ -68,17 +103,8 @@ namespace Logic
       /// <exception cref="Logic::IOException">I/O error occurred</exception>
       XFileList  XFileSystem::Browse(Path  folder) const
       {
-         XFileList results;
-
-         // Ensure trailing backslash
-         folder = folder.AppendBackslash();
-
-         // Copy all files with exactly the same folder
-         for (auto pair : Files)
-            if (folder == pair.first.Folder)
-               results.push_back(pair.second);
-
-         return results;
+         std::lock_guard<std::mutex> lock(Lock);
+         return Files.Browse(*this, folder);
       }
 
       /// <summary>Queries whether file system contains a file</summary>
@@ -86,7 +112,8 @@ namespace Logic
       /// <returns></returns>
       bool  XFileSystem::Contains(Path  path) const
       {
-         return Files.find(path) != Files.end();
+         std::lock_guard<std::mutex> lock(Lock);
+         return Files.Contains(path);
       }
 
       /// <summary>Enumerates and locks the catalogs and their contents.  Any previous contents are cleared.</summary>
@@ -101,11 +128,13 @@ namespace Logic
       /// <exception cref="Logic::IOException">I/O error occurred</exception>
       DWORD  XFileSystem::Enumerate(Path folder, GameVersion ver, const WorkerData* data)
       {
+         PROFILE_FUNCTION();
          REQUIRED(data);
+         std::lock_guard<std::mutex> lock(Lock);
 
          // Clear previous
+         Files.Clear();
          Catalogs.clear();
-         Files.clear();
 
          // Ensure trailing backslash
          Folder = folder.AppendBackslash();
@@ -128,7 +157,7 @@ namespace Logic
          EnumerateFiles(data);
 
          // Return count
-         return Files.size();
+         return Files.Count;
       }
 
       /// <summary>Queries whether file system contains a file</summary>
@@ -137,14 +166,41 @@ namespace Logic
       /// <exception cref="Logic::FileNotFoundException">File not found</exception>
       XFileInfo XFileSystem::Find(Path  path) const
       {
-         auto it = Files.find(path);
+         std::lock_guard<std::mutex> lock(Lock);
+         return Files.Find(*this, path);
+      }
 
-         // Error: file not found
-         if (it == Files.end())
-            throw FileNotFoundException(HERE, path);
+      /// <summary>Re-searches a single folder for physical files, without searching its sub-folders</summary>
+      /// <param name="folder">Full path of folder whose contents have changed</param>
+      /// <returns>True if refreshed, false if the folder is not searched for physical files</returns>
+      /// <remarks>Catalog files overridden by physical files that no longer exist are restored.  Safe to call from the file watcher thread</remarks>
+      /// <exception cref="Logic::IOException">I/O error occurred</exception>
+      bool  XFileSystem::Refresh(Path folder)
+      {
+         list<wstring> results;
+
+         // Skip folders pruned by the include list
+         if (!IsIncludedFolder(folder))
+            return false;
+
+         // Search folder, unless removed
+         if (folder.Exists())
+            SearchFolder(folder, results, false);
+
+         // Replace previous contents
+         std::lock_guard<std::mutex> lock(Lock);
+         Files.RemovePhysical(folder);
+         for (auto& path : results)
+            Files.Add(nullptr, path, 0, 0);
+         return true;
+      }
 
-         // Return result 
-         return it->second;
+      /// <summary>Sets the game sub-folders searched for physical files. Takes effect upon the next enumeration or refresh</summary>
+      /// <param name="folders">Names of top-level folders to search</param>
+      /// <remarks>Not thread safe: Must not be called while the file system is being watched</remarks>
+      void  XFileSystem::SetIncludeFolders(const list<wstring>& folders)
+      {
+         IncludeFolders = folders;
       }
 
       /// <summary>Gets the full path of a known subfolder</summary>
@@ -159,7 +215,35 @@ namespace Logic
 		// ------------------------------ PROTECTED METHODS -----------------------------
 
 		// ------------------------------- PRIVATE METHODS ------------------------------
-      
+
+      /// <summary>Determines whether a top-level game sub-folder should be searched for physical files</summary>
+      /// <param name="folder">Name of folder</param>
+      /// <returns></returns>
+      bool  XFileSystem::IsIncluded(const wstring& folder) const
+      {
+         return any_of(IncludeFolders.begin(), IncludeFolders.end(), [&folder](const wstring& f) {return StrCmpI(f.c_str(), folder.c_str()) == 0;});
+      }
+
+      /// <summary>Determines whether a folder is searched for physical files</summary>
+      /// <param name="folder">Full path of folder</param>
+      /// <returns>True for the game folder and folders within an included top-level sub-folder</returns>
+      bool  XFileSystem::IsIncludedFolder(Path folder) const
+      {
+         wstring path = folder.AppendBackslash().c_str();
+
+         // Ensure within game folder
+         if (path.length() < Folder.Length || StrCmpNI(path.c_str(), Folder.c_str(), Folder.Length) != 0)
+            return false;
+         path.erase(0, Folder.Length);
+
+         // X3AP: Treat addon folder as a game folder
+         if (Version == GameVersion::AlbionPrelude && StrCmpNI(path.c_str(), L"addon\\", 6) == 0)
+            path.erase(0, 6);
+
+         // Game folder: Files always searched.  Sub-folder: Search if within an included top-level folder
+         return path.empty() || IsIncluded(path.substr(0, path.find(L'\\')));
+      }
+
       /// <summary>Enumerates and locks the catalogs</summary>
       /// <returns></returns>
       /// <exception cref="Logic::IOException">I/O error occurred</exception>
@@ -215,7 +299,7 @@ namespace Logic
                // Iterate thru declarations + insert. Calculate running offset.  (Duplicate files are automatically discarded)
                CatalogReader  reader(cat.GetReader());
                for (DWORD offset = 0; reader.ReadDeclaration(path, size); offset += size)
-                  Files.Add( XFileInfo(*this, cat, path, size, offset) );
+                  Files.Add(&cat, (Folder+path).c_str(), size, offset);
 
                // Feedback
                Console << Cons::Success << ENDL;
@@ -226,16 +310,37 @@ namespace Logic
             }
          }
 
-         // Enumerate physical files
-         EnumerateFolder(Folder);
+         // Search game folder, queue included sub-folders
+         FolderSearchList searches;
+         EnumerateFolder(Folder, searches);
+
+         // Search sub-folders concurrently upon the task scheduler
+         TaskProgress progress(data, L"Searching folders", searches.size());
+         TaskArray tasks;
+         for (auto& s : searches)
+            tasks.push_back(TaskScheduler::GetDefault().Run([&s,&progress] (const CancellationToken&) -> DWORD 
+            {
+               SearchFolder(s.Folder, s.Results, true);
+               progress.Advance();
+               return 0;
+            }, data->Cancellation));
+
+         // Wait for all searches.  Rethrows the first error
+         TaskScheduler::GetDefault().WaitAll(tasks);
+
+         // Add physical files in search order, regardless of which completed first
+         for (auto& s : searches)
+            for (auto& path : s.Results)
+               Files.Add(nullptr, path, 0, 0);
 
          // Return count
-         return Files.size();
+         return Files.Count;
       }
 
-      /// <summary>Enumerates physical files within the folder</summary>
+      /// <summary>Adds the physical files within a game folder and queues the included sub-folders to be searched</summary>
       /// <param name="folder">The folder path</param>
-      void  XFileSystem::EnumerateFolder(Path  folder)
+      /// <param name="searches">Receives the sub-folders to be searched</param>
+      void  XFileSystem::EnumerateFolder(Path  folder, FolderSearchList& searches)
       {
          folder = folder.AppendBackslash();
 
@@ -243,16 +348,21 @@ namespace Logic
          for (FileSearch fs(folder + L"*.*"); fs.HasResult(); fs.Next())
          {
             // Skip catalogs/datafiles
-            if (fs.FileName == L"." || fs.FileName == L".." || fs.FullPath.HasExtension(L".cat") || fs.FullPath.HasExtension(L".dat"))
+            if (fs.FileName == L"." || fs.FileName == L".." || IsCatalogFile(fs.FullPath))
                continue;
 
-            // Add files, recurse into folders
+            // Add files
             if (!fs.IsDirectory())
-               Files.Add(XFileInfo(fs.FullPath));
-            else
-               EnumerateFolder(fs.FullPath);
+               Files.Add(nullptr, fs.FullPath.c_str(), 0, 0);
+
+            // X3AP: Treat addon folder as a game folder
+            else if (Version == GameVersion::AlbionPrelude && folder == Folder && StrCmpI(fs.FileName.c_str(), L"addon") == 0)
+               EnumerateFolder(fs.FullPath, searches);
+
+            // Queue included folders, prune the rest
+            else if (IsIncluded(fs.FileName))
+               searches.push_back(FolderSearch(fs.FullPath));
          }
-         
       }
 
 		// -------------------------------- NESTED CLASSES ------------------------------
@@ -2,7 +2,9 @@
 
 #include "XCatalog.h"
 #include "XFileInfo.h"
+#include "XFileTable.h"
 #include "BackgroundWorker.h"
+#include <mutex>
 
 namespace Logic
 {
@@ -33,32 +35,20 @@ namespace Logic
             void  Add(XCatalog&& c)  { push_front(std::move(c)); }
          };
 
-         /// <summary>Collection of file descriptors</summary>
-         class FileCollection : public map<Path, XFileInfo>
+         /// <summary>Physical files found beneath a folder by a search thread</summary>
+         class FolderSearch
          {
          public:
-            // ---------------------- PROPERTIES -----------------------
-         
-            PROPERTY_GET(size_type,Count,size);
+            FolderSearch(const Path& f) : Folder(f)
+            {}
 
-            // ----------------------- MUTATORS ------------------------
-         
-            /// <summary>Attempts to add a file to the collection, overwriting any of lower precedence</summary>
-            /// <param name="f">The file to add</param>
-            void  Add(const XFileInfo& f)
-            {
-               _Pairib res = insert(value_type(f.Key, f));
-
-               // Exists: Overwrite if higher precendence
-               if (!res.second && f.Precedence > res.first->second.Precedence)
-               {
-                  //res.first->second = f;
-                  erase(res.first);
-                  insert(value_type(f.Key, f));
-               }
-            }
+            Path           Folder;     // Folder to search, recursively
+            list<wstring>  Results;    // Full paths of files found, in depth-first order
          };
 
+         /// <summary>Folder searches, each walked by its own thread</summary>
+         typedef list<FolderSearch>  FolderSearchList;
+
       public:
          // --------------------- CONSTRUCTION ----------------------
          XFileSystem();
@@ -72,6 +62,10 @@ namespace Logic
       public:
          static Path  GetPath(Path folder, GameVersion ver, XFolder f);
 
+      private:
+         static bool          IsCatalogFile(const Path& p);
+         static void          SearchFolder(const Path& folder, list<wstring>& results, bool recurse);
+
          // --------------------- PROPERTIES ------------------------
 
          // ---------------------- ACCESSORS ------------------------
@@ -84,21 +78,29 @@ namespace Logic
          Path         GetFolder() const            { return Folder;  }
          GameVersion  GetVersion() const           { return Version; }
 
+      private:
+         bool         IsIncluded(const wstring& folder) const;
+         bool         IsIncludedFolder(Path folder) const;
+
 			// ----------------------- MUTATORS ------------------------
       public:
          DWORD   Enumerate(Path folder, GameVersion version, const WorkerData* data = &WorkerData::NoFeedback);
+         bool    Refresh(Path folder);
+         void    SetIncludeFolders(const list<wstring>& folders);
          
       private:
          DWORD   EnumerateCatalogs();
          DWORD   EnumerateFiles(const WorkerData* data);
-         void    EnumerateFolder(Path  folder);
+         void    EnumerateFolder(Path  folder, FolderSearchList& searches);
          
          // -------------------- REPRESENTATION ---------------------
       private:
-         CatalogCollection  Catalogs;
-         FileCollection     Files;
-         Path               Folder;
-         GameVersion        Version;
+         CatalogCollection    Catalogs;
+         XFileTable           Files;
+         Path                 Folder;
+         GameVersion          Version;
+         list<wstring>        IncludeFolders;   // Names of game subfolders searched for physical files
+         mutable std::mutex   Lock;             // Guards the files against refreshes by the file watcher
       };
 
    }
@@ -0,0 +1,319 @@
+#include "stdafx.h"
+#include "XFileTable.h"
+#include "XFileSystem.h"
+#include <Shlwapi.h>
+
+namespace Logic
+{
+   namespace FileSystem
+   {
+      // -------------------------------- CONSTRUCTION --------------------------------
+
+      /// <summary>Creates an empty table</summary>
+      XFileTable::XFileTable() : Arena(new MemoryArena())
+      {
+      }
+
+      /// <summary>Nothing</summary>
+      XFileTable::~XFileTable()
+      {
+      }
+
+      // ------------------------------- STATIC METHODS -------------------------------
+
+      /// <summary>Folds the case of a character.  Used for both hashing and comparison, so equal strings always hash equally</summary>
+      /// <param name="ch">Character</param>
+      /// <returns>Upper case equivalent, as mapped by the system  [independent of the CRT locale]</returns>
+      wchar  XFileTable::FoldCase(wchar ch)
+      {
+         // ASCII: Fold directly
+         if (ch < 0x80)
+            return ch >= 'a' && ch <= 'z' ? ch - ('a'-'A') : ch;
+
+         return (wchar)(UINT_PTR)CharUpper(reinterpret_cast<LPWSTR>((UINT_PTR)ch));
+      }
+
+      /// <summary>Gets the length of a file name excluding the extension</summary>
+      /// <param name="name">File name</param>
+      /// <returns></returns>
+      UINT  XFileTable::GetKeyLength(const wchar* name)
+      {
+         return PathFindExtension(name) - name;
+      }
+
+      /// <summary>Hashes a string, ignoring case</summary>
+      /// <param name="s">String</param>
+      /// <returns></returns>
+      size_t  XFileTable::StringHash::operator()(const StringRef& s) const
+      {
+         size_t hash = 2166136261U;
+
+         // FNV-1a over case-folded characters
+         for (UINT i = 0; i < s.Length; ++i)
+            hash = (hash ^ FoldCase(s.Text[i])) * 16777619U;
+
+         return hash;
+      }
+
+      /// <summary>Compares two strings, ignoring case</summary>
+      /// <param name="a">First string</param>
+      /// <param name="b">Second string</param>
+      /// <returns></returns>
+      bool  XFileTable::StringEqual::operator()(const StringRef& a, const StringRef& b) const
+      {
+         if (a.Length != b.Length)
+            return false;
+
+         // Fold as per StringHash
+         for (UINT i = 0; i < a.Length; ++i)
+            if (a.Text[i] != b.Text[i] && FoldCase(a.Text[i]) != FoldCase(b.Text[i]))
+               return false;
+
+         return true;
+      }
+
+      // ------------------------------- PUBLIC METHODS -------------------------------
+
+      /// <summary>Adds a file to the table, overwriting any with the same key of lower precedence</summary>
+      /// <param name="cat">Catalog containing the file, or nullptr for physical files</param>
+      /// <param name="fullPath">Full path of the file</param>
+      /// <param name="size">Length within data file</param>
+      /// <param name="offset">Position within data file</param>
+      void  XFileTable::Add(const XCatalog* cat, const wstring& fullPath, DWORD size, DWORD offset)
+      {
+         // Split into folder + filename
+         UINT length = fullPath.find_last_of(L'\\') + 1;
+         UINT folder = AddFolder(fullPath.c_str(), length);
+         const wchar* name = Intern(fullPath.c_str() + length, fullPath.length() - length);
+
+         // Generate descriptor
+         FileEntry entry = { cat, name, folder, offset, size, XFileInfo::CalculatePrecendence(cat ? FileSource::Catalog : FileSource::Physical, fullPath) };
+
+         // New: Append to table and folder
+         auto res = FileIndex.insert(FileMap::value_type(FileKey(folder, name, GetKeyLength(name)), Entries.size()));
+         if (res.second)
+         {
+            Children[folder].push_back(Entries.size());
+            Entries.push_back(entry);
+         }
+         // Exists: Overwrite if higher precendence
+         else if (entry.Precedence > Entries[res.first->second].Precedence)
+         {
+            // Physical overriding catalog: Preserve catalog file in case physical file is removed
+            if (!cat && Entries[res.first->second].Catalog)
+               Shadowed[res.first->second] = Entries[res.first->second];
+
+            Entries[res.first->second] = entry;
+         }
+      }
+
+      /// <summary>Searches for all files within a folder</summary>
+      /// <param name="vfs">File system</param>
+      /// <param name="folder">Full path of folder</param>
+      /// <returns>Results collection, ordered by path</returns>
+      XFileList  XFileTable::Browse(const XFileSystem& vfs, Path folder) const
+      {
+         XFileList results;
+
+         // Ensure trailing backslash
+         folder = folder.AppendBackslash();
+
+         // Lookup folder
+         int index = FindFolder(folder.c_str(), folder.Length);
+         if (index == -1)
+            return results;
+
+         // Order by key
+         IndexArray files(Children[index]);
+         sort(files.begin(), files.end(), [this](UINT a, UINT b) -> bool
+         {
+            const wchar *x = Entries[a].Name,
+                        *y = Entries[b].Name;
+            UINT lx = GetKeyLength(x),
+                 ly = GetKeyLength(y);
+
+            int cmp = StrCmpNI(x, y, min(lx, ly));
+            return cmp != 0 ? cmp < 0 : lx < ly;
+         });
+
+         // Generate descriptors
+         for (UINT i : files)
+            results.push_back(GetFileInfo(vfs, Entries[i]));
+
+         return results;
+      }
+
+      /// <summary>Clears the table</summary>
+      void  XFileTable::Clear()
+      {
+         FileIndex.clear();
+         FolderIndex.clear();
+         Children.clear();
+         Folders.clear();
+         Entries.clear();
+         Shadowed.clear();
+         Strings.clear();
+
+         // Release strings
+         Arena.reset(new MemoryArena());
+      }
+
+      /// <summary>Queries whether the table contains a file</summary>
+      /// <param name="key">Full path EXCLUDING extension</param>
+      /// <returns></returns>
+      bool  XFileTable::Contains(Path key) const
+      {
+         return FindEntry(key) != nullptr;
+      }
+
+      /// <summary>Finds a file</summary>
+      /// <param name="vfs">File system</param>
+      /// <param name="key">Full path EXCLUDING extension</param>
+      /// <returns>File descriptor</returns>
+      /// <exception cref="Logic::FileNotFoundException">File not found</exception>
+      XFileInfo  XFileTable::Find(const XFileSystem& vfs, Path key) const
+      {
+         auto entry = FindEntry(key);
+
+         // Error: file not found
+         if (!entry)
+            throw FileNotFoundException(HERE, key);
+
+         return GetFileInfo(vfs, *entry);
+      }
+
+      /// <summary>Gets the number of files</summary>
+      /// <returns></returns>
+      UINT  XFileTable::GetCount() const
+      {
+         return FileIndex.size();
+      }
+
+      /// <summary>Removes the physical files within a folder, restoring any catalog files they overrode</summary>
+      /// <param name="folder">Full path of folder</param>
+      void  XFileTable::RemovePhysical(Path folder)
+      {
+         // Ensure trailing backslash
+         folder = folder.AppendBackslash();
+
+         // Lookup folder
+         int index = FindFolder(folder.c_str(), folder.Length);
+         if (index == -1)
+            return;
+
+         auto& files = Children[index];
+         for (auto it = files.begin(); it != files.end(); )
+         {
+            FileEntry& e = Entries[*it];
+            auto shadow = Shadowed.find(*it);
+
+            // Catalog: Skip
+            if (e.Catalog)
+               ++it;
+            // Physical overriding catalog: Restore catalog file
+            else if (shadow != Shadowed.end())
+            {
+               e = shadow->second;
+               Shadowed.erase(shadow);
+               ++it;
+            }
+            // Physical: Remove from indicies.  (Descriptor remains unreferenced until cleared)
+            else
+            {
+               FileIndex.erase(FileKey(index, e.Name, GetKeyLength(e.Name)));
+               it = files.erase(it);
+            }
+         }
+      }
+
+      // ------------------------------ PROTECTED METHODS -----------------------------
+
+      /// <summary>Adds a folder, if not already present</summary>
+      /// <param name="folder">Folder path, with trailing backslash</param>
+      /// <param name="length">Length of path</param>
+      /// <returns>Index of folder</returns>
+      UINT  XFileTable::AddFolder(const wchar* folder, UINT length)
+      {
+         int index = FindFolder(folder, length);
+
+         // New: Intern path
+         if (index == -1)
+         {
+            const wchar* path = Intern(folder, length);
+
+            index = Folders.size();
+            FolderIndex.insert(FolderMap::value_type(StringRef(path, length), index));
+            Folders.push_back(path);
+            Children.push_back(IndexArray());
+         }
+
+         return index;
+      }
+
+      /// <summary>Finds a file by key</summary>
+      /// <param name="key">Full path EXCLUDING extension</param>
+      /// <returns>Descriptor if found, otherwise nullptr</returns>
+      const XFileTable::FileEntry*  XFileTable::FindEntry(const Path& key) const
+      {
+         const wchar* path = key.c_str();
+
+         // Split into folder + filename
+         const wchar* name = PathFindFileName(path);
+         int folder = FindFolder(path, name - path);
+         if (folder == -1)
+            return nullptr;
+
+         // Lookup file
+         auto it = FileIndex.find(FileKey(folder, name, lstrlen(name)));
+         return it != FileIndex.end() ? &Entries[it->second] : nullptr;
+      }
+
+      /// <summary>Finds a folder</summary>
+      /// <param name="folder">Folder path, with trailing backslash</param>
+      /// <param name="length">Length of path</param>
+      /// <returns>Index of folder if found, otherwise -1</returns>
+      int  XFileTable::FindFolder(const wchar* folder, UINT length) const
+      {
+         auto it = FolderIndex.find(StringRef(folder, length));
+         return it != FolderIndex.end() ? (int)it->second : -1;
+      }
+
+      /// <summary>Generates the file descriptor for an entry</summary>
+      /// <param name="vfs">File system</param>
+      /// <param name="e">Entry</param>
+      /// <returns></returns>
+      XFileInfo  XFileTable::GetFileInfo(const XFileSystem& vfs, const FileEntry& e) const
+      {
+         wstring path = wstring(Folders[e.Folder]) + e.Name;
+
+         // Physical: Full path
+         if (!e.Catalog)
+            return XFileInfo(Path(path));
+
+         // Catalog: Path relative to file-system folder
+         return XFileInfo(vfs, *e.Catalog, path.substr(vfs.GetFolder().Length), e.Length, e.Offset);
+      }
+
+      /// <summary>Interns a string</summary>
+      /// <param name="str">String</param>
+      /// <param name="length">Length of string</param>
+      /// <returns>Null terminated copy, shared by all equal strings</returns>
+      const wchar*  XFileTable::Intern(const wchar* str, UINT length)
+      {
+         // Existing: Re-use
+         auto it = Strings.find(StringRef(str, length));
+         if (it != Strings.end() && StrCmpN(it->Text, str, length) == 0)
+            return it->Text;
+
+         // New: Copy into arena
+         auto copy = static_cast<wchar*>(Arena->Allocate((length+1) * sizeof(wchar), __alignof(wchar)));
+         wmemcpy(copy, str, length);
+         copy[length] = L'\0';
+
+         Strings.insert(StringRef(copy, length));
+         return copy;
+      }
+
+      // ------------------------------- PRIVATE METHODS ------------------------------
+   }
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "XFileInfo.h"
+#include "MemoryArena.h"
+#include <unordered_map>
+#include <unordered_set>
+
+namespace Logic
+{
+   namespace FileSystem
+   {
+      class XFileSystem;
+      class XCatalog;
+
+      /// <summary>Compact table of file descriptors, indexed by folder and by key (full path without extension)</summary>
+      /// <remarks>Folder paths and file names are interned into an arena and compared case-insensitively.
+      /// Descriptors are only created when requested.</remarks>
+      class LogicExport XFileTable
+      {
+         // ------------------------ TYPES --------------------------
+      protected:
+         /// <summary>Reference to a string, not necessarily null terminated</summary>
+         class StringRef
+         {
+         public:
+            StringRef(const wchar* txt, UINT len) : Text(txt), Length(len)
+            {}
+
+            const wchar*  Text;
+            UINT          Length;
+         };
+
+         /// <summary>Case-insensitive string reference hash</summary>
+         class StringHash
+         {
+         public:
+            size_t operator()(const StringRef& s) const;
+         };
+
+         /// <summary>Case-insensitive string reference comparison</summary>
+         class StringEqual
+         {
+         public:
+            bool operator()(const StringRef& a, const StringRef& b) const;
+         };
+
+         /// <summary>Identifies a file by folder and file name without extension</summary>
+         class FileKey : public StringRef
+         {
+         public:
+            FileKey(UINT folder, const wchar* name, UINT len) : StringRef(name, len), Folder(folder)
+            {}
+
+            UINT  Folder;
+         };
+
+         /// <summary>Case-insensitive file key hash</summary>
+         class FileKeyHash
+         {
+         public:
+            size_t operator()(const FileKey& k) const  { return StringHash()(k) ^ (k.Folder * 2654435761U); }
+         };
+
+         /// <summary>Case-insensitive file key comparison</summary>
+         class FileKeyEqual
+         {
+         public:
+            bool operator()(const FileKey& a, const FileKey& b) const  { return a.Folder == b.Folder && StringEqual()(a, b); }
+         };
+
+         /// <summary>Compact file descriptor</summary>
+         class FileEntry
+         {
+         public:
+            const XCatalog*  Catalog;        // Catalog containing file, or nullptr if physical
+            const wchar*     Name;           // Interned file name, including extension
+            UINT             Folder;         // Index of folder
+            DWORD            Offset,         // Position within data file
+                             Length,         // Length within data file
+                             Precedence;     // File precedence
+         };
+
+         typedef unordered_map<StringRef,UINT,StringHash,StringEqual>  FolderMap;
+         typedef unordered_map<FileKey,UINT,FileKeyHash,FileKeyEqual>  FileMap;
+         typedef unordered_set<StringRef,StringHash,StringEqual>       StringSet;
+         typedef unordered_map<UINT,FileEntry>                         ShadowMap;
+         typedef vector<UINT>                                          IndexArray;
+
+         // --------------------- CONSTRUCTION ----------------------
+      public:
+         XFileTable();
+         virtual ~XFileTable();
+
+         NO_COPY(XFileTable);	// Cannot copy semantics
+         NO_MOVE(XFileTable);	// Cannot move semantics
+
+         // ------------------------ STATIC -------------------------
+      protected:
+         static wchar  FoldCase(wchar ch);
+         static UINT   GetKeyLength(const wchar* name);
+
+         // --------------------- PROPERTIES ------------------------
+      public:
+         PROPERTY_GET(UINT,Count,GetCount);
+
+         // ---------------------- ACCESSORS ------------------------
+      public:
+         XFileList  Browse(const XFileSystem& vfs, Path folder) const;
+         bool       Contains(Path key) const;
+         XFileInfo  Find(const XFileSystem& vfs, Path key) const;
+         UINT       GetCount() const;
+
+      protected:
+         const FileEntry*  FindEntry(const Path& key) const;
+         int               FindFolder(const wchar* folder, UINT length) const;
+         XFileInfo         GetFileInfo(const XFileSystem& vfs, const FileEntry& e) const;
+
+         // ----------------------- MUTATORS ------------------------
+      public:
+         void  Add(const XCatalog* cat, const wstring& fullPath, DWORD size, DWORD offset);
+         void  Clear();
+         void  RemovePhysical(Path folder);
+
+      protected:
+         UINT          AddFolder(const wchar* folder, UINT length);
+         const wchar*  Intern(const wchar* str, UINT length);
+
+         // -------------------- REPRESENTATION ---------------------
+      protected:
+         MemoryArenaPtr       Arena;         // Storage for interned strings
+         StringSet            Strings;       // Interned strings
+         vector<FileEntry>    Entries;       // File descriptors
+         vector<const wchar*> Folders;       // Interned folder paths, with trailing backslash
+         vector<IndexArray>   Children;      // Indicies of files within each folder
+         FolderMap            FolderIndex;   // Index of each folder
+         FileMap              FileIndex;     // Index of each file, by key
+         ShadowMap            Shadowed;      // Catalog files overridden by physical files, by index
+      };
+
+   }
+}
+
+using namespace Logic::FileSystem;
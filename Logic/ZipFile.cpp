@@ -5,58 +5,323 @@ namespace Logic
 {
    namespace IO
    {
-   
+
       // -------------------------------- CONSTRUCTION --------------------------------
 
       /// <summary>Create zip file</summary>
       /// <param name="p">Full path</param>
-      /// <exception cref="Logic::IO::XZipException">Unable to create file handle</exception>
-      ZipFile::ZipFile(const Path& p) : Handle(nullptr)
+      /// <param name="opt">Compression level, strategy and number of entries compressed concurrently.  Entries are compressed on the default task scheduler</param>
+      /// <exception cref="Logic::IOException">Unable to create file</exception>
+      ZipFile::ZipFile(const Path& p, const CompressionOptions& opt)
+         : Output(new FileStream(p, FileMode::CreateAlways, FileAccess::Write)), Options(opt)
       {
-         // Create handle
-         if ((Handle = CreateZip((void*)p.c_str(), 0, ZIP_FILENAME)) == nullptr)
-            throw XZipException(HERE, ZR_RECENT);
       }
 
+      /// <summary>Releases the file. Archives that were not closed are incomplete</summary>
       ZipFile::~ZipFile()
       {
       }
 
       // ------------------------------- STATIC METHODS -------------------------------
 
+      /// <summary>Deflates an entry into memory, streaming the input from disc</summary>
+      /// <param name="e">The entry.  On return, contains the output, checksum and lengths or an error</param>
+      /// <param name="opt">Compression options</param>
+      void  ZipFile::CompressEntry(Entry& e, const CompressionOptions& opt)
+      {
+         z_stream zs;
+         ZeroMemory(&zs, sizeof(zs));
+
+         try
+         {
+            GetTimeStamp(e);
+
+            // Open input
+            FileStream in(e.FullPath, FileMode::OpenExisting, FileAccess::Read);
+            DWORD total = in.GetLength();
+
+            // Init raw deflate stream
+            if (deflateInit2(&zs, opt.Level, Z_DEFLATED, -15, 9, opt.Strategy) != Z_OK)
+            {
+               e.Error = GuiString::Convert(zs.msg ? zs.msg : "Unable to initialise compression", CP_ACP);
+               return;
+            }
+
+            unique_ptr<BYTE[]> input(new BYTE[CHUNK_SIZE]);
+            e.Checksum = crc32(0L, Z_NULL, 0);
+            int flush;
+
+            // Compress input in chunks
+            do
+            {
+               DWORD read = in.Read(input.get(), min(CHUNK_SIZE, total - e.Length));
+               e.Checksum = crc32(e.Checksum, input.get(), read);
+               e.Length += read;
+
+               // Finish once all input is consumed, or the file is truncated
+               flush = (e.Length == total || read == 0 ? Z_FINISH : Z_NO_FLUSH);
+               zs.next_in = input.get();
+               zs.avail_in = read;
+
+               // Drain output
+               do
+               {
+                  auto pos = e.Output.size();
+                  e.Output.resize(pos + CHUNK_SIZE);
+                  zs.next_out = &e.Output[pos];
+                  zs.avail_out = CHUNK_SIZE;
+
+                  deflate(&zs, flush);
+                  e.Output.resize(pos + CHUNK_SIZE - zs.avail_out);
+               }
+               while (zs.avail_out == 0);
+            }
+            while (flush != Z_FINISH);
+
+            e.CompressedLength = e.Output.size();
+         }
+         catch (ExceptionBase& ex) {
+            e.Error = ex.Message;
+         }
+         catch (std::exception& ex) {
+            e.Error = GuiString::Convert(ex.what(), CP_ACP);
+         }
+
+         deflateEnd(&zs);
+      }
+
+      /// <summary>Encodes a little-endian value</summary>
+      /// <param name="pos">Output position</param>
+      /// <param name="value">The value</param>
+      /// <param name="bytes">Number of bytes</param>
+      /// <returns>Position following the value</returns>
+      BYTE*  ZipFile::Encode(BYTE* pos, DWORD value, UINT bytes)
+      {
+         for (UINT i = 0; i < bytes; ++i, value >>= 8)
+            *pos++ = (BYTE)(value & 0xff);
+
+         return pos;
+      }
+
+      /// <summary>Reads the modification date of an entry's input file, in DOS format</summary>
+      /// <param name="e">The entry</param>
+      void  ZipFile::GetTimeStamp(Entry& e)
+      {
+         WIN32_FILE_ATTRIBUTE_DATA attr;
+         FILETIME local;
+
+         if (GetFileAttributesEx(e.FullPath.c_str(), GetFileExInfoStandard, &attr) && FileTimeToLocalFileTime(&attr.ftLastWriteTime, &local))
+            FileTimeToDosDateTime(&local, &e.Date, &e.Time);
+      }
+
+      /// <summary>Determines whether a file is already compressed</summary>
+      /// <param name="p">Full path</param>
+      /// <returns></returns>
+      bool  ZipFile::IsCompressed(const Path& p)
+      {
+         return p.HasExtension(L".pck") || p.HasExtension(L".zip");
+      }
+
       // ------------------------------- PUBLIC METHODS -------------------------------
 
-      /// <summary>Add file to the archive.</summary>
+      /// <summary>Add file to the archive.  Files are read when the archive is closed</summary>
       /// <param name="path">Fullpath</param>
       /// <param name="name">Subpath displayed within archive.</param>
-      /// <exception cref="Logic::IO::XZipException">Unable to add file -or- file already closed</exception>
+      /// <exception cref="Logic::IO::XZipException">Too many files -or- file already closed</exception>
       void  ZipFile::Add(const Path& path, const wstring& name)
       {
          // Verify state
-         if (!Handle)
+         if (!Output)
             throw XZipException(HERE, L"File has been closed");
+         else if (Entries.size() == 0xffff)
+            throw XZipException(HERE, L"Archive cannot contain more than 65535 files");
+
+         // Use forward slashes within archive
+         wstring subPath(name);
+         replace(subPath.begin(), subPath.end(), L'\\', L'/');
 
-         // Add file
-         if (ZipAdd(Handle, name.c_str(), (void*)path.c_str(), 0, ZIP_FILENAME) != ZR_OK)
-            throw XZipException(HERE, ZR_RECENT);
+         Entries.push_back(Entry(path, GuiString::Convert(subPath, CP_UTF8), IsCompressed(path)));
+
+         // Flag UTF-8 names
+         auto& e = Entries.back();
+         if (any_of(e.Name.begin(), e.Name.end(), [](char ch) {return (ch & 0x80) != 0;}))
+            e.Flags |= 0x0800;
       }
 
-      /// <summary>Writes the file to disc</summary>
-      /// <exception cref="Logic::IO::XZipException">Unable to write file</exception>
+      /// <summary>Compresses the files concurrently and writes the archive to disc</summary>
+      /// <exception cref="Logic::FileNotFoundException">File not found</exception>
+      /// <exception cref="Logic::IOException">An I/O error occurred</exception>
+      /// <exception cref="Logic::IO::XZipException">Unable to compress file</exception>
       void  ZipFile::Close()
       {
-         // Close/Write file
-         if (Handle && CloseZip(Handle) != ZR_OK)
-            throw XZipException(HERE, ZR_RECENT);
-         
-         // Cleanup
-         Handle = nullptr;
+         auto&          scheduler = TaskScheduler::GetDefault();
+         const UINT     window = Options.Threads * 2;
+         deque<TaskPtr> pending;                      // Compression of deflated entries not yet written, in archive order
+         auto           next = Entries.begin();       // Next entry to consider for compression
+
+         // Verify state
+         if (!Output)
+            return;
+
+         // Queues deflated entries for compression until the window is full
+         auto fill = [&]()
+         {
+            for (; next != Entries.end() && pending.size() < window; ++next)
+               if (!next->Stored)
+               {
+                  Entry* e = &*next;
+                  pending.push_back(scheduler.Run([e,this] (const CancellationToken&) -> DWORD { CompressEntry(*e, Options); return 0; }));
+               }
+         };
+
+         try
+         {
+            // Write entries in order, as each completes
+            for (auto& e : Entries)
+            {
+               fill();
+
+               if (e.Stored)
+               {
+                  StoreEntry(e);
+                  continue;
+               }
+
+               // Oldest pending task compresses this entry
+               auto task = pending.front();
+               pending.pop_front();
+               task->GetResult();
+
+               if (!e.Error.empty())
+                  throw XZipException(HERE, e.Error);
+
+               // Write header + data, then release data
+               e.Offset = Output->GetPosition();
+               WriteLocalHeader(e);
+               if (!e.Output.empty())
+                  Output->Write(&e.Output[0], e.Output.size());
+               vector<BYTE>().swap(e.Output);
+            }
+
+            WriteCentralDirectory();
+            Output->Close();
+         }
+         catch (...) {
+            // Abandon remaining entries, entries being compressed must complete
+            for (auto& t : pending)
+               t->Wait();
+            Output.reset();
+            throw;
+         }
+
+         Output.reset();
       }
 
       // ------------------------------ PROTECTED METHODS -----------------------------
 
+      /// <summary>Writes an entry without compression, streaming the input from disc</summary>
+      /// <param name="e">The entry</param>
+      /// <exception cref="Logic::FileNotFoundException">File not found</exception>
+      /// <exception cref="Logic::IOException">An I/O error occurred</exception>
+      void  ZipFile::StoreEntry(Entry& e)
+      {
+         GetTimeStamp(e);
+
+         // Open input
+         FileStream in(e.FullPath, FileMode::OpenExisting, FileAccess::Read);
+         unique_ptr<BYTE[]> buffer(new BYTE[CHUNK_SIZE]);
+
+         // Write header with placeholder checksum/lengths
+         e.Offset = Output->GetPosition();
+         e.Checksum = crc32(0L, Z_NULL, 0);
+         WriteLocalHeader(e);
+
+         // Copy input in chunks
+         for (DWORD read; (read = in.Read(buffer.get(), CHUNK_SIZE)) > 0; e.Length += read)
+         {
+            e.Checksum = crc32(e.Checksum, buffer.get(), read);
+            Output->Write(buffer.get(), read);
+         }
+         e.CompressedLength = e.Length;
+
+         // Rewrite header
+         DWORD end = Output->GetPosition();
+         Output->Seek(e.Offset, SeekOrigin::Begin);
+         WriteLocalHeader(e);
+         Output->Seek(end, SeekOrigin::Begin);
+      }
+
+      /// <summary>Writes the central directory and end of central directory record</summary>
+      /// <exception cref="Logic::IOException">An I/O error occurred</exception>
+      void  ZipFile::WriteCentralDirectory()
+      {
+         DWORD start = Output->GetPosition();
+
+         // Write directory entries
+         for (auto& e : Entries)
+         {
+            BYTE header[46], *pos = header;
+
+            pos = Encode(pos, 0x02014b50, 4);                     // Signature
+            pos = Encode(pos, 20, 2);                             // Version made by  [MS-DOS, v2.0]
+            pos = Encode(pos, 20, 2);                             // Version needed
+            pos = Encode(pos, e.Flags, 2);                        // Flags
+            pos = Encode(pos, e.Stored ? 0 : Z_DEFLATED, 2);      // Method
+            pos = Encode(pos, e.Time, 2);                         // Modification time
+            pos = Encode(pos, e.Date, 2);                         // Modification date
+            pos = Encode(pos, e.Checksum, 4);                     // CRC32
+            pos = Encode(pos, e.CompressedLength, 4);             // Compressed length
+            pos = Encode(pos, e.Length, 4);                       // Length
+            pos = Encode(pos, e.Name.length(), 2);                // Name length
+            pos = Encode(pos, 0, 2);                              // Extra field length
+            pos = Encode(pos, 0, 2);                              // Comment length
+            pos = Encode(pos, 0, 2);                              // Disk number
+            pos = Encode(pos, 0, 2);                              // Internal attributes
+            pos = Encode(pos, FILE_ATTRIBUTE_ARCHIVE, 4);         // External attributes
+            pos = Encode(pos, e.Offset, 4);                       // Local header position
+
+            Output->Write(header, sizeof(header));
+            Output->Write((const BYTE*)e.Name.c_str(), e.Name.length());
+         }
+
+         // Write end record
+         BYTE record[22], *pos = record;
+         pos = Encode(pos, 0x06054b50, 4);                        // Signature
+         pos = Encode(pos, 0, 2);                                 // Disk number
+         pos = Encode(pos, 0, 2);                                 // Disk containing directory
+         pos = Encode(pos, Entries.size(), 2);                    // Entries on this disk
+         pos = Encode(pos, Entries.size(), 2);                    // Entries
+         pos = Encode(pos, Output->GetPosition() - start, 4);     // Directory length
+         pos = Encode(pos, start, 4);                             // Directory position
+         pos = Encode(pos, 0, 2);                                 // Comment length
+
+         Output->Write(record, sizeof(record));
+      }
+
+      /// <summary>Writes the local header of an entry</summary>
+      /// <param name="e">The entry</param>
+      /// <exception cref="Logic::IOException">An I/O error occurred</exception>
+      void  ZipFile::WriteLocalHeader(const Entry& e)
+      {
+         BYTE header[30], *pos = header;
+
+         pos = Encode(pos, 0x04034b50, 4);                        // Signature
+         pos = Encode(pos, 20, 2);                                // Version needed
+         pos = Encode(pos, e.Flags, 2);                           // Flags
+         pos = Encode(pos, e.Stored ? 0 : Z_DEFLATED, 2);         // Method
+         pos = Encode(pos, e.Time, 2);                            // Modification time
+         pos = Encode(pos, e.Date, 2);                            // Modification date
+         pos = Encode(pos, e.Checksum, 4);                        // CRC32
+         pos = Encode(pos, e.CompressedLength, 4);                // Compressed length
+         pos = Encode(pos, e.Length, 4);                          // Length
+         pos = Encode(pos, e.Name.length(), 2);                   // Name length
+         pos = Encode(pos, 0, 2);                                 // Extra field length
+
+         Output->Write(header, sizeof(header));
+         Output->Write((const BYTE*)e.Name.c_str(), e.Name.length());
+      }
+
       // ------------------------------- PRIVATE METHODS ------------------------------
-   
+
    }
 }
-
@@ -1,26 +1,18 @@
 #pragma once
-#include "XZip.h"
+#include "GZipStream.h"
+#include "FileStream.h"
+#include "TaskScheduler.h"
 
 namespace Logic
 {
    namespace IO
    {
-      
-      /// <summary>XZip exception</summary>
+
+      /// <summary>Zip archive exception</summary>
       class LogicExport XZipException : public ExceptionBase
       {
       public:
-         /// <summary>Create XZip exception from an XZip error code</summary>
-         /// <param name="src">The source.</param>
-         /// <param name="code">The code.</param>
-         XZipException(const wstring& src, ZRESULT code) : ExceptionBase(src, code, L"")
-         {
-            char buf[128];
-            FormatZipMessageZ(code, buf, 128);
-            Message = GuiString::Convert(buf, CP_ACP);
-         }
-
-         /// <summary>Create XZip exception from a custom message</summary>
+         /// <summary>Create zip exception from a custom message</summary>
          /// <param name="src">The source.</param>
          /// <param name="msg">message.</param>
          XZipException(const wstring& src, const wstring& msg) : ExceptionBase(src, msg)
@@ -28,36 +20,74 @@ namespace Logic
          }
       };
 
-      
-      /// <summary></summary>
+
+      /// <summary>Writes zip archives, compressing entries concurrently and writing them in the order they were added</summary>
+      /// <remarks>Input files are streamed from disc.  Files that are already compressed are stored without recompression.
+      /// At most two entries per thread are compressed ahead of the writer, bounding the output held in memory.</remarks>
       class LogicExport ZipFile
       {
          // ------------------------ TYPES --------------------------
       protected:
+         /// <summary>File queued for archiving</summary>
+         class Entry
+         {
+         public:
+            Entry(const Path& path, const string& name, bool stored)
+               : FullPath(path), Name(name), Stored(stored), Flags(0), Checksum(0), Length(0), CompressedLength(0), Offset(0), Time(0), Date(0)
+            {}
+
+            Path          FullPath;            // Full path of input file
+            string        Name;                // UTF-8 path within archive
+            bool          Stored;              // Whether to store without compression
+            WORD          Flags;               // General purpose flags
+            vector<BYTE>  Output;              // Compressed data  [Deflated entries only]
+            uLong         Checksum;            // CRC32 of input
+            DWORD         Length,              // Length of input
+                          CompressedLength,    // Length of data within archive
+                          Offset;              // Position of local header within archive
+            WORD          Time,                // DOS modification time
+                          Date;                // DOS modification date
+            wstring       Error;               // Error, if any
+         };
+
+      private:
+         static const DWORD  CHUNK_SIZE = 64*1024;
 
          // --------------------- CONSTRUCTION ----------------------
 
       public:
-         ZipFile(const Path& p);
+         ZipFile(const Path& p, const CompressionOptions& opt = CompressionOptions());
          virtual ~ZipFile();
 
          NO_COPY(ZipFile);	// No copy semantics
          NO_MOVE(ZipFile);	// No move semantics
 
          // ------------------------ STATIC -------------------------
+      protected:
+         static void   CompressEntry(Entry& e, const CompressionOptions& opt);
+         static BYTE*  Encode(BYTE* pos, DWORD value, UINT bytes);
+         static void   GetTimeStamp(Entry& e);
+         static bool   IsCompressed(const Path& p);
 
          // --------------------- PROPERTIES ------------------------
 
-         // ---------------------- ACCESSORS ------------------------			
+         // ---------------------- ACCESSORS ------------------------
 
          // ----------------------- MUTATORS ------------------------
       public:
          void Add(const Path& f, const wstring& name);
          void Close();
 
+      protected:
+         void  StoreEntry(Entry& e);
+         void  WriteCentralDirectory();
+         void  WriteLocalHeader(const Entry& e);
+
          // -------------------- REPRESENTATION ---------------------
       protected:
-         HZIP Handle;
+         StreamPtr           Output;     // Archive, or nullptr once closed
+         CompressionOptions  Options;    // Compression options
+         list<Entry>         Entries;    // Entries in archive order
       };
 
    }
@@ -30,8 +30,10 @@
 #include <afxcontrolbars.h>     // MFC support for ribbons and control bars
 
 
-// Visual Leak Detector
+// Visual Leak Detector  [Optional outside the solution build]
+#ifndef NO_VLD
 #include <vld.h>
+#endif
 
 
 // STL
@@ -49,7 +51,7 @@ using namespace std;
 
 /// <summary>BugFix for Release version optimizing away [w]string::npos</summary>
 /// <remarks>See https://connect.microsoft.com/VisualStudio/feedback/details/586959/std  (Bug 586959) for details</remarks>
-#if _MSC_VER >= 1600
+#if _MSC_VER >= 1600 && _MSC_VER < 1900
 const wstring::size_type wstring::npos = (wstring::size_type) -1;
 #endif
 
@@ -110,6 +110,9 @@
 /// <summary>Disable some extra compiler features that produce byte-code that fails validation</summary>
 //#define STRICT_VALIDATION
 
+/// <summary>Compile profiling zones into the build, see Logic/Profiler.h</summary>
+//#define LOGIC_PROFILING
+
 /// <summary>Define the version number</summary>
 #define BUILD_VERSION  4
 
@@ -269,6 +269,7 @@
 #define IDC_ZIP_RADIO                   803
 #define IDC_SPK_RADIO                   804
 #define IDC_FOLDER_RADIO                805
+#define IDC_CATALOG_RADIO               806
 
 // About dialog
 #define IDC_NAME_STATIC                 800
@@ -0,0 +1,224 @@
+#include "stdafx.h"
+#include "BenchmarkCorpus.h"
+#include "../Logic/CatalogStream.h"
+#include "../Logic/DataStream.h"
+#include "../Logic/FileStream.h"
+#include "../Logic/ScriptFileWriter.h"
+#include "../Logic/ScriptParser.h"
+#include "../Logic/XFileInfo.h"
+#include "../Logic/XFileSystem.h"
+
+namespace Testing
+{
+   // -------------------------------- CONSTRUCTION --------------------------------
+
+   /// <summary>Creates a corpus description, nothing is generated until requested.</summary>
+   /// <param name="folder">Corpus folder.</param>
+   /// <param name="scripts">Number of scripts, the number of language pages scales with it.</param>
+   /// <param name="ver">Game version.</param>
+   BenchmarkCorpus::BenchmarkCorpus(Path folder, UINT scripts, GameVersion ver)
+      : Folder(folder.AppendBackslash()), 
+        Version(ver), 
+        Scripts(max(2U, scripts)), 
+        LanguageFiles(4), 
+        Pages(min(249U, max(1U, scripts / 20))),    // Keep page IDs within 30nnnn
+        Strings(100)
+   {
+   }
+
+   BenchmarkCorpus::~BenchmarkCorpus()
+   {
+   }
+
+   // ------------------------------- STATIC METHODS -------------------------------
+
+   /// <summary>Generates the text of a script from repeated blocks of commands, expressions and conditionals.</summary>
+   /// <param name="index">Script index, used to vary literals</param>
+   /// <param name="blocks">Number of blocks</param>
+   /// <returns></returns>
+   LineArray  BenchmarkCorpus::GenerateScript(UINT index, UINT blocks)
+   {
+      LineArray lines;
+
+      lines.push_back(VString(L"* Synthetic benchmark script %d", index));
+      lines.push_back(L"$total = 0");
+      
+      // Generate blocks
+      for (UINT b = 0; b < blocks; ++b)
+      {
+         UINT n = index * blocks + b;
+
+         lines.push_back(VString(L"* Block %d", b));
+         lines.push_back(L"$count = 0");
+         lines.push_back(L"$array = array alloc: size=0");
+         lines.push_back(VString(L"while $count < %d", 5 + n % 7));
+         lines.push_back(VString(L"   $value = random value from zero to %d", 100 + n));
+         lines.push_back(L"   append $value to array $array");
+         lines.push_back(L"   if $value > 50 AND $count != 3");
+         lines.push_back(L"      $total = $total + $value * 2");
+         lines.push_back(L"   else");
+         lines.push_back(L"      $total = $total - ( $value / 3 )");
+         lines.push_back(L"   end");
+         lines.push_back(L"   inc $count");
+         lines.push_back(L"end");
+         lines.push_back(L"$size = size of array $array");
+         lines.push_back(VString(L"write to log file %d append=null value=$size", 9000 + n % 100));
+      }
+
+      lines.push_back(L"return $total");
+      return lines;
+   }
+
+   /// <summary>Creates a folder and any intermediate folders.</summary>
+   /// <param name="f">The folder.</param>
+   /// <exception cref="Logic::IOException">Unable to create folder</exception>
+   void BenchmarkCorpus::CreateFolder(const Path& f)
+   {
+      switch (auto res = SHCreateDirectory(nullptr, f.c_str()))
+      {
+      case ERROR_SUCCESS:
+      case ERROR_ALREADY_EXISTS:
+      case ERROR_FILE_EXISTS:
+         break;
+
+      default:
+         throw IOException(HERE, SysErrorString(res));
+      }  
+   }
+
+   // ------------------------------- PUBLIC METHODS -------------------------------
+
+   /// <summary>Gets the path of the corpus catalog.</summary>
+   /// <returns></returns>
+   Path  BenchmarkCorpus::GetCatalogPath() const
+   {
+      return Folder + L"01.cat";
+   }
+
+   /// <summary>Gets the language folder.</summary>
+   /// <returns></returns>
+   Path  BenchmarkCorpus::GetLanguageFolder() const
+   {
+      return XFileSystem::GetPath(Folder, Version, XFolder::Language);
+   }
+
+   /// <summary>Gets the script folder.</summary>
+   /// <returns></returns>
+   Path  BenchmarkCorpus::GetScriptFolder() const
+   {
+      return XFileSystem::GetPath(Folder, Version, XFolder::Scripts);
+   }
+
+   /// <summary>Packs a copy of every fourth script and the first language file into a catalog/datafile pair</summary>
+   /// <exception cref="Logic::IOException">An I/O error occurred</exception>
+   void  BenchmarkCorpus::GenerateCatalog()
+   {
+      list<pair<Path,wstring>> entries;
+
+      // Select contents:  Store under different names to avoid masking the physical files
+      entries.push_back(make_pair(LanguageFolder + L"0001-L044.xml", wstring(L"t/0099-L044.xml")));
+      for (UINT i = 1; i < Scripts; i += 4)
+         entries.push_back(make_pair(ScriptFolder + VString(L"bench.%04d.pck", i), wstring(VString(L"scripts/cat.bench.%04d.pck", i))));
+
+      // Create catalog + datafile
+      StreamPtr cat(new CatalogStream(CatalogPath, FileMode::CreateAlways, FileAccess::Write));
+      FileStream dat(CatalogPath.RenameExtension(L".dat"), FileMode::CreateAlways, FileAccess::Write);
+
+      // Header
+      string header = "01.dat\n";
+      cat->Write((const BYTE*)header.c_str(), header.length());
+
+      // Append each file to datafile, declare in catalog
+      for (auto& e : entries)
+      {
+         StreamPtr src(new FileStream(e.first, FileMode::OpenExisting, FileAccess::Read));
+         DWORD length = src->GetLength();
+         auto  buffer = src->ReadAllBytes();
+         
+         // Encode + write 
+         for (DWORD i = 0; i < length; ++i)
+            buffer.get()[i] ^= DATAFILE_ENCRYPT_KEY;
+         dat.Write(buffer.get(), length);
+
+         // Declare
+         string decl = GuiString::Convert(VString(L"%s %d\n", e.second.c_str(), length), CP_ACP);
+         cat->Write((const BYTE*)decl.c_str(), decl.length());
+      }
+
+      cat->Close();
+      dat.Close();
+   }
+   
+   /// <summary>Generates language files whose strings contain nested references and comments.</summary>
+   /// <exception cref="Logic::IOException">An I/O error occurred</exception>
+   void  BenchmarkCorpus::GenerateLanguageFiles()
+   {
+      CreateFolder(LanguageFolder);
+
+      for (UINT f = 1; f <= LanguageFiles; ++f)
+      {
+         GuiString xml(L"<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\r\n<language id=\"44\">\r\n");
+
+         // Pages: Unique per file
+         for (UINT p = 0; p < Pages; ++p)
+         {
+            UINT page = FirstPageID + (f-1) * Pages + p;
+            xml += VString(L"  <page id=\"30%d\" title=\"Benchmark page %d\" descr=\"Synthetic strings\" voice=\"no\">\r\n", page, page);
+
+            // Strings: Reference the previous string on the page, and the first string of the first page
+            for (UINT s = 1; s <= Strings; ++s)
+               if (s == 1)
+                  xml += VString(L"    <t id=\"%d\">Synthetic string %d:%d (comment)</t>\r\n", s, page, s);
+               else
+                  xml += VString(L"    <t id=\"%d\">String %d of page %d refers to {%d,%d} and {%d,1} \\(not a comment\\)</t>\r\n", s, s, page, page, s-1, FirstPageID);
+
+            xml += L"  </page>\r\n";
+         }
+         xml += L"</language>\r\n";
+
+         // Write UTF-8
+         string utf8 = GuiString::Convert(xml, CP_UTF8);
+         FileStream fs(LanguageFolder + VString(L"%04d-L044.xml", f), FileMode::CreateAlways, FileAccess::Write);
+         fs.Write((const BYTE*)utf8.c_str(), utf8.length());
+         fs.Close();
+      }
+   }
+
+   /// <summary>Compiles the generated scripts, writing alternately as XML and PCK</summary>
+   /// <exception cref="Logic::AlgorithmException">Generated script failed to compile</exception>
+   /// <exception cref="Logic::IOException">An I/O error occurred</exception>
+   /// <remarks>Requires the syntax library and string library to have been loaded</remarks>
+   void  BenchmarkCorpus::GenerateScripts()
+   {
+      CreateFolder(ScriptFolder);
+
+      for (UINT i = 0; i < Scripts; ++i)
+      {
+         Path path = ScriptFolder + VString(i % 2 ? L"bench.%04d.pck" : L"bench.%04d.xml", i);
+         ScriptFile script(path);
+
+         // Properties
+         script.Name = path.RemoveExtension().FileName;
+         script.Description = L"Synthetic benchmark script";
+         script.Version = 1;
+         script.Game = Version;
+
+         // Compile
+         ScriptParser parser(script, GenerateScript(i, BlocksPerScript), Version);
+         if (!parser.Successful)
+            throw AlgorithmException(HERE, VString(L"Unable to compile generated script: %s", parser.Errors.begin()->Message.c_str()));
+         parser.Compile();
+
+         // Write
+         ScriptFileWriter w(XFileInfo(path).OpenWrite());
+         w.Write(script);
+         w.Close();
+      }
+   }
+
+   // ------------------------------ PROTECTED METHODS -----------------------------
+
+   // ------------------------------- PRIVATE METHODS ------------------------------
+
+}
+
@@ -0,0 +1,60 @@
+#pragma once
+
+namespace Testing
+{
+   /// <summary>Generates a deterministic synthetic game folder used by the benchmarks</summary>
+   /// <remarks>The corpus is laid out like a game folder:  Language files in 't', scripts in 'scripts' and a catalog/datafile pair containing
+   /// copies of some of each, so it can be loaded by the XFileSystem and game data libraries.</remarks>
+   class LogicExport BenchmarkCorpus
+   {
+      // ------------------------ TYPES --------------------------
+   protected:
+      // --------------------- CONSTRUCTION ----------------------
+   public:
+      BenchmarkCorpus(Path folder, UINT scripts, GameVersion ver = GameVersion::TerranConflict);
+      virtual ~BenchmarkCorpus();
+
+      DEFAULT_COPY(BenchmarkCorpus);	// Default copy semantics
+      DEFAULT_MOVE(BenchmarkCorpus);	// Default move semantics
+
+      // ------------------------ STATIC -------------------------
+   public:
+      static LineArray  GenerateScript(UINT index, UINT blocks);
+
+   protected:
+      static void       CreateFolder(const Path& f);
+
+      // --------------------- PROPERTIES ------------------------
+   public:
+      PROPERTY_GET(Path,CatalogPath,GetCatalogPath);
+      PROPERTY_GET(Path,LanguageFolder,GetLanguageFolder);
+      PROPERTY_GET(Path,ScriptFolder,GetScriptFolder);
+
+      // ---------------------- ACCESSORS ------------------------			
+   public:
+      Path  GetCatalogPath() const;
+      Path  GetLanguageFolder() const;
+      Path  GetScriptFolder() const;
+
+      // ----------------------- MUTATORS ------------------------
+   public:
+      void  GenerateCatalog();
+      void  GenerateLanguageFiles();
+      void  GenerateScripts();
+
+      // -------------------- REPRESENTATION ---------------------
+   public:
+      const Path         Folder;           // Corpus folder
+      const GameVersion  Version;          // Game version the corpus is generated for
+      const UINT         Scripts,          // Number of scripts
+                         LanguageFiles,    // Number of language files
+                         Pages,            // Pages per language file
+                         Strings;          // Strings per page
+
+      static const UINT  BlocksPerScript = 16,    // Number of command blocks per script (15 lines each)
+                         FirstPageID = 9000;      // ID of the first language page
+   };
+
+}
+
+using namespace Testing;
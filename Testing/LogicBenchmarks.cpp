@@ -0,0 +1,407 @@
+#include "stdafx.h"
+#include "LogicBenchmarks.h"
+#include "../Logic/CommandLexer.h"
+#include "../Logic/CommandNode.h"
+#include "../Logic/FileStream.h"
+#include "../Logic/GameDataWorker.h"
+#include "../Logic/GZipStream.h"
+#include "../Logic/LanguageFileReader.h"
+#include "../Logic/MatchData.h"
+#include "../Logic/ScriptFileReader.h"
+#include "../Logic/ScriptParser.h"
+#include "../Logic/Stopwatch.h"
+#include "../Logic/StringLibrary.h"
+#include "../Logic/StringResolver.h"
+#include "../Logic/SyntaxLibrary.h"
+#include "../Logic/XFileSystem.h"
+
+namespace Testing
+{
+   /// <summary>Number of allocations made through operator new by the logic library</summary>
+   volatile LONG  AllocationCount = 0;
+}
+
+/// <summary>Replaces the global operator new of the logic library to count allocations, in every configuration</summary>
+/// <param name="size">Size in bytes</param>
+/// <returns></returns>
+/// <remarks>The array, nothrow and sized forms are implemented by the CRT in terms of this</remarks>
+/// <exception cref="std::bad_alloc">Out of memory</exception>
+void* __cdecl  operator new(size_t size)
+{
+   InterlockedIncrement(&Testing::AllocationCount);
+
+   if (void* p = malloc(size ? size : 1))
+      return p;
+
+   throw std::bad_alloc();
+}
+
+/// <summary>Replaces the global operator delete of the logic library, to match operator new</summary>
+/// <param name="p">Block allocated by operator new</param>
+void __cdecl  operator delete(void* p) throw()
+{
+   free(p);
+}
+
+namespace Testing
+{
+
+   // -------------------------------- CONSTRUCTION --------------------------------
+
+   /// <summary>Creates the benchmarks.</summary>
+   /// <param name="folder">Corpus folder.</param>
+   /// <param name="scripts">Number of corpus scripts.</param>
+   /// <param name="iterations">Number of times each benchmark is repeated, the fastest is reported.</param>
+   LogicBenchmarks::LogicBenchmarks(Path folder, UINT scripts, UINT iterations) 
+      : Corpus(folder, scripts), Iterations(max(1U, iterations))
+   {
+   }
+
+   LogicBenchmarks::~LogicBenchmarks()
+   {
+   }
+
+   // ------------------------------- STATIC METHODS -------------------------------
+
+   /// <summary>Escapes a string for use within JSON.</summary>
+   /// <param name="str">The string.</param>
+   /// <returns></returns>
+   wstring  LogicBenchmarks::EscapeJson(const wstring& str)
+   {
+      wstring out;
+
+      for (wchar ch : str)
+         switch (ch)
+         {
+         case '\\':  out += L"\\\\";  break;
+         case '"':   out += L"\\\"";  break;
+         case '\r':  out += L"\\r";   break;
+         case '\n':  out += L"\\n";   break;
+         default:    out += ch;       break;
+         }
+
+      return out;
+   }
+
+   // ------------------------------- PUBLIC METHODS -------------------------------
+
+   /// <summary>Generates the corpus and loads it as the game data.</summary>
+   /// <param name="data">Worker data.</param>
+   /// <exception cref="Logic::AlgorithmException">Generated script failed to compile</exception>
+   /// <exception cref="Logic::ComException">COM error</exception>
+   /// <exception cref="Logic::IOException">An I/O error occurred</exception>
+   void  LogicBenchmarks::Generate(WorkerData* data)
+   {
+      // Language files first:  Scripts cannot be compiled without the string + syntax libraries
+      Corpus.GenerateLanguageFiles();
+      GameDataWorker::Load(Corpus.Folder, Corpus.Version, GameLanguage::English, data);
+
+      // Scripts + Catalog
+      Corpus.GenerateScripts();
+      Corpus.GenerateCatalog();
+
+      // Prepare inputs
+      ScriptText.clear();
+      ScriptFiles.clear();
+      for (UINT i = 0; i < Corpus.Scripts; ++i)
+      {
+         ScriptText.push_back(BenchmarkCorpus::GenerateScript(i, BenchmarkCorpus::BlocksPerScript));
+         ScriptFiles.push_back(Corpus.ScriptFolder + VString(i % 2 ? L"bench.%04d.pck" : L"bench.%04d.xml", i));
+      }
+   }
+
+   /// <summary>Runs all benchmarks, the corpus must have been generated.</summary>
+   /// <exception cref="Logic::ExceptionBase">Benchmark failed</exception>
+   void  LogicBenchmarks::Run()
+   {
+      Results.clear();
+
+      // Lexer: Tokenize every line
+      Measure(L"CommandLexer", [&](UINT64& bytes) -> UINT {
+         UINT ops = 0;
+         for (auto& lines : ScriptText)
+            for (auto& line : lines)
+            {
+               CommandLexer lex(line);
+               bytes += line.length() * sizeof(wchar);
+               ++ops;
+            }
+         return ops;
+      });
+
+      // Syntax: Identify every line 
+      Measure(L"SyntaxLibrary::Identify", [&](UINT64& bytes) -> UINT {
+         UINT ops = 0;
+         for (auto& lines : ScriptText)
+            for (auto& line : lines)
+            {
+               CommandLexer lex(line);
+               TokenIterator pos = lex.begin();
+               TokenList params;
+               SyntaxLib.Identify(pos, lex.end(), Corpus.Version, params);
+               bytes += line.length() * sizeof(wchar);
+               ++ops;
+            }
+         return ops;
+      });
+
+      // Parser: Parse, verify + compile every script
+      Measure(L"ScriptParser::Compile", [&](UINT64& bytes) -> UINT {
+         UINT ops = 0;
+         auto path = ScriptFiles.begin();
+         for (auto& lines : ScriptText)
+         {
+            ScriptFile script(*path++);
+            ScriptParser parser(script, lines, Corpus.Version);
+            if (parser.Successful)
+               parser.Compile();
+
+            for (auto& line : lines)
+               bytes += line.length() * sizeof(wchar);
+            ++ops;
+         }
+         return ops;
+      });
+
+      // Parser: Parse, verify + compile one large script  [Dominated by the tree passes]
+      LineArray large = BenchmarkCorpus::GenerateScript(0, LargeScriptBlocks);
+      Measure(L"CommandTree::Verify+Compile", [&](UINT64& bytes) -> UINT {
+         ScriptFile script(Corpus.ScriptFolder + L"bench.large.xml");
+         ScriptParser parser(script, large, Corpus.Version);
+         if (parser.Successful)
+            parser.Compile();
+
+         for (auto& line : large)
+            bytes += line.length() * sizeof(wchar);
+         return (UINT)large.size();
+      });
+
+      // Nodes: Create a node for every line within a new arena, then within one arena reset after each iteration  [Difference is the chunk allocations saved by reuse]
+      Measure(L"CommandNode (new arena)", [&](UINT64& bytes) -> UINT {
+         return CreateNodes(bytes, MemoryArenaPtr(new MemoryArena()));
+      });
+
+      MemoryArenaPtr reused(new MemoryArena());
+      Measure(L"CommandNode (reset arena)", [&](UINT64& bytes) -> UINT {
+         return CreateNodes(bytes, reused);
+      });
+
+      // Reader: Read every script  [Half are compressed]
+      Measure(L"ScriptFileReader", [&](UINT64& bytes) -> UINT {
+         for (auto& path : ScriptFiles)
+         {
+            auto s = XFileInfo(path).OpenRead();
+            bytes += s->GetLength();
+            ScriptFileReader(s).ReadFile(path, false);
+         }
+         return ScriptFiles.size();
+      });
+
+      // Language: Read every language file
+      Measure(L"LanguageFileReader", [&](UINT64& bytes) -> UINT {
+         for (UINT f = 1; f <= Corpus.LanguageFiles; ++f)
+         {
+            Path path = Corpus.LanguageFolder + VString(L"%04d-L044.xml", f);
+            auto s = XFileInfo(path).OpenRead();
+            bytes += s->GetLength();
+            LanguageFileReader(s).ReadFile(path);
+         }
+         return Corpus.LanguageFiles;
+      });
+
+      // Resolver: Resolve every string in the library
+      Measure(L"StringResolver", [&](UINT64& bytes) -> UINT {
+         UINT ops = 0;
+         for (auto& file : StringLib.Files)
+            for (auto& page : file)
+               for (auto& str : page)
+               {
+                  StringResolver res(str);
+                  bytes += res.Text.length() * sizeof(wchar);
+                  ++ops;
+               }
+         return ops;
+      });
+
+      // Search: Case insensitive search of every string  [Short, long + non-ASCII patterns.  Previous implementation first]
+      const wchar* patterns[] = { L"REFERS", L"(Not A Comment)", L"\u00C4rger", L"of page 12345 refers to {12345,1} and {12345,1}" };
+      Measure(L"StrStrI", [&](UINT64& bytes) -> UINT {
+         UINT ops = 0;
+         for (auto& file : StringLib.Files)
+            for (auto& page : file)
+               for (auto& str : page)
+                  for (auto p : patterns)
+                  {
+                     StrStrI(str.Text.c_str(), p);
+                     bytes += str.Text.length() * sizeof(wchar);
+                     ++ops;
+                  }
+         return ops;
+      });
+
+      Measure(L"TextSearch::Find", [&](UINT64& bytes) -> UINT {
+         UINT ops = 0;
+         for (auto& file : StringLib.Files)
+            for (auto& page : file)
+               for (auto& str : page)
+                  for (auto p : patterns)
+                  {
+                     TextSearch::Find(str.Text.c_str(), str.Text.length(), p, wcslen(p));
+                     bytes += str.Text.length() * sizeof(wchar);
+                     ++ops;
+                  }
+         return ops;
+      });
+
+      // GZip: Decompress every PCK
+      Measure(L"GZipStream::Read", [&](UINT64& bytes) -> UINT {
+         UINT ops = 0;
+         for (auto& path : ScriptFiles)
+            if (path.HasExtension(L".pck"))
+            {
+               StreamPtr s(new GZipStream(StreamPtr(new FileStream(path, FileMode::OpenExisting, FileAccess::Read)), GZipStream::Operation::Decompression));
+               bytes += s->GetLength();
+               s->ReadAllBytes();
+               ++ops;
+            }
+         return ops;
+      });
+
+      // Catalog: Enumerate file system + decode every catalog file
+      Measure(L"CatalogStream", [&](UINT64& bytes) -> UINT {
+         WorkerData data(Operation::NoFeedback);
+         XFileSystem vfs;
+         UINT ops = 0;
+         
+         vfs.Enumerate(Corpus.Folder, Corpus.Version, &data);
+         for (auto& f : vfs.Browse(XFolder::Scripts))
+            if (f.Source == FileSource::Catalog)
+            {
+               auto s = f.OpenRead();
+               bytes += s->GetLength();
+               s->ReadAllBytes();
+               ++ops;
+            }
+         return ops;
+      });
+
+      // Search: Find all matches in every script  [Mirrors SearchWorker FindAll]
+      Measure(L"SearchWorker::FindAll", [&](UINT64& bytes) -> UINT {
+         MatchData match(SearchTarget::ScriptFolder, L"$count", L"", false, false, false);
+         for (auto& path : ScriptFiles)
+         {
+            ScriptFile script = ScriptFileReader(XFileInfo(path).OpenRead()).ReadFile(path, false);
+            match.SetPath(path);
+            for (UINT start = 0; script.FindNext(start, match); start = match.End)
+               ;
+
+            // Text searched
+            for (auto& cmd : script.Commands.Input)
+               bytes += cmd.Text.length() * sizeof(wchar);
+         }
+         return ScriptFiles.size();
+      });
+   }
+
+   /// <summary>Saves the results as JSON.</summary>
+   /// <param name="path">Full path.</param>
+   /// <exception cref="Logic::IOException">An I/O error occurred</exception>
+   void  LogicBenchmarks::SaveResults(Path path) const
+   {
+      UINT i = 0;
+
+      // Corpus
+      GuiString json(L"{\r\n");
+#ifdef _DEBUG
+      json += L"  \"configuration\": \"Debug\",\r\n";
+#else
+      json += L"  \"configuration\": \"Release\",\r\n";
+#endif
+      json += VString(L"  \"corpus\": { \"folder\": \"%s\", \"scripts\": %d, \"languageFiles\": %d, \"pages\": %d, \"strings\": %d },\r\n", 
+                       EscapeJson(Corpus.Folder.c_str()).c_str(), Corpus.Scripts, Corpus.LanguageFiles, Corpus.Pages, Corpus.Strings);
+      json += VString(L"  \"iterations\": %d,\r\n", Iterations);
+
+      // Results
+      json += L"  \"results\": [\r\n";
+      for (auto& r : Results)
+      {
+         json += VString(L"    { \"name\": \"%s\", \"operations\": %d, \"bytes\": %I64u, \"milliseconds\": %.3f, \"opsPerSecond\": %.1f, \"mbPerSecond\": %.3f, ", 
+                          EscapeJson(r.Name).c_str(), r.Operations, r.Bytes, r.Milliseconds, r.GetOpsPerSecond(), r.GetMegabytesPerSecond());
+
+         // Allocations
+         json += VString(L"\"allocationsPerOp\": %.2f }", r.GetAllocationsPerOp());
+
+         json += (++i < Results.size() ? L",\r\n" : L"\r\n");
+      }
+      json += L"  ]\r\n}\r\n";
+
+      // Write UTF-8
+      string utf8 = GuiString::Convert(json, CP_UTF8);
+      FileStream fs(path, FileMode::CreateAlways, FileAccess::Write);
+      fs.Write((const BYTE*)utf8.c_str(), utf8.length());
+      fs.Close();
+   }
+
+   // ------------------------------ PROTECTED METHODS -----------------------------
+
+   /// <summary>Creates a command node for every line of the corpus, as children of one root, then releases them all by resetting the arena.</summary>
+   /// <param name="bytes">Accumulates the bytes of text processed</param>
+   /// <param name="arena">Arena to allocate nodes from</param>
+   /// <returns>Number of nodes created</returns>
+   UINT  LogicBenchmarks::CreateNodes(UINT64& bytes, MemoryArenaPtr arena)
+   {
+      UINT ops = 0;
+
+      // Link nodes to a root, as the parser would
+      {
+         CommandNodePtr root = CommandNode::Create(*arena);
+
+         for (auto& lines : ScriptText)
+            for (auto& line : lines)
+            {
+               CommandLexer   lex(line);
+               ParameterArray params(*arena);
+               ++ops;
+
+               *root += CommandNode::Create(*arena, Conditional::NONE, CommandSyntax::Unrecognised, params, lex, ops, false);
+               bytes += line.length() * sizeof(wchar);
+            }
+      }
+
+      // Release tree
+      arena->Reset();
+      return ops;
+   }
+
+   /// <summary>Runs a benchmark repeatedly, recording the fastest iteration.</summary>
+   /// <param name="name">Benchmark name.</param>
+   /// <param name="op">Operation, returns number of operations performed and accumulates the bytes of input processed</param>
+   void  LogicBenchmarks::Measure(const wstring& name, BenchmarkFunc op)
+   {
+      BenchmarkResult best(name);
+
+      for (UINT i = 0; i < Iterations; ++i)
+      {
+         BenchmarkResult r(name);
+         LONG  allocations = AllocationCount;
+         Stopwatch timer;
+
+         // Execute
+         r.Operations = op(r.Bytes);
+         r.Milliseconds = timer.ElapsedMilliseconds;
+         r.Allocations = AllocationCount - allocations;
+
+         // Record fastest
+         if (i == 0 || r.Milliseconds < best.Milliseconds)
+            best = r;
+      }
+
+      // Feedback
+      Console << Cons::Heading << name << Cons::White << L": " << best.Operations << L" ops in " << VString(L"%.1fms", best.Milliseconds) << ENDL;
+      Results.push_back(best);
+   }
+
+   // ------------------------------- PRIVATE METHODS ------------------------------
+
+}
+
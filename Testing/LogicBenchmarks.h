@@ -0,0 +1,101 @@
+#pragma once
+#include "BenchmarkCorpus.h"
+#include "../Logic/MemoryArena.h"
+
+namespace Testing
+{
+   /// <summary>Result of a single benchmark</summary>
+   class LogicExport BenchmarkResult
+   {
+      // --------------------- CONSTRUCTION ----------------------
+   public:
+      BenchmarkResult(const wstring& name) : Name(name), Operations(0), Bytes(0), Milliseconds(0), Allocations(-1)
+      {}
+
+      DEFAULT_COPY(BenchmarkResult);	// Default copy semantics
+      DEFAULT_MOVE(BenchmarkResult);	// Default move semantics
+
+      // ---------------------- ACCESSORS ------------------------			
+   public:
+      /// <summary>Gets the average number of heap allocations per operation, or -1 if not available</summary>
+      /// <returns></returns>
+      double  GetAllocationsPerOp() const
+      {
+         return Allocations >= 0 && Operations ? (double)Allocations / Operations : -1.0;
+      }
+
+      /// <summary>Gets the throughput in megabytes per second</summary>
+      /// <returns></returns>
+      double  GetMegabytesPerSecond() const
+      {
+         return Milliseconds > 0 ? (Bytes / (1024.0 * 1024.0)) / (Milliseconds / 1000.0) : 0.0;
+      }
+
+      /// <summary>Gets the throughput in operations per second</summary>
+      /// <returns></returns>
+      double  GetOpsPerSecond() const
+      {
+         return Milliseconds > 0 ? Operations / (Milliseconds / 1000.0) : 0.0;
+      }
+
+      // -------------------- REPRESENTATION ---------------------
+   public:
+      wstring  Name;            // Benchmark name
+      UINT     Operations;      // Number of operations performed
+      UINT64   Bytes;           // Number of bytes processed, if applicable
+      double   Milliseconds;    // Elapsed time of the fastest iteration
+      LONG     Allocations;     // Allocations by operator new during the fastest iteration  [-1 if not measured]
+   };
+
+   /// <summary>List of benchmark results</summary>
+   typedef list<BenchmarkResult>  BenchmarkResultList;
+
+   /// <summary>Measures the throughput of the logic library hot paths over a synthetic corpus</summary>
+   /// <remarks>Heap allocations are counted using the debug CRT allocation hook, so are only available in debug builds</remarks>
+   class LogicExport LogicBenchmarks
+   {
+      // ------------------------ TYPES --------------------------
+   protected:
+      typedef function<UINT (UINT64&)>  BenchmarkFunc;
+
+      // --------------------- CONSTRUCTION ----------------------
+   public:
+      LogicBenchmarks(Path folder, UINT scripts, UINT iterations = 3);
+      virtual ~LogicBenchmarks();
+
+      NO_COPY(LogicBenchmarks);	// No copy semantics
+      NO_MOVE(LogicBenchmarks);	// No move semantics
+
+      // ------------------------ STATIC -------------------------
+   protected:
+      static wstring  EscapeJson(const wstring& str);
+
+      // ---------------------- ACCESSORS ------------------------			
+   public:
+      void  SaveResults(Path path) const;
+
+      // ----------------------- MUTATORS ------------------------
+   public:
+      void  Generate(WorkerData* data);
+      void  Run();
+
+   protected:
+      UINT  CreateNodes(UINT64& bytes, MemoryArenaPtr arena);
+      void  Measure(const wstring& name, BenchmarkFunc op);
+
+      // -------------------- REPRESENTATION ---------------------
+   public:
+      BenchmarkCorpus      Corpus;        // Synthetic corpus
+      BenchmarkResultList  Results;       // Results, in order of execution
+      const UINT           Iterations;    // Number of times each benchmark is repeated
+
+   protected:
+      list<LineArray>      ScriptText;    // Script text, one per corpus script
+      list<Path>           ScriptFiles;   // Physical script paths
+
+      static const UINT    LargeScriptBlocks = 1000;   // Number of command blocks in the large script (15 lines each)
+   };
+
+}
+
+using namespace Testing;
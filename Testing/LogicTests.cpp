@@ -4,24 +4,39 @@
 #include "../Logic/ScriptParser.h"
 #include "../Logic/FileStream.h"
 #include "../Logic/CatalogStream.h"
+#include "../Logic/CatalogWriter.h"
+#include "../Logic/MemoryStream.h"
 #include "../Logic/GZipStream.h"
 #include "../Logic/StringReader.h"
+#include "../Logic/TextDecoder.h"
 #include "../Logic/LanguageFileReader.h"
+#include "../Logic/LanguageFileIndex.h"
 #include "../Logic/XFileSystem.h"
+#include "../Logic/XFileTable.h"
+#include "../Logic/XCatalog.h"
+#include "../Logic/GameDataSet.h"
+#include "../Logic/ProjectFile.h"
 #include "../Logic/LegacySyntaxFileReader.h"
 #include "../Logic/SyntaxLibrary.h"
 #include "../Logic/ScriptFileReader.h"
 #include "../Logic/StringLibrary.h"
+#include "../Logic/StringPool.h"
 #include "../Logic/XmlWriter.h"
 #include "../Logic/SyntaxFileWriter.h"
 #include "../Logic/ExpressionParser.h"
 #include "../Logic/CommandLexer.h"
+#include "../Logic/LineHighlighter.h"
+#include "../Logic/RegExPrefilter.h"
 #include "../Logic/TWare.h"
 #include "../Logic/TLaser.h"
 #include "../Logic/TreeTraversal.h"
 #include "../Logic/StringResolver.h"
 #include "../Logic/RichStringParser.h"
 #include "../Logic/DescriptionFileReader.h"
+#include "../Logic/TaskScheduler.h"
+#include "../Logic/BuildCacheReader.h"
+#include "../Logic/BuildCacheWriter.h"
+#include "../Logic/ProjectBuilder.h"
 #include "../DTL/dtl.hpp"
 #include "ScriptValidator.h"
 
@@ -45,13 +60,20 @@ namespace Testing
       //Test_DiffDocument();
 
       //Test_GZip_Compress();
+      //Test_GZip_Parallel();
+      //Test_TextDecoder();
+      //Test_ProjectFile();
       
 
       //Test_LanguageFileReader();
+      //Test_LanguageFileIndex();
       //Test_LanguageEditRegEx();
       //Test_CatalogReader();
+      //Test_CatalogWriter();
       //Test_GZip_Decompress();
       //Test_FileSystem();
+      //Test_XFileTable();
+      //Test_GameDataSet();
       //Test_CommandSyntax();
       //Test_StringLibrary();
       //Test_XmlWriter();
@@ -61,7 +83,15 @@ namespace Testing
       //Text_RegEx();
       //Test_Iterator();
       //BatchTest_ScriptCompiler();
+      //BatchTest_CodeArrayReader();
       //Test_Lexer();
+      //Test_LineHighlighter();
+      //Test_MemoryArena();
+      //Test_RegExPrefilter();
+      //Test_StringPool();
+      //Test_TaskScheduler();
+      //Test_BuildCache();
+      //Test_BuildDecisions();
 
       //theApp.WriteString(L"example", L"writeString");
       //theApp.WriteProfileStringW(L"Settings", L"example 1", L"WriteProfileStringW");
@@ -126,6 +156,98 @@ namespace Testing
       Test_DepthIterator(*sp.Tree.begin(), sp.Tree.begin());
    }
 
+   /// <summary>Exposes the codearray of the DOM script reader</summary>
+   class CodeArrayDocument : public ScriptValueReader
+   {
+   public:
+      CodeArrayDocument(StreamPtr in) : ScriptValueReader(in)
+      {
+         LoadDocument();
+      }
+
+      using ScriptValueReader::GetChild;
+      using ScriptValueReader::ReadAttribute;
+   };
+
+   /// <summary>Compares a codearray node read by the DOM reader against the pull reader.</summary>
+   /// <param name="dom">DOM reader.</param>
+   /// <param name="node">node.</param>
+   /// <param name="pull">pull reader, positioned at the same node.</param>
+   /// <returns>True if identical</returns>
+   bool Compare_CodeArray(CodeArrayDocument& dom, XmlNodePtr& node, CodeArrayReader& pull)
+   {
+      wstring type = dom.ReadAttribute(node, L"type");
+
+      // Array: Compare size + children
+      if (type == L"array")
+      {
+         UINT size = pull.ReadArray(L"array");
+         if (size != (UINT)node->childNodes->length)
+            return (Console << Cons::Red << "Array size mismatch: " << size << " vs " << (UINT)node->childNodes->length << ENDL, false);
+
+         for (UINT i = 0; i < size; ++i)
+            if (!Compare_CodeArray(dom, dom.GetChild(node, i, L"array element"), pull))
+               return false;
+
+         pull.EndArray();
+         return true;
+      }
+
+      // Int/String: Compare value
+      wstring expected = dom.ReadAttribute(node, L"val"),
+              actual = (type == L"int" ? VString(L"%d", pull.ReadInt(L"int")) : pull.ReadString(L"string"));
+
+      if (type == L"int")
+         expected = VString(L"%d", _wtoi(expected.c_str()));
+
+      if (expected != actual)
+         return (Console << Cons::Red << "Value mismatch: '" << expected << "' vs '" << actual << "'" << ENDL, false);
+      return true;
+   }
+
+   void LogicTests::BatchTest_CodeArrayReader()
+   {
+      XFileSystem vfs;
+      UINT count = 0, failed = 0;
+
+      // Feedback
+      Console << Cons::Heading << L"Comparing codearray pull-parser against MSXML: " << ENDL;
+
+      // Browse scripts in VFS
+      vfs.Enumerate(L"D:\\X3 Albion Prelude", GameVersion::TerranConflict);
+      for (auto& f : vfs.Browse(XFolder::Scripts))
+      {
+         // Ensure PCK/XML
+         if (!f.FullPath.HasExtension(L".pck") && !f.FullPath.HasExtension(L".xml"))
+            continue;
+
+         try
+         {
+            // Parse with DOM
+            CodeArrayDocument dom(f.OpenRead());
+
+            // Decode incrementally + parse with pull reader
+            CodeArrayReader pull;
+            pull.Load(f.OpenRead());
+
+            // Compare trees
+            if (!Compare_CodeArray(dom, dom.CodeArray, pull))
+            {
+               Console << Cons::Error << "Mismatch: " << f.FullPath << ENDL;
+               ++failed;
+            }
+            ++count;
+         }
+         catch (ExceptionBase& e) {
+            Console << Cons::Error << "Failed: " << f.FullPath << " : " << e.Message << ENDL;
+            ++failed;
+         }
+      }
+
+      // Feedback
+      Console << (failed ? Cons::Red : Cons::Green) << "Compared " << count << " scripts, " << failed << " mismatches" << ENDL;
+   }
+
    void LogicTests::Test_ScriptCompiler(Path p)
    {
       // Located problem: egosoft inserts JMPs to end-of-conditional even after RETURNs, except when it's the final RETURN of the script.
@@ -249,6 +371,49 @@ namespace Testing
    }
 
 
+   void  LogicTests::Test_CatalogWriter()
+   {
+      const char* files[2] = { "<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\r\n<language id=\"44\" />", 
+                               "Arbitrary data within a types file" };
+      TempPath folder(L"cat");
+
+      try
+      {
+         // Create game folder
+         DeleteFile(folder.c_str());
+         CreateDirectory(folder.c_str(), nullptr);
+
+         // Pack files into catalog
+         CatalogWriter writer(folder + L"01.cat");
+         writer.Add(StreamPtr(new MemoryStream((BYTE*)files[0], strlen(files[0]), FileAccess::Read)), L"t\\440001.xml");
+         writer.Add(StreamPtr(new MemoryStream((BYTE*)files[1], strlen(files[1]), FileAccess::Read)), L"types\\TTest.txt");   // NB: Not .pck, data is not compressed
+         writer.Close();
+
+         // Read back through file-system
+         XFileSystem vfs;
+         vfs.Enumerate(folder, GameVersion::TerranConflict);
+
+         const wchar* keys[2] = { L"t\\440001", L"types\\TTest" };
+         for (int i = 0; i < 2; ++i)
+         {
+            auto bytes = vfs.Find(folder + keys[i]).OpenRead()->ReadAllBytes();
+
+            if (memcmp(bytes.get(), files[i], strlen(files[i])) != 0)
+               Console << Cons::Error << "Catalog file " << keys[i] << " does not match input" << ENDL;
+            else
+               Console << Cons::Success << "Catalog file " << keys[i] << " matches input" << ENDL;
+         }
+      }
+      catch (ExceptionBase&  e) {
+         GetAppBase()->ShowError(HERE, e, L"Unable to pack catalog");
+      }
+
+      // Cleanup
+      DeleteFile((folder + L"01.cat").c_str());
+      DeleteFile((folder + L"01.dat").c_str());
+      RemoveDirectory(folder.c_str());
+   }
+
    void  LogicTests::Test_DescriptionReader()
    {
       const AppPath path = L"Data\\Descriptions.xml";
@@ -383,8 +548,13 @@ namespace Testing
 
             try
             {
-               ExpressionParser(lex.Tokens.begin(), lex.Tokens.end());
-               Console << Cons::Green << "Success" << ENDL;
+               ExpressionParser expr(lex.Tokens.begin(), lex.Tokens.end());
+               Console << Cons::Green << "Success: ";
+
+               // Print postfix
+               for (auto& tok : expr.PostfixParams)
+                  Console << tok.Text << L" ";
+               Console << ENDL;
             }
             catch (ExpressionParserException& e)
             {
@@ -480,7 +650,436 @@ namespace Testing
          Console.Log(HERE, e);
       }
    }
+
+   void  LogicTests::Test_LineHighlighter()
+   {
+      try
+      {
+         Console << Cons::Heading << "Performing line highlighter test..." << ENDL;
+
+         ScriptFile script(L"test.xml");
+         LineHighlighter highlighter;
+         wstring line(L"$ship = [THIS] -> get ship  * comment");
+
+         // Lex + cache
+         auto& runs = highlighter.GetRuns(script, line);
+         for (auto& r : runs)
+            Console << "Run: " << r.Start << "-" << r.End << " colour=" << (UINT)r.Colour << ENDL;
+
+         // Runs should be contiguous, non-empty and cached
+         bool ordered = true;
+         for (UINT i = 0; i < runs.size(); ++i)
+            ordered &= runs[i].Start < runs[i].End && (i == 0 || runs[i-1].End <= runs[i].Start);
+
+         Console << (ordered ? Cons::Green : Cons::Red) << "Runs ordered: " << ordered << ENDL;
+         Console << (&highlighter.GetRuns(script, line) == &runs ? Cons::Green : Cons::Red) << "Cached: " << highlighter.Count << " lines" << ENDL;
+
+         // Reset discards cache
+         highlighter.Reset();
+         Console << (highlighter.Count == 0 ? Cons::Green : Cons::Red) << "Reset: " << highlighter.Count << " lines" << ENDL;
+      }
+      catch (ExceptionBase& e)
+      {
+         Console.Log(HERE, e);
+      }
+   }
+   
+   void  LogicTests::Test_RegExPrefilter()
+   {
+      try
+      {
+         Console << Cons::Heading << "Performing regEx prefilter test..." << ENDL;
+
+         wstring text(L"$ship = [THIS] -> get ship\n* comment: ship 42\n$ship.2 = $ship -> get sector\nreturn $ship.2");
+         const wchar* patterns[] = { L"\\$ship\\.\\d", L"get s[a-z]+", L"ship \\d+$", L"^\\$ship", L"comment:\\s+ship", L"\\[THIS\\]|return",
+                                     L"(get|return) \\$?s\\w*", L"\\bship\\b", L"[^a-z $.]{2,3}", L"s.*?r", L"(?:\\$s[a-z]+)+\\.?\\d?" };
+
+         // Filtered search should find the same matches as regex_search
+         for (auto p : patterns)
+         {
+            wregex regex(p);
+            RegExPrefilter filter(p);
+            bool same = true;
+
+            for (UINT start = 0; start < text.length(); ++start)
+            {
+               wsmatch matches;
+               UINT pos = 0, length = 0;
+               bool expected = regex_search(text.cbegin()+start, text.cend(), matches, regex),
+                    found = filter.Find(text, start, regex, pos, length);
+
+               same &= (expected == found) && (!found || (pos == matches[0].first - text.cbegin() && length == matches[0].length()));
+            }
+
+            Console << (same ? Cons::Green : Cons::Red) << p << Cons::White << " literal='" << filter.Literal << "' singleLine=" << filter.SingleLine 
+                    << " linear=" << filter.Linear << ENDL;
+         }
+      }
+      catch (ExceptionBase& e)
+      {
+         Console.Log(HERE, e);
+      }
+   }
+
+   void  LogicTests::Test_XFileTable()
+   {
+      try
+      {
+         Console << Cons::Heading << "Performing file table test..." << ENDL;
+
+         // NB: Catalog must exist, its contents are not read
+         XFileSystem vfs;
+         XCatalog    cat(vfs, L"D:\\X3 Terran Conflict\\01.cat");
+         XFileTable  table;
+
+         // Catalog files, one overridden by a physical file that differs only in case
+         table.Add(&cat, L"D:\\X3\\scripts\\plugin.b.pck", 10, 0);
+         table.Add(&cat, L"D:\\X3\\scripts\\plugin.a.xml", 20, 10);
+         table.Add(&cat, L"D:\\X3\\scripts\\\u00C4rger.xml", 30, 30);
+         table.Add(nullptr, L"d:\\x3\\SCRIPTS\\PLUGIN.A.xml", 0, 0);
+         table.Add(nullptr, L"D:\\X3\\scripts\\plugin.c.xml", 0, 0);
+
+         // Lookup: Case insensitive, including non-ASCII
+         Console << (table.Count == 4 ? Cons::Green : Cons::Red) << "Count: " << table.Count << ENDL;
+         Console << (table.Contains(L"d:\\x3\\scripts\\\u00E4RGER") && !table.Contains(L"D:\\X3\\scripts\\plugin.d") ? Cons::Green : Cons::Red) << "Contains" << ENDL;
+         Console << (table.Find(vfs, L"D:\\X3\\Scripts\\plugin.a").Source == FileSource::Physical ? Cons::Green : Cons::Red) << "Find: Physical overrides catalog" << ENDL;
+
+         // Browse: All files, ordered by key
+         auto files = table.Browse(vfs, L"D:\\X3\\scripts");
+         auto a = find_if(files.begin(), files.end(), [](const XFileInfo& f) { return f.Key == L"D:\\X3\\scripts\\plugin.b"; });
+         Console << (files.size() == 4 && a != files.begin() && prev(a)->Key == L"d:\\x3\\SCRIPTS\\PLUGIN.A" ? Cons::Green : Cons::Red) << "Browse: " << files.size() << " files" << ENDL;
+
+         // Shadowing: Lower precedence files do not replace higher
+         table.Add(&cat, L"D:\\X3\\scripts\\plugin.a.pck", 40, 60);
+         table.Add(&cat, L"D:\\X3\\scripts\\plugin.b.xml", 50, 100);
+         auto b = table.Find(vfs, L"D:\\X3\\scripts\\plugin.b");
+         Console << (table.Find(vfs, L"D:\\X3\\scripts\\plugin.a").Source == FileSource::Physical ? Cons::Green : Cons::Red) << "Catalog does not replace physical" << ENDL;
+         Console << (b.Length == 10 && b.FullPath.HasExtension(L".pck") && table.Count == 4 ? Cons::Green : Cons::Red) << "XML does not replace PCK" << ENDL;
+
+         // Refresh: Removing physical files restores the catalog file they overrode
+         table.RemovePhysical(L"D:\\X3\\scripts");
+         auto restored = table.Find(vfs, L"D:\\X3\\scripts\\plugin.a");
+         Console << (restored.Source == FileSource::Catalog && restored.Length == 20 && restored.Offset == 10 ? Cons::Green : Cons::Red) << "Shadowed catalog file restored" << ENDL;
+         Console << (!table.Contains(L"D:\\X3\\scripts\\plugin.c") ? Cons::Green : Cons::Red) << "Physical file removed" << ENDL;
+      }
+      catch (ExceptionBase& e)
+      {
+         Console.Log(HERE, e);
+      }
+   }
+
+   void  LogicTests::Test_GameDataSet()
+   {
+      try
+      {
+         // NB: Discards any loaded game data
+         Console << Cons::Heading << "Performing game data set test..." << ENDL;
+
+         Path folder(L"D:\\X3 Terran Conflict");
+         auto tc = GameDataSet::Create(folder, GameVersion::TerranConflict, GameLanguage::English);
+         tc->Loaded = true;
+         auto ap = GameDataSet::Create(folder, GameVersion::AlbionPrelude, GameLanguage::English);
+         ap->Loaded = true;
+
+         // Libraries should resolve to the active set
+         Console << (&StringLib == &ap->Strings && &GameObjectLib == &ap->GameObjects ? Cons::Green : Cons::Red) << "Active: AP" << ENDL;
+         GameDataSet::Activate(GameDataSet::Find(GameVersion::TerranConflict, GameLanguage::German));
+         Console << (tc->Active && &ScriptObjectLib == &tc->ScriptObjects ? Cons::Green : Cons::Red) << "Switched: TC" << ENDL;
+
+         // Scoped set should resolve upon this thread without being activated
+         {
+            GameDataSet::Scope scope(GameDataSet::Find(GameVersion::AlbionPrelude));
+            Console << (tc->Active && &StringLib == &ap->Strings && &ScriptObjectLib == &ap->ScriptObjects ? Cons::Green : Cons::Red) << "Scoped: AP" << ENDL;
+         }
+         Console << (&StringLib == &tc->Strings ? Cons::Green : Cons::Red) << "Scope released: TC" << ENDL;
+
+         // Loading the same game again should replace its set only
+         auto reload = GameDataSet::Create(folder, GameVersion::TerranConflict, GameLanguage::English);
+         Console << (reload->Active && !GameDataSet::Find(folder, GameVersion::TerranConflict, GameLanguage::English) && GameDataSet::GetCount() == 1 ? Cons::Green : Cons::Red) 
+                 << "Replaced: " << GameDataSet::GetCount() << " loaded" << ENDL;
+
+         // Clearing should restore the default libraries
+         GameDataSet::Clear();
+         Console << (&StringLib == &StringLibrary::Instance && !GameDataSet::GetActive() ? Cons::Green : Cons::Red) << "Cleared" << ENDL;
+      }
+      catch (ExceptionBase& e)
+      {
+         Console.Log(HERE, e);
+      }
+   }
+
+   void  LogicTests::Test_MemoryArena()
+   {
+      try
+      {
+         Console << Cons::Heading << "Performing memory arena test..." << ENDL;
+
+         MemoryArenaPtr arena(new MemoryArena(4096));
+         {
+            CommandNodePtr root = CommandNode::Create(*arena);
+
+            // Nodes, their parameters and text should be drawn from the arena and linked as siblings
+            for (UINT i = 1; i <= 100; ++i)
+            {
+               CommandLexer   lex(VString(L"$x = %d", i));
+               ParameterArray params(*arena);
+               *root += CommandNode::Create(*arena, Conditional::NONE, CommandSyntax::Unrecognised, params, lex, i, false);
+            }
+            Console << (root->Children.size() == 100 && root->Children.back()->FindPrevSibling()->LineNumber == 99 ? Cons::Green : Cons::Red) 
+                    << "Linked: " << root->Children.size() << " children in " << arena->Size << " bytes" << ENDL;
+
+            // Removing a child should unlink it, but it should remain valid until the arena is reset
+            CommandNode* first = root->Children.front();
+            *root -= first;
+            Console << (root->Children.front()->LineNumber == 2 && first->LineText == L"$x = 1" ? Cons::Green : Cons::Red) 
+                    << "Unlinked: " << root->Children.size() << " children" << ENDL;
+         }
+
+         // Resetting should release every node at once, retaining a single chunk
+         arena->Reset();
+         Console << (arena->Size == 0 && arena->Capacity == 4096 ? Cons::Green : Cons::Red) << "Reset: " << arena->Capacity << " bytes retained" << ENDL;
+      }
+      catch (ExceptionBase& e)
+      {
+         Console.Log(HERE, e);
+      }
+   }
+
+   void  LogicTests::Test_StringPool()
+   {
+      try
+      {
+         Console << Cons::Heading << "Performing string pool test..." << ENDL;
+
+         auto& pool = StringPool::GetInstance();
+         UINT count = pool.Count;
+         {
+            // Identical text should share a single copy
+            LanguageString a(1, 7, L"Argon Prime", GameVersion::Threat),
+                           b(2, 7, L"Argon Prime", GameVersion::Reunion),
+                           c(a);
+            Console << (&a.GetText() == &b.GetText() && &a.GetText() == &c.GetText() ? Cons::Green : Cons::Red) << "Shared: " << (pool.Count - count) << " distinct" << ENDL;
+
+            // Changing text should not affect other strings
+            b.Text = L"Home of Light";
+            Console << (a.Text == L"Argon Prime" && b.Text == L"Home of Light" ? Cons::Green : Cons::Red) << "Changed: " << (pool.Count - count) << " distinct" << ENDL;
+         }
+
+         // Strings should be released with the last reference
+         Console << (pool.Count == count ? Cons::Green : Cons::Red) << "Released: " << pool.SharedBytes << " bytes shared" << ENDL;
+      }
+      catch (ExceptionBase& e)
+      {
+         Console.Log(HERE, e);
+      }
+   }
+
+   void  LogicTests::Test_TaskScheduler()
+   {
+      try
+      {
+         Console << Cons::Heading << "Performing task scheduler test..." << ENDL;
+
+         auto& scheduler = TaskScheduler::GetDefault();
+         std::atomic<UINT> sum(0);
+         TaskArray tasks;
+
+         // Nested tasks: Each waits upon children queued by itself
+         for (UINT i = 0; i < 16; ++i)
+            tasks.push_back(scheduler.Run([&scheduler,&sum] (const CancellationToken&) -> DWORD 
+            {
+               TaskArray children;
+               for (UINT j = 0; j < 16; ++j)
+                  children.push_back(scheduler.Run([&sum] (const CancellationToken&) -> DWORD { ++sum; return 0; }));
+
+               scheduler.WaitAll(children);
+               return 0;
+            }));
+
+         scheduler.WaitAll(tasks);
+         Console << (sum == 256 ? Cons::Green : Cons::Red) << "Nested: " << sum.load() << " of 256 on " << scheduler.ThreadCount << " workers" << ENDL;
+
+         // Dependencies: Second executes after first, third is cancelled by a failed dependency
+         auto first = scheduler.Run([] (const CancellationToken&) -> DWORD { return 1; }),
+              second = scheduler.Run([&first] (const CancellationToken&) -> DWORD { return first->Result + 1; }, CancellationToken(), TaskArray(1, first)),
+              failed = scheduler.Run([] (const CancellationToken&) -> DWORD { throw InvalidOperationException(HERE, L"Task failure"); }),
+              third = scheduler.Run([] (const CancellationToken&) -> DWORD { return 3; }, CancellationToken(), TaskArray(1, failed));
+
+         Console << (second->Result == 2 ? Cons::Green : Cons::Red) << "Dependency result: " << second->Result << ENDL;
+         third->Wait();
+         Console << (third->State == TaskState::Cancelled ? Cons::Green : Cons::Red) << "Dependent of failed task cancelled: " << (third->State == TaskState::Cancelled) << ENDL;
+
+         // Cancellation: Token cancelled before execution
+         CancellationToken token;
+         token.Cancel();
+         auto cancelled = scheduler.Run([] (const CancellationToken&) -> DWORD { return 0; }, token);
+         cancelled->Wait();
+         Console << (cancelled->State == TaskState::Cancelled ? Cons::Green : Cons::Red) << "Cancelled: " << (cancelled->State == TaskState::Cancelled) << ENDL;
+      }
+      catch (ExceptionBase& e)
+      {
+         Console.Log(HERE, e);
+      }
+   }
    
+   void  LogicTests::Test_BuildCache()
+   {
+      const WCHAR *path = L"D:\\Temp\\build.xml";
+
+      try
+      {
+         Console << Cons::Heading << "Performing build cache test..." << ENDL;
+
+         // Build cache containing a successful script and a failed caller
+         BuildCache cache(L"D:\\X3 Terran Conflict", GameVersion::TerranConflict, GameLanguage::English, true);
+         BuildEntry callee(L"D:\\Temp\\plugin.callee.xml"), caller(L"D:\\Temp\\plugin.caller.xml");
+         
+         callee.SourceHash = BuildCache::GetHash((const BYTE*)"callee", 6);
+         callee.Signature = 0xfedcba9876543210ULL;
+         callee.Output = L"0000abcd.plugin.callee.xml";
+         caller.SourceHash = BuildCache::GetHash((const BYTE*)"caller", 6);
+         caller.Calls[L"plugin.callee"] = callee.Signature;
+         caller.Diagnostics.push_back(BuildDiagnostic(3, L"Unknown command", L"$x = <caller>"));
+         cache.Add(callee);
+         cache.Add(caller);
+
+         // Write/Read
+         BuildCacheWriter w(StreamPtr(new FileStream(path, FileMode::CreateAlways, FileAccess::Write)));
+         w.WriteFile(cache);
+         w.Close();
+
+         auto copy = BuildCacheReader(StreamPtr(new FileStream(path, FileMode::OpenExisting, FileAccess::Read))).ReadFile();
+
+         // Compare: Lookups are case insensitive
+         auto a = copy.Find(L"D:\\TEMP\\PLUGIN.CALLEE.XML"),
+              b = copy.Find(caller.FullPath);
+         Console << (copy.Matches(cache) && copy.Count == 2 ? Cons::Green : Cons::Red) << "Header: " << copy.Count << " entries" << ENDL;
+         Console << (a && a->SourceHash == callee.SourceHash && a->Signature == callee.Signature && a->Output == callee.Output && a->IsSuccessful() ? Cons::Green : Cons::Red) << "Callee" << ENDL;
+         // Different verification preference: Discarded
+         copy.CheckArgumentTypes = !cache.CheckArgumentTypes;
+         Console << (!copy.Matches(cache) ? Cons::Green : Cons::Red) << "Preferences changed: discarded" << ENDL;
+         Console << (b && b->Calls == caller.Calls && !b->IsSuccessful() && b->Diagnostics.front().Line == 3 && b->Diagnostics.front().Text == L"$x = <caller>" ? Cons::Green : Cons::Red) << "Caller" << ENDL;
+      }
+      catch (ExceptionBase& e)
+      {
+         Console.Log(HERE, e);
+      }
+   }
+
+   /// <summary>Exposes the rebuild decisions of the project builder</summary>
+   class BuildDecisionTester : public ProjectBuilder
+   {
+   public:
+      BuildDecisionTester(const Path& cache) : ProjectBuilder(L"", cache, L"D:\\X3 Terran Conflict", GameVersion::TerranConflict, GameLanguage::English, true)
+      {}
+
+      /// <summary>Records the previous result of a script</summary>
+      void  AddPrevious(const BuildEntry& e)
+      {
+         Previous.Add(e);
+      }
+
+      /// <summary>Hashes the project scripts then invalidates those calling changed scripts, as a build does</summary>
+      void  Decide(const list<Path>& project)
+      {
+         for (auto& p : project)
+         {
+            ScriptIndex[BuildCache::GetPathKey(p)] = Scripts.size();
+            Scripts.push_back(ScriptState(p));
+         }
+
+         for (auto& s : Scripts)
+            HashScript(s);
+
+         for (auto& s : Scripts)
+            if (!s.Dirty && Invalidate(s))
+               s.Dirty = true;
+      }
+
+      /// <summary>Query whether a project script must be rebuilt</summary>
+      bool  IsDirty(const Path& p) const
+      {
+         return Scripts[ScriptIndex.find(BuildCache::GetPathKey(p))->second].Dirty;
+      }
+   };
+
+   void  LogicTests::Test_BuildDecisions()
+   {
+      const Path folder = L"D:\\Temp\\BuildTest\\",
+                 cache = folder + L"cache\\",
+                 callee = folder + L"test.callee.xml",
+                 caller = folder + L"test.caller.xml";
+      const char *calleeText = "callee", 
+                 *callerText = "caller";
+      const UINT64 signature = 0xfedcba9876543210ULL;
+
+      // Writes a file
+      auto write = [](const Path& p, const char* txt) 
+      {
+         FileStream(p, FileMode::CreateAlways, FileAccess::Write).Write((const BYTE*)txt, (DWORD)strlen(txt));
+      };
+
+      // Builds the decisions for the project against a previous build of both scripts.  Caller recorded the callee signature given
+      auto decide = [&](const list<Path>& project, UINT64 recorded) -> shared_ptr<BuildDecisionTester>
+      {
+         auto tester = make_shared<BuildDecisionTester>(cache);
+         BuildEntry a(callee), b(caller);
+
+         a.SourceHash = BuildCache::GetHash((const BYTE*)calleeText, (DWORD)strlen(calleeText));
+         a.Signature = signature;
+         a.Output = L"callee.out";
+         b.SourceHash = BuildCache::GetHash((const BYTE*)callerText, (DWORD)strlen(callerText));
+         b.Calls[L"test.callee"] = recorded;
+         b.Output = L"caller.out";
+         tester->AddPrevious(a);
+         tester->AddPrevious(b);
+
+         tester->Decide(project);
+         return tester;
+      };
+
+      try
+      {
+         Console << Cons::Heading << "Performing build decision test..." << ENDL;
+
+         // Previous build: Both scripts and their compiled output
+         SHCreateDirectory(nullptr, cache.c_str());
+         write(callee, calleeText);
+         write(caller, callerText);
+         write(cache + L"callee.out", "");
+         write(cache + L"caller.out", "");
+
+         // Unchanged: Reused
+         auto t = decide({callee, caller}, signature);
+         Console << (!t->IsDirty(callee) && !t->IsDirty(caller) ? Cons::Green : Cons::Red) << "Unchanged: reused" << ENDL;
+
+         // Callee signature changed since caller was built: Caller rebuilt
+         t = decide({callee, caller}, signature+1);
+         Console << (!t->IsDirty(callee) && t->IsDirty(caller) ? Cons::Green : Cons::Red) << "Changed callee signature: caller rebuilt" << ENDL;
+
+         // Caller source changed: Rebuilt
+         write(caller, "caller changed");
+         t = decide({callee, caller}, signature);
+         Console << (t->IsDirty(caller) ? Cons::Green : Cons::Red) << "Changed source: rebuilt" << ENDL;
+         write(caller, callerText);
+
+         // Compiled output missing: Caller rebuilt
+         DeleteFile((cache + L"caller.out").c_str());
+         t = decide({callee, caller}, signature);
+         Console << (!t->IsDirty(callee) && t->IsDirty(caller) ? Cons::Green : Cons::Red) << "Missing output: caller rebuilt" << ENDL;
+         write(cache + L"caller.out", "");
+
+         // Callee removed from project and disc: Caller rebuilt
+         DeleteFile(callee.c_str());
+         t = decide({caller}, signature);
+         Console << (t->IsDirty(caller) ? Cons::Green : Cons::Red) << "Removed callee: caller rebuilt" << ENDL;
+      }
+      catch (ExceptionBase& e)
+      {
+         Console.Log(HERE, e);
+      }
+   }
+
    void  LogicTests::Test_GZip_Decompress()
    {
       const WCHAR *zipped = L"D:\\Temp\\lib.piracy.progressbar.xml.zip",
@@ -545,6 +1144,92 @@ namespace Testing
       }
    }
 
+   void  LogicTests::Test_GZip_Parallel()
+   {
+      TempPath path(L"gzp");
+      
+      try
+      {
+         // Generate ~4MB of compressible input
+         string input;
+         char   line[128];
+         for (int i = 0; input.length() < 4*1024*1024; ++i)
+         {
+            sprintf_s(line, "<t id=\"%d\">Synthetic language string number %d</t>\r\n", i, i*7);
+            input += line;
+         }
+
+         // Compress in parallel, in uneven writes
+         StreamPtr output( new GZipStream(StreamPtr(new FileStream(path, FileMode::CreateAlways, FileAccess::Write)), GZipStream::Operation::Compression, CompressionOptions::Parallel()) );
+         for (DWORD pos = 0; pos < input.length(); pos += 100000)
+            output->Write((const BYTE*)&input[pos], min(100000U, (DWORD)input.length() - pos));
+         output->Close();
+
+         // Decompress serially + compare
+         StreamPtr gz( new GZipStream(StreamPtr(new FileStream(path, FileMode::OpenExisting, FileAccess::Read)), GZipStream::Operation::Decompression) );
+         auto length = gz->GetLength();
+         auto bytes = gz->ReadAllBytes();
+
+         if (length != input.length() || memcmp(bytes.get(), input.c_str(), length) != 0)
+            Console << Cons::Error << "Parallel GZip output does not match input" << ENDL;
+         else
+            Console << Cons::Success << "Parallel GZip output matches input" << ENDL;
+      }
+      catch (ExceptionBase&  e) {
+         GetAppBase()->ShowError(HERE, e, L"Unable to compress in parallel");
+      }
+
+      DeleteFile(path.c_str());
+   }
+
+   void  LogicTests::Test_TextDecoder()
+   {
+      Console << Cons::Heading << "Comparing TextDecoder against MultiByteToWideChar..." << ENDL;
+
+      // Decodes input in chunks and compares against the system conversion
+      auto compare = [](const char* name, TextDecoder::Encoding enc, UINT codepage, const string& input)
+      {
+         vector<WCHAR> expected(input.length()+1);
+         expected.resize(MultiByteToWideChar(codepage, 0, input.c_str(), input.length(), &expected[0], expected.size()));
+
+         // Chunk at awkward sizes to split multi-byte sequences
+         for (UINT chunk : { 1U, 3U, 17U, 4096U })
+         {
+            TextDecoder decoder(enc);
+            vector<WCHAR> output(input.length()+1);
+            size_t length = 0;
+
+            for (size_t pos = 0; pos < input.length() || pos == 0; pos += chunk)
+            {
+               size_t count = min((size_t)chunk, input.length() - pos);
+               length += decoder.Decode((const BYTE*)input.c_str() + pos, count, &output[length], pos + count >= input.length());
+            }
+
+            if (length != expected.size() || !equal(expected.begin(), expected.end(), output.begin()))
+            {
+               Console << Cons::Error << name << " output differs using " << chunk << " byte chunks" << ENDL;
+               return;
+            }
+         }
+         Console << Cons::Success << name << " output matches" << ENDL;
+      };
+
+      // Windows-1250: Every byte
+      string cp1250;
+      for (int ch = 1; ch < 256; ++ch)
+         cp1250 += (char)ch;
+      compare("Windows-1250", TextDecoder::Encoding::Windows1250, 1250, cp1250);
+
+      // UTF-8: Every BMP character, plus supplementary characters
+      wstring chars;
+      for (WCHAR ch = 1; ch < 0xD800; ++ch)
+         chars += ch;
+      for (UINT ch = 0xE000; ch <= 0xFFFF; ++ch)
+         chars += (WCHAR)ch;
+      chars += L"\xD83D\xDE00 \xD800\xDC00 \xDBFF\xDFFF";
+      compare("UTF-8", TextDecoder::Encoding::UTF8, CP_UTF8, GuiString::Convert(chars, CP_UTF8));
+   }
+
    void  LogicTests::Test_Iterator()
    {
       const WCHAR* path = L"D:\\My Projects\\MFC Test 1\\MFC Test 1\\testfile.xml"; 
@@ -568,6 +1253,47 @@ namespace Testing
          AfxMessageBox(sz);
       }
    }
+
+   void  LogicTests::Test_ProjectFile()
+   {
+      Console << Cons::Heading << "Testing ProjectFile indexes..." << ENDL;
+
+      auto check = [](const char* name, bool result)
+      {
+         Console << (result ? Cons::Green : Cons::Red) << (result ? "Passed: " : "Failed: ") << name << ENDL;
+      };
+
+      ProjectFile proj(L"C:\\Project\\example.xprj");
+      auto& scripts   = proj.Add(ProjectItem(L"MSCI Scripts", true));
+      auto& variables = proj.Add(ProjectItem(L"Variables", true));
+
+      // Add: Nested folder + file
+      auto& user = proj.Add(ProjectItem(L"MSCI Scripts", false), scripts);
+      auto& file = proj.Add(ProjectItem(FileType::Script, L"C:\\Scripts\\plugin.test.xml", L""), user);
+      proj.Add(ProjectItem(L"example", 42), variables);
+
+      check("Find root", proj.Find(L"c:\\project\\EXAMPLE.xprj") == &proj.Root);
+      check("Find path (case-insensitive)", proj.Find(L"c:\\SCRIPTS\\Plugin.Test.xml") == &file);
+      check("Find variable", proj.Find(ProjectItemType::Variable, L"example") != nullptr);
+      check("Find base folder", proj.FindFolder(FileType::Script) == &scripts);
+
+      // Rename: Old path/name removed
+      proj.Rename(file, L"plugin.renamed.xml", L"C:\\Scripts\\plugin.renamed.xml");
+      check("Rename: Old path", !proj.Contains(L"C:\\Scripts\\plugin.test.xml"));
+      check("Rename: New path", proj.Find(L"C:\\Scripts\\plugin.renamed.xml") == &file);
+      check("Rename: New name", proj.Find(ProjectItemType::File, L"plugin.renamed.xml") == &file);
+
+      // Copy: Indexes refer to copy
+      ProjectFile copy(proj);
+      auto item = copy.Find(L"C:\\Scripts\\plugin.renamed.xml");
+      check("Copy", item != nullptr && item != &file);
+
+      // Remove: Descendants removed
+      proj.Remove(user);
+      check("Remove: Descendant path", !proj.Contains(L"C:\\Scripts\\plugin.renamed.xml"));
+      check("Remove: Folder name", proj.Find(ProjectItemType::Folder, L"MSCI Scripts") == &scripts);
+      check("Remove: Copy unaffected", copy.Contains(L"C:\\Scripts\\plugin.renamed.xml"));
+   }
    
    void  LogicTests::Test_LanguageFileReader()
    {
@@ -588,6 +1314,55 @@ namespace Testing
       }
    }
 
+   void  LogicTests::Test_LanguageFileIndex()
+   {
+      const char* xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\r\n"
+                        "<!-- <page id=\"9999\"/> -->\r\n"
+                        "<language id=\"44\">\r\n"
+                        "  <page id=\"300017\" title=\"Ships &amp; &quot;Stations&quot;\" descr=\"&lt;none&gt;\" voice=\"no\">\r\n"
+                        "    <t id=\"1\">Argon Prime</t>\r\n"
+                        "    <t id=\"2\"><![CDATA[<Home> of Light]]></t>\r\n"
+                        "  </page>\r\n"
+                        "  <page id=\"1004\" title=\"Empty\"/>\r\n"
+                        "  <page id=\"350017\" title=\"Duplicate\" voice=\"yes\">\r\n"
+                        "    <t id=\"2\">Kingdom End</t>\r\n"
+                        "    <!-- <t id=\"3\">Commented</t> -->\r\n"
+                        "    <t id=\"3\">Three Worlds</t>\r\n"
+                        "  </page>\r\n"
+                        "</language>";
+
+      try
+      {
+         Console << Cons::Heading << "Performing language file index test..." << ENDL;
+
+         LanguageFileIndex index;
+         auto lazy = index.ReadFile(StreamPtr(new MemoryStream((BYTE*)xml, strlen(xml), FileAccess::Read)), L"0001-L044.xml");
+         auto full = LanguageFileReader(StreamPtr(new MemoryStream((BYTE*)xml, strlen(xml), FileAccess::Read))).ReadFile(L"0001-L044.xml");
+
+         // Pages should be indexed without strings
+         auto& page = lazy.Pages.FindByIndex(0);
+         Console << (lazy.Pages.size() == 2 && index.PendingPages == 1 && page.Strings.empty() ? Cons::Green : Cons::Red) 
+                 << "Indexed: " << index.GetStringCount(page) << " strings, title='" << page.Title << "'" << ENDL;
+
+         // Loaded pages should match a file read in full
+         index.LoadAll(lazy.Pages);
+         bool same = lazy.Pages.size() == full.Pages.size();
+         for (auto& pair : full.Pages)
+         {
+            auto& p = lazy.Pages.Find(pair.first);
+            same &= (p.Title == pair.second.Title && p.Description == pair.second.Description && p.Voiced == pair.second.Voiced && p.Strings.size() == pair.second.Strings.size());
+
+            for (auto& str : pair.second.Strings)
+               same &= (p.Strings.Contains(str.first) && p.Strings.Find(str.first).Text == str.second.Text && p.Strings.Find(str.first).Version == str.second.Version);
+         }
+         Console << (same && index.PendingPages == 0 ? Cons::Green : Cons::Red) << "Loaded: " << lazy.Pages.Find(17).Strings.size() << " strings" << ENDL;
+      }
+      catch (ExceptionBase& e)
+      {
+         Console.Log(HERE, e);
+      }
+   }
+
    void  LogicTests::Test_LanguageEditRegEx()
    {
       try
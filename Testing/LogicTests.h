@@ -16,29 +16,44 @@ namespace Testing
       static void  RunAll();
 
    public:
+      static void  BatchTest_CodeArrayReader();
       static void  BatchTest_ScriptCompiler();
       static void  Test_CommandSyntax();
       static void  Test_LanguageFileReader();
+      static void  Test_LanguageFileIndex();
       static void  Test_LanguageEditRegEx();
       static void  Test_TFileReader();
       static void  Test_CatalogReader();
+      static void  Test_BuildCache();
+      static void  Test_BuildDecisions();
+      static void  Test_CatalogWriter();
       static void  Test_CommandTreeIterator();
       static void  Test_ExpressionParser();
       static void  Test_DescriptionReader();
       static void  Test_DescriptionRegEx();
       static void  Test_DiffDocument();
       static void  Test_FileSystem();
+      static void  Test_GameDataSet();
       static void  Test_GZip_Decompress();
       static void  Test_GZip_Compress();
+      static void  Test_GZip_Parallel();
       static void  Test_Lexer();
+      static void  Test_LineHighlighter();
+      static void  Test_MemoryArena();
       static void  Test_Iterator();
+      static void  Test_ProjectFile();
+      static void  Test_RegExPrefilter();
       static void  Text_RegEx();
       static void  Test_StringLibrary();
+      static void  Test_StringPool();
       static void  Test_ScriptCompiler(Path p);
       static void  Test_ScriptValidator(Path p);
       static void  Test_StringParser();
       static void  Test_StringParserRegEx();
+      static void  Test_TextDecoder();
       static void  Test_SyntaxWriter();
+      static void  Test_TaskScheduler();
+      static void  Test_XFileTable();
       static void  Test_XmlWriter();
 
       // --------------------- PROPERTIES ------------------------
@@ -188,7 +188,7 @@ namespace Logic
    /// <returns></returns>
    bool  GuiString::Contains(const wstring& str, bool matchCase) const
    {
-      return matchCase ? find(str) != npos : StrStrI(c_str(), str.c_str()) != nullptr;
+      return matchCase ? find(str) != npos : TextSearch::Find(c_str(), length(), str.c_str(), str.length()) != npos;
    }
       
    /// <summary>Perform case insensitive comparison</summary>
@@ -209,10 +209,8 @@ namespace Logic
       if (matchCase)
          return find(str);
 
-      // Insensitive: Convert string ptr into char index
-      auto txt = c_str();
-      auto pos = StrStrI(txt, str.c_str());
-      return pos ? pos - txt : npos;
+      // Insensitive: Case-folding search
+      return TextSearch::Find(c_str(), length(), str.c_str(), str.length());
    }
 
    /// <summary>Find index of a substring</summary>
@@ -231,10 +229,9 @@ namespace Logic
       if (matchCase)
          return find(str, offset);
 
-      // Insensitive: Convert string ptr into char index
-      auto txt = c_str();
-      auto pos = StrStrI(&txt[offset], str.c_str());
-      return pos ? pos - txt : npos;
+      // Insensitive: Search remainder, convert into char index
+      auto pos = TextSearch::Find(c_str() + offset, length() - offset, str.c_str(), str.length());
+      return pos != npos ? offset + pos : npos;
    }
 
    
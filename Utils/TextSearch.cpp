@@ -0,0 +1,174 @@
+#include "stdafx.h"
+#include "TextSearch.h"
+#include <mutex>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+   #include <emmintrin.h>
+   #define TEXT_SEARCH_SSE2
+#endif
+
+namespace Logic
+{
+   /// <summary>Guards creation of the case-folding table</summary>
+   static std::once_flag  FoldTableCreated;
+
+   /// <summary>Lower case equivalent of every UTF-16 code unit</summary>
+   static wchar_t  FoldTable[0x10000];
+
+   // -------------------------------- CONSTRUCTION --------------------------------
+
+   // ------------------------------- STATIC METHODS -------------------------------
+
+   /// <summary>Finds the first case insensitive occurrence of a pattern</summary>
+   /// <param name="text">Text to search</param>
+   /// <param name="length">Length of text, in characters</param>
+   /// <param name="pattern">Pattern to find</param>
+   /// <param name="patternLength">Length of pattern, in characters</param>
+   /// <returns>Offset of first match, or wstring::npos if none.  An empty pattern matches at offset zero</returns>
+   size_t  TextSearch::Find(const wchar_t* text, size_t length, const wchar_t* pattern, size_t patternLength)
+   {
+      // Trivial cases
+      if (patternLength == 0)
+         return 0;
+      if (patternLength > length)
+         return wstring::npos;
+
+      // Fold pattern once: Use stack for short patterns
+      wchar_t          local[STACK_PATTERN];
+      vector<wchar_t>  heap(patternLength > STACK_PATTERN ? patternLength : 0);
+      wchar_t*         folded = heap.empty() ? local : heap.data();
+
+      for (size_t i = 0; i < patternLength; ++i)
+         folded[i] = Fold(pattern[i]);
+
+      // Long: Skip ahead.  Short: Filter candidates by first+last character
+      return patternLength >= LONG_PATTERN ? FindHorspool(text, length, folded, patternLength)
+                                           : FindFiltered(text, length, folded, patternLength);
+   }
+
+   /// <summary>Gets the lower case equivalent of a character, as CharLowerBuff would</summary>
+   /// <param name="ch">Character</param>
+   /// <returns></returns>
+   wchar_t  TextSearch::Fold(wchar_t ch)
+   {
+      // Create upon first use
+      std::call_once(FoldTableCreated, []
+      {
+         for (UINT i = 0; i < 0x10000; ++i)
+            FoldTable[i] = static_cast<wchar_t>(i);
+         CharLowerBuff(FoldTable, 0x10000);
+      });
+
+      return FoldTable[ch];
+   }
+
+   /// <summary>Searches text by comparing the first and last characters of the pattern at each position, then the remainder</summary>
+   /// <param name="text">Text to search</param>
+   /// <param name="length">Length of text, in characters</param>
+   /// <param name="folded">Case-folded pattern</param>
+   /// <param name="patternLength">Length of pattern, in characters.  Must be between one and the length of the text</param>
+   /// <returns>Offset of first match, or wstring::npos if none</returns>
+   size_t  TextSearch::FindFiltered(const wchar_t* text, size_t length, const wchar_t* folded, size_t patternLength)
+   {
+      const wchar_t first = folded[0],
+                    last = folded[patternLength-1];
+      size_t i = 0;
+
+#ifdef TEXT_SEARCH_SSE2
+      // Examine eight positions at a time, while both the first and last characters of each fit within the text
+      if (sizeof(wchar_t) == 2)
+      {
+         const __m128i nonASCII = _mm_set1_epi16(static_cast<short>(0xFF80)),
+                       beforeA = _mm_set1_epi16(L'A'-1),
+                       afterZ = _mm_set1_epi16(L'Z'+1),
+                       lowerBit = _mm_set1_epi16(0x20),
+                       firstCh = _mm_set1_epi16(static_cast<short>(first)),
+                       lastCh = _mm_set1_epi16(static_cast<short>(last)),
+                       zero = _mm_setzero_si128();
+
+         for (; i + patternLength + 7 <= length; i += 8)
+         {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i)),
+                    b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i + patternLength - 1));
+
+            // Non-ASCII: Check each position using the table
+            if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(_mm_or_si128(a, b), nonASCII), zero)) != 0xFFFF)
+            {
+               for (size_t k = i; k < i + 8; ++k)
+                  if (FoldTable[text[k]] == first && FoldTable[text[k+patternLength-1]] == last && Matches(text + k, folded, patternLength))
+                     return k;
+               continue;
+            }
+
+            // ASCII: Set the lower case bit of every upper case letter
+            a = _mm_or_si128(a, _mm_and_si128(_mm_and_si128(_mm_cmpgt_epi16(a, beforeA), _mm_cmplt_epi16(a, afterZ)), lowerBit));
+            b = _mm_or_si128(b, _mm_and_si128(_mm_and_si128(_mm_cmpgt_epi16(b, beforeA), _mm_cmplt_epi16(b, afterZ)), lowerBit));
+
+            // Verify positions where both the first and last characters match  [Two mask bits per position]
+            UINT mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi16(a, firstCh), _mm_cmpeq_epi16(b, lastCh)));
+            for (size_t k = i; mask; ++k, mask >>= 2)
+               if ((mask & 1) && Matches(text + k, folded, patternLength))
+                  return k;
+         }
+      }
+#endif
+      // Check remainder
+      for (; i + patternLength <= length; ++i)
+         if (FoldTable[text[i]] == first && FoldTable[text[i+patternLength-1]] == last && Matches(text + i, folded, patternLength))
+            return i;
+
+      return wstring::npos;
+   }
+
+   /// <summary>Searches text using Boyer-Moore-Horspool, indexing the shift table by the low byte of each character</summary>
+   /// <param name="text">Text to search</param>
+   /// <param name="length">Length of text, in characters</param>
+   /// <param name="folded">Case-folded pattern</param>
+   /// <param name="patternLength">Length of pattern, in characters.  Must be between two and the length of the text</param>
+   /// <returns>Offset of first match, or wstring::npos if none</returns>
+   size_t  TextSearch::FindHorspool(const wchar_t* text, size_t length, const wchar_t* folded, size_t patternLength)
+   {
+      const size_t  lastIndex = patternLength - 1;
+      const wchar_t first = folded[0],
+                    last = folded[lastIndex];
+      size_t shift[256];
+
+      // Shift by distance from the end of the last occurrence.  Characters sharing a low byte share the smallest (safe) distance
+      for (size_t ch = 0; ch < 256; ++ch)
+         shift[ch] = patternLength;
+      for (size_t k = 0; k < lastIndex; ++k)
+         shift[folded[k] & 0xFF] = lastIndex - k;
+
+      // Compare last character, then first character, then remainder
+      for (size_t i = 0; i + patternLength <= length; )
+      {
+         wchar_t ch = FoldTable[text[i+lastIndex]];
+         if (ch == last && FoldTable[text[i]] == first && Matches(text + i, folded, patternLength))
+            return i;
+
+         i += shift[ch & 0xFF];
+      }
+
+      return wstring::npos;
+   }
+
+   /// <summary>Compares the characters between the first and last characters of the pattern</summary>
+   /// <param name="text">Candidate position</param>
+   /// <param name="folded">Case-folded pattern</param>
+   /// <param name="patternLength">Length of pattern, in characters</param>
+   /// <returns></returns>
+   bool  TextSearch::Matches(const wchar_t* text, const wchar_t* folded, size_t patternLength)
+   {
+      for (size_t k = 1; k + 1 < patternLength; ++k)
+         if (FoldTable[text[k]] != folded[k])
+            return false;
+
+      return true;
+   }
+
+   // ------------------------------- PUBLIC METHODS -------------------------------
+
+   // ------------------------------ PROTECTED METHODS -----------------------------
+
+   // ------------------------------- PRIVATE METHODS ------------------------------
+}
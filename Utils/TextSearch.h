@@ -0,0 +1,31 @@
+#pragma once
+
+namespace Logic
+{
+   /// <summary>Case insensitive substring search over UTF-16 text</summary>
+   /// <remarks>Candidate positions are found by comparing the first and last characters of the pattern against eight positions
+   /// at once using SSE2, where available.  Runs of ASCII are case-folded in registers; blocks containing any other character
+   /// are folded using a table built from CharLowerBuff, so accented Latin-1 and code page 1250 letters match as they do in StrStrI.
+   /// Long patterns are searched using Boyer-Moore-Horspool.</remarks>
+   class UtilExport TextSearch
+   {
+      // ------------------------ TYPES --------------------------
+   private:
+      static const size_t  LONG_PATTERN = 32;      // Minimum length of pattern searched using Horspool
+      static const size_t  STACK_PATTERN = 64;     // Maximum length of pattern folded into a stack buffer
+
+      // --------------------- CONSTRUCTION ----------------------
+   private:
+      TextSearch();
+
+      // ------------------------ STATIC -------------------------
+   public:
+      static size_t   Find(const wchar_t* text, size_t length, const wchar_t* pattern, size_t patternLength);
+      static wchar_t  Fold(wchar_t ch);
+
+   private:
+      static size_t   FindFiltered(const wchar_t* text, size_t length, const wchar_t* folded, size_t patternLength);
+      static size_t   FindHorspool(const wchar_t* text, size_t length, const wchar_t* folded, size_t patternLength);
+      static bool     Matches(const wchar_t* text, const wchar_t* folded, size_t patternLength);
+   };
+}
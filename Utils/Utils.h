@@ -13,6 +13,7 @@
 #include "Path.h"
 #include "Exceptions.h"
 #include "GuiString.h"
+#include "TextSearch.h"
 
 
 /// <summary>Logic</summary>
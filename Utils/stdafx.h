@@ -30,8 +30,10 @@
 #include <afxcontrolbars.h>     // MFC support for ribbons and control bars
 
 
-// Visual Leak Detector
+// Visual Leak Detector  [Optional outside the solution build]
+#ifndef NO_VLD
 #include <vld.h>
+#endif
 
 
 // STL
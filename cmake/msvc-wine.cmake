@@ -0,0 +1,34 @@
+# Toolchain: Visual C++ (with ATL/MFC) run under Wine, as installed by https://github.com/mstorsjo/msvc-wine
+#
+#  ./vsdownload.py --dest /opt/msvc  &&  ./install.sh /opt/msvc
+#  cmake -S . -B build -G Ninja -DMSVC_WINE_ROOT=/opt/msvc
+#
+# The batch compiler is 32-bit, as the solution.  Its tests are run with 'wine'
+set(CMAKE_SYSTEM_NAME Windows)
+set(CMAKE_SYSTEM_PROCESSOR x86)
+
+set(MSVC_WINE_ROOT "/opt/msvc" CACHE PATH "Folder msvc-wine installed Visual C++ to")
+set(MSVC_WINE_BIN "${MSVC_WINE_ROOT}/bin/x86")
+
+if(NOT EXISTS "${MSVC_WINE_BIN}/cl")
+   message(FATAL_ERROR "Visual C++ not found in '${MSVC_WINE_BIN}', install it with msvc-wine and set MSVC_WINE_ROOT")
+endif()
+
+set(CMAKE_C_COMPILER   "${MSVC_WINE_BIN}/cl")
+set(CMAKE_CXX_COMPILER "${MSVC_WINE_BIN}/cl")
+set(CMAKE_RC_COMPILER  "${MSVC_WINE_BIN}/rc")
+set(CMAKE_MT           "${MSVC_WINE_BIN}/mt")
+set(CMAKE_LINKER       "${MSVC_WINE_BIN}/link")
+set(CMAKE_AR           "${MSVC_WINE_BIN}/lib")
+
+# Redistributables: Newest toolset version present
+file(GLOB MSVC_REDIST_VERSIONS LIST_DIRECTORIES true "${MSVC_WINE_ROOT}/VC/Redist/MSVC/*")
+list(FILTER MSVC_REDIST_VERSIONS INCLUDE REGEX "/[0-9.]+$")
+list(SORT MSVC_REDIST_VERSIONS COMPARE NATURAL ORDER DESCENDING)
+if(MSVC_REDIST_VERSIONS)
+   list(GET MSVC_REDIST_VERSIONS 0 MSVC_REDIST_DIR)
+endif()
+
+# Run tests under Wine
+find_program(WINE_EXECUTABLE NAMES wine REQUIRED)
+set(CMAKE_CROSSCOMPILING_EMULATOR "${WINE_EXECUTABLE}")